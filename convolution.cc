@@ -20,6 +20,17 @@ const double hsqrt3=0.5*sqrt3;
 const Complex zeta3(-0.5,hsqrt3);
 const double twopi=2.0*M_PI;
 
+// Set Zeta[a] to exp(i*a*arg).
+struct Roots {
+  Complex *Zeta;
+  double arg;
+  Roots(Complex *Zeta, double arg) : Zeta(Zeta), arg(arg) {}
+  void operator()(unsigned int a, unsigned int) const {
+    double theta=a*arg;
+    Zeta[a]=Complex(cos(theta),sin(theta));
+  }
+};
+
 // Build zeta table, returning the floor of the square root of m.
 unsigned int BuildZeta(double arg, unsigned int m,
                        Complex *&ZetaH, Complex *&ZetaL, unsigned int threads)
@@ -28,22 +39,9 @@ unsigned int BuildZeta(double arg, unsigned int m,
   unsigned int t=m/s;
   if(s*t < m) ++t;
   ZetaH=ComplexAlign(t);
-  
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-  for(unsigned int a=0; a < t; ++a) {
-    double theta=s*a*arg;
-    ZetaH[a]=Complex(cos(theta),sin(theta));
-  }
+  parallel(t,Roots(ZetaH,s*arg),threads);
   ZetaL=ComplexAlign(s);
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-  for(unsigned int b=0; b < s; ++b) {
-    double theta=b*arg;
-    ZetaL[b]=Complex(cos(theta),sin(theta));
-  }
+  parallel(s,Roots(ZetaL,arg),threads);
   return s;
 }
 
@@ -53,6 +51,13 @@ unsigned int BuildZeta(unsigned int n, unsigned int m,
   return BuildZeta(twopi/n,m,ZetaH,ZetaL,threads);
 }
 
+// Instrumentation estimates of the bytes moved and operations performed by
+// a complex (real) transform of length m.
+inline double cbytes(unsigned int m) {return 2.0*sizeof(Complex)*m;}
+inline double cflops(unsigned int m) {return instrument::fftflops(m,m);}
+inline double rbytes(unsigned int m) {return sizeof(Complex)*m;}
+inline double rflops(unsigned int m) {return instrument::fftflops(0.5*m,m);}
+
 void ImplicitConvolution::convolve(Complex **F, multiplier *pmult,
                                    unsigned int i, unsigned int offset)
 { 
@@ -65,11 +70,12 @@ void ImplicitConvolution::convolve(Complex **F, multiplier *pmult,
   
   // Backwards FFT (even indices):
   for(unsigned int a=0; a < A; ++a) {
-    BackwardsO->fft(P[a],U[a]);
+    FFTWPP_TIME(BACKWARDS,cbytes(m),cflops(m),BackwardsO->fft(P[a],U[a]));
   }
   
-  if(A >= B)
-    (*pmult)(U,m,indexsize,index,0,threads); // multiply even indices
+  if(A >= B) // multiply even indices
+    FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(Complex)*m,3.0*A*m,
+                (*pmult)(U,m,indexsize,index,0,threads));
 
   switch(A) {
     case 1: pretransform<pretransform1>(P); break;
@@ -86,16 +92,18 @@ void ImplicitConvolution::convolve(Complex **F, multiplier *pmult,
       W[a-1]=P[a];
 
     for(unsigned int a=A; a-- > 0;) // Loop from A-1 to 0.
-      BackwardsO->fft(P[a],W[a]);
+      FFTWPP_TIME(BACKWARDS,cbytes(m),cflops(m),BackwardsO->fft(P[a],W[a]));
     
-    (*pmult)(W,m,indexsize,index,1,threads); // multiply odd indices
+    // Multiply odd indices:
+    FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(Complex)*m,3.0*A*m,
+                (*pmult)(W,m,indexsize,index,1,threads));
     
     // Return to original space
     Complex *lastW=W[A-1];
     for(unsigned int b=0; b < B; ++b) {
       Complex *Pb=P[b];
-      ForwardsO->fft(W[b],Pb);
-      ForwardsO->fft(U[b],lastW);
+      FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),ForwardsO->fft(W[b],Pb));
+      FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),ForwardsO->fft(U[b],lastW));
       posttransform(Pb,lastW);
     }
     
@@ -106,46 +114,52 @@ void ImplicitConvolution::convolve(Complex **F, multiplier *pmult,
       W[b-1]=P[b];
 
     for(unsigned int a=A; a-- > 0;) // Loop from A-1 to 0.
-      BackwardsO->fft(P[a],W[a]);
+      FFTWPP_TIME(BACKWARDS,cbytes(m),cflops(m),BackwardsO->fft(P[a],W[a]));
     
-    (*pmult)(W,m,indexsize,index,1,threads); // multiply odd indices
+    // Multiply odd indices:
+    FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(Complex)*m,3.0*A*m,
+                (*pmult)(W,m,indexsize,index,1,threads));
     
     // Return to original space
     for(unsigned int b=0; b < B; ++b)
-      ForwardsO->fft(W[b],P[b]);
+      FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),ForwardsO->fft(W[b],P[b]));
     
-    (*pmult)(U,m,indexsize,index,0,threads); // multiply even indices
+    // Multiply even indices:
+    FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(Complex)*m,3.0*A*m,
+                (*pmult)(U,m,indexsize,index,0,threads));
     
     Complex *f0=P[0];
     Complex *u0=U[0];
-    Forwards->fft(u0);
+    FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),Forwards->fft(u0));
     posttransform(f0,u0);
     for(unsigned int b=1; b < B; ++b) {
       Complex *fb=P[b];
       Complex *ub=U[b];
       Complex *u0=U[0];
-      ForwardsO->fft(ub,u0);
+      FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),ForwardsO->fft(ub,u0));
       posttransform(fb,u0);
     }
     
   } else { // A == B
     // Backwards FFT (odd indices):
     for(unsigned int a=0; a < A; ++a)
-      Backwards->fft(P[a]);
-    (*pmult)(P,m,indexsize,index,1,threads); //multiply odd indices
+      FFTWPP_TIME(BACKWARDS,cbytes(m),cflops(m),Backwards->fft(P[a]));
+    // Multiply odd indices:
+    FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(Complex)*m,3.0*A*m,
+                (*pmult)(P,m,indexsize,index,1,threads));
 
     // Return to original space:
     Complex *f0=P[0];
     Complex *u0=U[0];
-    Forwards->fft(f0);
-    Forwards->fft(u0);
+    FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),Forwards->fft(f0));
+    FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),Forwards->fft(u0));
     posttransform(f0,u0);
     for(unsigned int b=1; b < B; ++b) {
       Complex *fb=P[b];
       Complex *ub=U[b];
       Complex *u0=U[0];
-      Forwards->fft(fb);
-      ForwardsO->fft(ub,u0);
+      FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),Forwards->fft(fb));
+      FFTWPP_TIME(FORWARDS,cbytes(m),cflops(m),ForwardsO->fft(ub,u0));
       posttransform(fb,u0);
     }
   }
@@ -215,48 +229,128 @@ pretransform<pretransform4>(Complex **F, unsigned int k, Vec& Zetak)
   STORE(fk3,ZMULT(Zetak,Fk3));
 }
 
+// multiply block b by root of unity to prepare for inverse FFT for odd modes
+template<class T>
+void ImplicitConvolution::pretransformBlock(Complex **F, unsigned int b)
+{
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,m);
+  Vec Zeta=LOAD(ZetaH+b);
+  Vec X=UNPACKL(Zeta,Zeta);
+  Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+  for(unsigned int k=K; k < stop; ++k) {
+    Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+    pretransform<T>(F,k,Zetak);
+  }
+}
+
+// Loop body that pretransforms block b of the inputs F of convolution C.
+template<class T>
+struct PretransformBlocks {
+  ImplicitConvolution *C;
+  Complex **F;
+  PretransformBlocks(ImplicitConvolution *C, Complex **F) : C(C), F(F) {}
+  void operator()(unsigned int b, unsigned int) const {
+    C->pretransformBlock<T>(F,b);
+  }
+};
+
 // multiply by root of unity to prepare for inverse FFT for odd modes
 template<class T>
 void ImplicitConvolution::pretransform(Complex **F)
-{  
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        pretransform<T>(F,k,Zetak);
-      }
-    }
-    );
+{
+  FFTWPP_PHASE(PRETRANSFORM,2.0*A*sizeof(Complex)*m,6.0*A*m);  
+  parallel((m+s-1)/s,PretransformBlocks<T>(this,F),threads);
 }
 
-// multiply by root of unity to prepare and add for inverse FFT for odd modes
-void ImplicitConvolution::posttransform(Complex *f, Complex *u)
+// multiply block b by root of unity to prepare and add for inverse FFT for
+// odd modes
+void ImplicitConvolution::posttransformBlock(Complex *f, Complex *u,
+                                             unsigned int b)
 {
   double ninv=0.5/m;
   Vec Ninv=LOAD(ninv);
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      unsigned int stop=min(K+s,m);
-      Complex *ZetaL0=ZetaL-K;
-      Vec Zeta=Ninv*LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        Complex *fki=f+k;
-        STORE(fki,ZMULTC(Zetak,LOAD(fki))+Ninv*LOAD(u+k));
-      }
-    }
-    );
+  unsigned int K=b*s;
+  unsigned int stop=min(K+s,m);
+  Complex *ZetaL0=ZetaL-K;
+  Vec Zeta=Ninv*LOAD(ZetaH+b);
+  Vec X=UNPACKL(Zeta,Zeta);
+  Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+  for(unsigned int k=K; k < stop; ++k) {
+    Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+    Complex *fki=f+k;
+    STORE(fki,ZMULTC(Zetak,LOAD(fki))+Ninv*LOAD(u+k));
+  }
+}
+
+// multiply by root of unity to prepare and add for inverse FFT for odd modes
+void ImplicitConvolution::posttransform(Complex *f, Complex *u)
+{
+  FFTWPP_PHASE(POSTTRANSFORM,3.0*sizeof(Complex)*m,8.0*m);
+  parallel((m+s-1)/s,
+           PadBlocks<ImplicitConvolution>(this,
+                                          &ImplicitConvolution::
+                                          posttransformBlock,f,u),threads);
+}
+
+// Pretransform block b (of size s) of the modes k in [1,d] and c+1-k.
+void ImplicitHConvolution::pretransformBlock(Complex *F, Complex *U,
+                                             unsigned int b)
+{
+  Vec Mhalf=LOAD(-0.5);
+  Vec HSqrt3=LOAD(hsqrt3);
+  
+  unsigned int c1=c+1;
+  unsigned int d=c1/2;
+  unsigned int a=c1/s;
+  Vec Zeta=LOAD(ZetaH+a);
+  Vec X=UNPACKL(Zeta,Zeta);
+  Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+  Vec Zetac1=ZMULT(X,Y,LOAD(ZetaL+c1-s*a));
+  
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,d+1);
+  Zeta=LOAD(ZetaH+b);
+  X=UNPACKL(Zeta,Zeta);
+  Y=UNPACKH(CONJ(Zeta),Zeta);
+  Complex *fm=F+m;
+  Complex *fpc1=F+c1;
+  Complex *fmc1=fm-c1;
+  Complex *upc1=U+c1;
+  for(unsigned int k=max(1,K); k < stop; ++k) {
+    Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+    Vec Zetak=ZMULTC(zetak,Zetac1);
+      
+    Vec Fa=LOAD(F+k);
+    Vec FA=LOAD(fpc1-k);
+    Vec FB=LOAD(fmc1+k);
+    Vec Fb=LOAD(fm-k);
+      
+    Vec b=Fb*Mhalf+CONJ(Fa);
+    STORE(F+k,Fa+CONJ(Fb));
+    Fb *= HSqrt3;
+    Vec a=ZMULTC(zetak,UNPACKL(b,Fb));
+    b=ZMULTIC(zetak,UNPACKH(b,Fb));
+    
+    STORE(fmc1+k,CONJ(a+b));
+    STORE(U+k,a-b);
+    
+    b=FB*Mhalf+CONJ(FA);
+    STORE(fpc1-k,FA+CONJ(FB));
+    FB *= HSqrt3;
+    a=ZMULTC(Zetak,UNPACKL(b,FB));
+    b=ZMULTIC(Zetak,UNPACKH(b,FB));
+
+    STORE(upc1-k,a-b);
+    STORE(fm-k,CONJ(a+b));
+  }
 }
 
 void ImplicitHConvolution::pretransform(Complex *F, Complex *f1c, Complex *U)
 {
+  FFTWPP_PHASE(PRETRANSFORM,(2.0*m+c)*sizeof(Complex),12.0*c);
   Vec Mhalf=LOAD(-0.5);
   Vec HSqrt3=LOAD(hsqrt3);
   
@@ -285,6 +379,28 @@ void ImplicitHConvolution::pretransform(Complex *F, Complex *f1c, Complex *U)
     Im=re+sqrt3*F[c].im;
   }
   
+  parallel((c+1)/2/s+1,
+           PadBlocks<ImplicitHConvolution>(this,
+                                           &ImplicitHConvolution::
+                                           pretransformBlock,F,U),threads);
+    
+  if(even) {
+    F[c]=Re;
+    U[c]=Im;
+  }
+}
+
+// Posttransform block b (of size s) of the modes k in [even+1,c-d] and
+// c+1-k, where d=(c+1)/2.
+void ImplicitHConvolution::posttransformBlock(Complex *F, Complex *U,
+                                              unsigned int b)
+{
+  double ninv=1.0/(3.0*m);
+  Vec Ninv=LOAD(ninv);
+
+  Vec Mhalf=LOAD(-0.5);
+  Vec HSqrt3=LOAD(hsqrt3);
+
   unsigned int c1=c+1;
   unsigned int d=c1/2;
   unsigned int a=c1/s;
@@ -292,56 +408,44 @@ void ImplicitHConvolution::pretransform(Complex *F, Complex *f1c, Complex *U)
   Vec X=UNPACKL(Zeta,Zeta);
   Vec Y=UNPACKH(CONJ(Zeta),Zeta);
   Vec Zetac1=ZMULT(X,Y,LOAD(ZetaL+c1-s*a));
-  PARALLEL(
-    for(unsigned int K=0; K <= d; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,d+1);
-      Vec Zeta=LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      Complex *fm=F+m;
-      Complex *fpc1=F+c1;
-      Complex *fmc1=fm-c1;
-      Complex *upc1=U+c1;
-      for(unsigned int k=max(1,K); k < stop; ++k) {
-        Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        Vec Zetak=ZMULTC(zetak,Zetac1);
-          
-        Vec Fa=LOAD(F+k);
-        Vec FA=LOAD(fpc1-k);
-        Vec FB=LOAD(fmc1+k);
-        Vec Fb=LOAD(fm-k);
-          
-        Vec b=Fb*Mhalf+CONJ(Fa);
-        STORE(F+k,Fa+CONJ(Fb));
-        Fb *= HSqrt3;
-        Vec a=ZMULTC(zetak,UNPACKL(b,Fb));
-        b=ZMULTIC(zetak,UNPACKH(b,Fb));
+
+  unsigned int D=c-d;
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,D+1);
+  Zeta=Ninv*LOAD(ZetaH+b);
+  X=UNPACKL(Zeta,Zeta);
+  Y=UNPACKH(CONJ(Zeta),Zeta);
+  Complex *fm=F+m;
+  Complex *fpc1=F+c1;
+  Complex *fmc1=fm-c1;
+  Complex *upc1=U+c1;
+  for(unsigned int k=max(even+1,K); k < stop; ++k) {
+    Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+    Vec Zetak=ZMULTC(zetak,Zetac1);
+      
+    Vec F0=LOAD(F+k)*Ninv;
+    Vec F1=ZMULTC(zetak,LOAD(fmc1+k));
+    Vec F2=ZMULT(zetak,LOAD(U+k));
+    Vec S=F1+F2;
+    F2=CONJ(F0+Mhalf*S)-HSqrt3*FLIP(F1-F2);
         
-        STORE(fmc1+k,CONJ(a+b));
-        STORE(U+k,a-b);
+    Vec FA=LOAD(fpc1-k)*Ninv;
+    Vec FB=ZMULTC(Zetak,LOAD(fm-k));
+    Vec FC=ZMULT(Zetak,LOAD(upc1-k));
+    Vec T=FB+FC;
         
-        b=FB*Mhalf+CONJ(FA);
-        STORE(fpc1-k,FA+CONJ(FB));
-        FB *= HSqrt3;
-        a=ZMULTC(Zetak,UNPACKL(b,FB));
-        b=ZMULTIC(Zetak,UNPACKH(b,FB));
-
-        STORE(upc1-k,a-b);
-        STORE(fm-k,CONJ(a+b));
-      }
-    }
-    );
-    
-  if(even) {
-    F[c]=Re;
-    U[c]=Im;
+    STORE(F+k,F0+S);
+    STORE(fpc1-k,FA+T);
+    STORE(fmc1+k,CONJ(FA+Mhalf*T)-HSqrt3*FLIP(FB-FC));
+    STORE(fm-k,F2);
   }
 }
 
 void ImplicitHConvolution::posttransform(Complex *F, const Complex& w,
                                          Complex *U)
 {
+  FFTWPP_PHASE(POSTTRANSFORM,(2.0*m+c)*sizeof(Complex),16.0*c);
   double ninv=1.0/(3.0*m);
   Vec Ninv=LOAD(ninv);
 
@@ -379,39 +483,10 @@ void ImplicitHConvolution::posttransform(Complex *F, const Complex& w,
   }
   
   unsigned int D=c-d;
-  PARALLEL(
-    for(unsigned int K=0; K <= D; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,D+1);
-      Vec Zeta=Ninv*LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      Complex *fm=F+m;
-      Complex *fpc1=F+c1;
-      Complex *fmc1=fm-c1;
-      Complex *upc1=U+c1;
-      for(unsigned int k=max(even+1,K); k < stop; ++k) {
-        Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        Vec Zetak=ZMULTC(zetak,Zetac1);
-          
-        Vec F0=LOAD(F+k)*Ninv;
-        Vec F1=ZMULTC(zetak,LOAD(fmc1+k));
-        Vec F2=ZMULT(zetak,LOAD(U+k));
-        Vec S=F1+F2;
-        F2=CONJ(F0+Mhalf*S)-HSqrt3*FLIP(F1-F2);
-            
-        Vec FA=LOAD(fpc1-k)*Ninv;
-        Vec FB=ZMULTC(Zetak,LOAD(fm-k));
-        Vec FC=ZMULT(Zetak,LOAD(upc1-k));
-        Vec T=FB+FC;
-            
-        STORE(F+k,F0+S);
-        STORE(fpc1-k,FA+T);
-        STORE(fmc1+k,CONJ(FA+Mhalf*T)-HSqrt3*FLIP(FB-FC));
-        STORE(fm-k,F2);
-      }  
-    }
-    );
+  parallel(D/s+1,
+           PadBlocks<ImplicitHConvolution>(this,
+                                           &ImplicitHConvolution::
+                                           posttransformBlock,F,U),threads);
 
   
   if(d == D+1) {
@@ -484,15 +559,16 @@ void ImplicitHConvolution::convolve(Complex **F, realmultiplier *pmult,
   if(A >= B) {
     for(unsigned int a=0; a < A-1; ++a) {
       pretransform(c0[a],w+a,U[A-1]);
-      cro->fft(U[A-1],U[a]);
+      FFTWPP_TIME(BACKWARDS,rbytes(m),rflops(m),cro->fft(U[A-1],U[a]));
     }
     pretransform(c0[A-1],w+A-1,U[A-1]);
-    cr->fft(U[A-1]);
-    (*pmult)((double **) U,m,indexsize,index,-1,threads);
+    FFTWPP_TIME(BACKWARDS,rbytes(m),rflops(m),cr->fft(U[A-1]));
+    FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(double)*m,0.5*A*m,
+                (*pmult)((double **) U,m,indexsize,index,-1,threads));
   } else {
     for(unsigned int a=A; a-- > 0;) {// Loop from A-1 to 0.
       pretransform(c0[a],w+a,U[a]);
-      cro->fft(U[a],d2[a]);
+      FFTWPP_TIME(BACKWARDS,rbytes(m),rflops(m),cro->fft(U[a],d2[a]));
     }
   }
 
@@ -503,13 +579,14 @@ void ImplicitHConvolution::convolve(Complex **F, realmultiplier *pmult,
     T[a]=c0a[0].re; // r=0, k=0
     if(!compact)
       c0a[0].re += 2.0*c0a[m].re; // Nyquist
-    crO->fft(c0a,d0[a]);
+    FFTWPP_TIME(BACKWARDS,rbytes(m),rflops(m),crO->fft(c0a,d0[a]));
   }
-  (*pmult)(d0,m,indexsize,index,0,threads);
+  FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(double)*m,0.5*A*m,
+              (*pmult)(d0,m,indexsize,index,0,threads));
     
   for(unsigned int b=0; b < B; ++b) {
     Complex *c0b=c0[b];
-    rcO->fft(d0[b],c0b);
+    FFTWPP_TIME(FORWARDS,rbytes(m),rflops(m),rcO->fft(d0[b],c0b));
     if(!compact) c0b[m]=0.0; // Zero Nyquist mode, for Hermitian symmetry.
     Complex z=c0[b][start];  // r=0, k=start
     Re[b]=z.re;
@@ -529,13 +606,14 @@ void ImplicitHConvolution::convolve(Complex **F, realmultiplier *pmult,
   for(unsigned int a=A; a-- > 0;) { // Loop from A-1 to 0.
     Complex *c1a=c1[a];
     c1a[0]=compact ? T[a] : T[a]-c1a[c+1].re; // r=1, k=0 with Nyquist
-    crO->fft(c1[a],d1[a]);
+    FFTWPP_TIME(BACKWARDS,rbytes(m),rflops(m),crO->fft(c1[a],d1[a]));
   }
-  (*pmult)(d1,m,indexsize,index,1,threads);
+  FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(double)*m,0.5*A*m,
+              (*pmult)(d1,m,indexsize,index,1,threads));
 
   for(unsigned int b=0; b < B; ++b) {
     Complex *c1b=c1[b];
-    rcO->fft(d1[b],c1b); // r=1
+    FFTWPP_TIME(FORWARDS,rbytes(m),rflops(m),rcO->fft(d1[b],c1b)); // r=1
     if(even) {
       double tmp=w[b].re;
       w[b]=c1b[1]; // r=1, k=1
@@ -548,7 +626,7 @@ void ImplicitHConvolution::convolve(Complex **F, realmultiplier *pmult,
   // r=-1 (forwards):
   if(A > B) {
     for(unsigned int b=0; b < B; ++b) {
-      rco->fft(d2[b],U[A-1]);
+      FFTWPP_TIME(FORWARDS,rbytes(m),rflops(m),rco->fft(d2[b],U[A-1]));
       double R=c1[b][0].re;
       c0[b][start]=Complex(Re[b],Im[b]); // r=0, k=c-1 (c) for m=even (odd)
       c0[b][0]=(c0[b][0].re+R+U[A-1][0].re)*ninv;
@@ -556,16 +634,17 @@ void ImplicitHConvolution::convolve(Complex **F, realmultiplier *pmult,
     }
   } else {
     if(A < B)
-      (*pmult)(d2,m,indexsize,index,-1,threads);
+      FFTWPP_TIME(MULTIPLY,(A+B)*sizeof(double)*m,0.5*A*m,
+                  (*pmult)(d2,m,indexsize,index,-1,threads));
 
-    rc->fft(c2[0]);
+    FFTWPP_TIME(FORWARDS,rbytes(m),rflops(m),rc->fft(c2[0]));
     double R=c1[0][0].re;
     c0[0][start]=Complex(Re[0],Im[0]); // r=0, k=c-1 (c) for m=even (odd)
     c0[0][0]=(c0[0][0].re+R+c2[0][0].re)*ninv;
     posttransform(c0[0],w[0],c2[0]);
 
     for(unsigned int b=1; b < B; ++b) {
-      rco->fft(d2[b],c2[0]);
+      FFTWPP_TIME(FORWARDS,rbytes(m),rflops(m),rco->fft(d2[b],c2[0]));
       double R=c1[b][0].re;
       c0[b][start]=Complex(Re[b],Im[b]); // r=0, k=c-1 (c) for m=even (odd)
       c0[b][0]=(c0[b][0].re+R+c2[0][0].re)*ninv;
@@ -574,59 +653,151 @@ void ImplicitHConvolution::convolve(Complex **F, realmultiplier *pmult,
   }
 }
 
-void fftpad::expand(Complex *f, Complex *u)
+// Loop bodies for the Chebyshev convolution: fold the coefficients k=i+1
+// and 2p-k of f into f[k] and W[k], or unfold them after the multiplication.
+struct ChebyshevFold {
+  double *f;
+  Complex *W,*ZetaH,*ZetaL;
+  unsigned int s,m,twop;
+  ChebyshevFold(double *f, Complex *W, Complex *ZetaH, Complex *ZetaL,
+                unsigned int s, unsigned int m, unsigned int twop) :
+    f(f), W(W), ZetaH(ZetaH), ZetaL(ZetaL), s(s), m(m), twop(twop) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int k=i+1;
+    unsigned int K=twop-k;
+    double fk=f[k];
+    double fK=K < m ? f[K] : 0.0;
+    Complex Zetak=ZetaH[k/s]*ZetaL[k % s];
+    Complex ZetaK=ZetaH[K/s]*ZetaL[K % s];
+    W[k]=0.5*(fk*Zetak+fK*conj(ZetaK));
+    f[k]=0.5*(fk-fK);
+  }
+};
+
+struct ChebyshevUnfold {
+  double *f;
+  Complex *W,*ZetaH,*ZetaL;
+  unsigned int s,m,twop;
+  double ninv;
+  ChebyshevUnfold(double *f, Complex *W, Complex *ZetaH, Complex *ZetaL,
+                  unsigned int s, unsigned int m, unsigned int twop,
+                  double ninv) :
+    f(f), W(W), ZetaH(ZetaH), ZetaL(ZetaL), s(s), m(m), twop(twop),
+    ninv(ninv) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int k=i+1;
+    unsigned int K=twop-k;
+    double D=f[k];
+    Complex Wk=W[k];
+    Complex Zetak=ZetaH[k/s]*ZetaL[k % s];
+    f[k]=ninv*(D+2.0*(Zetak.re*Wk.re+Zetak.im*Wk.im));
+    if(K < m) {
+      Complex ZetaK=ZetaH[K/s]*ZetaL[K % s];
+      f[K]=ninv*(2.0*(ZetaK.re*Wk.re-ZetaK.im*Wk.im)-D);
+    }
+  }
+};
+
+// The Gauss-Chebyshev node theta_j=pi(j+1/2)/n, with n=3p and j=3l+r, is
+// pi(l+1/2)/p for r=1, and pi(l+1/6)/p or pi-pi(l'+1/6)/p, with l'=p-1-l,
+// for r=0 or 2, respectively. Folding k onto 2p-k, the series
+// sum_k f[k]cos(k theta_j) then reduces for r=1 to a DCT-III of length p of
+// f[k]-f[2p-k], and for r=0 and 2 to the real part of a complex Fourier
+// series of length 2p in l (or p+l') with coefficients f[k]zeta^k, where
+// zeta=exp(i pi/(6p)). Coefficients with k >= m are implicitly zero.
+void ChebyshevConvolution::convolve(double **F, realmultiplier *pmult)
 {
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec H=LOAD(ZetaH+K/s);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
-        Vec X=UNPACKL(Zetak,Zetak);
-        Vec Y=UNPACKH(CONJ(Zetak),Zetak);
-        unsigned int kstride=k*stride;
-        Complex *fk=f+kstride;
-        Complex *uk=u+kstride;
-        for(unsigned int i=0; i < M; ++i)
-          STORE(uk+i,ZMULT(X,Y,LOAD(fk+i)));
-      }
+  unsigned int twop=2*p;
+  
+  for(unsigned int a=0; a < A; ++a) {
+    double *f=F[a];
+    Complex *W=(Complex *) U[a];
+    W[0]=f[0];
+    W[p]=p < m ? f[p]*(ZetaH[p/s]*ZetaL[p % s]).re : 0.0;
+    parallel(p-1,ChebyshevFold(f,W,ZetaH,ZetaL,s,m,twop),threads);
+    Backwards->fft(f);
+    cr->fft(W);
+  }
+
+  (*pmult)(F,p,0,NULL,0,threads);
+  (*pmult)(U,twop,0,NULL,0,threads);
+
+  double ninv=1.0/(3*p);
+  for(unsigned int b=0; b < B; ++b) {
+    double *f=F[b];
+    Complex *W=(Complex *) U[b];
+    Forwards->fft(f);
+    rc->fft(W);
+    f[0]=ninv*(0.5*f[0]+W[0].re);
+    if(p < m) {
+      Complex Zetap=ZetaH[p/s]*ZetaL[p % s];
+      f[p]=2.0*ninv*Zetap.re*W[p].re;
     }
-    );
+    parallel(p-1,ChebyshevUnfold(f,W,ZetaH,ZetaL,s,m,twop,ninv),threads);
+  }
+}
+
+void fftpad::expandBlock(Complex *f, Complex *u, unsigned int b)
+{
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,m);
+  Vec H=LOAD(ZetaH+b);
+  for(unsigned int k=K; k < stop; ++k) {
+    Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
+    Vec X=UNPACKL(Zetak,Zetak);
+    Vec Y=UNPACKH(CONJ(Zetak),Zetak);
+    unsigned int kstride=k*stride;
+    Complex *fk=f+kstride;
+    Complex *uk=u+kstride;
+    for(unsigned int i=0; i < M; ++i)
+      STORE(uk+i,ZMULT(X,Y,LOAD(fk+i)));
+  }
+}
+
+void fftpad::expand(Complex *f, Complex *u)
+{
+  parallel((m+s-1)/s,PadBlocks<fftpad>(this,&fftpad::expandBlock,f,u),
+           threads);
 }
   
 void fftpad::backwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADBACKWARDS,3.0*cbytes(m)*M,2.0*M*cflops(m)+6.0*m*M);
   expand(f,u);
   Backwards->fft(f);
   Backwards->fft(u);
 }
 
-void fftpad::reduce(Complex *f, Complex *u)
+void fftpad::reduceBlock(Complex *f, Complex *u, unsigned int b)
 {
   double ninv=0.5/m;
   Vec Ninv=LOAD(ninv);
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec H=Ninv*LOAD(ZetaH+K/s);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
-        Vec X=UNPACKL(Zetak,Zetak);
-        Vec Y=UNPACKH(Zetak,CONJ(Zetak));
-        unsigned int kstride=k*stride;
-        Complex *uk=u+kstride;
-        Complex *fk=f+kstride;
-        for(unsigned int i=0; i < M; ++i)
-          STORE(fk+i,LOAD(fk+i)*Ninv+ZMULT(X,Y,LOAD(uk+i)));
-      }
-    }
-    );
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,m);
+  Vec H=Ninv*LOAD(ZetaH+b);
+  for(unsigned int k=K; k < stop; ++k) {
+    Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
+    Vec X=UNPACKL(Zetak,Zetak);
+    Vec Y=UNPACKH(Zetak,CONJ(Zetak));
+    unsigned int kstride=k*stride;
+    Complex *uk=u+kstride;
+    Complex *fk=f+kstride;
+    for(unsigned int i=0; i < M; ++i)
+      STORE(fk+i,LOAD(fk+i)*Ninv+ZMULT(X,Y,LOAD(uk+i)));
+  }
+}
+
+void fftpad::reduce(Complex *f, Complex *u)
+{
+  parallel((m+s-1)/s,PadBlocks<fftpad>(this,&fftpad::reduceBlock,f,u),
+           threads);
 }
 
 void fftpad::forwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADFORWARDS,3.0*cbytes(m)*M,2.0*M*cflops(m)+8.0*m*M);
   Forwards->fft(f);
   Forwards->fft(u);
   reduce(f,u);
@@ -683,6 +854,7 @@ void fft0pad::Backwards1(Complex *f, Complex *u)
 
 void fft0pad::backwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADBACKWARDS,4.5*cbytes(m)*M,3.0*M*cflops(m)+16.0*m*M);
   expand(f,u);
   Backwards->fft(f);
   Backwards1(f,u);
@@ -748,6 +920,7 @@ void fft0pad::Forwards1(Complex *f, Complex *u)
   
 void fft0pad::forwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADFORWARDS,4.5*cbytes(m)*M,3.0*M*cflops(m)+24.0*m*M);
   Forwards0(f);  
   Forwards1(f,u);  
   Forwards->fft(f);
@@ -764,37 +937,40 @@ void fft1pad::expand(Complex *f, Complex *u)
     u[i]=fmstride[i] -= Nyquist;
   }
     
+  parallel((m+s-1)/s,PadBlocks<fft1pad>(this,&fft1pad::expandBlock,f,u),
+           threads);
+}
+
+void fft1pad::expandBlock(Complex *f, Complex *u, unsigned int b)
+{
+  Complex *fmstride=f+m*stride;
   Vec Mhalf=LOAD(-0.5);
   Vec Mhsqrt3=LOAD(-hsqrt3);
-  unsigned int inc=s;
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += inc) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=max(1,K); k < stop; ++k) {
-        Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        unsigned int kstride=k*stride;
-        Complex *uk=u+kstride;
-        Complex *fk=f+kstride;
-        Complex *fmk=fmstride+kstride;
-        for(unsigned int i=0; i < M; ++i) {
-          Vec Fa=LOAD(fk+i);
-          Vec Fb=LOAD(fmk+i);
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,m);
+  Vec Zeta=LOAD(ZetaH+b);
+  Vec X=UNPACKL(Zeta,Zeta);
+  Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+  for(unsigned int k=max(1,K); k < stop; ++k) {
+    Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+    unsigned int kstride=k*stride;
+    Complex *uk=u+kstride;
+    Complex *fk=f+kstride;
+    Complex *fmk=fmstride+kstride;
+    for(unsigned int i=0; i < M; ++i) {
+      Vec Fa=LOAD(fk+i);
+      Vec Fb=LOAD(fmk+i);
         
-          Vec B=Fa*Mhalf+Fb;
-          STORE(fk+i,Fa+Fb);
-          Fa *= Mhsqrt3;
-          Vec A=ZMULT(zetak,UNPACKL(B,Fa));
-          B=ZMULTI(zetak,UNPACKH(B,Fa));
-          STORE(fmk+i,A+B);
-          STORE(uk+i,CONJ(A-B));
-        }
-      }
+      Vec B=Fa*Mhalf+Fb;
+      STORE(fk+i,Fa+Fb);
+      Fa *= Mhsqrt3;
+      Vec A=ZMULT(zetak,UNPACKL(B,Fa));
+      B=ZMULTI(zetak,UNPACKH(B,Fa));
+      STORE(fmk+i,A+B);
+      STORE(uk+i,CONJ(A-B));
     }
-    );
+  }
 }
 
 void fft1pad::Backwards1(Complex *f, Complex *u)
@@ -814,35 +990,39 @@ void fft1pad::reduce(Complex *f, Complex *u)
     f[i]=0.0; // Zero Nyquist mode, for Hermitian symmetry.
     fmstride[i]=(f0+f1+f2)*ninv;
   }
+  parallel((m+s-1)/s,PadBlocks<fft1pad>(this,&fft1pad::reduceBlock,f,u),
+           threads);
+}
+
+void fft1pad::reduceBlock(Complex *f, Complex *u, unsigned int b)
+{
+  Complex *fmstride=f+m*stride;
+  double ninv=1.0/(3.0*m);
   Vec Ninv=LOAD(ninv);
   Vec Mhalf=LOAD(-0.5);
   Vec HSqrt3=LOAD(hsqrt3);
   
-  unsigned int inc=s;
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += inc) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=Ninv*LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=max(1,K); k < stop; ++k) {
-        Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        unsigned int kstride=k*stride;
-        Complex *fk=f+kstride;
-        Complex *fmk=fmstride+kstride;
-        Complex *uk=u+kstride;
-        for(unsigned int i=0; i < M; ++i) {
-          Vec F0=LOAD(fk+i)*Ninv;
-          Vec F1=ZMULTC(zetak,LOAD(fmk+i));
-          Vec F2=ZMULT(zetak,LOAD(uk+i));
-          Vec S=F1+F2;
-          STORE(fk+i,F0+Mhalf*S+HSqrt3*ZMULTI(F1-F2));
-          STORE(fmk+i,F0+S);
-        }
-      }
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,m);
+  Vec Zeta=Ninv*LOAD(ZetaH+b);
+  Vec X=UNPACKL(Zeta,Zeta);
+  Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+  for(unsigned int k=max(1,K); k < stop; ++k) {
+    Vec zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+    unsigned int kstride=k*stride;
+    Complex *fk=f+kstride;
+    Complex *fmk=fmstride+kstride;
+    Complex *uk=u+kstride;
+    for(unsigned int i=0; i < M; ++i) {
+      Vec F0=LOAD(fk+i)*Ninv;
+      Vec F1=ZMULTC(zetak,LOAD(fmk+i));
+      Vec F2=ZMULT(zetak,LOAD(uk+i));
+      Vec S=F1+F2;
+      STORE(fk+i,F0+Mhalf*S+HSqrt3*ZMULTI(F1-F2));
+      STORE(fmk+i,F0+S);
     }
-    );
+  }
 }
 
 void fft1pad::Forwards0(Complex *f)
@@ -856,31 +1036,27 @@ void fft1pad::Forwards1(Complex *f, Complex *u)
 
 void fft1pad::forwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADFORWARDS,4.5*cbytes(m)*M,3.0*M*cflops(m)+24.0*m*M);
   Forwards->fft(f);
   Forwards->fft(f+m*stride);
   Forwards->fft(u);
   reduce(f,u);
 }
 
-// a[0][k]=sum_i a[i][k]*b[i][k]*c[i][k]
-void ImplicitHTConvolution::mult(double *a, double *b, double **C,
-                                 unsigned int offset)
+// a[0][k]=sum_i a[i][k]*b[i][k]*c[i][k] for k < n
+void ImplicitHTConvolution::multBlock(double *a, double *b, double **C,
+                                      unsigned int offset, unsigned int n)
 {
-  unsigned int twom=2*m;
   if(M == 1) { // a[k]=a[k]*b[k]*c[k]
     double *C0=C[0]+offset;
 #ifdef __SSE2__
-    PARALLEL(
-      for(unsigned int k=0; k < twom; k += 2) {
-        double *ak=a+k;
-        STORE(ak,LOAD(ak)*LOAD(b+k)*LOAD(C0+k));
-      }
-      );
+    for(unsigned int k=0; k < n; k += 2) {
+      double *ak=a+k;
+      STORE(ak,LOAD(ak)*LOAD(b+k)*LOAD(C0+k));
+    }
 #else
-    PARALLEL(
-      for(unsigned int k=0; k < twom; ++k)
-        a[k] *= b[k]*C0[k];
-      );
+    for(unsigned int k=0; k < n; ++k)
+      a[k] *= b[k]*C0[k];
 #endif
   } else if(M == 2) {
     double *a1=a+stride;
@@ -888,18 +1064,14 @@ void ImplicitHTConvolution::mult(double *a, double *b, double **C,
     double *C0=C[0]+offset;
     double *C1=C[1]+offset;
 #ifdef __SSE2__
-    PARALLEL(
-      for(unsigned int k=0; k < twom; k += 2) {
-        double *ak=a+k;
-        STORE(ak,LOAD(ak)*LOAD(b+k)*LOAD(C0+k)+
-              LOAD(a1+k)*LOAD(b1+k)*LOAD(C1+k));
-      }  
-      );
+    for(unsigned int k=0; k < n; k += 2) {
+      double *ak=a+k;
+      STORE(ak,LOAD(ak)*LOAD(b+k)*LOAD(C0+k)+
+            LOAD(a1+k)*LOAD(b1+k)*LOAD(C1+k));
+    }  
 #else
-    PARALLEL(
-      for(unsigned int k=0; k < twom; ++k)
-        a[k]=a[k]*b[k]*C0[k]+a1[k]*b1[k]*C1[k];
-      );
+    for(unsigned int k=0; k < n; ++k)
+      a[k]=a[k]*b[k]*C0[k]+a1[k]*b1[k]*C1[k];
 #endif
   } else if(M == 3) {
     double *a1=a+stride;
@@ -910,55 +1082,122 @@ void ImplicitHTConvolution::mult(double *a, double *b, double **C,
     double *C1=C[1]+offset;
     double *C2=C[2]+offset;
 #ifdef __SSE2__
-    PARALLEL(
-      for(unsigned int k=0; k < twom; k += 2) {
-        double *ak=a+k;
-        STORE(ak,LOAD(ak)*LOAD(b+k)*LOAD(C0+k)+
-              LOAD(a1+k)*LOAD(b1+k)*LOAD(C1+k)+
-              LOAD(a2+k)*LOAD(b2+k)*LOAD(C2+k));
-      }
-      );
+    for(unsigned int k=0; k < n; k += 2) {
+      double *ak=a+k;
+      STORE(ak,LOAD(ak)*LOAD(b+k)*LOAD(C0+k)+
+            LOAD(a1+k)*LOAD(b1+k)*LOAD(C1+k)+
+            LOAD(a2+k)*LOAD(b2+k)*LOAD(C2+k));
+    }
 #else
-    PARALLEL(
-      for(unsigned int k=0; k < twom; ++k)
-        a[k]=a[k]*b[k]*C0[k]+a1[k]*b1[k]*C1[k]+a2[k]*b2[k]*C2[k];
-      );
+    for(unsigned int k=0; k < n; ++k)
+      a[k]=a[k]*b[k]*C0[k]+a1[k]*b1[k]*C1[k]+a2[k]*b2[k]*C2[k];
 #endif
   } else {
     double *A=a-offset;
     double *B=b-offset;
     double *C0=C[0];
-    unsigned int stop=twom+offset;
+    unsigned int stop=n+offset;
 #ifdef __SSE2__
-    PARALLEL(   
-      for(unsigned int k=offset; k < stop; k += 2) {
-        double *p=A+k;
-        double *q=B+k;
-        Vec sum=LOAD(p)*LOAD(q)*LOAD(C0+k);
-        for(unsigned int i=1; i < M; ++i) {
-          unsigned int istride=i*stride;
-          sum += LOAD(p+istride)*LOAD(q+istride)*LOAD(C[i]+k);
-        }
-        STORE(p,sum);
-      }   
-      );
+    for(unsigned int k=offset; k < stop; k += 2) {
+      double *p=A+k;
+      double *q=B+k;
+      Vec sum=LOAD(p)*LOAD(q)*LOAD(C0+k);
+      for(unsigned int i=1; i < M; ++i) {
+        unsigned int istride=i*stride;
+        sum += LOAD(p+istride)*LOAD(q+istride)*LOAD(C[i]+k);
+      }
+      STORE(p,sum);
+    }   
 #else
-    PARALLEL(
-      for(unsigned int k=offset; k < stop; ++k) {
-        double *p=A+k;
-        double *q=B+k;
-        double sum=(*p)*(*q)*C0[k];
-        for(unsigned int i=1; i < M; ++i) {
-          unsigned int istride=i*stride;
-          sum += p[istride]*q[istride]*C[i][k];
-        }
-        *p=sum;
+    for(unsigned int k=offset; k < stop; ++k) {
+      double *p=A+k;
+      double *q=B+k;
+      double sum=(*p)*(*q)*C0[k];
+      for(unsigned int i=1; i < M; ++i) {
+        unsigned int istride=i*stride;
+        sum += p[istride]*q[istride]*C[i][k];
       }
-      );
+      *p=sum;
+    }
 #endif
   }
 }
 
+// Loop body that multiplies block i (of size size) of the 2m elements of
+// the ternary Hermitian convolution C.
+struct HTMultBlocks {
+  ImplicitHTConvolution *C;
+  double *a,*b;
+  double **W;
+  unsigned int offset,n,size;
+  HTMultBlocks(ImplicitHTConvolution *C, double *a, double *b, double **W,
+               unsigned int offset, unsigned int n, unsigned int size) :
+    C(C), a(a), b(b), W(W), offset(offset), n(n), size(size) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int start=i*size;
+    C->multBlock(a+start,b+start,W,offset+start,std::min(size,n-start));
+  }
+};
+
+void ImplicitHTConvolution::mult(double *a, double *b, double **C,
+                                 unsigned int offset)
+{
+  unsigned int size=evenBlockSize(twom,threads);
+  parallel((twom+size-1)/size,HTMultBlocks(this,a,b,C,offset,twom,size),
+           threads);
+}
+
+// Loop bodies for the ternary Hermitian convolutions: multiply block b (of
+// size s) of the n inputs f by the twiddle factors into u, or multiply
+// block b of u by the conjugate twiddle factors and add it to f, both
+// scaled by ninv.
+struct HTPretransform {
+  Complex **f,**u;
+  unsigned int n;
+  Complex *ZetaH,*ZetaL;
+  unsigned int m,s;
+  HTPretransform(Complex **f, Complex **u, unsigned int n, Complex *ZetaH,
+                 Complex *ZetaL, unsigned int m, unsigned int s) :
+    f(f), u(u), n(n), ZetaH(ZetaH), ZetaL(ZetaL), m(m), s(s) {}
+  void operator()(unsigned int b, unsigned int) const {
+    unsigned int K=b*s;
+    Complex *ZetaL0=ZetaL-K;
+    unsigned int stop=min(K+s,m);
+    Vec Zeta=LOAD(ZetaH+b);
+    Vec X=UNPACKL(Zeta,Zeta);
+    Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+    for(unsigned int k=K; k < stop; ++k) {
+      Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+      for(unsigned int i=0; i < n; ++i)
+        STORE(u[i]+k,ZMULT(Zetak,LOAD(f[i]+k)));
+    }
+  }
+};
+
+struct HTPosttransform {
+  Complex *f,*u;
+  Complex *ZetaH,*ZetaL;
+  unsigned int m,s;
+  double ninv;
+  HTPosttransform(Complex *f, Complex *u, Complex *ZetaH, Complex *ZetaL,
+                  unsigned int m, unsigned int s, double ninv) :
+    f(f), u(u), ZetaH(ZetaH), ZetaL(ZetaL), m(m), s(s), ninv(ninv) {}
+  void operator()(unsigned int b, unsigned int) const {
+    Vec Ninv=LOAD(ninv);
+    unsigned int K=b*s;
+    Complex *ZetaL0=ZetaL-K;
+    unsigned int stop=min(K+s,m);
+    Vec Zeta=Ninv*LOAD(ZetaH+b);
+    Vec X=UNPACKL(Zeta,Zeta);
+    Vec Y=UNPACKH(CONJ(Zeta),Zeta);
+    for(unsigned int k=K; k < stop; ++k) {
+      Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
+      Complex *fk=f+k;
+      STORE(fk,ZMULTC(Zetak,LOAD(u+k))+Ninv*LOAD(fk));
+    }
+  }
+};
+
 void ImplicitHTConvolution::convolve(Complex **F, Complex **G, Complex **H,
                                      Complex *u, Complex *v, Complex **W,
                                      unsigned int offset)
@@ -980,42 +1219,35 @@ void ImplicitHTConvolution::convolve(Complex **F, Complex **G, Complex **H,
       vi += m1;
       wi += m1;
     }
-    PARALLEL(
-      for(unsigned int K=0; K < m; K += s) {
-        Complex *ZetaL0=ZetaL-K;
-        unsigned int stop=min(K+s,m);
-        Vec Zeta=LOAD(ZetaH+K/s);
-        Vec X=UNPACKL(Zeta,Zeta);
-        Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-        for(unsigned int k=K; k < stop; ++k) {
-          Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-          Vec Fk=LOAD(fi+k);
-          Vec Gk=LOAD(gi+k);
-          Vec Hk=LOAD(hi+k);
-          STORE(ui+k,ZMULT(Zetak,Fk));
-          STORE(vi+k,ZMULT(Zetak,Gk));
-          STORE(wi+k,ZMULT(Zetak,Hk));
-        }
-      }  
-      );
+    {
+      FFTWPP_PHASE(PRETRANSFORM,6.0*sizeof(Complex)*m,18.0*m);
+      Complex *f[]={fi,gi,hi};
+      Complex *u[]={ui,vi,wi};
+      parallel((m+s-1)/s,HTPretransform(f,u,3,ZetaH,ZetaL,m,s),threads);
+    }
       
     ui[m]=0.0;
     vi[m]=0.0;
     wi[m]=0.0;
     
     if(i+1 < M) {
-      cro->fft(ui,(double *) (ui-m1));
-      cro->fft(vi,(double *) (vi-m1));
-      cro->fft(wi,(double *) (wi-m1));
+      FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),
+                  cro->fft(ui,(double *) (ui-m1)));
+      FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),
+                  cro->fft(vi,(double *) (vi-m1)));
+      FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),
+                  cro->fft(wi,(double *) (wi-m1)));
     } else {
-      cr->fft(ui);
-      cr->fft(vi);
-      cr->fft(wi);
+      FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),cr->fft(ui));
+      FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),cr->fft(vi));
+      FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),cr->fft(wi));
     }
   }   
     
-  mult((double *) v,(double *) u,(double **) W);
-  rco->fft((double *) v,u); // v and w are now free
+  FFTWPP_TIME(MULTIPLY,(3.0*M+1.0)*sizeof(double)*twom,3.0*M*twom,
+              mult((double *) v,(double *) u,(double **) W));
+  // v and w are now free
+  FFTWPP_TIME(FORWARDS,rbytes(twom),rflops(twom),rco->fft((double *) v,u));
 
   for(unsigned int i=0; i < M; ++i) {
     Complex *fi=F[i]+offset;
@@ -1023,75 +1255,67 @@ void ImplicitHTConvolution::convolve(Complex **F, Complex **G, Complex **H,
     Complex *hi=H[i]+offset;
     unsigned int im1=i*m1;
     fi[m]=0.0;
-    cro->fft(fi,(double *) (v+im1));
+    FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),
+                cro->fft(fi,(double *) (v+im1)));
     gi[m]=0.0;
-    cro->fft(gi,(double *) (w+im1));
+    FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),
+                cro->fft(gi,(double *) (w+im1)));
     hi[m]=0.0;
-    cro->fft(hi,(double *) gi);
+    FFTWPP_TIME(BACKWARDS,rbytes(twom),rflops(twom),
+                cro->fft(hi,(double *) gi));
   }
   
-  mult((double *) v,(double *) w,(double **) G,2*offset);
+  FFTWPP_TIME(MULTIPLY,(3.0*M+1.0)*sizeof(double)*twom,3.0*M*twom,
+              mult((double *) v,(double *) w,(double **) G,2*offset));
   Complex *f=F[0]+offset;
-  rco->fft((double *) v,f);
+  FFTWPP_TIME(FORWARDS,rbytes(twom),rflops(twom),rco->fft((double *) v,f));
     
+  FFTWPP_PHASE(POSTTRANSFORM,3.0*sizeof(Complex)*m,8.0*m);
   double ninv=0.25/m;
-  Vec Ninv=LOAD(ninv);
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=Ninv*LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        Complex *fk=f+k;
-        STORE(fk,ZMULTC(Zetak,LOAD(u+k))+Ninv*LOAD(fk));
-      }
-    }
-    );
+  parallel((m+s-1)/s,HTPosttransform(f,u,ZetaH,ZetaL,m,s,ninv),threads);
 }
 
-// a[k]=a[k]*b[k]*b[k]
-void ImplicitHFGGConvolution::mult(double *a, double *b)
+// a[k]=a[k]*a[k]*b[k] for k < n
+void ImplicitHFGGConvolution::multBlock(double *a, double *b, unsigned int n)
 {
-  unsigned int twom=2*m;
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int k=0; k < twom; k += 2) {
-      double *ak=a+k;
-      STORE(ak,LOAD(ak)*LOAD(ak)*LOAD(b+k));
-    }
-    );
+  for(unsigned int k=0; k < n; k += 2) {
+    double *ak=a+k;
+    STORE(ak,LOAD(ak)*LOAD(ak)*LOAD(b+k));
+  }
 #else
-  PARALLEL(
-    for(unsigned int k=0; k < twom; ++k) {
-      double ak=a[k];
-      a[k]=ak*ak*b[k];
-    }
-    );
+  for(unsigned int k=0; k < n; ++k) {
+    double ak=a[k];
+    a[k]=ak*ak*b[k];
+  }
 #endif
 }
 
+struct HFGGMultBlocks {
+  ImplicitHFGGConvolution *C;
+  double *a,*b;
+  unsigned int n,size;
+  HFGGMultBlocks(ImplicitHFGGConvolution *C, double *a, double *b,
+                 unsigned int n, unsigned int size) :
+    C(C), a(a), b(b), n(n), size(size) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int start=i*size;
+    C->multBlock(a+start,b+start,std::min(size,n-start));
+  }
+};
+
+void ImplicitHFGGConvolution::mult(double *a, double *b)
+{
+  unsigned int size=evenBlockSize(twom,threads);
+  parallel((twom+size-1)/size,HFGGMultBlocks(this,a,b,twom,size),threads);
+}
+
 void ImplicitHFGGConvolution::convolve(Complex *f, Complex *g,
                                        Complex *u, Complex *v)
 {
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        Vec Fk=LOAD(f+k);
-        Vec Gk=LOAD(g+k);
-        STORE(u+k,ZMULT(Zetak,Fk));
-        STORE(v+k,ZMULT(Zetak,Gk));
-      }
-    }  
-    );
+  Complex *F[]={f,g};
+  Complex *U[]={u,v};
+  parallel((m+s-1)/s,HTPretransform(F,U,2,ZetaH,ZetaL,m,s),threads);
 
   u[m]=0.0;
   v[m]=0.0;
@@ -1112,50 +1336,40 @@ void ImplicitHFGGConvolution::convolve(Complex *f, Complex *g,
   rco->fft((double *) v,f);
     
   double ninv=0.25/m;
+  parallel((m+s-1)/s,HTPosttransform(f,u,ZetaH,ZetaL,m,s,ninv),threads);
+}
 
-  Vec Ninv=LOAD(ninv);
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=Ninv*LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k) {
-        Vec Zetak=ZMULT(X,Y,LOAD(ZetaL0+k));
-        Complex *fk=f+k;
-        STORE(fk,ZMULTC(Zetak,LOAD(u+k))+Ninv*LOAD(fk));
-      }
-    }
-    );
+// a[k]=a[k]^3 for k < n
+void ImplicitHFFFConvolution::multBlock(double *a, unsigned int n)
+{
+  for(unsigned int k=0; k < n; k += 2) {
+    double *p=a+k;
+    Vec ak=LOAD(p);
+    STORE(p,ak*ak*ak);
+  }        
 }
 
-// a[k]=a[k]^3
+struct HFFFMultBlocks {
+  ImplicitHFFFConvolution *C;
+  double *a;
+  unsigned int n,size;
+  HFFFMultBlocks(ImplicitHFFFConvolution *C, double *a, unsigned int n,
+                 unsigned int size) : C(C), a(a), n(n), size(size) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int start=i*size;
+    C->multBlock(a+start,std::min(size,n-start));
+  }
+};
+
 void ImplicitHFFFConvolution::mult(double *a)
 {
-  unsigned int twom=2*m;
-  PARALLEL(
-    for(unsigned int k=0; k < twom; k += 2) {
-      double *p=a+k;
-      Vec ak=LOAD(p);
-      STORE(p,ak*ak*ak);
-    }        
-    );
+  unsigned int size=evenBlockSize(twom,threads);
+  parallel((twom+size-1)/size,HFFFMultBlocks(this,a,twom,size),threads);
 }
   
 void ImplicitHFFFConvolution::convolve(Complex *f, Complex *u)
 {
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k)
-        STORE(u+k,ZMULT(ZMULT(X,Y,LOAD(ZetaL0+k)),LOAD(f+k)));
-    }  
-    );
+  parallel((m+s-1)/s,HTPretransform(&f,&u,1,ZetaH,ZetaL,m,s),threads);
     
   u[m]=0.0;
   cr->fft(u);
@@ -1167,79 +1381,74 @@ void ImplicitHFFFConvolution::convolve(Complex *f, Complex *u)
   mult((double *) f);
   rc->fft(f);
   double ninv=0.25/m;
-  Vec Ninv=LOAD(ninv);
-  PARALLEL(
-    for(unsigned int K=0; K < m; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,m);
-      Vec Zeta=Ninv*LOAD(ZetaH+K/s);
-      Vec X=UNPACKL(Zeta,Zeta);
-      Vec Y=UNPACKH(CONJ(Zeta),Zeta);
-      for(unsigned int k=K; k < stop; ++k) {
-        Complex *p=f+k;
-        STORE(p,ZMULTC(ZMULT(X,Y,LOAD(ZetaL0+k)),LOAD(u+k))+Ninv*LOAD(p));
-      } 
-    }
-    );
+  parallel((m+s-1)/s,HTPosttransform(f,u,ZetaH,ZetaL,m,s,ninv),threads);
 }
 
 void fft0bipad::backwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADBACKWARDS,3.0*cbytes(2*m)*M,2.0*M*cflops(2*m)+12.0*m*M);
   for(unsigned int i=0; i < M; ++i)
     f[i]=0.0;
   for(unsigned int i=0; i < M; ++i)
     u[i]=0.0;
     
-  unsigned int twom=2*m;
-  PARALLEL(
-    for(unsigned int K=0; K < twom; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,twom);
-      Vec H=-LOAD(ZetaH+K/s);
-      for(unsigned int k=max(1,K); k < stop; ++k) {
-        Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
-        Vec X=UNPACKL(Zetak,Zetak);
-        Vec Y=UNPACKH(CONJ(Zetak),Zetak);
-        unsigned int kstride=k*stride;
-        Complex *fk=f+kstride;
-        Complex *uk=u+kstride;
-        for(unsigned int i=0; i < M; ++i)
-          STORE(uk+i,ZMULTI(X,Y,LOAD(fk+i)));
-      }
-    }
-    );
+  parallel((2*m+s-1)/s,
+           PadBlocks<fft0bipad>(this,&fft0bipad::expandBlock,f,u),threads);
     
   Backwards->fft(f);
   Backwards->fft(u);
 }
 
+void fft0bipad::expandBlock(Complex *f, Complex *u, unsigned int b)
+{
+  unsigned int twom=2*m;
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,twom);
+  Vec H=-LOAD(ZetaH+b);
+  for(unsigned int k=max(1,K); k < stop; ++k) {
+    Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
+    Vec X=UNPACKL(Zetak,Zetak);
+    Vec Y=UNPACKH(CONJ(Zetak),Zetak);
+    unsigned int kstride=k*stride;
+    Complex *fk=f+kstride;
+    Complex *uk=u+kstride;
+    for(unsigned int i=0; i < M; ++i)
+      STORE(uk+i,ZMULTI(X,Y,LOAD(fk+i)));
+  }
+}
+
 void fft0bipad::forwards(Complex *f, Complex *u)
 {
+  FFTWPP_PHASE(PADFORWARDS,3.0*cbytes(2*m)*M,2.0*M*cflops(2*m)+16.0*m*M);
   Forwards->fft(f);
   Forwards->fft(u);
 
+  parallel((2*m+s-1)/s,
+           PadBlocks<fft0bipad>(this,&fft0bipad::reduceBlock,f,u),threads);
+}
+
+void fft0bipad::reduceBlock(Complex *f, Complex *u, unsigned int b)
+{
   double ninv=0.25/m;
   unsigned int twom=2*m;
   Vec Ninv=LOAD(ninv);
-  PARALLEL(
-    for(unsigned int K=0; K < twom; K += s) {
-      Complex *ZetaL0=ZetaL-K;
-      unsigned int stop=min(K+s,twom);
-      Vec H=Ninv*LOAD(ZetaH+K/s);
-      for(unsigned int k=max(1,K); k < stop; ++k) {
-        Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
-        Vec X=UNPACKL(Zetak,Zetak);
-        Vec Y=UNPACKH(Zetak,CONJ(Zetak));
-        unsigned int kstride=k*stride;
-        Complex *uk=u+kstride;
-        Complex *fk=f+kstride;
-        for(unsigned int i=0; i < M; ++i) {
-          Complex *p=fk+i;
-          STORE(p,LOAD(p)*Ninv+ZMULTI(X,Y,LOAD(uk+i)));
-        }
-      }
+  unsigned int K=b*s;
+  Complex *ZetaL0=ZetaL-K;
+  unsigned int stop=min(K+s,twom);
+  Vec H=Ninv*LOAD(ZetaH+b);
+  for(unsigned int k=max(1,K); k < stop; ++k) {
+    Vec Zetak=ZMULT(H,LOAD(ZetaL0+k));
+    Vec X=UNPACKL(Zetak,Zetak);
+    Vec Y=UNPACKH(Zetak,CONJ(Zetak));
+    unsigned int kstride=k*stride;
+    Complex *uk=u+kstride;
+    Complex *fk=f+kstride;
+    for(unsigned int i=0; i < M; ++i) {
+      Complex *p=fk+i;
+      STORE(p,LOAD(p)*Ninv+ZMULTI(X,Y,LOAD(uk+i)));
     }
-    );
+  }
 }
 
 // This multiplication routine is for binary convolutions and takes two inputs
@@ -1250,20 +1459,18 @@ void multautocorrelation(Complex **F, unsigned int m,
                          const unsigned int *index,
                          unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multautocorrelation,F,1,m,indexsize,index,r,
+                    threads)) return;
   Complex* F0=F[0];
   
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *p=F0+j;
-      STORE(p,ZMULT(LOAD(p),CONJ(LOAD(p))));
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *p=F0+j;
+    STORE(p,ZMULT(LOAD(p),CONJ(LOAD(p))));
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j] *= conj(F0[j]);
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= conj(F0[j]);
 #endif
 }
 
@@ -1272,22 +1479,19 @@ void multcorrelation(Complex **F, unsigned int m,
                      const unsigned int *index,
                      unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multcorrelation,F,2,m,indexsize,index,r,threads)) return;
   Complex* F0=F[0];
   Complex* F1=F[1];
   
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *p=F0+j;
-      Complex *q=F1+j;
-      STORE(p,ZMULT(LOAD(p),CONJ(LOAD(q))));
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *p=F0+j;
+    Complex *q=F1+j;
+    STORE(p,ZMULT(LOAD(p),CONJ(LOAD(q))));
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j] *= conj(F1[j]);
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= conj(F1[j]);
 #endif
 }
 
@@ -1302,6 +1506,7 @@ void multbinary(Complex **F, unsigned int m,
                 const unsigned int *index,
                 unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary,F,2,m,indexsize,index,r,threads)) return;
   Complex* F0=F[0];
   Complex* F1=F[1];
   
@@ -1315,17 +1520,13 @@ void multbinary(Complex **F, unsigned int m,
 #endif  
       
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *p=F0+j;
-      STORE(p,ZMULT(LOAD(p),LOAD(F1+j)));
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *p=F0+j;
+    STORE(p,ZMULT(LOAD(p),LOAD(F1+j)));
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j] *= F1[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= F1[j];
 #endif
 }
 
@@ -1335,20 +1536,18 @@ void multautoconvolution(Complex **F, unsigned int m,
                          const unsigned int *index,
                          unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multautoconvolution,F,1,m,indexsize,index,r,
+                    threads)) return;
   Complex* F0=F[0];
   
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *p=F0+j;
-      STORE(p,ZMULT(LOAD(p),LOAD(p)));
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *p=F0+j;
+    STORE(p,ZMULT(LOAD(p),LOAD(p)));
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j] *= F0[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= F0[j];
 #endif
 }
 
@@ -1366,6 +1565,7 @@ void multbinary(double **F, unsigned int m,
                 const unsigned int *index,
                 unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary,F,2,m,indexsize,index,r,threads)) return;
   double* F0=F[0];
   double* F1=F[1];
   
@@ -1381,46 +1581,84 @@ void multbinary(double **F, unsigned int m,
       
 #ifdef __SSE2__
   unsigned int m1=m-1;
-  PARALLEL(
-    for(unsigned int j=0; j < m1; j += 2) {
-      double *p=F0+j;
-      STORE(p,LOAD(p)*LOAD(F1+j));
-    }
-    if(m % 2)
-      F0[m1] *= F1[m1];
-    );
+  for(unsigned int j=0; j < m1; j += 2) {
+    double *p=F0+j;
+    STORE(p,LOAD(p)*LOAD(F1+j));
+  }
+  if(m % 2)
+    F0[m1] *= F1[m1];
+#else
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= F1[j];
+#endif
+}
+
+// This multiplication routine is for Hermitian autoconvolutions and takes
+// one input.
+// F[0][j] *= F[0][j];
+void multautoconvolution(double **F, unsigned int m,
+                         const unsigned int indexsize,
+                         const unsigned int *index,
+                         unsigned int r, unsigned int threads)
+{
+  if(multiplyBlocks(multautoconvolution,F,1,m,indexsize,index,r,
+                    threads)) return;
+  double* F0=F[0];
+  
+#ifdef __SSE2__
+  unsigned int m1=m-1;
+  for(unsigned int j=0; j < m1; j += 2) {
+    double *p=F0+j;
+    Vec P=LOAD(p);
+    STORE(p,P*P);
+  }
+  if(m % 2)
+    F0[m1] *= F0[m1];
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j] *= F1[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= F0[j];
 #endif
 }
 
+// Real data are self-conjugate, so Hermitian correlations reduce to the
+// corresponding convolutions: conj(g[p-k])=g[k-p] absorbs the index reversal.
+void multcorrelation(double **F, unsigned int m,
+                     const unsigned int indexsize,
+                     const unsigned int *index,
+                     unsigned int r, unsigned int threads)
+{
+  multbinary(F,m,indexsize,index,r,threads);
+}
+
+void multautocorrelation(double **F, unsigned int m,
+                         const unsigned int indexsize,
+                         const unsigned int *index,
+                         unsigned int r, unsigned int threads)
+{
+  multautoconvolution(F,m,indexsize,index,r,threads);
+}
+
 // F[0][j]=F[0][j]*F[2][j]+F[1][j]*F[3][j]
 void multbinary2(Complex **F, unsigned int m,
                  const unsigned int indexsize,
                  const unsigned int *index,
                  unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary2,F,4,m,indexsize,index,r,threads)) return;
   Complex* F0=F[0];
   Complex* F1=F[1];
   Complex* F2=F[2];
   Complex* F3=F[3];
   
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *F0j=F0+j;
-      STORE(F0j,ZMULT(LOAD(F0j),LOAD(F2+j))
-            +ZMULT(LOAD(F1+j),LOAD(F3+j)));
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *F0j=F0+j;
+    STORE(F0j,ZMULT(LOAD(F0j),LOAD(F2+j))
+          +ZMULT(LOAD(F1+j),LOAD(F3+j)));
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j]=F0[j]*F2[j]+F1[j]*F3[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j]=F0[j]*F2[j]+F1[j]*F3[j];
 #endif
 }
 
@@ -1430,6 +1668,7 @@ void multbinary2(double **F, unsigned int m,
                  const unsigned int *index,
                  unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary2,F,4,m,indexsize,index,r,threads)) return;
   double* F0=F[0];
   double* F1=F[1];
   double* F2=F[2];
@@ -1437,19 +1676,15 @@ void multbinary2(double **F, unsigned int m,
   
 #ifdef __SSE2__
   unsigned int m1=m-1;
-  PARALLEL(
-    for(unsigned int j=0; j < m1; j += 2) {
-      double *F0j=F0+j;
-      STORE(F0j,LOAD(F0j)*LOAD(F2+j)+LOAD(F1+j)*LOAD(F3+j));
-    }
-    );
+  for(unsigned int j=0; j < m1; j += 2) {
+    double *F0j=F0+j;
+    STORE(F0j,LOAD(F0j)*LOAD(F2+j)+LOAD(F1+j)*LOAD(F3+j));
+  }
   if(m % 2)
     F0[m1]=F0[m1]*F2[m1]+F1[m1]*F3[m1];
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j]=F0[j]*F2[j]+F1[j]*F3[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j]=F0[j]*F2[j]+F1[j]*F3[j];
 #endif
 }
 
@@ -1459,6 +1694,7 @@ void multbinary3(Complex **F, unsigned int m,
                  const unsigned int *index,
                  unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary3,F,6,m,indexsize,index,r,threads)) return;
   Complex* F0=F[0];
   Complex* F1=F[1];
   Complex* F2=F[2];
@@ -1467,20 +1703,16 @@ void multbinary3(Complex **F, unsigned int m,
   Complex* F5=F[5];
   
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *F0j=F0+j;
-      STORE(F0j,ZMULT(LOAD(F0j),LOAD(F3+j))
-            +ZMULT(LOAD(F1+j),LOAD(F4+j))
-            +ZMULT(LOAD(F2+j),LOAD(F5+j))
-        );
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *F0j=F0+j;
+    STORE(F0j,ZMULT(LOAD(F0j),LOAD(F3+j))
+          +ZMULT(LOAD(F1+j),LOAD(F4+j))
+          +ZMULT(LOAD(F2+j),LOAD(F5+j))
+      );
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j]=F0[j]*F3[j]+F1[j]*F4[j]+F2[j]*F5[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j]=F0[j]*F3[j]+F1[j]*F4[j]+F2[j]*F5[j];
 
 #endif
 }
@@ -1491,6 +1723,7 @@ void multbinary4(Complex **F, unsigned int m,
                  const unsigned int *index,
                  unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary4,F,8,m,indexsize,index,r,threads)) return;
   Complex* F0=F[0];
   Complex* F1=F[1];
   Complex* F2=F[2];
@@ -1501,21 +1734,17 @@ void multbinary4(Complex **F, unsigned int m,
   Complex* F7=F[7];
   
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *F0j=F0+j;
-      STORE(F0j,ZMULT(LOAD(F0j),LOAD(F4+j))
-            +ZMULT(LOAD(F1+j),LOAD(F5+j))
-            +ZMULT(LOAD(F2+j),LOAD(F6+j))
-            +ZMULT(LOAD(F3+j),LOAD(F7+j))
-        );
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *F0j=F0+j;
+    STORE(F0j,ZMULT(LOAD(F0j),LOAD(F4+j))
+          +ZMULT(LOAD(F1+j),LOAD(F5+j))
+          +ZMULT(LOAD(F2+j),LOAD(F6+j))
+          +ZMULT(LOAD(F3+j),LOAD(F7+j))
+      );
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j]=F0[j]*F4[j]+F1[j]*F5[j]+F2[j]*F6[j]+F3[j]*F7[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j]=F0[j]*F4[j]+F1[j]*F5[j]+F2[j]*F6[j]+F3[j]*F7[j];
 
 #endif
 }
@@ -1527,6 +1756,7 @@ void multbinary8(Complex **F, unsigned int m,
                  const unsigned int *index,
                  unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multbinary8,F,16,m,indexsize,index,r,threads)) return;
   Complex* F0=F[0];
   Complex* F1=F[1];
   Complex* F2=F[2];
@@ -1545,27 +1775,23 @@ void multbinary8(Complex **F, unsigned int m,
   Complex* F15=F[15];
     
 #ifdef __SSE2__
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j) {
-      Complex *F0j=F0+j;
-      STORE(F0j,
-            ZMULT(LOAD(F0j),LOAD(F8+j))
-            +ZMULT(LOAD(F1+j),LOAD(F9+j))
-            +ZMULT(LOAD(F2+j),LOAD(F10+j))
-            +ZMULT(LOAD(F3+j),LOAD(F11+j))
-            +ZMULT(LOAD(F4+j),LOAD(F12+j))
-            +ZMULT(LOAD(F5+j),LOAD(F13+j))
-            +ZMULT(LOAD(F6+j),LOAD(F14+j))
-            +ZMULT(LOAD(F7+j),LOAD(F15+j))
-        );
-    }
-    );
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *F0j=F0+j;
+    STORE(F0j,
+          ZMULT(LOAD(F0j),LOAD(F8+j))
+          +ZMULT(LOAD(F1+j),LOAD(F9+j))
+          +ZMULT(LOAD(F2+j),LOAD(F10+j))
+          +ZMULT(LOAD(F3+j),LOAD(F11+j))
+          +ZMULT(LOAD(F4+j),LOAD(F12+j))
+          +ZMULT(LOAD(F5+j),LOAD(F13+j))
+          +ZMULT(LOAD(F6+j),LOAD(F14+j))
+          +ZMULT(LOAD(F7+j),LOAD(F15+j))
+      );
+  }
 #else
-  PARALLEL(
-    for(unsigned int j=0; j < m; ++j)
-      F0[j]=F0[j]*F8[j]+F1[j]*F9[j]+F2[j]*F10[j]+F3[j]*F11[j]
-        +F4[j]*F12[j]+F5[j]*F13[j]+F6[j]*F14[j]+F7[j]*F15[j];
-    );
+  for(unsigned int j=0; j < m; ++j)
+    F0[j]=F0[j]*F8[j]+F1[j]*F9[j]+F2[j]*F10[j]+F3[j]*F11[j]
+      +F4[j]*F12[j]+F5[j]*F13[j]+F6[j]*F14[j]+F7[j]*F15[j];
 #endif
 }
 
@@ -1576,21 +1802,20 @@ void multadvection2(double **F, unsigned int m,
                     const unsigned int *index,
                     unsigned int r, unsigned int threads)
 {
+  if(multiplyBlocks(multadvection2,F,2,m,indexsize,index,r,threads)) return;
   double* F0=F[0];
   double* F1=F[1];
   
 #ifdef __SSE2__
   unsigned int m1=m-1;
-  PARALLEL(
-    for(unsigned int j=0; j < m1; j += 2) {
-      double *F0j=F0+j;
-      double *F1j=F1+j;
-      Vec u=LOAD(F0j);
-      Vec v=LOAD(F1j);
-      STORE(F0j,v*v-u*u);
-      STORE(F1j,u*v);
-    }
-    );
+  for(unsigned int j=0; j < m1; j += 2) {
+    double *F0j=F0+j;
+    double *F1j=F1+j;
+    Vec u=LOAD(F0j);
+    Vec v=LOAD(F1j);
+    STORE(F0j,v*v-u*u);
+    STORE(F1j,u*v);
+  }
   if(m % 2) {
     double u=F0[m1];
     double v=F1[m1];
@@ -1607,4 +1832,163 @@ void multadvection2(double **F, unsigned int m,
 #endif  
 }
 
+// Cross product u x b of the vectors u=(F[0],F[1],F[2]) and
+// b=(F[3],F[4],F[5]), returned in F[0], F[1], and F[2] (A=6, B=3).
+void multcross(Complex **F, unsigned int m,
+               const unsigned int indexsize,
+               const unsigned int *index,
+               unsigned int r, unsigned int threads)
+{
+  if(multiplyBlocks(multcross,F,6,m,indexsize,index,r,threads)) return;
+  Complex *F0=F[0];
+  Complex *F1=F[1];
+  Complex *F2=F[2];
+  Complex *F3=F[3];
+  Complex *F4=F[4];
+  Complex *F5=F[5];
+  
+#ifdef __SSE2__
+  for(unsigned int j=0; j < m; ++j) {
+    Complex *F0j=F0+j;
+    Complex *F1j=F1+j;
+    Complex *F2j=F2+j;
+    Vec u0=LOAD(F0j);
+    Vec u1=LOAD(F1j);
+    Vec u2=LOAD(F2j);
+    Vec b0=LOAD(F3+j);
+    Vec b1=LOAD(F4+j);
+    Vec b2=LOAD(F5+j);
+    STORE(F0j,ZMULT(u1,b2)-ZMULT(u2,b1));
+    STORE(F1j,ZMULT(u2,b0)-ZMULT(u0,b2));
+    STORE(F2j,ZMULT(u0,b1)-ZMULT(u1,b0));
+  }
+#else
+  for(unsigned int j=0; j < m; ++j) {
+    Complex u0=F0[j];
+    Complex u1=F1[j];
+    Complex u2=F2[j];
+    Complex b0=F3[j];
+    Complex b1=F4[j];
+    Complex b2=F5[j];
+    F0[j]=u1*b2-u2*b1;
+    F1[j]=u2*b0-u0*b2;
+    F2[j]=u0*b1-u1*b0;
+  }
+#endif
+}
+
+void multcross(double **F, unsigned int m,
+               const unsigned int indexsize,
+               const unsigned int *index,
+               unsigned int r, unsigned int threads)
+{
+  if(multiplyBlocks(multcross,F,6,m,indexsize,index,r,threads)) return;
+  double *F0=F[0];
+  double *F1=F[1];
+  double *F2=F[2];
+  double *F3=F[3];
+  double *F4=F[4];
+  double *F5=F[5];
+  
+#ifdef __SSE2__
+  unsigned int m1=m-1;
+  for(unsigned int j=0; j < m1; j += 2) {
+    double *F0j=F0+j;
+    double *F1j=F1+j;
+    double *F2j=F2+j;
+    Vec u0=LOAD(F0j);
+    Vec u1=LOAD(F1j);
+    Vec u2=LOAD(F2j);
+    Vec b0=LOAD(F3+j);
+    Vec b1=LOAD(F4+j);
+    Vec b2=LOAD(F5+j);
+    STORE(F0j,u1*b2-u2*b1);
+    STORE(F1j,u2*b0-u0*b2);
+    STORE(F2j,u0*b1-u1*b0);
+  }
+  if(m % 2) {
+    double u0=F0[m1];
+    double u1=F1[m1];
+    double u2=F2[m1];
+    double b0=F3[m1];
+    double b1=F4[m1];
+    double b2=F5[m1];
+    F0[m1]=u1*b2-u2*b1;
+    F1[m1]=u2*b0-u0*b2;
+    F2[m1]=u0*b1-u1*b0;
+  }
+#else
+  for(unsigned int j=0; j < m; ++j) {
+    double u0=F0[j];
+    double u1=F1[j];
+    double u2=F2[j];
+    double b0=F3[j];
+    double b1=F4[j];
+    double b2=F5[j];
+    F0[j]=u1*b2-u2*b1;
+    F1[j]=u2*b0-u0*b2;
+    F2[j]=u0*b1-u1*b0;
+  }
+#endif
+}
+
+// This 3D version of the scheme of Basdevant, J. Comp. Phys, 50, 1983
+// requires only 5 forward FFTs per stage: given the velocity (u,v,w) in
+// F[0], F[1], and F[2] (A=3), it returns the independent components
+// u^2-w^2, v^2-w^2, uv, uw, and vw of the traceless stress in F[0],...,F[4]
+// (B=5).
+void multadvection3(double **F, unsigned int m,
+                    const unsigned int indexsize,
+                    const unsigned int *index,
+                    unsigned int r, unsigned int threads)
+{
+  if(multiplyBlocks(multadvection3,F,5,m,indexsize,index,r,threads)) return;
+  double* F0=F[0];
+  double* F1=F[1];
+  double* F2=F[2];
+  double* F3=F[3];
+  double* F4=F[4];
+  
+#ifdef __SSE2__
+  unsigned int m1=m-1;
+  for(unsigned int j=0; j < m1; j += 2) {
+    double *F0j=F0+j;
+    double *F1j=F1+j;
+    double *F2j=F2+j;
+    Vec u=LOAD(F0j);
+    Vec v=LOAD(F1j);
+    Vec w=LOAD(F2j);
+    Vec w2=w*w;
+    STORE(F0j,u*u-w2);
+    STORE(F1j,v*v-w2);
+    STORE(F2j,u*v);
+    STORE(F3+j,u*w);
+    STORE(F4+j,v*w);
+  }
+  if(m % 2) {
+    double u=F0[m1];
+    double v=F1[m1];
+    double w=F2[m1];
+    double w2=w*w;
+    F0[m1]=u*u-w2;
+    F1[m1]=v*v-w2;
+    F2[m1]=u*v;
+    F3[m1]=u*w;
+    F4[m1]=v*w;
+  }
+#else
+  for(unsigned int j=0; j < m; ++j) {
+    double u=F0[j];
+    double v=F1[j];
+    double w=F2[j];
+    double w2=w*w;
+    F0[j]=u*u-w2;
+    F1[j]=v*v-w2;
+    F2[j]=u*v;
+    F3[j]=u*w;
+    F4[j]=v*w;
+  }
+#endif
+}
+
 } // namespace fftwpp
@@ -15,6 +15,9 @@
    along with this program; if not, write to the Free Software
    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
 
+#ifndef __convolution_h__
+#define __convolution_h__ 1
+
 #include "Complex.h"
 #include "fftw++.h"
 #include "cmult-sse2.h"
@@ -22,9 +25,6 @@
     
 namespace fftwpp {
 
-#ifndef __convolution_h__
-#define __convolution_h__ 1
-
 extern const double sqrt3;
 extern const double hsqrt3;
 
@@ -89,6 +89,61 @@ typedef void realmultiplier(double **, unsigned int m,
                             const unsigned int *index,
                             unsigned int r, unsigned int threads); 
   
+// Return the size, rounded up to an even number so that pairs of doubles
+// stay aligned, of the blocks that divide n elements among threads.
+inline unsigned int evenBlockSize(unsigned int n, unsigned int threads)
+{
+  unsigned int size=(n+threads-1)/threads;
+  return size+size % 2;
+}
+
+// Loop body that applies the multiplier mult, with one thread, to block i
+// (of length size) of the m elements of each of the A arrays F.
+template<class T>
+struct MultiplierBlocks {
+  typedef void Multiplier(T **, unsigned int m,
+                          const unsigned int indexsize,
+                          const unsigned int *index,
+                          unsigned int r, unsigned int threads);
+  Multiplier *mult;
+  T **F;
+  unsigned int A,m,size;
+  unsigned int indexsize;
+  const unsigned int *index;
+  unsigned int r;
+  MultiplierBlocks(Multiplier *mult, T **F, unsigned int A, unsigned int m,
+                   unsigned int size, unsigned int indexsize,
+                   const unsigned int *index, unsigned int r) :
+    mult(mult), F(F), A(A), m(m), size(size), indexsize(indexsize),
+    index(index), r(r) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int start=i*size;
+    T *G[A];
+    for(unsigned int a=0; a < A; ++a)
+      G[a]=F[a]+start;
+    unsigned int n=m-start;
+    (*mult)(G,n < size ? n : size,indexsize,index,r,1);
+  }
+};
+
+// Distribute a pointwise multiplier that accesses the first A arrays of F
+// over threads blocks of an even number of elements. Returns false, without
+// doing anything, when the multiplier should run with one thread. The
+// multiplier must not depend on the position of an element within F.
+template<class T>
+inline bool multiplyBlocks(typename MultiplierBlocks<T>::Multiplier *mult,
+                           T **F, unsigned int A, unsigned int m,
+                           const unsigned int indexsize,
+                           const unsigned int *index, unsigned int r,
+                           unsigned int threads)
+{
+  if(threads <= 1 || m < 4) return false;
+  unsigned int size=evenBlockSize(m,threads);
+  parallel((m+size-1)/size,
+           MultiplierBlocks<T>(mult,F,A,m,size,indexsize,index,r),threads);
+  return true;
+}
+
 // Multipliers for binary convolutions.
 
 multiplier multautoconvolution;
@@ -100,10 +155,82 @@ multiplier multbinary3;
 multiplier multbinary4;
 multiplier multbinary8;
 
+realmultiplier multautoconvolution;
+realmultiplier multautocorrelation;
 realmultiplier multbinary;
+realmultiplier multcorrelation;
 realmultiplier multbinary2;
 realmultiplier multadvection2;
 
+// Fused multipliers that combine several products into fewer outputs
+// before the forward transforms.
+multiplier multcross;
+realmultiplier multcross;
+realmultiplier multadvection3;
+
+// Dot-product multiplier for an even number A of inputs:
+// F[0][j]=F[0][j]*F[A/2][j]+F[1][j]*F[A/2+1][j]+...+F[A/2-1][j]*F[A-1][j].
+template<unsigned int A>
+void multdot(Complex **F, unsigned int m,
+             const unsigned int indexsize,
+             const unsigned int *index,
+             unsigned int r, unsigned int threads)
+{
+  if(multiplyBlocks(multdot<A>,F,A,m,indexsize,index,r,threads)) return;
+  const unsigned int M=A/2;
+  Complex *F0=F[0];
+  
+#ifdef __SSE2__
+  for(unsigned int j=0; j < m; ++j) {
+    Vec sum=ZMULT(LOAD(F0+j),LOAD(F[M]+j));
+    for(unsigned int s=1; s < M; ++s)
+      sum += ZMULT(LOAD(F[s]+j),LOAD(F[M+s]+j));
+    STORE(F0+j,sum);
+  }
+#else
+  for(unsigned int j=0; j < m; ++j) {
+    Complex sum=F0[j]*F[M][j];
+    for(unsigned int s=1; s < M; ++s)
+      sum += F[s][j]*F[M+s][j];
+    F0[j]=sum;
+  }
+#endif
+}
+
+template<unsigned int A>
+void multdot(double **F, unsigned int m,
+             const unsigned int indexsize,
+             const unsigned int *index,
+             unsigned int r, unsigned int threads)
+{
+  if(multiplyBlocks(multdot<A>,F,A,m,indexsize,index,r,threads)) return;
+  const unsigned int M=A/2;
+  double *F0=F[0];
+  
+#ifdef __SSE2__
+  unsigned int m1=m-1;
+  for(unsigned int j=0; j < m1; j += 2) {
+    Vec sum=LOAD(F0+j)*LOAD(F[M]+j);
+    for(unsigned int s=1; s < M; ++s)
+      sum += LOAD(F[s]+j)*LOAD(F[M+s]+j);
+    STORE(F0+j,sum);
+  }
+  if(m % 2) {
+    double sum=F0[m1]*F[M][m1];
+    for(unsigned int s=1; s < M; ++s)
+      sum += F[s][m1]*F[M+s][m1];
+    F0[m1]=sum;
+  }
+#else
+  for(unsigned int j=0; j < m; ++j) {
+    double sum=F0[j]*F[M][j];
+    for(unsigned int s=1; s < M; ++s)
+      sum += F[s][j]*F[M+s][j];
+    F0[j]=sum;
+  }
+#endif
+}
+
 struct general {};
 struct pretransform1 {};
 struct pretransform2 {};
@@ -252,9 +379,13 @@ public:
   template<class T>
   inline void pretransform(Complex **F, unsigned int k, Vec& Zetak);
 
+  template<class T>
+  void pretransformBlock(Complex **F, unsigned int b);
+  
   template<class T>
   void pretransform(Complex **F);
   
+  void posttransformBlock(Complex *f, Complex *u, unsigned int b);
   void posttransform(Complex *f, Complex *u);
 };
 
@@ -399,7 +530,9 @@ public:
   void convolve(Complex **F, realmultiplier *pmult, unsigned int i=0,         
                 unsigned int offset=0);
 
+  void pretransformBlock(Complex *F, Complex *U, unsigned int b);
   void pretransform(Complex *F, Complex *f1c, Complex *U);
+  void posttransformBlock(Complex *F, Complex *U, unsigned int b);
   void posttransform(Complex *F, const Complex& f1c, Complex *U);
 
   // Binary convolution:
@@ -407,8 +540,116 @@ public:
     Complex *F[]={f,g};
     convolve(F,multbinary);
   }
+
+  // Binary correlation (identical to the convolution for Hermitian data):
+  void correlate(Complex *f, Complex *g) {
+    Complex *F[]={f,g};
+    convolve(F,multcorrelation);
+  }
+
+  // The following routines require A=1.
+  void autoconvolve(Complex *f) {
+    Complex *F[]={f};
+    convolve(F,multautoconvolution);
+  }
+
+  void autocorrelate(Complex *f) {
+    Complex *F[]={f};
+    convolve(F,multautocorrelation);
+  }
 };
   
+// Implicitly dealiased convolution (product) of Chebyshev series using the
+// 3/2 rule. The A inputs, each holding the m coefficients of a Chebyshev
+// series, are evaluated at the n=3p Gauss-Chebyshev nodes, where p=(m+1)/2,
+// without explicit padding: the nodes are split by their residue modulo 3.
+// The values at the nodes with residue 1 are a DCT-III of length p, computed
+// in place in the input array; those at the nodes with residues 0 and 2 are
+// the real part of a twiddled complex Fourier series of length 2p, computed
+// with a complex-to-real transform in a work array of p+1 Complex values.
+// The multiplier is applied to each group of nodes, and the first m
+// Chebyshev coefficients of each of the B outputs are recovered with the
+// corresponding DCT-II and real-to-complex transforms.
+class ChebyshevConvolution : public ThreadBase {
+protected:
+  unsigned int m;
+  unsigned int p;
+  unsigned int A;
+  unsigned int B;
+  unsigned int s;
+  Complex *ZetaH, *ZetaL;
+  Complex *u;
+  double **U;
+  rrfft1d *Backwards,*Forwards;
+  crfft1d *cr;
+  rcfft1d *rc;
+public:
+  // m is the number of Chebyshev coefficients of each input.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ChebyshevConvolution(unsigned int m, unsigned int A=2, unsigned int B=1,
+                       unsigned int threads=fftw::maxthreads)
+    : ThreadBase(threads), m(m), p((m+1)/2), A(A), B(B) {
+    unsigned int C=max(A,B);
+    u=utils::ComplexAlign(C*(p+1));
+    U=new double *[C];
+    for(unsigned int a=0; a < C; ++a)
+      U[a]=(double *) (u+a*(p+1));
+    double *f=utils::doubleAlign(p);
+    Backwards=new rrfft1d(p,FFTW_REDFT01,f,f,threads);
+    Forwards=new rrfft1d(p,FFTW_REDFT10,f,f,threads);
+    utils::deleteAlign(f);
+    cr=new crfft1d(2*p,u,(double *) NULL,threads);
+    rc=new rcfft1d(2*p,u,threads);
+    this->threads=std::min(threads,
+                           std::max(std::max(Backwards->Threads(),
+                                             Forwards->Threads()),
+                                    std::max(cr->Threads(),rc->Threads())));
+    s=BuildZeta(12*p,2*p,ZetaH,ZetaL,this->threads);
+  }
+
+  ~ChebyshevConvolution() {
+    utils::deleteAlign(ZetaL);
+    utils::deleteAlign(ZetaH);
+    delete rc;
+    delete cr;
+    delete Forwards;
+    delete Backwards;
+    delete [] U;
+    utils::deleteAlign(u);
+  }
+
+  // F is an array of max(A,B) pointers to distinct data blocks each of
+  // size m. The outputs are returned in F[0],...,F[B-1].
+  void convolve(double **F, realmultiplier *pmult);
+
+  // Binary convolution:
+  void convolve(double *f, double *g) {
+    double *F[]={f,g};
+    convolve(F,multbinary);
+  }
+
+  // The following routine requires A=1.
+  void autoconvolve(double *f) {
+    double *F[]={f};
+    convolve(F,multautoconvolution);
+  }
+};
+
+// Loop body that applies the twiddle factors of block b (of size s) in an
+// implicit padding pass, pretransform, or posttransform of class T.
+template<class T>
+struct PadBlocks {
+  typedef void (T::*Pass)(Complex *f, Complex *u, unsigned int b);
+  T *pad;
+  Pass pass;
+  Complex *f,*u;
+  PadBlocks(T *pad, Pass pass, Complex *f, Complex *u) :
+    pad(pad), pass(pass), f(f), u(u) {}
+  void operator()(unsigned int b, unsigned int) const {
+    (pad->*pass)(f,u,b);
+  }
+};
 
 // Compute the scrambled implicitly m-padded complex Fourier transform of M
 // complex vectors, each of length m.
@@ -455,6 +696,8 @@ public:
   
   void expand(Complex *f, Complex *u);
   void reduce(Complex *f, Complex *u);
+  void expandBlock(Complex *f, Complex *u, unsigned int b);
+  void reduceBlock(Complex *f, Complex *u, unsigned int b);
   
   void backwards(Complex *f, Complex *u);
   void forwards(Complex *f, Complex *u);
@@ -551,6 +794,8 @@ public:
   
   void expand(Complex *f, Complex *u);
   void reduce(Complex *f, Complex *u);
+  void expandBlock(Complex *f, Complex *u, unsigned int b);
+  void reduceBlock(Complex *f, Complex *u, unsigned int b);
   
   void forwards(Complex *f, Complex *u);
   
@@ -559,6 +804,22 @@ public:
   void Forwards1(Complex *f, Complex *u);
 };
   
+// Loop body that convolves block i of a subconvolution with the
+// per-thread engines C[thread].
+template<class T>
+struct Subconvolution {
+  T **C;
+  Complex **F;
+  multiplier *pmult;
+  unsigned int r,stride,offset;
+  Subconvolution(T **C, Complex **F, multiplier *pmult, unsigned int r,
+                 unsigned int stride, unsigned int offset) :
+    C(C), F(F), pmult(pmult), r(r), stride(stride), offset(offset) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C[thread]->convolve(F,pmult,2*i+r,offset+i*stride);
+  }
+};
+
 // In-place implicitly dealiased 2D complex convolution.
 class ImplicitConvolution2 : public ThreadBase {
 protected:
@@ -673,17 +934,8 @@ public:
   void subconvolution(Complex **F, multiplier *pmult, 
                       unsigned int r, unsigned int M, unsigned int stride,
                       unsigned int offset=0) {
-    if(threads > 1) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-      for(unsigned int i=0; i < M; ++i)
-        yconvolve[get_thread_num()]->convolve(F,pmult,2*i+r,offset+i*stride);
-    } else {
-      ImplicitConvolution *yconvolve0=yconvolve[0];
-      for(unsigned int i=0; i < M; ++i)
-        yconvolve0->convolve(F,pmult,2*i+r,offset+i*stride);
-    }
+    parallel(M,Subconvolution<ImplicitConvolution>
+             (yconvolve,F,pmult,r,stride,offset),threads);
   }
   
   void forwards(Complex **F, Complex **U2, unsigned int offset) {
@@ -734,14 +986,107 @@ public:
   }
 };
 
+// Minimum number of reflected index pairs that are worth distributing
+// over multiple threads in the Hermitian symmetrization routines.
+const unsigned int symmetrizethreshold=4096;
+
+// Loop bodies for the Hermitian symmetrization routines, each of which
+// handles one x row. ReflectX reflects row x=i+1 (of stride my) of f0 onto
+// row -x.
+struct ReflectX {
+  Complex *f0;
+  int my;
+  ReflectX(Complex *f0, int my) : f0(f0), my(my) {}
+  void operator()(unsigned int i, unsigned int) const {
+    int x=(i+1)*my;
+#ifdef __SSE2__
+    STORE(f0-x,CONJ(LOAD(f0+x)));
+#else
+    f0[-x]=conj(f0[x]);
+#endif
+  }
+};
+
+// Reflect the y > 0 entries of rows x=i and -x of f0 onto each other, along
+// with the y=0 entry of row x > 0.
+struct ReflectXY {
+  Complex *f0;
+  int stride,mz,myz;
+  ReflectXY(Complex *f0, int stride, int mz, int myz) :
+    f0(f0), stride(stride), mz(mz), myz(myz) {}
+  void operator()(unsigned int i, unsigned int) const {
+    int x=i*stride;
+    Complex *p=f0+x;
+    Complex *q=f0-x;
+#ifdef __SSE2__
+    if(x > 0)
+      STORE(q,CONJ(LOAD(p)));
+    for(int j=mz; j < myz; j += mz) {
+      Vec P=LOAD(p+j);
+      Vec Q=LOAD(q+j);
+      STORE(q-j,CONJ(P));
+      STORE(p-j,CONJ(Q));
+    }
+#else
+    if(x > 0)
+      *q=conj(*p);
+    for(int j=mz; j < myz; j += mz) {
+      Complex P=p[j];
+      Complex Q=q[j];
+      q[-j]=conj(P);
+      p[-j]=conj(Q);
+    }
+#endif
+  }
+};
+
+// Zero the y < 0 entries, and double the y > 0 entries, of the x row that
+// starts at offset start+i*stride of f0.
+struct HalfXY {
+  Complex *f0;
+  int start,stride,mz,myz;
+  HalfXY(Complex *f0, int start, int stride, int mz, int myz) :
+    f0(f0), start(start), stride(stride), mz(mz), myz(myz) {}
+  void operator()(unsigned int i, unsigned int) const {
+    int x=start+(int) i*stride;
+    int stop=x+myz;
+    for(int j=x+mz; j < stop; j += mz) {
+      f0[-j]=0.0;
+      f0[j] *= 2.0;
+    }
+  }
+};
+
+// Reflect the z > 0 entries of the x row that starts at offset
+// start+i*xstride of f0 onto those of the opposite row.
+struct ReflectXYZ {
+  Complex *f0;
+  int start,xstride,my,ystride,zstop,mw;
+  ReflectXYZ(Complex *f0, int start, int xstride, int my, int ystride,
+             int zstop, int mw) :
+    f0(f0), start(start), xstride(xstride), my(my), ystride(ystride),
+    zstop(zstop), mw(mw) {}
+  void operator()(unsigned int i, unsigned int) const {
+    int x=start+(int) i*xstride;
+    int ystop=x+my*ystride;
+    for(int j=x+(1-my)*ystride; j < ystop; j += ystride) {
+      int kstop=j+zstop;
+      for(int k=j+mw; k < kstop; k += mw)
+        f0[-k]=conj(f0[k]);
+    }
+  }
+};
+
+// Enforce 2D Hermiticity using specified (x >= 0,y=0) data.
 inline void HermitianSymmetrizeX(unsigned int mx, unsigned int my,
-                                 unsigned int xorigin, Complex *f)
+                                 unsigned int xorigin, Complex *f,
+                                 unsigned int threads=1)
 {
-  unsigned int offset=xorigin*my;
-  unsigned int stop=mx*my;
-  f[offset].im=0.0;
-  for(unsigned int i=my; i < stop; i += my)
-    f[offset-i]=conj(f[offset+i]);
+  Complex *f0=f+xorigin*my;
+  f0->im=0.0;
+  if(mx < symmetrizethreshold) threads=1;
+  if(mx > 1)
+    parallel(mx-1,ReflectX(f0,my),threads);
 }
 
 // Enforce 3D Hermiticity using specified (x,y > 0,z=0) and (x >= 0,y=0,z=0)
@@ -750,29 +1095,111 @@ inline void HermitianSymmetrizeXY(unsigned int mx, unsigned int my,
                                   unsigned int mz, unsigned int xorigin,
                                   unsigned int yorigin, Complex *f,
                                   unsigned int threads=fftw::maxthreads)
+{
+  int stride=(yorigin+my)*mz;
+  int myz=my*mz;
+  Complex *f0=f+xorigin*stride+yorigin*mz;
+  
+  if(mx*my < symmetrizethreshold) threads=1;
+  
+  // Row pairs (x,-x) are reflected onto each other by the same thread; the
+  // y=0 entries of row x > 0 are reflected along with the pair.
+  parallel(mx,ReflectXY(f0,stride,mz,myz),threads);
+  
+  f0->im=0.0;
+}
+
+// Prepare specified (x > 0,y=0) data for an implicitly Hermitian transform
+// by zeroing the (x < 0,y=0) data and doubling the (x > 0,y=0) data.
+// Since the final complex-to-real transform discards the imaginary part
+// of the y=0 modes, this is equivalent to HermitianSymmetrizeX.
+inline void HermitianHalfX(unsigned int mx, unsigned int my,
+                           unsigned int xorigin, Complex *f)
+{
+  unsigned int offset=xorigin*my;
+  unsigned int stop=mx*my;
+  for(unsigned int i=my; i < stop; i += my) {
+    f[offset-i]=0.0;
+    f[offset+i] *= 2.0;
+  }
+}
+
+// Prepare specified (x,y > 0,z=0) and (x > 0,y=0,z=0) data for an implicitly
+// Hermitian transform by zeroing the remaining half of the z=0 plane and
+// doubling the specified half; equivalent to HermitianSymmetrizeXY.
+inline void HermitianHalfXY(unsigned int mx, unsigned int my,
+                            unsigned int mz, unsigned int xorigin,
+                            unsigned int yorigin, Complex *f,
+                            unsigned int threads=fftw::maxthreads)
 {
   int stride=(yorigin+my)*mz;
   int mxstride=mx*stride;
-  unsigned int myz=my*mz;
+  int myz=my*mz;
   unsigned int origin=xorigin*stride+yorigin*mz;
   
-  f[origin].im=0.0;
+  for(int i=stride; i < mxstride; i += stride) {
+    f[origin-i]=0.0;
+    f[origin+i] *= 2.0;
+  }
+  
+  parallel(2*mx-1,HalfXY(f+origin,(1-(int) mx)*stride,stride,mz,myz),
+           threads);
+}
 
-  for(int i=stride; i < mxstride; i += stride)
-    f[origin-i]=conj(f[origin+i]);
+// Enforce 4D Hermiticity using specified (x,y,z > 0,w=0),
+// (x,y > 0,z=0,w=0), and (x >= 0,y=0,z=0,w=0) data.
+inline void HermitianSymmetrizeXYZ(unsigned int mx, unsigned int my,
+                                   unsigned int mz, unsigned int mw,
+                                   unsigned int xorigin, unsigned int yorigin,
+                                   unsigned int zorigin, Complex *f,
+                                   unsigned int threads=fftw::maxthreads)
+{
+  int ystride=(zorigin+mz)*mw;
+  int xstride=(yorigin+my)*ystride;
+  int origin=xorigin*xstride+yorigin*ystride+zorigin*mw;
   
-  PARALLEL(
-    for(int i=stride-mxstride; i < mxstride; i += stride) {
-      int stop=i+myz;
-      for(int j=i+mz; j < stop; j += mz) {
-        f[origin-j]=conj(f[origin+j]);
-      }
-    }
-    );
+  HermitianSymmetrizeXY(mx,my,ystride,xorigin,yorigin,f+zorigin*mw,threads);
+  
+  parallel(2*mx-1,ReflectXYZ(f+origin,(1-(int) mx)*xstride,xstride,my,
+                             ystride,mz*mw,mw),threads);
 }
 
 typedef unsigned int IndexFunction(unsigned int, unsigned int m);
 
+// Convolve row index of a Hermitian subconvolution (without symmetrizing).
+inline void hconvolve(ImplicitHConvolution *C, Complex **F,
+                      realmultiplier *pmult, unsigned int index,
+                      unsigned int offset)
+{
+  C->convolve(F,pmult,index,offset);
+}
+
+template<class T>
+inline void hconvolve(T *C, Complex **F, realmultiplier *pmult,
+                      unsigned int index, unsigned int offset)
+{
+  C->convolve(F,pmult,false,index,offset);
+}
+
+// Loop body that convolves block i of a Hermitian subconvolution with the
+// per-thread engines C[thread].
+template<class T>
+struct HSubconvolution {
+  T **C;
+  Complex **F;
+  realmultiplier *pmult;
+  IndexFunction *indexfunction;
+  unsigned int mx,stride,offset;
+  HSubconvolution(T **C, Complex **F, realmultiplier *pmult,
+                  IndexFunction indexfunction, unsigned int mx,
+                  unsigned int stride, unsigned int offset) :
+    C(C), F(F), pmult(pmult), indexfunction(indexfunction), mx(mx),
+    stride(stride), offset(offset) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    hconvolve(C[thread],F,pmult,indexfunction(i,mx),offset+i*stride);
+  }
+};
+
 class ImplicitHConvolution2 : public ThreadBase {
 protected:
   unsigned int mx,my;
@@ -786,6 +1213,7 @@ protected:
   bool allocated;
   unsigned int indexsize;
   bool toplevel;
+  bool implicitsymmetry;
 public:
   unsigned int *index;
 
@@ -821,6 +1249,7 @@ public:
   void init(const convolveOptions& options) {
     unsigned int C=max(A,B);
     toplevel=options.toplevel;
+    implicitsymmetry=false;
     xfftpad=xcompact ? new fft0pad(mx,options.ny,options.ny,u2) :
       new fft1pad(mx,options.ny,options.ny,u2);
     
@@ -900,12 +1329,23 @@ public:
     }
   }
 
+  // Symmetrize by zeroing the (x < 0,y=0) data and doubling the
+  // (x > 0,y=0) data instead of reflecting it: the (x < 0,y=0) input is
+  // then never read.
+  void ImplicitSymmetry(bool flag=true) {
+    implicitsymmetry=flag;
+  }
+  
   void backwards(Complex **F, Complex **U2, unsigned int ny,
                  bool symmetrize, unsigned int offset) {
     for(unsigned int a=0; a < A; ++a) {
       Complex *f=F[a]+offset;
-      if(symmetrize)
-        HermitianSymmetrizeX(mx,ny,mx-xcompact,f);
+      if(symmetrize) {
+        if(implicitsymmetry)
+          HermitianHalfX(mx,ny,mx-xcompact,f);
+        else
+          HermitianSymmetrizeX(mx,ny,mx-xcompact,f,threads);
+      }
       xfftpad->backwards(f,U2[a]);
     }
   }
@@ -914,18 +1354,8 @@ public:
                       IndexFunction indexfunction,
                       unsigned int M, unsigned int stride,
                       unsigned int offset=0) {
-    if(threads > 1) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-      for(unsigned int i=0; i < M; ++i)
-        yconvolve[get_thread_num()]->convolve(F,pmult,indexfunction(i,mx),
-                                              offset+i*stride);
-    } else {
-      ImplicitHConvolution *yconvolve0=yconvolve[0];
-      for(unsigned int i=0; i < M; ++i)
-        yconvolve0->convolve(F,pmult,indexfunction(i,mx),offset+i*stride);
-    }
+    parallel(M,HSubconvolution<ImplicitHConvolution>
+             (yconvolve,F,pmult,indexfunction,mx,stride,offset),threads);
   }  
   
   void forwards(Complex **F, Complex **U2, unsigned int offset) {
@@ -960,6 +1390,23 @@ public:
     Complex *F[]={f,g};
     convolve(F,multbinary,symmetrize);
   }
+  
+  // Binary correlation (identical to the convolution for Hermitian data):
+  void correlate(Complex *f, Complex *g, bool symmetrize=true) {
+    Complex *F[]={f,g};
+    convolve(F,multcorrelation,symmetrize);
+  }
+  
+  // The following routines require A=1.
+  void autoconvolve(Complex *f, bool symmetrize=true) {
+    Complex *F[]={f};
+    convolve(F,multautoconvolution,symmetrize);
+  }
+  
+  void autocorrelate(Complex *f, bool symmetrize=true) {
+    Complex *F[]={f};
+    convolve(F,multautocorrelation,symmetrize);
+  }
 };
   
 // In-place implicitly dealiased 3D complex convolution.
@@ -1092,18 +1539,8 @@ public:
   void subconvolution(Complex **F, multiplier *pmult, 
                       unsigned int r, unsigned int M, unsigned int stride,
                       unsigned int offset=0) {
-    if(threads > 1) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-      for(unsigned int i=0; i < M; ++i)
-        yzconvolve[get_thread_num()]->convolve(F,pmult,2*i+r,offset+i*stride);
-    } else {
-      ImplicitConvolution2 *yzconvolve0=yzconvolve[0];
-      for(unsigned int i=0; i < M; ++i) {
-        yzconvolve0->convolve(F,pmult,2*i+r,offset+i*stride);
-      }
-    }
+    parallel(M,Subconvolution<ImplicitConvolution2>
+             (yzconvolve,F,pmult,r,stride,offset),threads);
   }
   
   void forwards(Complex **F, Complex **U3, unsigned int offset=0) {
@@ -1156,145 +1593,767 @@ public:
   }
 };
 
-// In-place implicitly dealiased 3D Hermitian convolution.
-class ImplicitHConvolution3 : public ThreadBase {
+// In-place implicitly dealiased 4D complex convolution.
+class ImplicitConvolution4 : public ThreadBase {
 protected:
-  unsigned int mx,my,mz;
-  bool xcompact,ycompact,zcompact;
+  unsigned int mx,my,mz,mw;
   Complex *u1;
   Complex *u2;
   Complex *u3;
+  Complex *u4;
   unsigned int A,B;
-  fft0pad *xfftpad;
-  ImplicitHConvolution2 **yzconvolve;
-  Complex **U3;
+  fftpad *xfftpad;
+  ImplicitConvolution3 **yzwconvolve;
+  Complex **U4;
   bool allocated;
   unsigned int indexsize;
   bool toplevel;
-public:     
+public:  
   unsigned int *index;
-  
-  void initpointers3(Complex **&U3, Complex *u3, unsigned int stride) {
+
+  void initpointers4(Complex **&U4, Complex *u4, unsigned int stride) {
     unsigned int C=max(A,B);
-    U3=new Complex *[C];
+    U4=new Complex *[C];
     for(unsigned int a=0; a < C; ++a)
-      U3[a]=u3+a*stride;
+      U4[a]=u4+a*stride;
     
-    if(toplevel) allocateindex(2,new unsigned int[2]);
+    if(toplevel) allocateindex(3,new unsigned int[3]);
   }
   
-  void deletepointers3(Complex **&U3) {
+  void deletepointers4(Complex **&U4) {
     if(toplevel) {
       delete [] index;
       
       for(unsigned int t=1; t < threads; ++t)
-        delete [] yzconvolve[t]->index;
+        delete [] yzwconvolve[t]->index;
     }
       
-    delete [] U3;
+    delete [] U4;
   }
-    
+  
   void allocateindex(unsigned int n, unsigned int *i) {
     indexsize=n;
     index=i;
-    yzconvolve[0]->allocateindex(n,i);
+    yzwconvolve[0]->allocateindex(n,i);
     for(unsigned int t=1; t < threads; ++t)
-      yzconvolve[t]->allocateindex(n,new unsigned int[n]);
+      yzwconvolve[t]->allocateindex(n,new unsigned int[n]);
   }
   
   void init(const convolveOptions& options) {
     toplevel=options.toplevel;
-    unsigned int nyz=options.ny*options.nz;
-    xfftpad=xcompact ? new fft0pad(mx,nyz,nyz,u3) :
-      new fft1pad(mx,nyz,nyz,u3);
-
-      if(options.nz == mz+!zcompact) {
-      unsigned int C=max(A,B);
-      yzconvolve=new ImplicitHConvolution2*[threads];
-      for(unsigned int t=0; t < threads; ++t)
-        yzconvolve[t]=new ImplicitHConvolution2(my,mz,
-                                                ycompact,zcompact,
-                                                u1+t*(mz/2+1)*C*innerthreads,
-                                                u2+t*options.stride2*C,
-                                                A,B,innerthreads,false);
-      initpointers3(U3,u3,options.stride3);
-    } else yzconvolve=NULL;
-  }
-  
-  void set(convolveOptions& options) {
-    if(options.ny == 0) {
-      options.ny=2*my-ycompact;
-      options.nz=mz+!zcompact;
-      options.stride2=(my+ycompact)*options.nz;
-      options.stride3=(mx+xcompact)*options.ny*options.nz;
-    }
+    unsigned int nyzw=my*mz*mw;
+    xfftpad=new fftpad(mx,nyzw,nyzw,u4,threads);
+    
+    unsigned int C=max(A,B);
+    unsigned int C1=mw*C*innerthreads;
+    unsigned int C2=mz*mw*C*innerthreads;
+    yzwconvolve=new ImplicitConvolution3*[threads];
+    for(unsigned int t=0; t < threads; ++t)
+      yzwconvolve[t]=new ImplicitConvolution3(my,mz,mw,u1+t*C1,u2+t*C2,
+                                              u3+t*nyzw*C,A,B,innerthreads,
+                                              false);
+    initpointers4(U4,u4,mx*nyzw);
   }
   
-  // u1 is a temporary array of size (mz/2+1)*C*threads.
-  // u2 is a temporary array of size (my+ycompact)*(mz+!zcompact)*C*threads.
-  // u3 is a temporary array of size 
-  //                             (mx+xcompact)*(2my-ycompact)*(mz+!zcompact)*C.
+  // u1 is a temporary array of size mw*C*threads.
+  // u2 is a temporary array of size mz*mw*C*threads.
+  // u3 is a temporary array of size my*mz*mw*C*threads.
+  // u4 is a temporary array of size mx*my*mz*mw*C.
   // A is the number of inputs.
   // B is the number of outputs.
   // Here C=max(A,B).
-  ImplicitHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
-                        Complex *u1, Complex *u2, Complex *u3,
-                        unsigned int A=2, unsigned int B=1,
-                        unsigned int threads=fftw::maxthreads,
-                        convolveOptions options=defaultconvolveOptions) :
-    ThreadBase(threads), mx(mx), my(my), mz(mz),
-    xcompact(true), ycompact(true), zcompact(true), u1(u1), u2(u2), u3(u3),
-    A(A), B(B),
-    allocated(false) {
-    set(options);
-    multithread(mx);
-    init(options);
-  }
-  
-  ImplicitHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
-                        bool xcompact, bool ycompact, bool zcompact,
-                        Complex *u1, Complex *u2, Complex *u3,
-                        unsigned int A=2, unsigned int B=1,
-                        unsigned int threads=fftw::maxthreads,
-                        convolveOptions options=defaultconvolveOptions) :
-    ThreadBase(threads), mx(mx), my(my), mz(mz),
-    xcompact(xcompact), ycompact(ycompact), zcompact(zcompact), 
-    u1(u1), u2(u2), u3(u3), A(A), B(B), allocated(false) {
-    set(options);
+  ImplicitConvolution4(unsigned int mx, unsigned int my, unsigned int mz,
+                       unsigned int mw,
+                       Complex *u1, Complex *u2, Complex *u3, Complex *u4,
+                       unsigned int A=2, unsigned int B=1, 
+                       unsigned int threads=fftw::maxthreads,
+                       convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), mw(mw),
+    u1(u1), u2(u2), u3(u3), u4(u4), A(A), B(B), allocated(false) {
     multithread(mx);
     init(options);
   }
-  
-  ImplicitHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
-                        bool xcompact=true, bool ycompact=true,
-                        bool zcompact=true,
-                        unsigned int A=2, unsigned int B=1,
-                        unsigned int threads=fftw::maxthreads,
-                        convolveOptions options=defaultconvolveOptions) :
-    ThreadBase(threads), mx(mx), my(my), mz(mz),
-    xcompact(xcompact), ycompact(ycompact), zcompact(zcompact), A(A), B(B),
+
+  ImplicitConvolution4(unsigned int mx, unsigned int my, unsigned int mz,
+                       unsigned int mw,
+                       unsigned int A=2, unsigned int B=1, 
+                       unsigned int threads=fftw::maxthreads,
+                       convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), mw(mw), A(A), B(B),
     allocated(true) {
-    set(options);
     multithread(mx);
     unsigned int C=max(A,B);
-    u1=utils::ComplexAlign((mz/2+1)*C*threads*innerthreads);
-    u2=utils::ComplexAlign(options.stride2*C*threads);
-    u3=utils::ComplexAlign(options.stride3*C);
+    u1=utils::ComplexAlign(mw*C*threads*innerthreads);
+    u2=utils::ComplexAlign(mz*mw*C*threads*innerthreads);
+    u3=utils::ComplexAlign(my*mz*mw*C*threads);
+    u4=utils::ComplexAlign(mx*my*mz*mw*C);
     init(options);
   }
   
-  virtual ~ImplicitHConvolution3() {
-    if(yzconvolve) {
-      deletepointers3(U3);
-      
-      for(unsigned int t=0; t < threads; ++t)
-        delete yzconvolve[t];
-      delete [] yzconvolve;
+  virtual ~ImplicitConvolution4() {
+    deletepointers4(U4);
+
+    for(unsigned int t=0; t < threads; ++t)
+      delete yzwconvolve[t];
+    delete [] yzwconvolve;
+    
+    delete xfftpad;
+    
+    if(allocated) {
+      utils::deleteAlign(u4);
+      utils::deleteAlign(u3);
+      utils::deleteAlign(u2);
+      utils::deleteAlign(u1);
+    }
+  }
+  
+  void backwards(Complex **F, Complex **U4, unsigned int offset) {
+    for(unsigned int a=0; a < A; ++a)
+      xfftpad->backwards(F[a]+offset,U4[a]);
+  }
+
+  void subconvolution(Complex **F, multiplier *pmult, 
+                      unsigned int r, unsigned int M, unsigned int stride,
+                      unsigned int offset=0) {
+    parallel(M,Subconvolution<ImplicitConvolution3>
+             (yzwconvolve,F,pmult,r,stride,offset),threads);
+  }
+  
+  void forwards(Complex **F, Complex **U4, unsigned int offset=0) {
+    for(unsigned int b=0; b < B; ++b)
+      xfftpad->forwards(F[b]+offset,U4[b]);
+  }
+  
+  // F is a pointer to A distinct data blocks each of size mx*my*mz*mw,
+  // shifted by offset (contents not preserved).
+  virtual void convolve(Complex **F, multiplier *pmult, unsigned int i=0,
+                        unsigned int offset=0)
+  {
+    if(!toplevel) {
+      index[indexsize-4]=i;
+      if(threads > 1) {
+        for(unsigned int t=1; t < threads; ++t) {
+          unsigned int *Index=yzwconvolve[t]->index;
+          for(unsigned int i=0; i < indexsize; ++i)
+            Index[i]=index[i];
+        }
+      }
+    }
+    unsigned int stride=my*mz*mw;
+    backwards(F,U4,offset);
+    subconvolution(F,pmult,0,mx,stride,offset);
+    subconvolution(U4,pmult,1,mx,stride);
+    forwards(F,U4,offset);
+  }
+  
+  // Binary convolution:
+  void convolve(Complex *f, Complex *g) {
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+
+  // Binary correlation:
+  void correlate(Complex *f, Complex *g) {
+    Complex *F[]={f, g};
+    convolve(F,multcorrelation);
+  }
+
+  void autoconvolve(Complex *f) {
+    Complex *F[]={f};
+    convolve(F,multautoconvolution);
+  }
+
+  void autocorrelate(Complex *f) {
+    Complex *F[]={f};
+    convolve(F,multautocorrelation);
+  }
+};
+
+// In-place implicitly dealiased complex convolution of rank D, for the
+// ranks beyond ImplicitConvolution4. The outermost dimension is padded with
+// fftpad and each slab is convolved by an ImplicitConvolutionN<D-1>,
+// terminating in ImplicitConvolution.
+// The top-level object chooses between threading the outer loop and
+// threading the subconvolutions by timing both.
+template<unsigned int D>
+class ImplicitConvolutionN : public ThreadBase {
+protected:
+  unsigned int m[D];
+  unsigned int A,B;
+  unsigned int stride;   // size of each slab
+  Complex *u;
+  fftpad *xfftpad;
+  ImplicitConvolutionN<D-1> **subconvolve;
+  Complex **U;
+  unsigned int indexsize;
+  bool toplevel;
+public:  
+  unsigned int *index;
+
+  static void multnone(Complex **, unsigned int, const unsigned int,
+                       const unsigned int *, unsigned int, unsigned int) {}
+  
+  ImplicitConvolutionN<D-1> **subconvolutions(unsigned int n,
+                                              unsigned int inner) {
+    ImplicitConvolutionN<D-1> **sub=new ImplicitConvolutionN<D-1>*[n];
+    for(unsigned int t=0; t < n; ++t)
+      sub[t]=new ImplicitConvolutionN<D-1>(m+1,A,B,inner,false);
+    return sub;
+  }
+  
+  void deletesubconvolutions(ImplicitConvolutionN<D-1> **sub,
+                             unsigned int n) {
+    for(unsigned int t=0; t < n; ++t) {
+      if(toplevel && t > 0) delete [] sub[t]->index;
+      delete sub[t];
+    }
+    delete [] sub;
+  }
+  
+  void allocateindex(unsigned int n, unsigned int *i) {
+    indexsize=n;
+    index=i;
+    subconvolve[0]->allocateindex(n,i);
+    for(unsigned int t=1; t < threads; ++t)
+      subconvolve[t]->allocateindex(n,new unsigned int[n]);
+  }
+  
+  // Time the current threading choice against the alternative of
+  // (threads,innerthreads)=(Threads,1) or (1,Threads), keeping the faster.
+  void measure(unsigned int Threads) {
+    unsigned int threads0=threads;
+    unsigned int innerthreads0=innerthreads;
+    ImplicitConvolutionN<D-1> **sub0=subconvolve;
+    
+    bool outer=threads > 1;
+    unsigned int threads1=outer ? 1 : Threads;
+    unsigned int innerthreads1=outer ? Threads : 1;
+    ImplicitConvolutionN<D-1> **sub1=subconvolutions(threads1,innerthreads1);
+    threads=threads1;
+    subconvolve=sub1;
+    allocateindex(indexsize,index);
+    
+    unsigned int C=max(A,B);
+    unsigned int size=m[0]*stride;
+    Complex *f=utils::ComplexAlign(C*size);
+    Complex **F=new Complex *[C];
+    for(unsigned int a=0; a < C; ++a) {
+      F[a]=f+a*size;
+      for(unsigned int i=0; i < size; ++i)
+        F[a][i]=0.0;
+    }
+    
+    utils::statistics S0,S1;
+    double stop=utils::totalseconds()+fftw::testseconds;
+    unsigned int N=1;
+    for(;;) {
+      double t0=utils::totalseconds();
+      threads=threads0;
+      subconvolve=sub0;
+      for(unsigned int i=0; i < N; ++i)
+        convolve(F,multnone);
+      double t1=utils::totalseconds();
+      threads=threads1;
+      subconvolve=sub1;
+      for(unsigned int i=0; i < N; ++i)
+        convolve(F,multnone);
+      double t=utils::totalseconds();
+      S0.add(t1-t0);
+      S1.add(t-t1);
+      if(S0.mean() < 100.0/CLOCKS_PER_SEC) N *= 2;
+      if(S0.count() >= 10 || t > stop) break;
+    }
+    
+    delete [] F;
+    utils::deleteAlign(f);
+    
+    if(S1.mean() < S0.mean()) {
+      innerthreads=innerthreads1;
+      deletesubconvolutions(sub0,threads0);
+    } else {
+      threads=threads0;
+      innerthreads=innerthreads0;
+      subconvolve=sub0;
+      deletesubconvolutions(sub1,threads1);
+    }
+  }
+  
+  // m is an array of the D dimensions, outermost first.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ImplicitConvolutionN(const unsigned int *M, unsigned int A=2,
+                       unsigned int B=1,
+                       unsigned int threads=fftw::maxthreads,
+                       bool toplevel=true) :
+    ThreadBase(threads), A(A), B(B), toplevel(toplevel) {
+    for(unsigned int d=0; d < D; ++d)
+      m[d]=M[d];
+    stride=1;
+    for(unsigned int d=1; d < D; ++d)
+      stride *= m[d];
+    
+    unsigned int C=max(A,B);
+    unsigned int size=m[0]*stride;
+    u=utils::ComplexAlign(C*size);
+    U=new Complex *[C];
+    for(unsigned int a=0; a < C; ++a)
+      U[a]=u+a*size;
+    
+    xfftpad=new fftpad(m[0],stride,stride,u,threads);
+    
+    multithread(m[0]);
+    subconvolve=subconvolutions(this->threads,innerthreads);
+    if(toplevel) {
+      allocateindex(D-1,new unsigned int[D-1]);
+      if(threads > 1 && m[0] > 1) measure(threads);
+    }
+  }
+  
+  virtual ~ImplicitConvolutionN() {
+    if(toplevel) delete [] index;
+    deletesubconvolutions(subconvolve,threads);
+    delete xfftpad;
+    delete [] U;
+    utils::deleteAlign(u);
+  }
+  
+  void backwards(Complex **F, Complex **U, unsigned int offset) {
+    for(unsigned int a=0; a < A; ++a)
+      xfftpad->backwards(F[a]+offset,U[a]);
+  }
+
+  void subconvolution(Complex **F, multiplier *pmult, 
+                      unsigned int r, unsigned int offset=0) {
+    parallel(m[0],Subconvolution<ImplicitConvolutionN<D-1> >
+             (subconvolve,F,pmult,r,stride,offset),threads);
+  }
+  
+  void forwards(Complex **F, Complex **U, unsigned int offset=0) {
+    for(unsigned int b=0; b < B; ++b)
+      xfftpad->forwards(F[b]+offset,U[b]);
+  }
+  
+  // F is a pointer to A distinct data blocks each of size m[0]*...*m[D-1],
+  // shifted by offset (contents not preserved).
+  void convolve(Complex **F, multiplier *pmult, unsigned int i=0,
+                unsigned int offset=0) {
+    if(!toplevel) {
+      index[indexsize-D]=i;
+      if(threads > 1) {
+        for(unsigned int t=1; t < threads; ++t) {
+          unsigned int *Index=subconvolve[t]->index;
+          for(unsigned int i=0; i < indexsize; ++i)
+            Index[i]=index[i];
+        }
+      }
+    }
+    backwards(F,U,offset);
+    subconvolution(F,pmult,0,offset);
+    subconvolution(U,pmult,1);
+    forwards(F,U,offset);
+  }
+  
+  // Binary convolution:
+  void convolve(Complex *f, Complex *g) {
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+
+  // Binary correlation:
+  void correlate(Complex *f, Complex *g) {
+    Complex *F[]={f, g};
+    convolve(F,multcorrelation);
+  }
+
+  void autoconvolve(Complex *f) {
+    Complex *F[]={f};
+    convolve(F,multautoconvolution);
+  }
+
+  void autocorrelate(Complex *f) {
+    Complex *F[]={f};
+    convolve(F,multautocorrelation);
+  }
+};
+
+// The one-dimensional leaf of ImplicitConvolutionN.
+template<>
+class ImplicitConvolutionN<1> : public ImplicitConvolution {
+public:
+  ImplicitConvolutionN(const unsigned int *m, unsigned int A=2,
+                       unsigned int B=1,
+                       unsigned int threads=fftw::maxthreads,
+                       bool toplevel=true) :
+    ImplicitConvolution(m[0],A,B,threads) {}
+};
+
+// In-place implicitly dealiased 3D Hermitian convolution.
+class ImplicitHConvolution3 : public ThreadBase {
+protected:
+  unsigned int mx,my,mz;
+  bool xcompact,ycompact,zcompact;
+  Complex *u1;
+  Complex *u2;
+  Complex *u3;
+  unsigned int A,B;
+  fft0pad *xfftpad;
+  ImplicitHConvolution2 **yzconvolve;
+  Complex **U3;
+  bool allocated;
+  unsigned int indexsize;
+  bool toplevel;
+  bool implicitsymmetry;
+public:     
+  unsigned int *index;
+  
+  void initpointers3(Complex **&U3, Complex *u3, unsigned int stride) {
+    unsigned int C=max(A,B);
+    U3=new Complex *[C];
+    for(unsigned int a=0; a < C; ++a)
+      U3[a]=u3+a*stride;
+    
+    if(toplevel) allocateindex(2,new unsigned int[2]);
+  }
+  
+  void deletepointers3(Complex **&U3) {
+    if(toplevel) {
+      delete [] index;
+      
+      for(unsigned int t=1; t < threads; ++t)
+        delete [] yzconvolve[t]->index;
+    }
+      
+    delete [] U3;
+  }
+    
+  void allocateindex(unsigned int n, unsigned int *i) {
+    indexsize=n;
+    index=i;
+    yzconvolve[0]->allocateindex(n,i);
+    for(unsigned int t=1; t < threads; ++t)
+      yzconvolve[t]->allocateindex(n,new unsigned int[n]);
+  }
+  
+  void init(const convolveOptions& options) {
+    toplevel=options.toplevel;
+    implicitsymmetry=false;
+    unsigned int nyz=options.ny*options.nz;
+    xfftpad=xcompact ? new fft0pad(mx,nyz,nyz,u3) :
+      new fft1pad(mx,nyz,nyz,u3);
+
+      if(options.nz == mz+!zcompact) {
+      unsigned int C=max(A,B);
+      yzconvolve=new ImplicitHConvolution2*[threads];
+      for(unsigned int t=0; t < threads; ++t)
+        yzconvolve[t]=new ImplicitHConvolution2(my,mz,
+                                                ycompact,zcompact,
+                                                u1+t*(mz/2+1)*C*innerthreads,
+                                                u2+t*options.stride2*C,
+                                                A,B,innerthreads,false);
+      initpointers3(U3,u3,options.stride3);
+    } else yzconvolve=NULL;
+  }
+  
+  void set(convolveOptions& options) {
+    if(options.ny == 0) {
+      options.ny=2*my-ycompact;
+      options.nz=mz+!zcompact;
+      options.stride2=(my+ycompact)*options.nz;
+      options.stride3=(mx+xcompact)*options.ny*options.nz;
+    }
+  }
+  
+  // u1 is a temporary array of size (mz/2+1)*C*threads.
+  // u2 is a temporary array of size (my+ycompact)*(mz+!zcompact)*C*threads.
+  // u3 is a temporary array of size 
+  //                             (mx+xcompact)*(2my-ycompact)*(mz+!zcompact)*C.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  // Here C=max(A,B).
+  ImplicitHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                        Complex *u1, Complex *u2, Complex *u3,
+                        unsigned int A=2, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads,
+                        convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz),
+    xcompact(true), ycompact(true), zcompact(true), u1(u1), u2(u2), u3(u3),
+    A(A), B(B),
+    allocated(false) {
+    set(options);
+    multithread(mx);
+    init(options);
+  }
+  
+  ImplicitHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                        bool xcompact, bool ycompact, bool zcompact,
+                        Complex *u1, Complex *u2, Complex *u3,
+                        unsigned int A=2, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads,
+                        convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz),
+    xcompact(xcompact), ycompact(ycompact), zcompact(zcompact), 
+    u1(u1), u2(u2), u3(u3), A(A), B(B), allocated(false) {
+    set(options);
+    multithread(mx);
+    init(options);
+  }
+  
+  ImplicitHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                        bool xcompact=true, bool ycompact=true,
+                        bool zcompact=true,
+                        unsigned int A=2, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads,
+                        convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz),
+    xcompact(xcompact), ycompact(ycompact), zcompact(zcompact), A(A), B(B),
+    allocated(true) {
+    set(options);
+    multithread(mx);
+    unsigned int C=max(A,B);
+    u1=utils::ComplexAlign((mz/2+1)*C*threads*innerthreads);
+    u2=utils::ComplexAlign(options.stride2*C*threads);
+    u3=utils::ComplexAlign(options.stride3*C);
+    init(options);
+  }
+  
+  virtual ~ImplicitHConvolution3() {
+    if(yzconvolve) {
+      deletepointers3(U3);
+      
+      for(unsigned int t=0; t < threads; ++t)
+        delete yzconvolve[t];
+      delete [] yzconvolve;
+    }
+
+    delete xfftpad;
+    
+    if(allocated) {
+      utils::deleteAlign(u3);
+      utils::deleteAlign(u2);
+      utils::deleteAlign(u1);
+    }
+  }
+  
+  virtual void HermitianSymmetrize(Complex *f, Complex *u)
+  {      
+    HermitianSymmetrizeXY(mx,my,mz+!zcompact,mx-xcompact,my-ycompact,f,
+                          threads);
+  }
+  
+  virtual void HermitianHalf(Complex *f)
+  {      
+    HermitianHalfXY(mx,my,mz+!zcompact,mx-xcompact,my-ycompact,f,threads);
+  }
+  
+  // Symmetrize by zeroing the unspecified half of the z=0 plane and
+  // doubling the specified half instead of reflecting it: the unspecified
+  // half is then never read and no data is exchanged between processes.
+  void ImplicitSymmetry(bool flag=true) {
+    implicitsymmetry=flag;
+  }
+  
+  void backwards(Complex **F, Complex **U3, bool symmetrize,
+                 unsigned int offset) {
+    for(unsigned int a=0; a < A; ++a) {
+      Complex *f=F[a]+offset;
+      Complex *u=U3[a];
+      if(symmetrize) {
+        if(implicitsymmetry)
+          HermitianHalf(f);
+        else
+          HermitianSymmetrize(f,u);
+      }
+      xfftpad->backwards(f,u);
     }
+  }
+
+  void subconvolution(Complex **F, realmultiplier *pmult,
+                      IndexFunction indexfunction,
+                      unsigned int M, unsigned int stride,
+                      unsigned int offset=0) {
+    parallel(M,HSubconvolution<ImplicitHConvolution2>
+             (yzconvolve,F,pmult,indexfunction,mx,stride,offset),threads);
+  }
+
+  void forwards(Complex **F, Complex **U3, unsigned int offset=0) {
+    for(unsigned int b=0; b < B; ++b)
+      xfftpad->forwards(F[b]+offset,U3[b]);
+  }
+  
+  // F is a pointer to A distinct data blocks each of size
+  // (2mx-compact)*(2my-ycompact)*(mz+!zcompact), shifted by offset 
+  // (contents not preserved).
+  virtual void convolve(Complex **F, realmultiplier *pmult,
+                        bool symmetrize=true, unsigned int i=0,
+                        unsigned int offset=0) {
+    if(!toplevel) {
+      index[indexsize-3]=i;
+      if(threads > 1) {
+        for(unsigned int t=1; t < threads; ++t) {
+          unsigned int *Index=yzconvolve[t]->index;
+          for(unsigned int i=0; i < indexsize; ++i)
+            Index[i]=index[i];
+        }
+      }
+    }    
+    unsigned int stride=(2*my-ycompact)*(mz+!zcompact);
+    backwards(F,U3,symmetrize,offset);
+    subconvolution(F,pmult,xfftpad->findex,2*mx-xcompact,stride,offset);
+    subconvolution(U3,pmult,xfftpad->uindex,mx+xcompact,stride);
+    forwards(F,U3,offset);
+  }
+    
+  // Binary convolution:
+  void convolve(Complex *f, Complex *g, bool symmetrize=true) {
+    Complex *F[]={f,g};
+    convolve(F,multbinary,symmetrize);
+  }
+  
+  // Binary correlation (identical to the convolution for Hermitian data):
+  void correlate(Complex *f, Complex *g, bool symmetrize=true) {
+    Complex *F[]={f,g};
+    convolve(F,multcorrelation,symmetrize);
+  }
+  
+  // The following routines require A=1.
+  void autoconvolve(Complex *f, bool symmetrize=true) {
+    Complex *F[]={f};
+    convolve(F,multautoconvolution,symmetrize);
+  }
+  
+  void autocorrelate(Complex *f, bool symmetrize=true) {
+    Complex *F[]={f};
+    convolve(F,multautocorrelation,symmetrize);
+  }
+};
+
+// In-place implicitly dealiased 4D Hermitian convolution.
+class ImplicitHConvolution4 : public ThreadBase {
+protected:
+  unsigned int mx,my,mz,mw;
+  bool xcompact,ycompact,zcompact,wcompact;
+  Complex *u1;
+  Complex *u2;
+  Complex *u3;
+  Complex *u4;
+  unsigned int A,B;
+  fft0pad *xfftpad;
+  ImplicitHConvolution3 **yzwconvolve;
+  Complex **U4;
+  bool allocated;
+  unsigned int indexsize;
+  bool toplevel;
+  unsigned int ny,nz,nw;
+public:     
+  unsigned int *index;
+  
+  void initpointers4(Complex **&U4, Complex *u4, unsigned int stride) {
+    unsigned int C=max(A,B);
+    U4=new Complex *[C];
+    for(unsigned int a=0; a < C; ++a)
+      U4[a]=u4+a*stride;
+    
+    if(toplevel) allocateindex(3,new unsigned int[3]);
+  }
+  
+  void deletepointers4(Complex **&U4) {
+    if(toplevel) {
+      delete [] index;
+      
+      for(unsigned int t=1; t < threads; ++t)
+        delete [] yzwconvolve[t]->index;
+    }
+      
+    delete [] U4;
+  }
+    
+  void allocateindex(unsigned int n, unsigned int *i) {
+    indexsize=n;
+    index=i;
+    yzwconvolve[0]->allocateindex(n,i);
+    for(unsigned int t=1; t < threads; ++t)
+      yzwconvolve[t]->allocateindex(n,new unsigned int[n]);
+  }
+  
+  void init(const convolveOptions& options) {
+    toplevel=options.toplevel;
+    ny=2*my-ycompact;
+    nz=2*mz-zcompact;
+    nw=mw+!wcompact;
+    unsigned int nyzw=ny*nz*nw;
+    xfftpad=xcompact ? new fft0pad(mx,nyzw,nyzw,u4) :
+      new fft1pad(mx,nyzw,nyzw,u4);
+
+    unsigned int C=max(A,B);
+    unsigned int C1=(mw/2+1)*C*innerthreads;
+    unsigned int C2=(mz+zcompact)*nw*C*innerthreads;
+    unsigned int C3=(my+ycompact)*nz*nw*C;
+    yzwconvolve=new ImplicitHConvolution3*[threads];
+    for(unsigned int t=0; t < threads; ++t)
+      yzwconvolve[t]=new ImplicitHConvolution3(my,mz,mw,
+                                               ycompact,zcompact,wcompact,
+                                               u1+t*C1,u2+t*C2,u3+t*C3,
+                                               A,B,innerthreads,false);
+    initpointers4(U4,u4,(mx+xcompact)*nyzw);
+  }
+  
+  // u1 is a temporary array of size (mw/2+1)*C*threads.
+  // u2 is a temporary array of size (mz+zcompact)*(mw+!wcompact)*C*threads.
+  // u3 is a temporary array of size
+  //                (my+ycompact)*(2mz-zcompact)*(mw+!wcompact)*C*threads.
+  // u4 is a temporary array of size 
+  //   (mx+xcompact)*(2my-ycompact)*(2mz-zcompact)*(mw+!wcompact)*C.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  // Here C=max(A,B).
+  ImplicitHConvolution4(unsigned int mx, unsigned int my, unsigned int mz,
+                        unsigned int mw,
+                        bool xcompact, bool ycompact, bool zcompact,
+                        bool wcompact,
+                        Complex *u1, Complex *u2, Complex *u3, Complex *u4,
+                        unsigned int A=2, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads,
+                        convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), mw(mw),
+    xcompact(xcompact), ycompact(ycompact), zcompact(zcompact),
+    wcompact(wcompact), u1(u1), u2(u2), u3(u3), u4(u4), A(A), B(B),
+    allocated(false) {
+    multithread(mx);
+    init(options);
+  }
+  
+  ImplicitHConvolution4(unsigned int mx, unsigned int my, unsigned int mz,
+                        unsigned int mw,
+                        bool xcompact=true, bool ycompact=true,
+                        bool zcompact=true, bool wcompact=true,
+                        unsigned int A=2, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads,
+                        convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), mw(mw),
+    xcompact(xcompact), ycompact(ycompact), zcompact(zcompact),
+    wcompact(wcompact), A(A), B(B), allocated(true) {
+    multithread(mx);
+    unsigned int C=max(A,B);
+    unsigned int nw=mw+!wcompact;
+    unsigned int nz=2*mz-zcompact;
+    u1=utils::ComplexAlign((mw/2+1)*C*threads*innerthreads);
+    u2=utils::ComplexAlign((mz+zcompact)*nw*C*threads*innerthreads);
+    u3=utils::ComplexAlign((my+ycompact)*nz*nw*C*threads);
+    u4=utils::ComplexAlign((mx+xcompact)*(2*my-ycompact)*nz*nw*C);
+    init(options);
+  }
+  
+  virtual ~ImplicitHConvolution4() {
+    deletepointers4(U4);
+      
+    for(unsigned int t=0; t < threads; ++t)
+      delete yzwconvolve[t];
+    delete [] yzwconvolve;
 
     delete xfftpad;
     
     if(allocated) {
+      utils::deleteAlign(u4);
       utils::deleteAlign(u3);
       utils::deleteAlign(u2);
       utils::deleteAlign(u1);
@@ -1303,15 +2362,15 @@ public:
   
   virtual void HermitianSymmetrize(Complex *f, Complex *u)
   {      
-    HermitianSymmetrizeXY(mx,my,mz+!zcompact,mx-xcompact,my-ycompact,f,
-                          threads);
+    HermitianSymmetrizeXYZ(mx,my,mz,nw,mx-xcompact,my-ycompact,mz-zcompact,f,
+                           threads);
   }
   
-  void backwards(Complex **F, Complex **U3, bool symmetrize,
+  void backwards(Complex **F, Complex **U4, bool symmetrize,
                  unsigned int offset) {
     for(unsigned int a=0; a < A; ++a) {
       Complex *f=F[a]+offset;
-      Complex *u=U3[a];
+      Complex *u=U4[a];
       if(symmetrize)
         HermitianSymmetrize(f,u);
       xfftpad->backwards(f,u);
@@ -1322,48 +2381,36 @@ public:
                       IndexFunction indexfunction,
                       unsigned int M, unsigned int stride,
                       unsigned int offset=0) {
-    if(threads > 1) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-      for(unsigned int i=0; i < M; ++i)
-        yzconvolve[get_thread_num()]->convolve(F,pmult,false,
-                                               indexfunction(i,mx),
-                                               offset+i*stride);
-    } else {
-      ImplicitHConvolution2 *yzconvolve0=yzconvolve[0];
-      for(unsigned int i=0; i < M; ++i)
-        yzconvolve0->convolve(F,pmult,false,indexfunction(i,mx),
-                              offset+i*stride);
-    }
+    parallel(M,HSubconvolution<ImplicitHConvolution3>
+             (yzwconvolve,F,pmult,indexfunction,mx,stride,offset),threads);
   }
 
-  void forwards(Complex **F, Complex **U3, unsigned int offset=0) {
+  void forwards(Complex **F, Complex **U4, unsigned int offset=0) {
     for(unsigned int b=0; b < B; ++b)
-      xfftpad->forwards(F[b]+offset,U3[b]);
+      xfftpad->forwards(F[b]+offset,U4[b]);
   }
   
   // F is a pointer to A distinct data blocks each of size
-  // (2mx-compact)*(2my-ycompact)*(mz+!zcompact), shifted by offset 
-  // (contents not preserved).
+  // (2mx-xcompact)*(2my-ycompact)*(2mz-zcompact)*(mw+!wcompact),
+  // shifted by offset (contents not preserved).
   virtual void convolve(Complex **F, realmultiplier *pmult,
                         bool symmetrize=true, unsigned int i=0,
                         unsigned int offset=0) {
     if(!toplevel) {
-      index[indexsize-3]=i;
+      index[indexsize-4]=i;
       if(threads > 1) {
         for(unsigned int t=1; t < threads; ++t) {
-          unsigned int *Index=yzconvolve[t]->index;
+          unsigned int *Index=yzwconvolve[t]->index;
           for(unsigned int i=0; i < indexsize; ++i)
             Index[i]=index[i];
         }
       }
     }    
-    unsigned int stride=(2*my-ycompact)*(mz+!zcompact);
-    backwards(F,U3,symmetrize,offset);
+    unsigned int stride=ny*nz*nw;
+    backwards(F,U4,symmetrize,offset);
     subconvolution(F,pmult,xfftpad->findex,2*mx-xcompact,stride,offset);
-    subconvolution(U3,pmult,xfftpad->uindex,mx+xcompact,stride);
-    forwards(F,U3,offset);
+    subconvolution(U4,pmult,xfftpad->uindex,mx+xcompact,stride);
+    forwards(F,U4,offset);
   }
     
   // Binary convolution:
@@ -1371,6 +2418,23 @@ public:
     Complex *F[]={f,g};
     convolve(F,multbinary,symmetrize);
   }
+  
+  // Binary correlation (identical to the convolution for Hermitian data):
+  void correlate(Complex *f, Complex *g, bool symmetrize=true) {
+    Complex *F[]={f,g};
+    convolve(F,multcorrelation,symmetrize);
+  }
+  
+  // The following routines require A=1.
+  void autoconvolve(Complex *f, bool symmetrize=true) {
+    Complex *F[]={f};
+    convolve(F,multautoconvolution,symmetrize);
+  }
+  
+  void autocorrelate(Complex *f, bool symmetrize=true) {
+    Complex *F[]={f};
+    convolve(F,multautocorrelation,symmetrize);
+  }
 };
 
 // In-place implicitly dealiased Hermitian ternary convolution.
@@ -1445,6 +2509,8 @@ public:
     delete rc;
   }
   
+  void multBlock(double *a, double *b, double **C, unsigned int offset,
+                 unsigned int n);
   void mult(double *a, double *b, double **C, unsigned int offset=0);
   
   void convolve(Complex **F, Complex **G, Complex **H, 
@@ -1518,6 +2584,7 @@ public:
     delete rc;
   }
   
+  void multBlock(double *a, double *b, unsigned int n);
   void mult(double *a, double *b);
   
   void convolve(Complex *f, Complex *g, Complex *u, Complex *v);
@@ -1543,6 +2610,7 @@ protected:
   unsigned int twom;
   unsigned int stride;
 public:
+  void multBlock(double *a, unsigned int n);
   void mult(double *a);
   
   void init() {
@@ -1630,6 +2698,50 @@ public:
   
   void backwards(Complex *f, Complex *u);
   void forwards(Complex *f, Complex *u);
+  void expandBlock(Complex *f, Complex *u, unsigned int b);
+  void reduceBlock(Complex *f, Complex *u, unsigned int b);
+};
+
+// Loop bodies that convolve row i, at offset i*stride, of a 2D Hermitian
+// ternary convolution with the work arrays of the calling thread.
+struct HTRows {
+  ImplicitHTConvolution *C;
+  Complex **F,**G,**H;
+  Complex **u,**v,***W;
+  unsigned int stride,offset;
+  HTRows(ImplicitHTConvolution *C, Complex **F, Complex **G, Complex **H,
+         Complex **u, Complex **v, Complex ***W, unsigned int stride,
+         unsigned int offset) :
+    C(C), F(F), G(G), H(H), u(u), v(v), W(W), stride(stride),
+    offset(offset) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C->convolve(F,G,H,u[thread],v[thread],W[thread],offset+i*stride);
+  }
+};
+
+struct HFGGRows {
+  ImplicitHFGGConvolution *C;
+  Complex *f,*g;
+  Complex **u,**v;
+  unsigned int stride;
+  HFGGRows(ImplicitHFGGConvolution *C, Complex *f, Complex *g, Complex **u,
+           Complex **v, unsigned int stride) :
+    C(C), f(f), g(g), u(u), v(v), stride(stride) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C->convolve(f+i*stride,g+i*stride,u[thread],v[thread]);
+  }
+};
+
+struct HFFFRows {
+  ImplicitHFFFConvolution *C;
+  Complex *f;
+  Complex **u;
+  unsigned int stride;
+  HFFFRows(ImplicitHFFFConvolution *C, Complex *f, Complex **u,
+           unsigned int stride) : C(C), f(f), u(u), stride(stride) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C->convolve(f+i*stride,u[thread]);
+  }
 };
 
 // In-place implicitly dealiased 2D Hermitian ternary convolution.
@@ -1759,39 +2871,26 @@ public:
     for(unsigned int s=0; s < M; ++s) {
       Complex *f=F[s]+offset;
       if(symmetrize)
-        HermitianSymmetrizeX(mx,my1,mx,f);
+        HermitianSymmetrizeX(mx,my1,mx,f,threads);
       xfftpad->backwards(f,u2+s*mu);
     }
     
     for(unsigned int s=0; s < M; ++s) {
       Complex *g=G[s]+offset;
       if(symmetrize)
-        HermitianSymmetrizeX(mx,my1,mx,g);
+        HermitianSymmetrizeX(mx,my1,mx,g,threads);
       xfftpad->backwards(g,v2+s*mu);
     }
     
     for(unsigned int s=0; s < M; ++s) {
       Complex *h=H[s]+offset;
       if(symmetrize)
-        HermitianSymmetrizeX(mx,my1,mx,h);
+        HermitianSymmetrizeX(mx,my1,mx,h,threads);
       xfftpad->backwards(h,w2+s*mu);
     }
 
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-    for(unsigned int i=0; i < mu; i += my1) {
-      unsigned int thread=get_thread_num();
-      yconvolve->convolve(F,G,H,u[thread],v[thread],W[thread],i+offset);
-    }
-    
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-    for(unsigned int i=0; i < mu; i += my1) {
-      unsigned int thread=get_thread_num();
-      yconvolve->convolve(U2,V2,W2,u[thread],v[thread],W[thread],i+offset);
-    }
+    parallel(2*mx,HTRows(yconvolve,F,G,H,u,v,W,my1,offset),threads);
+    parallel(2*mx,HTRows(yconvolve,U2,V2,W2,u,v,W,my1,0),threads);
 
     xfftpad->forwards(F[0]+offset,u2);
   }
@@ -1888,31 +2987,17 @@ public:
                 Complex **u, Complex **v,
                 Complex *u2, Complex *v2, bool symmetrize=true) {
     unsigned int my1=my+1;
-    unsigned int mu=2*mx*my1;
     
     if(symmetrize)
-      HermitianSymmetrizeX(mx,my1,mx,f);
+      HermitianSymmetrizeX(mx,my1,mx,f,threads);
     xfftpad->backwards(f,u2);
     
     if(symmetrize)
-      HermitianSymmetrizeX(mx,my1,mx,g);
+      HermitianSymmetrizeX(mx,my1,mx,g,threads);
     xfftpad->backwards(g,v2);
     
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-    for(unsigned int i=0; i < mu; i += my1) {
-      unsigned int thread=get_thread_num();
-      yconvolve->convolve(f+i,g+i,u[thread],v[thread]);
-    }
-    
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-    for(unsigned int i=0; i < mu; i += my1) {
-      unsigned int thread=get_thread_num();
-      yconvolve->convolve(u2+i,v2+i,u[thread],v[thread]);
-    }
+    parallel(2*mx,HFGGRows(yconvolve,f,g,u,v,my1),threads);
+    parallel(2*mx,HFGGRows(yconvolve,u2,v2,u,v,my1),threads);
 
     xfftpad->forwards(f,u2);
   }
@@ -1986,23 +3071,13 @@ public:
   
   void convolve(Complex *f, Complex **u, Complex *u2, bool symmetrize=true) {
     unsigned int my1=my+1;
-    unsigned int mu=2*mx*my1;
     
     if(symmetrize)
-      HermitianSymmetrizeX(mx,my1,mx,f);
+      HermitianSymmetrizeX(mx,my1,mx,f,threads);
     xfftpad->backwards(f,u2);
     
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-    for(unsigned int i=0; i < mu; i += my1)
-      yconvolve->convolve(f+i,u[get_thread_num()]);
-    
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif    
-    for(unsigned int i=0; i < mu; i += my1)
-      yconvolve->convolve(u2+i,u[get_thread_num()]);
+    parallel(2*mx,HFFFRows(yconvolve,f,u,my1),threads);
+    parallel(2*mx,HFFFRows(yconvolve,u2,u,my1),threads);
 
     xfftpad->forwards(f,u2);
   }
@@ -2012,6 +3087,366 @@ public:
   }
 };
 
+// Loop bodies that convolve plane i, at offset i*stride, of a 3D Hermitian
+// ternary convolution with the 2D convolution of the calling thread.
+struct HTPlanes {
+  ImplicitHTConvolution2 **C;
+  Complex **F,**G,**H;
+  unsigned int stride,offset;
+  HTPlanes(ImplicitHTConvolution2 **C, Complex **F, Complex **G, Complex **H,
+           unsigned int stride, unsigned int offset) :
+    C(C), F(F), G(G), H(H), stride(stride), offset(offset) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C[thread]->convolve(F,G,H,false,offset+i*stride);
+  }
+};
+
+struct HFGGPlanes {
+  ImplicitHFGGConvolution2 **C;
+  Complex *f,*g;
+  unsigned int stride;
+  HFGGPlanes(ImplicitHFGGConvolution2 **C, Complex *f, Complex *g,
+             unsigned int stride) : C(C), f(f), g(g), stride(stride) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C[thread]->convolve(f+i*stride,g+i*stride,false);
+  }
+};
+
+struct HFFFPlanes {
+  ImplicitHFFFConvolution2 **C;
+  Complex *f;
+  unsigned int stride;
+  HFFFPlanes(ImplicitHFFFConvolution2 **C, Complex *f, unsigned int stride) :
+    C(C), f(f), stride(stride) {}
+  void operator()(unsigned int i, unsigned int thread) const {
+    C[thread]->convolve(f+i*stride,false);
+  }
+};
+
+// In-place implicitly dealiased 3D Hermitian ternary convolution.
+class ImplicitHTConvolution3 : public ThreadBase {
+protected:
+  unsigned int mx,my,mz;
+  Complex *u1,*v1,*w1;
+  Complex *u2,*v2,*w2;
+  Complex *u3,*v3,*w3;
+  unsigned int M;
+  unsigned int nyz;      // number of x-transformed columns
+  unsigned int stride3;  // spacing between data blocks
+  fft0bipad *xfftpad;
+  ImplicitHTConvolution2 **yzconvolve;
+  Complex **U3,**V3,**W3;
+  bool allocated;
+public:  
+  void initpointers(Complex **&U3, Complex **&V3, Complex **&W3,
+                    Complex *u3, Complex *v3, Complex *w3) {
+    U3=new Complex *[M];
+    V3=new Complex *[M];
+    W3=new Complex *[M];
+    for(unsigned int s=0; s < M; ++s) {
+      unsigned int sstride=s*stride3;
+      U3[s]=u3+sstride;
+      V3[s]=v3+sstride;
+      W3[s]=w3+sstride;
+    }
+  }
+  
+  void deletepointers(Complex **&U3, Complex **&V3, Complex **&W3) {
+    delete [] W3;
+    delete [] V3;
+    delete [] U3;
+  }
+  
+  void init(const convolveOptions& options) {
+    nyz=options.ny ? options.ny : 2*my*(mz+1);
+    stride3=options.ny ? options.stride3 : 2*mx*nyz;
+    xfftpad=new fft0bipad(mx,nyz,nyz,u3,threads);
+    
+    unsigned int mz1M=(mz+1)*M*innerthreads;
+    unsigned int mu2=2*my*(mz+1)*M;
+    yzconvolve=new ImplicitHTConvolution2*[threads];
+    for(unsigned int t=0; t < threads; ++t)
+      yzconvolve[t]=new ImplicitHTConvolution2(my,mz,u1+t*mz1M,v1+t*mz1M,
+                                               w1+t*mz1M,u2+t*mu2,v2+t*mu2,
+                                               w2+t*mu2,M,innerthreads);
+    initpointers(U3,V3,W3,u3,v3,w3);
+  }
+  
+  void set(convolveOptions& options) {
+    if(options.ny == 0) {
+      options.ny=2*my*(mz+1);
+      options.stride3=2*mx*options.ny;
+    }
+  }
+  
+  // u1, v1, and w1 are temporary arrays of size (mz+1)*M*threads;
+  // u2, v2, and w2 are temporary arrays of size 2my*(mz+1)*M*threads;
+  // u3, v3, and w3 are temporary arrays of size 2mx*2my*(mz+1)*M.
+  // M is the number of data blocks (each corresponding to a dot product term).
+  // threads is the number of threads to use in the outer subconvolution loop.
+  ImplicitHTConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                         Complex *u1, Complex *v1, Complex *w1, 
+                         Complex *u2, Complex *v2, Complex *w2,
+                         Complex *u3, Complex *v3, Complex *w3,
+                         unsigned int M=1,
+                         unsigned int threads=fftw::maxthreads,
+                         convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), u1(u1), v1(v1), w1(w1),
+    u2(u2), v2(v2), w2(w2), u3(u3), v3(v3), w3(w3), M(M), allocated(false) {
+    multithread(mx);
+    init(options);
+  }
+  
+  ImplicitHTConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                         unsigned int M=1,
+                         unsigned int threads=fftw::maxthreads,
+                         convolveOptions options=defaultconvolveOptions) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), M(M), allocated(true) {
+    set(options);
+    multithread(mx);
+    unsigned int n1=(mz+1)*M*threads*innerthreads;
+    unsigned int n2=2*my*(mz+1)*M*threads;
+    unsigned int n3=options.stride3*M;
+    u1=utils::ComplexAlign(n1);
+    v1=utils::ComplexAlign(n1);
+    w1=utils::ComplexAlign(n1);
+    u2=utils::ComplexAlign(n2);
+    v2=utils::ComplexAlign(n2);
+    w2=utils::ComplexAlign(n2);
+    u3=utils::ComplexAlign(n3);
+    v3=utils::ComplexAlign(n3);
+    w3=utils::ComplexAlign(n3);
+    init(options);
+  }
+  
+  virtual ~ImplicitHTConvolution3() {
+    deletepointers(U3,V3,W3);
+    
+    for(unsigned int t=0; t < threads; ++t)
+      delete yzconvolve[t];
+    delete [] yzconvolve;
+    delete xfftpad;
+    
+    if(allocated) {
+      utils::deleteAlign(w3);
+      utils::deleteAlign(v3);
+      utils::deleteAlign(u3);
+      utils::deleteAlign(w2);
+      utils::deleteAlign(v2);
+      utils::deleteAlign(u2);
+      utils::deleteAlign(w1);
+      utils::deleteAlign(v1);
+      utils::deleteAlign(u1);
+    }
+  }
+  
+  virtual void HermitianSymmetrize(Complex *f, Complex *u) {
+    HermitianSymmetrizeXY(mx,my,mz+1,mx,my,f,threads);
+  }
+  
+  void backwards(Complex **F, Complex **U3, bool symmetrize,
+                 unsigned int offset) {
+    for(unsigned int s=0; s < M; ++s) {
+      Complex *f=F[s]+offset;
+      Complex *u=U3[s];
+      if(symmetrize)
+        HermitianSymmetrize(f,u);
+      xfftpad->backwards(f,u);
+    }
+  }
+  
+  // Convolve nx consecutive yz planes.
+  void subconvolution(Complex **F, Complex **G, Complex **H,
+                      unsigned int nx, unsigned int offset=0) {
+    unsigned int stride=2*my*(mz+1);
+    parallel(nx,HTPlanes(yzconvolve,F,G,H,stride,offset),threads);
+  }
+  
+  // F, G, and H are distinct pointers to M distinct data blocks each of size
+  // 2mx*2my*(mz+1), shifted by offset (contents not preserved).
+  // The output is returned in F[0].
+  virtual void convolve(Complex **F, Complex **G, Complex **H,
+                        bool symmetrize=true, unsigned int offset=0) {
+    backwards(F,U3,symmetrize,offset);
+    backwards(G,V3,symmetrize,offset);
+    backwards(H,W3,symmetrize,offset);
+    
+    subconvolution(F,G,H,2*mx,offset);
+    subconvolution(U3,V3,W3,2*mx);
+    
+    xfftpad->forwards(F[0]+offset,U3[0]);
+  }
+  
+  // Constructor for special case M=1:
+  void convolve(Complex *f, Complex *g, Complex *h, bool symmetrize=true) {
+    convolve(&f,&g,&h,symmetrize);
+  }
+};
+
+// In-place implicitly dealiased 3D Hermitian ternary convolution.
+// Special case G=H, M=1.
+class ImplicitHFGGConvolution3 : public ThreadBase {
+protected:
+  unsigned int mx,my,mz;
+  Complex *u1,*v1;
+  Complex *u2,*v2;
+  Complex *u3,*v3;
+  fft0bipad *xfftpad;
+  ImplicitHFGGConvolution2 **yzconvolve;
+  bool allocated;
+public:  
+  void init() {
+    unsigned int nyz=2*my*(mz+1);
+    xfftpad=new fft0bipad(mx,nyz,nyz,u3,threads);
+    
+    unsigned int mz1=(mz+1)*innerthreads;
+    yzconvolve=new ImplicitHFGGConvolution2*[threads];
+    for(unsigned int t=0; t < threads; ++t)
+      yzconvolve[t]=new ImplicitHFGGConvolution2(my,mz,u1+t*mz1,v1+t*mz1,
+                                                 u2+t*nyz,v2+t*nyz,
+                                                 innerthreads);
+  }
+  
+  // u1 and v1 are temporary arrays of size (mz+1)*threads.
+  // u2 and v2 are temporary arrays of size 2my*(mz+1)*threads.
+  // u3 and v3 are temporary arrays of size 2mx*2my*(mz+1).
+  // threads is the number of threads to use in the outer subconvolution loop.
+  ImplicitHFGGConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                           Complex *u1, Complex *v1,
+                           Complex *u2, Complex *v2,
+                           Complex *u3, Complex *v3,
+                           unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), u1(u1), v1(v1),
+    u2(u2), v2(v2), u3(u3), v3(v3), allocated(false) {
+    multithread(mx);
+    init();
+  }
+  
+  ImplicitHFGGConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                           unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), allocated(true) {
+    multithread(mx);
+    unsigned int nyz=2*my*(mz+1);
+    u1=utils::ComplexAlign((mz+1)*threads*innerthreads);
+    v1=utils::ComplexAlign((mz+1)*threads*innerthreads);
+    u2=utils::ComplexAlign(nyz*threads);
+    v2=utils::ComplexAlign(nyz*threads);
+    u3=utils::ComplexAlign(2*mx*nyz);
+    v3=utils::ComplexAlign(2*mx*nyz);
+    init();
+  }
+  
+  ~ImplicitHFGGConvolution3() {
+    for(unsigned int t=0; t < threads; ++t)
+      delete yzconvolve[t];
+    delete [] yzconvolve;
+    delete xfftpad;
+    
+    if(allocated) {
+      utils::deleteAlign(v3);
+      utils::deleteAlign(u3);
+      utils::deleteAlign(v2);
+      utils::deleteAlign(u2);
+      utils::deleteAlign(v1);
+      utils::deleteAlign(u1);
+    }
+  }
+  
+  // f and g are pointers to data of size 2mx*2my*(mz+1) (contents not
+  // preserved). The output is returned in f.
+  void convolve(Complex *f, Complex *g, bool symmetrize=true) {
+    unsigned int stride=2*my*(mz+1);
+    
+    if(symmetrize) {
+      HermitianSymmetrizeXY(mx,my,mz+1,mx,my,f,threads);
+      HermitianSymmetrizeXY(mx,my,mz+1,mx,my,g,threads);
+    }
+    xfftpad->backwards(f,u3);
+    xfftpad->backwards(g,v3);
+    
+    parallel(2*mx,HFGGPlanes(yzconvolve,f,g,stride),threads);
+    parallel(2*mx,HFGGPlanes(yzconvolve,u3,v3,stride),threads);
+
+    xfftpad->forwards(f,u3);
+  }
+};
+
+// In-place implicitly dealiased 3D Hermitian ternary convolution.
+// Special case F=G=H, M=1.
+class ImplicitHFFFConvolution3 : public ThreadBase {
+protected:
+  unsigned int mx,my,mz;
+  Complex *u1;
+  Complex *u2;
+  Complex *u3;
+  fft0bipad *xfftpad;
+  ImplicitHFFFConvolution2 **yzconvolve;
+  bool allocated;
+public:  
+  void init() {
+    unsigned int nyz=2*my*(mz+1);
+    xfftpad=new fft0bipad(mx,nyz,nyz,u3,threads);
+    
+    unsigned int mz1=(mz+1)*innerthreads;
+    yzconvolve=new ImplicitHFFFConvolution2*[threads];
+    for(unsigned int t=0; t < threads; ++t)
+      yzconvolve[t]=new ImplicitHFFFConvolution2(my,mz,u1+t*mz1,u2+t*nyz,
+                                                 innerthreads);
+  }
+  
+  // u1 is a temporary array of size (mz+1)*threads.
+  // u2 is a temporary array of size 2my*(mz+1)*threads.
+  // u3 is a temporary array of size 2mx*2my*(mz+1).
+  // threads is the number of threads to use in the outer subconvolution loop.
+  ImplicitHFFFConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                           Complex *u1, Complex *u2, Complex *u3,
+                           unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz),
+    u1(u1), u2(u2), u3(u3), allocated(false) {
+    multithread(mx);
+    init();
+  }
+  
+  ImplicitHFFFConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                           unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), mx(mx), my(my), mz(mz), allocated(true) {
+    multithread(mx);
+    unsigned int nyz=2*my*(mz+1);
+    u1=utils::ComplexAlign((mz+1)*threads*innerthreads);
+    u2=utils::ComplexAlign(nyz*threads);
+    u3=utils::ComplexAlign(2*mx*nyz);
+    init();
+  }
+  
+  ~ImplicitHFFFConvolution3() {
+    for(unsigned int t=0; t < threads; ++t)
+      delete yzconvolve[t];
+    delete [] yzconvolve;
+    delete xfftpad;
+    
+    if(allocated) {
+      utils::deleteAlign(u3);
+      utils::deleteAlign(u2);
+      utils::deleteAlign(u1);
+    }
+  }
+  
+  // f is a pointer to data of size 2mx*2my*(mz+1) (contents not preserved).
+  // The output is returned in f.
+  void convolve(Complex *f, bool symmetrize=true) {
+    unsigned int stride=2*my*(mz+1);
+    
+    if(symmetrize)
+      HermitianSymmetrizeXY(mx,my,mz+1,mx,my,f,threads);
+    xfftpad->backwards(f,u3);
+    
+    parallel(2*mx,HFFFPlanes(yzconvolve,f,stride),threads);
+    parallel(2*mx,HFFFPlanes(yzconvolve,u3,stride),threads);
+
+    xfftpad->forwards(f,u3);
+  }
+};
+
 } //end namespace fftwpp
 
 #endif
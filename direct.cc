@@ -0,0 +1,497 @@
+#include "convolution.h"
+#include "direct.h"
+
+namespace fftwpp {
+
+// Return sum_{j=0}^{n-1} f[j]*g[-j].
+inline Complex dotreverse(const Complex *f, const Complex *g, unsigned int n)
+{
+  Vec A=LOAD(0.0);
+  Vec B=LOAD(0.0);
+  for(unsigned int j=0; j < n; ++j) {
+    Vec F=LOAD(f+j);
+    Vec G=LOAD(g-j);
+    A += UNPACKL(F,F)*G;
+    B += UNPACKH(F,F)*G;
+  }
+  Complex sum;
+  STORE(&sum,A+ZMULTI(B));
+  return sum;
+}
+
+// Extend row b of the M rows of length m starting at f, f+dist, ... to the
+// 2m-1 values conj(f[m-1]),...,conj(f[1]),f[0],...,f[m-1] in F.
+struct Extend {
+  Complex *F,*f;
+  unsigned int m,dist;
+  Extend(Complex *F, Complex *f, unsigned int m, unsigned int dist) :
+    F(F), f(f), m(m), dist(dist) {}
+  void operator()(unsigned int b, unsigned int) const {
+    Complex *Fb=F+(2*m-1)*b+m-1;
+    Complex *fb=f+dist*b;
+    for(unsigned int j=0; j < m; ++j)
+      Fb[j]=fb[j];
+    for(unsigned int j=1; j < m; ++j)
+      Fb[-(int) j]=conj(fb[j]);
+  }
+};
+
+// Loop bodies that compute output row r, or extend input row r, of the
+// direct convolution C.
+template<class T>
+struct DirectRows {
+  T *C;
+  Complex *h,*f,*g;
+  DirectRows(T *C, Complex *h, Complex *f, Complex *g) :
+    C(C), h(h), f(f), g(g) {}
+  void operator()(unsigned int r, unsigned int) const {
+    C->convolveRow(h,f,g,r);
+  }
+};
+
+template<class T>
+struct ExtendRows {
+  T *C;
+  Complex *f,*g;
+  ExtendRows(T *C, Complex *f, Complex *g) : C(C), f(f), g(g) {}
+  void operator()(unsigned int r, unsigned int) const {
+    C->extendRow(f,g,r);
+  }
+};
+
+void DirectConvolution::convolveRow(Complex *h, Complex *f, Complex *g,
+                                    unsigned int k)
+{
+  unsigned int b=k/m;
+  unsigned int i=k-b*m;
+  unsigned int offset=dist*b;
+  h[offset+i]=dotreverse(f+offset,g+offset+i,i+1);
+}
+
+void DirectConvolution::convolve(Complex *h, Complex *f, Complex *g)
+{
+  parallel(M*m,DirectRows<DirectConvolution>(this,h,f,g),threads);
+}
+
+void DirectHConvolution::convolveRow(Complex *h, Complex *, Complex *,
+                                     unsigned int k)
+{
+  unsigned int n=2*m-1;
+  unsigned int b=k/m;
+  unsigned int i=k-b*m;
+  h[dist*b+i]=dotreverse(F+n*b+i,G+n*b+n-1,n-i);
+}
+
+void DirectHConvolution::convolve(Complex *h, Complex *f, Complex *g)
+{
+  parallel(M,Extend(F,f,m,dist),threads);
+  parallel(M,Extend(G,g,m,dist),threads);
+  parallel(M*m,DirectRows<DirectHConvolution>(this,h,f,g),threads);
+}       
+
+void DirectConvolution2::convolveRow(Complex *h, Complex *f, Complex *g,
+                                     unsigned int r)
+{
+  unsigned int b=r/mx;
+  unsigned int i=r-b*mx;
+  unsigned int offset=dist*b;
+  Complex *fb=f+offset;
+  Complex *gb=g+offset;
+  Complex *hi=h+offset+i*my;
+  for(unsigned int j=0; j < my; ++j) {
+    Complex sum=0.0;
+    for(unsigned int k=0; k <= i; ++k)
+      sum += dotreverse(fb+k*my,gb+(i-k)*my+j,j+1);
+    hi[j]=sum;
+  }
+}
+
+void DirectConvolution2::convolve(Complex *h, Complex *f, Complex *g)
+{
+  parallel(M*mx,DirectRows<DirectConvolution2>(this,h,f,g),threads);
+}       
+
+// Each row of the input is extended using the conjugate of the row
+// reflected through the x origin.
+void DirectHConvolution2::extendRow(Complex *f, Complex *g, unsigned int r)
+{
+  unsigned int xorigin=mx-1;
+  unsigned int nxy=nx*ny;
+  unsigned int b=r/nx;
+  unsigned int i=r-b*nx;
+  Complex *Fi=F+nxy*b+ny*i+my-1;
+  Complex *Gi=G+nxy*b+ny*i+my-1;
+  Complex *fi=f+dist*b+my*i;
+  Complex *gi=g+dist*b+my*i;
+  Complex *fr=f+dist*b+my*(2*xorigin-i);
+  Complex *gr=g+dist*b+my*(2*xorigin-i);
+  for(unsigned int j=0; j < my; ++j) {
+    Fi[j]=fi[j];
+    Gi[j]=gi[j];
+  }
+  for(unsigned int j=1; j < my; ++j) {
+    Fi[-(int) j]=conj(fr[j]);
+    Gi[-(int) j]=conj(gr[j]);
+  }
+}
+
+void DirectHConvolution2::convolveRow(Complex *h, Complex *, Complex *,
+                                      unsigned int r)
+{
+  unsigned int xorigin=mx-1;
+  unsigned int nxy=nx*ny;
+  unsigned int b=r/nx;
+  unsigned int kx=r-b*nx; // kx-xorigin is the x wavenumber
+  Complex *Fb=F+nxy*b;
+  Complex *Gb=G+nxy*b+ny-1;
+  Complex *hk=h+dist*b+my*kx;
+  // Rows px of f with qx=kx-px in range, indexed from 0.
+  unsigned int start=kx > xorigin ? kx-xorigin : 0;
+  unsigned int stop=kx < xorigin ? kx+xorigin : 2*xorigin;
+  for(unsigned int ky=0; ky < my; ++ky) {
+    Complex sum=0.0;
+    for(unsigned int px=start; px <= stop; ++px)
+      sum += dotreverse(Fb+ny*px+ky,Gb+ny*(kx+xorigin-px),ny-ky);
+    hk[ky]=sum;
+  }
+}
+
+// The extended inputs F and G are nx x ny arrays with the origin at
+// (mx-1,my-1).
+void DirectHConvolution2::convolve(Complex *h, Complex *f, Complex *g,
+                                   bool symmetrize)
+{
+  unsigned int xorigin=mx-1;
+    
+  for(unsigned int b=0; b < M; ++b) {
+    if(symmetrize) {
+      HermitianSymmetrizeX(mx,my,xorigin,f+dist*b,threads);
+      HermitianSymmetrizeX(mx,my,xorigin,g+dist*b,threads);
+    }
+  }
+
+  parallel(M*nx,ExtendRows<DirectHConvolution2>(this,f,g),threads);
+  parallel(M*nx,DirectRows<DirectHConvolution2>(this,h,f,g),threads);
+}
+
+void DirectConvolution3::convolveRow(Complex *h, Complex *f, Complex *g,
+                                     unsigned int r)
+{
+  unsigned int b=r/(mx*my);
+  unsigned int ij=r-b*mx*my;
+  unsigned int i=ij/my;
+  unsigned int j=ij-i*my;
+  unsigned int offset=dist*b;
+  Complex *fb=f+offset;
+  Complex *gb=g+offset;
+  Complex *hij=h+offset+i*myz+j*mz;
+  for(unsigned int k=0; k < mz; ++k) {
+    Complex sum=0.0;
+    for(unsigned int s=0; s <= i; ++s)
+      for(unsigned int p=0; p <= j; ++p)
+        sum += dotreverse(fb+s*myz+p*mz,gb+(i-s)*myz+(j-p)*mz+k,k+1);
+    hij[k]=sum;
+  }
+}
+
+void DirectConvolution3::convolve(Complex *h, Complex *f, Complex *g)
+{
+  parallel(M*mx*my,DirectRows<DirectConvolution3>(this,h,f,g),threads);
+}       
+
+void DirectHConvolution3::extendRow(Complex *f, Complex *g, unsigned int r)
+{
+  unsigned int nxy=nx*ny;
+  unsigned int nxyz=nxy*nz;
+  unsigned int b=r/nxy;
+  unsigned int ij=r-b*nxy;
+  unsigned int R=nxy-1-ij; // Reflection of (i,j) through the origin
+  Complex *Fij=F+nxyz*b+nz*ij+mz-1;
+  Complex *Gij=G+nxyz*b+nz*ij+mz-1;
+  Complex *fij=f+dist*b+mz*ij;
+  Complex *gij=g+dist*b+mz*ij;
+  Complex *fr=f+dist*b+mz*R;
+  Complex *gr=g+dist*b+mz*R;
+  for(unsigned int k=0; k < mz; ++k) {
+    Fij[k]=fij[k];
+    Gij[k]=gij[k];
+  }
+  for(unsigned int k=1; k < mz; ++k) {
+    Fij[-(int) k]=conj(fr[k]);
+    Gij[-(int) k]=conj(gr[k]);
+  }
+}
+
+void DirectHConvolution3::convolveRow(Complex *h, Complex *, Complex *,
+                                      unsigned int r)
+{
+  unsigned int xorigin=mx-1;
+  unsigned int yorigin=my-1;
+  unsigned int nxy=nx*ny;
+  unsigned int nxyz=nxy*nz;
+  unsigned int b=r/nxy;
+  unsigned int kxy=r-b*nxy;
+  unsigned int kx=kxy/ny;
+  unsigned int ky=kxy-kx*ny;
+  Complex *Fb=F+nxyz*b;
+  Complex *Gb=G+nxyz*b+nz-1;
+  Complex *hk=h+dist*b+mz*kxy;
+  unsigned int xstart=kx > xorigin ? kx-xorigin : 0;
+  unsigned int xstop=kx < xorigin ? kx+xorigin : 2*xorigin;
+  unsigned int ystart=ky > yorigin ? ky-yorigin : 0;
+  unsigned int ystop=ky < yorigin ? ky+yorigin : 2*yorigin;
+  for(unsigned int kz=0; kz < mz; ++kz) {
+    Complex sum=0.0;
+    for(unsigned int px=xstart; px <= xstop; ++px) {
+      unsigned int qx=kx+xorigin-px;
+      for(unsigned int py=ystart; py <= ystop; ++py) {
+        unsigned int qy=ky+yorigin-py;
+        sum += dotreverse(Fb+nz*(ny*px+py)+kz,Gb+nz*(ny*qx+qy),nz-kz);
+      }
+    }
+    hk[kz]=sum;
+  }
+}
+
+// The extended inputs F and G are nx x ny x nz arrays with the origin at
+// (mx-1,my-1,mz-1).
+void DirectHConvolution3::convolve(Complex *h, Complex *f, Complex *g, 
+                                   bool symmetrize)
+{
+  unsigned int xorigin=mx-1;
+  unsigned int yorigin=my-1;
+  
+  for(unsigned int b=0; b < M; ++b) {
+    if(symmetrize) {
+      HermitianSymmetrizeXY(mx,my,mz,xorigin,yorigin,f+dist*b,threads);
+      HermitianSymmetrizeXY(mx,my,mz,xorigin,yorigin,g+dist*b,threads);
+    }
+  }
+    
+  unsigned int nxy=nx*ny;
+  parallel(M*nxy,ExtendRows<DirectHConvolution3>(this,f,g),threads);
+  parallel(M*nxy,DirectRows<DirectHConvolution3>(this,h,f,g),threads);
+}
+
+void DirectConvolution4::convolve(Complex *h, Complex *f, Complex *g)
+{
+  unsigned int mzw=mz*mw;
+  unsigned int myzw=my*mzw;
+#if (!defined FFTWPP_SINGLE_THREAD) && defined _OPENMP
+#pragma omp parallel for
+#endif
+  for(unsigned int i=0; i < mx; ++i) {
+    for(unsigned int j=0; j < my; ++j) {
+      for(unsigned int k=0; k < mz; ++k) {
+        for(unsigned int l=0; l < mw; ++l) {
+          Complex sum=0.0;
+          for(unsigned int r=0; r <= i; ++r)
+            for(unsigned int p=0; p <= j; ++p)
+              for(unsigned int q=0; q <= k; ++q)
+                for(unsigned int s=0; s <= l; ++s)
+                  sum += f[r*myzw+p*mzw+q*mw+s]*
+                    g[(i-r)*myzw+(j-p)*mzw+(k-q)*mw+(l-s)];
+          h[i*myzw+j*mzw+k*mw+l]=sum;
+        }
+      }
+    }
+  }
+}       
+
+void DirectHConvolution4::convolve(Complex *h, Complex *f, Complex *g, 
+                                   bool symmetrize)
+{
+  int xorigin=mx-1;
+  int yorigin=my-1;
+  int zorigin=mz-1;
+  unsigned int ny=2*my-1;
+  unsigned int nz=2*mz-1;
+  
+  if(symmetrize) {
+    HermitianSymmetrizeXYZ(mx,my,mz,mw,xorigin,yorigin,zorigin,f);
+    HermitianSymmetrizeXYZ(mx,my,mz,mw,xorigin,yorigin,zorigin,g);
+  }
+    
+  int xstart=-xorigin;
+  int ystart=-yorigin;
+  int zstart=-zorigin;
+  int wstart=1-(int) mw;
+  int xstop=mx;
+  int ystop=my;
+  int zstop=mz;
+  int wstop=mw;
+#if (!defined FFTWPP_SINGLE_THREAD) && defined _OPENMP
+#pragma omp parallel for
+#endif
+  for(int kx=xstart; kx < xstop; ++kx) {
+    for(int ky=ystart; ky < ystop; ++ky) {
+      for(int kz=zstart; kz < zstop; ++kz) {
+        for(int kw=0; kw < wstop; ++kw) {
+          Complex sum=0.0;
+          for(int px=xstart; px < xstop; ++px) {
+            int qx=kx-px;
+            if(qx < xstart || qx >= xstop) continue;
+            for(int py=ystart; py < ystop; ++py) {
+              int qy=ky-py;
+              if(qy < ystart || qy >= ystop) continue;
+              for(int pz=zstart; pz < zstop; ++pz) {
+                int qz=kz-pz;
+                if(qz < zstart || qz >= zstop) continue;
+                for(int pw=wstart; pw < wstop; ++pw) {
+                  int qw=kw-pw;
+                  if(qw >= wstart && qw < wstop) {
+                    sum += ((pw >= 0) ? 
+                            f[(((xorigin+px)*ny+yorigin+py)*nz+zorigin+pz)*mw+
+                              pw] : 
+                            conj(f[(((xorigin-px)*ny+yorigin-py)*nz+zorigin-pz)*
+                                   mw-pw])) *
+                      ((qw >= 0) ?
+                       g[(((xorigin+qx)*ny+yorigin+qy)*nz+zorigin+qz)*mw+qw] :
+                       conj(g[(((xorigin-qx)*ny+yorigin-qy)*nz+zorigin-qz)*
+                              mw-qw]));
+                  }
+                }
+              }
+            }
+          }
+          h[(((xorigin+kx)*ny+yorigin+ky)*nz+zorigin+kz)*mw+kw]=sum;
+        }
+      }
+    }
+  }
+}
+
+void DirectHTConvolution::convolve(Complex *h, Complex *e, Complex *f,
+                                   Complex *g)
+{
+  int stop=m;
+  int start=1-m;
+#if (!defined FFTWPP_SINGLE_THREAD) && defined _OPENMP
+#pragma omp parallel for
+#endif
+  for(int k=0; k < stop; ++k) {
+    Complex sum=0.0;
+    for(int p=start; p < stop; ++p) {
+      Complex E=(p >= 0) ? e[p] : conj(e[-p]);
+      for(int q=start; q < stop; ++q) {
+        int r=k-p-q;
+        if(r >= start && r < stop)
+          sum += E*
+            ((q >= 0) ? f[q] : conj(f[-q]))*
+            ((r >= 0) ? g[r] : conj(g[-r]));
+      }
+    }
+    h[k]=sum;
+  }
+}
+
+void DirectHTConvolution2::convolve(Complex *h, Complex *e, Complex *f,
+                                    Complex *g, bool symmetrize)
+{
+  if(symmetrize) {
+    HermitianSymmetrizeX(mx,my,mx-1,e);
+    HermitianSymmetrizeX(mx,my,mx-1,f);
+    HermitianSymmetrizeX(mx,my,mx-1,g);
+  }
+    
+  unsigned int xorigin=mx-1;
+  int xstart=-(int) xorigin;
+  int xstop=mx;
+  int ystop=my;
+  int ystart=1-(int) my;
+#if (!defined FFTWPP_SINGLE_THREAD) && defined _OPENMP
+#pragma omp parallel for
+#endif
+  for(int kx=xstart; kx < xstop; ++kx) {
+    for(int ky=0; ky < ystop; ++ky) {
+      Complex sum=0.0;
+      for(int px=xstart; px < xstop; ++px) {
+        for(int py=ystart; py < ystop; ++py) {
+          Complex E=(py >= 0) ? e[(xorigin+px)*my+py] : 
+            conj(e[(xorigin-px)*my-py]);
+          for(int qx=xstart; qx < xstop; ++qx) {
+            for(int qy=ystart; qy < ystop; ++qy) {
+              int rx=kx-px-qx;
+              if(rx >= xstart && rx < xstop) {
+                int ry=ky-py-qy;
+                if(ry >= ystart && ry < ystop) {
+                  sum += E *
+                    ((qy >= 0) ? f[(xorigin+qx)*my+qy] : 
+                     conj(f[(xorigin-qx)*my-qy])) *
+                    ((ry >= 0) ? g[(xorigin+rx)*my+ry] : 
+                     conj(g[(xorigin-rx)*my-ry]));
+                }
+              }
+            }
+          }
+        }
+        h[(xorigin+kx)*my+ky]=sum;
+      }
+    }
+  }     
+}
+
+// Return the value of the 3D Hermitian array f at (x,y,z), where
+// 1-mz < z < mz.
+static inline Complex HermitianValue(Complex *f, int x, int y, int z,
+                                     int xorigin, int yorigin,
+                                     unsigned int ny, unsigned int mz)
+{
+  return z >= 0 ? f[((xorigin+x)*ny+yorigin+y)*mz+z] :
+    conj(f[((xorigin-x)*ny+yorigin-y)*mz-z]);
+}
+
+void DirectHTConvolution3::convolve(Complex *h, Complex *e, Complex *f,
+                                    Complex *g, bool symmetrize)
+{
+  if(symmetrize) {
+    HermitianSymmetrizeXY(mx,my,mz,mx-1,my-1,e);
+    HermitianSymmetrizeXY(mx,my,mz,mx-1,my-1,f);
+    HermitianSymmetrizeXY(mx,my,mz,mx-1,my-1,g);
+  }
+    
+  int xorigin=mx-1;
+  int yorigin=my-1;
+  unsigned int ny=2*my-1;
+  int xstart=-xorigin;
+  int xstop=mx;
+  int ystart=-yorigin;
+  int ystop=my;
+  int zstart=1-(int) mz;
+  int zstop=mz;
+#if (!defined FFTWPP_SINGLE_THREAD) && defined _OPENMP
+#pragma omp parallel for
+#endif
+  for(int kx=xstart; kx < xstop; ++kx) {
+    for(int ky=ystart; ky < ystop; ++ky) {
+      for(int kz=0; kz < zstop; ++kz) {
+        Complex sum=0.0;
+        for(int px=xstart; px < xstop; ++px) {
+          for(int py=ystart; py < ystop; ++py) {
+            for(int pz=zstart; pz < zstop; ++pz) {
+              Complex E=HermitianValue(e,px,py,pz,xorigin,yorigin,ny,mz);
+              for(int qx=xstart; qx < xstop; ++qx) {
+                int rx=kx-px-qx;
+                if(rx < xstart || rx >= xstop) continue;
+                for(int qy=ystart; qy < ystop; ++qy) {
+                  int ry=ky-py-qy;
+                  if(ry < ystart || ry >= ystop) continue;
+                  for(int qz=zstart; qz < zstop; ++qz) {
+                    int rz=kz-pz-qz;
+                    if(rz >= zstart && rz < zstop)
+                      sum += E*
+                        HermitianValue(f,qx,qy,qz,xorigin,yorigin,ny,mz)*
+                        HermitianValue(g,rx,ry,rz,xorigin,yorigin,ny,mz);
+                  }
+                }
+              }
+            }
+          }
+        }
+        h[((xorigin+kx)*ny+yorigin+ky)*mz+kz]=sum;
+      }
+    }
+  }     
+}
+
+}
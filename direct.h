@@ -0,0 +1,266 @@
+/* Direct convolution routines.
+   Copyright (C) 2010-2015 John C. Bowman and Malcolm Roberts, Univ. of Alberta
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#ifndef __direct_h__
+#define __direct_h__ 1
+
+#include "convolution.h"
+
+namespace fftwpp {
+
+// The 1D, 2D, and 3D direct convolutions below evaluate the O(m^2)
+// (O(mx^2 my^2), O(mx^2 my^2 mz^2)) sums with SSE2 complex multiply-adds
+// over contiguous rows. For very small sizes they are faster than any
+// FFT-based convolution. Each call computes a batch of M convolutions of
+// data blocks separated by dist Complex values (by default the size of one
+// block), distributed over the available threads. The Hermitian versions
+// first extend each input to its full (conjugate-symmetric) range, so that
+// the inner sums are contiguous.
+
+// Out-of-place direct 1D complex convolution.
+class DirectConvolution : public ThreadBase {
+protected:
+  unsigned int m;
+  unsigned int M;    // Number of convolutions in a batch
+  unsigned int dist; // Distance between successive inputs
+public:  
+  DirectConvolution(unsigned int m, unsigned int M=1, unsigned int dist=0,
+                    unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), m(m), M(M), dist(dist ? dist : m) {}
+  
+  void convolveRow(Complex *h, Complex *f, Complex *g, unsigned int r);
+  void convolve(Complex *h, Complex *f, Complex *g);
+  void autoconvolve(Complex *h, Complex *f) {convolve(h,f,f);}
+};
+
+// Out-of-place direct 1D Hermitian convolution.
+class DirectHConvolution : public ThreadBase {
+protected:
+  unsigned int m;
+  unsigned int M;
+  unsigned int dist;
+  Complex *F,*G; // Extended inputs
+public:  
+  DirectHConvolution(unsigned int m, unsigned int M=1, unsigned int dist=0,
+                     unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), m(m), M(M), dist(dist ? dist : m) {
+    F=utils::ComplexAlign(2*(2*m-1)*M);
+    G=F+(2*m-1)*M;
+  }
+
+  ~DirectHConvolution() {
+    utils::deleteAlign(F);
+  }
+  
+  void convolveRow(Complex *h, Complex *f, Complex *g, unsigned int r);
+  
+// Compute h= f (*) g via direct convolution, where f and g contain the m
+// non-negative Fourier components of real functions (contents
+// preserved). The output of m complex values is returned in the array h,
+// which must be distinct from f and g.
+  void convolve(Complex *h, Complex *f, Complex *g);
+};
+
+// Out-of-place direct 2D complex convolution.
+class DirectConvolution2 : public ThreadBase {
+protected:  
+  unsigned int mx,my;
+  unsigned int M;
+  unsigned int dist;
+public:
+  DirectConvolution2(unsigned int mx, unsigned int my, unsigned int M=1,
+                     unsigned int dist=0,
+                     unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), mx(mx), my(my), M(M), dist(dist ? dist : mx*my) {}
+  
+  void convolveRow(Complex *h, Complex *f, Complex *g, unsigned int r);
+  void convolve(Complex *h, Complex *f, Complex *g);
+};
+
+// Out-of-place direct 2D Hermitian convolution of (2mx-1) x my arrays
+// with the x origin at row mx-1.
+class DirectHConvolution2 : public ThreadBase {
+protected:  
+  unsigned int mx,my;
+  unsigned int M;
+  unsigned int dist;
+  unsigned int nx,ny; // Dimensions of the extended inputs
+  Complex *F,*G;
+public:
+  DirectHConvolution2(unsigned int mx, unsigned int my, unsigned int M=1,
+                      unsigned int dist=0,
+                      unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), mx(mx), my(my), M(M),
+    dist(dist ? dist : (2*mx-1)*my), nx(2*mx-1), ny(2*my-1) {
+    F=utils::ComplexAlign(2*nx*ny*M);
+    G=F+nx*ny*M;
+  }
+
+  ~DirectHConvolution2() {
+    utils::deleteAlign(F);
+  }
+  
+  void extendRow(Complex *f, Complex *g, unsigned int r);
+  void convolveRow(Complex *h, Complex *f, Complex *g, unsigned int r);
+  void convolve(Complex *h, Complex *f, Complex *g, bool symmetrize=true);
+};
+
+// Out-of-place direct 3D complex convolution.
+class DirectConvolution3 : public ThreadBase {
+protected:  
+  unsigned int mx,my,mz;
+  unsigned int myz;
+  unsigned int M;
+  unsigned int dist;
+public:
+  DirectConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                     unsigned int M=1, unsigned int dist=0,
+                     unsigned int threads=fftw::maxthreads) : 
+    ThreadBase(threads), mx(mx), my(my), mz(mz), myz(my*mz), M(M),
+    dist(dist ? dist : mx*my*mz) {}
+  
+  void convolveRow(Complex *h, Complex *f, Complex *g, unsigned int r);
+  void convolve(Complex *h, Complex *f, Complex *g);
+};
+
+// Out-of-place direct 3D Hermitian convolution of (2mx-1) x (2my-1) x mz
+// arrays with the x and y origins at mx-1 and my-1.
+class DirectHConvolution3 : public ThreadBase {
+protected:  
+  unsigned int mx,my,mz;
+  unsigned int M;
+  unsigned int dist;
+  unsigned int nx,ny,nz; // Dimensions of the extended inputs
+  Complex *F,*G;
+public:
+  DirectHConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                      unsigned int M=1, unsigned int dist=0,
+                      unsigned int threads=fftw::maxthreads) : 
+    ThreadBase(threads), mx(mx), my(my), mz(mz), M(M),
+    dist(dist ? dist : (2*mx-1)*(2*my-1)*mz), nx(2*mx-1), ny(2*my-1),
+    nz(2*mz-1) {
+    F=utils::ComplexAlign(2*nx*ny*nz*M);
+    G=F+nx*ny*nz*M;
+  }
+  
+  ~DirectHConvolution3() {
+    utils::deleteAlign(F);
+  }
+  
+  void extendRow(Complex *f, Complex *g, unsigned int r);
+  void convolveRow(Complex *h, Complex *f, Complex *g, unsigned int r);
+  void convolve(Complex *h, Complex *f, Complex *g, bool symmetrize=true);
+};
+
+// Out-of-place direct 4D complex convolution.
+class DirectConvolution4 {
+protected:  
+  unsigned int mx,my,mz,mw;
+public:
+  DirectConvolution4(unsigned int mx, unsigned int my, unsigned int mz,
+                     unsigned int mw) : mx(mx), my(my), mz(mz), mw(mw) {}
+  
+  void convolve(Complex *h, Complex *f, Complex *g);
+};
+
+// Out-of-place direct complex convolution of rank D.
+template<unsigned int D>
+class DirectConvolutionN {
+protected:
+  unsigned int m[D];
+public:
+  // m is an array of the D dimensions, outermost first.
+  DirectConvolutionN(const unsigned int *M) {
+    for(unsigned int d=0; d < D; ++d)
+      m[d]=M[d];
+  }
+
+  void convolve(Complex *h, Complex *f, Complex *g) {
+    unsigned int n=1;
+    for(unsigned int d=0; d < D; ++d)
+      n *= m[d];
+    for(unsigned int I=0; I < n; ++I) {
+      Complex sum=0.0;
+      for(unsigned int J=0; J < n; ++J) {
+        // Skip J unless each of its indices is at most that of I.
+        unsigned int i=I, j=J;
+        bool inside=true;
+        for(unsigned int d=D; d-- > 0;) {
+          if(j % m[d] > i % m[d]) {
+            inside=false;
+            break;
+          }
+          i /= m[d];
+          j /= m[d];
+        }
+        if(inside) sum += f[J]*g[I-J];
+      }
+      h[I]=sum;
+    }
+  }
+};
+
+// Out-of-place direct 4D Hermitian convolution.
+class DirectHConvolution4 {
+protected:  
+  unsigned int mx,my,mz,mw;
+public:
+  DirectHConvolution4(unsigned int mx, unsigned int my, unsigned int mz,
+                      unsigned int mw) : mx(mx), my(my), mz(mz), mw(mw) {}
+  
+  void convolve(Complex *h, Complex *f, Complex *g, bool symmetrize=true);
+};
+
+// Out-of-place direct 1D Hermitian ternary convolution.
+class DirectHTConvolution {
+protected:  
+  unsigned int m;
+public:
+  DirectHTConvolution(unsigned int m) : m(m) {}
+  
+  void convolve(Complex *h, Complex *e, Complex *f, Complex *g);
+};
+
+// Out-of-place direct 2D Hermitian ternary convolution.
+class DirectHTConvolution2 {
+protected:  
+  unsigned int mx,my;
+public:
+  DirectHTConvolution2(unsigned int mx, unsigned int my) : mx(mx), my(my)
+  {}
+  
+  void convolve(Complex *h, Complex *e, Complex *f, Complex *g,
+                bool symmetrize=true);
+};
+
+// Out-of-place direct 3D Hermitian ternary convolution.
+class DirectHTConvolution3 {
+protected:  
+  unsigned int mx,my,mz;
+public:
+  DirectHTConvolution3(unsigned int mx, unsigned int my, unsigned int mz) :
+    mx(mx), my(my), mz(mz) {}
+  
+  void convolve(Complex *h, Complex *e, Complex *f, Complex *g,
+                bool symmetrize=true);
+};
+
+
+
+}
+
+#endif
@@ -0,0 +1,537 @@
+#include "Complex.h"
+#include "convolution.h"
+#include "explicit.h"
+
+namespace fftwpp {
+
+// Set f[start],...,f[stop-1] to zero.
+inline void zero(Complex *f, unsigned int start, unsigned int stop,
+                 unsigned int threads)
+{
+  parallel(stop-start,Zero(f+start,1),threads);
+}
+
+// Multiply the rows of length m starting at f, f+stride, ...,
+// f+(rows-1)*stride by scale.
+inline void scale(Complex *f, unsigned int rows, unsigned int m,
+                  unsigned int stride, double factor, unsigned int threads)
+{
+  parallel(rows,ScaleRows<Complex>(f,stride,1,m,factor),threads);
+}
+
+// Loop bodies for the products of the explicit Hermitian convolutions over
+// the ny real values of row i (at offset i*stride): f=ninv*sum_s f_s*g_s
+// over the M pairs of inputs F and G, or f=ninv*f*g*h.
+struct HProductRows {
+  Complex **F,**G;
+  unsigned int M,stride,ny;
+  double ninv;
+  HProductRows(Complex **F, Complex **G, unsigned int M, unsigned int stride,
+               unsigned int ny, double ninv) :
+    F(F), G(G), M(M), stride(stride), ny(ny), ninv(ninv) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int start=stride*i;
+    unsigned int stop=start+ny;
+    double *f=(double *) F[0];
+    double *g=(double *) G[0];
+    if(M == 1) {
+      for(unsigned int j=start; j < stop; ++j)
+        f[j] *= g[j]*ninv;
+    } else if(M == 2) {
+      double *f1=(double *) F[1];
+      double *g1=(double *) G[1];
+      for(unsigned int j=start; j < stop; ++j)
+        f[j]=(f[j]*g[j]+f1[j]*g1[j])*ninv;
+    } else {
+      for(unsigned int j=start; j < stop; ++j) {
+        double sum=f[j]*g[j];
+        for(unsigned int s=1; s < M; ++s)
+          sum += ((double *) F[s])[j]*((double *) G[s])[j];
+        f[j]=sum*ninv;
+      }
+    }
+  }
+};
+
+struct HTProductRows {
+  double *f,*g,*h;
+  unsigned int stride,ny;
+  double ninv;
+  HTProductRows(double *f, double *g, double *h, unsigned int stride,
+                unsigned int ny, double ninv) :
+    f(f), g(g), h(h), stride(stride), ny(ny), ninv(ninv) {}
+  void operator()(unsigned int i, unsigned int) const {
+    unsigned int start=stride*i;
+    unsigned int stop=start+ny;
+    for(unsigned int j=start; j < stop; ++j)
+      f[j] *= g[j]*h[j]*ninv;
+  }
+};
+
+// Zero the z padding of the first my y rows, and the y padding, of the x
+// plane i (at offset i*nyz).
+struct ZeroPlanes {
+  Complex *f;
+  unsigned int my,mz,nz,nyz;
+  ZeroPlanes(Complex *f, unsigned int my, unsigned int mz, unsigned int nz,
+             unsigned int nyz) : f(f), my(my), mz(mz), nz(nz), nyz(nyz) {}
+  void operator()(unsigned int i, unsigned int) const {
+    Vec Zero=LOAD(0.0);
+    Complex *fi=f+nyz*i;
+    for(unsigned int j=0; j < my; ++j) {
+      Complex *fij=fi+nz*j;
+      for(unsigned int k=mz; k < nz; ++k)
+        STORE(fij+k,Zero);
+    }
+    for(unsigned int k=my*nz; k < nyz; ++k)
+      STORE(fi+k,Zero);
+  }
+};
+
+void ExplicitConvolution::pad(Complex *f)
+{
+  zero(f,m,n,threads);
+}
+
+void ExplicitConvolution::unpad(Complex *f)
+{
+  scale(f,1,m,m,1.0/n,threads);
+}
+
+void ExplicitConvolution::backwards(Complex *f)
+{
+  Backwards->fft(f);
+}
+  
+void ExplicitConvolution::forwards(Complex *f)
+{
+  Forwards->fft(f);
+}
+  
+void ExplicitConvolution::convolve(Complex **F, multiplier *pmult)
+{
+  for(unsigned int a=0; a < A; ++a) {
+    pad(F[a]);
+    backwards(F[a]);
+  }
+  
+  (*pmult)(F,n,0,NULL,0,threads);
+
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+void ExplicitHConvolution::pad(Complex *f)
+{
+  zero(f,m,n/2+1,threads);
+}
+  
+void ExplicitHConvolution::unpad(Complex *f)
+{
+  scale(f,1,m,m,1.0/n,threads);
+}
+
+void ExplicitHConvolution::backwards(Complex *f)
+{
+  cr->fft(f);
+}
+  
+void ExplicitHConvolution::forwards(Complex *f)
+{
+  rc->fft(f);
+}
+
+void ExplicitHConvolution::convolve(Complex **F, realmultiplier *pmult)
+{
+  for(unsigned int a=0; a < A; ++a) {
+    pad(F[a]);
+    backwards(F[a]);
+  }
+  
+  (*pmult)((double **) F,n,0,NULL,0,threads);
+  
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+void ExplicitConvolution2::pad(Complex *f)
+{
+  // zero pad upper block
+  parallel(mx,Zero(f+my,ny,ny-my),threads);
+    
+  // zero pad right-hand block
+  zero(f,mx*ny,nx*ny,threads);
+}
+
+void ExplicitConvolution2::unpad(Complex *f)
+{
+  scale(f,mx,my,ny,1.0/(nx*ny),threads);
+}
+
+void ExplicitConvolution2::backwards(Complex *f)
+{
+  if(prune) {
+    xBackwards->fft(f);
+    yBackwards->fft(f);
+  } else
+    Backwards->fft(f);
+}
+  
+void ExplicitConvolution2::forwards(Complex *f)
+{
+  if(prune) {
+    yForwards->fft(f);
+    xForwards->fft(f);
+  } else
+    Forwards->fft(f);
+}
+  
+void ExplicitConvolution2::convolve(Complex **F, multiplier *pmult)
+{
+  for(unsigned int a=0; a < A; ++a) {
+    pad(F[a]);
+    backwards(F[a]);
+  }
+  
+  (*pmult)(F,nx*ny,0,NULL,0,threads);
+
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+void ExplicitHConvolution2::pad(Complex *f)
+{
+  unsigned int nyp=ny/2+1;
+  unsigned int nx2=nx/2;
+
+  // zero pad left block
+  unsigned int stop=(nx2-mx+1)*nyp;
+  zero(f,0,stop,threads);
+    
+  // zero pad top-middle block
+  parallel(2*mx-1,Zero(f+stop+my,nyp,nyp-my),threads);
+    
+  // zero pad right block
+  zero(f,(nx2+mx)*nyp,nx*nyp,threads);
+}
+
+void ExplicitHConvolution2::unpad(Complex *f)
+{
+  unsigned int nyp=ny/2+1;
+  scale(f+(nx/2-mx+1)*nyp,2*mx-1,my,nyp,1.0/(nx*ny),threads);
+}
+
+void oddShift(unsigned int nx, unsigned int ny, Complex *f, int sign,
+              unsigned int s, Complex *ZetaH, Complex *ZetaL)
+{
+  unsigned int nyp=ny/2+1;
+  int Sign=-1;
+  sign=-sign;
+  unsigned int stop=s;
+  Complex *ZetaL0=ZetaL;
+  for(unsigned int a=0, k=1; k < nx; ++a) {
+    Complex H=ZetaH[a];
+    for(; k < stop; ++k) {
+      Complex zeta=Sign*H*ZetaL0[k];
+      zeta.im *= sign;
+      unsigned int j=nyp*k;
+      unsigned int stop=j+nyp;
+      for(; j < stop; ++j)
+        f[j] *= zeta;
+      Sign=-Sign;
+    }
+    stop=std::min(k+s,nx);
+    ZetaL0=ZetaL-k;
+  }
+}
+
+void ExplicitHConvolution2::backwards(Complex *f, bool shift)
+{
+  if(prune) {
+    xBackwards->fft(f);
+    if(nx % 2 == 0) {
+      if(shift) fftw::Shift(f,nx,ny,threads);
+    } else oddShift(nx,ny,f,-1,s,ZetaH,ZetaL);
+    yBackwards->fft(f);
+  } else {
+    if(shift)
+      Backwards->fft0(f);
+    else
+      Backwards->fft(f);
+  }
+}
+
+void ExplicitHConvolution2::forwards(Complex *f)
+{
+  if(prune) {
+    yForwards->fft(f);
+    if(nx % 2 == 0) {
+      fftw::Shift(f,nx,ny,threads);
+    } else oddShift(nx,ny,f,1,s,ZetaH,ZetaL);
+    xForwards->fft(f);
+  } else
+    Forwards->fft0(f);
+}
+
+void ExplicitHConvolution2::convolve(Complex **F, Complex **G, bool symmetrize)
+{
+  unsigned int xorigin=nx/2;
+  unsigned int nyp=ny/2+1;
+    
+  for(unsigned int s=0; s < M; ++s) {
+    Complex *f=F[s];
+    if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,f);
+    pad(f);
+    backwards(f,false);
+  
+    Complex *g=G[s];
+    if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,g);
+    pad(g);
+    backwards(g,false);
+  }
+    
+  double ninv=1.0/(nx*ny);
+  parallel(nx,HProductRows(F,G,M,2*nyp,ny,ninv),threads);
+        
+  forwards(F[0]);
+}
+
+// Unlike the binary convolution, the inputs are shifted too, so that the
+// multiplier sees the physical-space values themselves.
+void ExplicitHConvolution2::convolve(Complex **F, realmultiplier *pmult,
+                                     bool symmetrize)
+{
+  unsigned int xorigin=nx/2;
+  unsigned int nyp=ny/2+1;
+    
+  for(unsigned int a=0; a < A; ++a) {
+    Complex *f=F[a];
+    if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,f);
+    pad(f);
+    backwards(f);
+  }
+
+  // The multiplier also sees the two padding doubles at the end of each
+  // row of the in-place real transform.
+  (*pmult)((double **) F,2*nx*nyp,0,NULL,0,threads);
+        
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+void ExplicitConvolution3::pad(Complex *f)
+{
+  unsigned int nyz=ny*nz;
+  parallel(mx,ZeroPlanes(f,my,mz,nz,nyz),threads);
+
+  zero(f,mx*nyz,nx*nyz,threads);
+}
+
+void ExplicitConvolution3::unpad(Complex *f)
+{
+  unsigned int nyz=ny*nz;
+  double ninv=1.0/(nx*nyz);
+  for(unsigned int i=0; i < mx; ++i)
+    scale(f+nyz*i,my,mz,nz,ninv,threads);
+}
+
+void ExplicitConvolution3::backwards(Complex *f)
+{
+  if(prune) {
+    yBackwards->fft(f);
+    xBackwards->fft(f);
+    zBackwards->fft(f);
+  } else
+    Backwards->fft(f);
+}
+  
+void ExplicitConvolution3::forwards(Complex *f)
+{
+  if(prune) {
+    zForwards->fft(f);
+    xForwards->fft(f);
+    yForwards->fft(f);
+  } else
+    Forwards->fft(f);
+}
+
+void ExplicitConvolution3::convolve(Complex **F, multiplier *pmult)
+{
+  for(unsigned int a=0; a < A; ++a) {
+    pad(F[a]);
+    backwards(F[a]);
+  }
+  
+  (*pmult)(F,nx*ny*nz,0,NULL,0,threads);
+
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+void ExplicitHTConvolution::pad(Complex *f)
+{
+  zero(f,m,n/2+1,threads);
+}
+
+void ExplicitHTConvolution::unpad(Complex *f)
+{
+  scale(f,1,m,m,1.0/n,threads);
+}
+
+void ExplicitHTConvolution::backwards(Complex *f)
+{
+  cr->fft(f);
+}
+
+void ExplicitHTConvolution::forwards(Complex *f)
+{
+  rc->fft(f);
+}
+
+void ExplicitHTConvolution::convolve(Complex *f, Complex *g, Complex *h)
+{
+  pad(f);
+  backwards(f);
+  
+  pad(g);
+  backwards(g);
+      
+  pad(h);
+  backwards(h);
+        
+  double *F=(double *) f;
+  double *G=(double *) g;
+  double *H=(double *) h;
+    
+  double ninv=1.0/n;
+  parallel(n,HTProductRows(F,G,H,1,1,ninv),threads);
+    
+  forwards(f);
+}
+
+void ExplicitHTConvolution::convolve(Complex **F, realmultiplier *pmult)
+{
+  for(unsigned int a=0; a < A; ++a) {
+    pad(F[a]);
+    backwards(F[a]);
+  }
+  
+  (*pmult)((double **) F,n,0,NULL,0,threads);
+  
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+void ExplicitHTConvolution2::pad(Complex *f)
+{
+  unsigned int nyp=ny/2+1;
+  unsigned int nx2=nx/2;
+  zero(f,0,(nx2-mx+1)*nyp,threads);
+  zero(f,(nx2+mx)*nyp,nx*nyp,threads);
+  parallel(2*mx-1,Zero(f+(nx2-mx+1)*nyp+my,nyp,nyp-my),threads);
+}
+
+void ExplicitHTConvolution2::unpad(Complex *f)
+{
+  unsigned int nyp=ny/2+1;
+  scale(f+(nx/2-mx+1)*nyp,2*mx-1,my,nyp,1.0/(nx*ny),threads);
+}
+
+void ExplicitHTConvolution2::backwards(Complex *f, bool shift)
+{
+  if(prune) {
+    xBackwards->fft(f);
+    if(nx % 2 == 0) {
+      if(shift) fftw::Shift(f,nx,ny,threads);
+    } else oddShift(nx,ny,f,-1,s,ZetaH,ZetaL);
+    yBackwards->fft(f);
+  } else {
+    if(shift)
+      Backwards->fft0(f);
+    else
+      Backwards->fft(f);
+  }
+}
+
+void ExplicitHTConvolution2::forwards(Complex *f, bool shift)
+{
+  if(prune) {
+    yForwards->fft(f);
+    if(nx % 2 == 0) {
+      if(shift) fftw::Shift(f,nx,ny,threads);
+    } else oddShift(nx,ny,f,1,s,ZetaH,ZetaL);
+    xForwards->fft(f);
+  } else {
+    if(shift)
+      Forwards->fft0(f);
+    else
+      Forwards->fft(f);
+  }
+}
+
+void ExplicitHTConvolution2::convolve(Complex *f, Complex *g, Complex *h,
+                                      bool symmetrize)
+{
+  unsigned int xorigin=nx/2;
+  unsigned int nyp=ny/2+1;
+    
+  if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,f);
+  pad(f);
+  backwards(f,false);
+  
+  if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,g);
+  pad(g);
+  backwards(g,false);
+      
+  if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,h);
+  pad(h);
+  backwards(h,false);
+        
+  double *F=(double *) f;
+  double *G=(double *) g;
+  double *H=(double *) h;
+    
+  double ninv=1.0/(nx*ny);
+  parallel(nx,HTProductRows(F,G,H,2*nyp,ny,ninv),threads);
+        
+  forwards(f,false);
+}
+
+// Unlike the binary convolutions, the inputs are shifted too, so that the
+// multiplier sees the physical-space values themselves.
+void ExplicitHTConvolution2::convolve(Complex **F, realmultiplier *pmult,
+                                      bool symmetrize)
+{
+  unsigned int xorigin=nx/2;
+  unsigned int nyp=ny/2+1;
+    
+  for(unsigned int a=0; a < A; ++a) {
+    Complex *f=F[a];
+    if(symmetrize) HermitianSymmetrizeX(mx,nyp,xorigin,f);
+    pad(f);
+    backwards(f);
+  }
+
+  // The multiplier also sees the two padding doubles at the end of each
+  // row of the in-place real transform.
+  (*pmult)((double **) F,2*nx*nyp,0,NULL,0,threads);
+        
+  for(unsigned int b=0; b < B; ++b) {
+    forwards(F[b]);
+    unpad(F[b]);
+  }
+}
+
+}
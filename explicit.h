@@ -0,0 +1,489 @@
+/* Explicitly dealiased convolution routines.
+   Copyright (C) 2010-2015 John C. Bowman and Malcolm Roberts, Univ. of Alberta
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#ifndef __explicit_h__
+#define __explicit_h__ 1
+
+#include "convolution.h"
+
+namespace fftwpp {
+
+// The explicitly dealiased convolutions zero pad their in-place inputs to
+// the transform size n (or nx*ny, nx*ny*nz), transform them, apply a
+// multiplier with the same interface as the implicit convolutions to the
+// n padded values, and transform back the B outputs, which are normalized
+// in the unpadded region only. The pruned versions skip the transforms of
+// rows that contain only zeros, using multiple 1D (or guru) transforms.
+
+// The binary convolve(f,g) wrappers pass exactly two arrays to the
+// multiplier interface.
+inline void checkBinary(unsigned int A, unsigned int B)
+{
+  if(A != 2 || B != 1) {
+    std::cerr << "ERROR: convolve(f,g) requires A=2 and B=1, not A=" << A
+              << " and B=" << B << std::endl;
+    exit(1);
+  }
+}
+
+// In-place explicitly dealiased 1D complex convolution.
+class ExplicitConvolution : public ThreadBase {
+protected:
+  unsigned int n,m;
+  unsigned int A,B;
+  fft1d *Backwards,*Forwards;
+public:  
+  
+  // u is a temporary array of size n.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ExplicitConvolution(unsigned int n, unsigned int m, Complex *u,
+                      unsigned int A=2, unsigned int B=1,
+                      unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), n(n), m(m), A(A), B(B) {
+    Backwards=new fft1d(n,1,u,NULL,threads);
+    Forwards=new fft1d(n,-1,u,NULL,threads);
+
+    this->threads=Forwards->Threads();
+  }
+  
+  ~ExplicitConvolution() {
+    delete Forwards;
+    delete Backwards;
+  }    
+  
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f);
+  void forwards(Complex *f);
+  
+  // F is an array of max(A,B) pointers to distinct data blocks each of
+  // size n, with the data in the first m values (contents not preserved).
+  // The outputs are returned in the first m values of F[0],...,F[B-1].
+  void convolve(Complex **F, multiplier *pmult);
+
+  // Compute f (*) g. The distinct input arrays f and g are each of size n 
+  // (contents not preserved). The output is returned in f.
+  void convolve(Complex *f, Complex *g) {
+    checkBinary(A,B);
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+};
+
+// In-place explicitly dealiased 1D Hermitian convolution.
+class ExplicitHConvolution : public ThreadBase {
+protected:
+  unsigned int n,m;
+  unsigned int A,B;
+  rcfft1d *rc;
+  crfft1d *cr;
+public:
+  // u is a temporary array of size n/2+1.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ExplicitHConvolution(unsigned int n, unsigned int m, Complex *u,
+                       unsigned int A=2, unsigned int B=1,
+                       unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), n(n), m(m), A(A), B(B) {
+    rc=new rcfft1d(n,u,threads);
+    cr=new crfft1d(n,u,NULL,threads);
+
+    this->threads=cr->Threads();
+  }
+  
+  ~ExplicitHConvolution() {
+    delete cr;
+    delete rc;
+  }
+    
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f);
+  void forwards(Complex *f);
+  
+  // F is an array of max(A,B) pointers to distinct data blocks each of
+  // size n/2+1, containing the m non-negative Fourier components of real
+  // functions (contents not preserved). The real multiplier is applied to
+  // the n padded real values. The outputs are returned in the first m
+  // elements of F[0],...,F[B-1].
+  void convolve(Complex **F, realmultiplier *pmult);
+  
+// Compute f (*) g, where f and g contain the m non-negative Fourier
+// components of real functions. Dealiasing is internally implemented via
+// explicit zero-padding to size n >= 3*m.
+//
+// The (distinct) input arrays f and g must each be allocated to size n/2+1
+// (contents not preserved). The output is returned in the first m elements
+// of f.
+  void convolve(Complex *f, Complex *g) {
+    checkBinary(A,B);
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+};
+
+// In-place explicitly dealiased 2D complex convolution.
+class ExplicitConvolution2 : public ThreadBase {
+protected:
+  unsigned int nx,ny;
+  unsigned int mx,my;
+  unsigned int A,B;
+  bool prune; // Skip Fourier transforming rows containing all zeroes?
+  mfft1d *xBackwards, *xForwards;
+  mfft1d *yBackwards, *yForwards;
+  fft2d *Backwards, *Forwards;
+public:
+  ExplicitConvolution2(unsigned int nx, unsigned int ny,
+                       unsigned int mx, unsigned int my,
+                       Complex *f, bool prune=false,
+                       unsigned int A=2, unsigned int B=1,
+                       unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), nx(nx), ny(ny), mx(mx), my(my), A(A), B(B),
+    prune(prune) {
+    if(prune) {
+      xBackwards=new mfft1d(nx,1,my,ny,1,f,f,threads);
+      yBackwards=new mfft1d(ny,1,nx,1,ny,f,f,threads);
+      yForwards=new mfft1d(ny,-1,nx,1,ny,f,f,threads);
+      xForwards=new mfft1d(nx,-1,my,ny,1,f,f,threads);
+      this->threads=xForwards->Threads();
+    } else {
+      Backwards=new fft2d(nx,ny,1,f,NULL,threads);
+      Forwards=new fft2d(nx,ny,-1,f,NULL,threads);
+      this->threads=Forwards->Threads();
+    }
+  }
+  
+  ~ExplicitConvolution2() {
+    if(prune) {
+      delete xForwards;
+      delete yForwards;
+      delete yBackwards;
+      delete xBackwards;
+    } else {
+      delete Forwards;
+      delete Backwards;
+    }
+  }    
+  
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f);
+  void forwards(Complex *f);
+
+  // F is an array of max(A,B) pointers to distinct nx x ny data blocks,
+  // with the data in the first my columns of the first mx rows (contents
+  // not preserved).
+  void convolve(Complex **F, multiplier *pmult);
+
+  void convolve(Complex *f, Complex *g) {
+    checkBinary(A,B);
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+};
+
+// In-place explicitly dealiased 2D Hermitian convolution.
+class ExplicitHConvolution2 : public ThreadBase {
+protected:
+  unsigned int nx,ny;
+  unsigned int mx,my;
+  unsigned int M;
+  unsigned int A,B;
+  bool prune; // Skip Fourier transforming rows containing all zeroes?
+  mfft1d *xBackwards;
+  mfft1d *xForwards;
+  mcrfft1d *yBackwards;
+  mrcfft1d *yForwards;
+  crfft2d *Backwards;
+  rcfft2d *Forwards;
+  
+  unsigned int s;
+  Complex *ZetaH,*ZetaL;
+public:  
+  ExplicitHConvolution2(unsigned int nx, unsigned int ny, 
+                        unsigned int mx, unsigned int my,
+                        Complex *f, unsigned int M=1,
+                        bool pruned=false,
+                        unsigned int A=2, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), nx(nx), ny(ny), mx(mx), my(my), M(M), A(A), B(B),
+    prune(pruned) {
+    unsigned int nyp=ny/2+1;
+    // Odd nx requires interleaving of shift with x and y transforms.
+    unsigned int My=my;
+    if(nx % 2) {
+      if(!prune) My=nyp;
+      prune=true;
+      s=BuildZeta(2*nx,nx,ZetaH,ZetaL);
+    }
+
+    if(prune) {
+      xBackwards=new mfft1d(nx,1,My,nyp,1,f,NULL,threads);
+      xForwards=new mfft1d(nx,-1,My,nyp,1,f,NULL,threads);
+
+      {
+        ptrdiff_t cdist=nyp;
+        ptrdiff_t rdist=2*cdist; // in-place transform
+        yForwards=new mrcfft1d(ny,nx,1,1,rdist,cdist,(double*) f,NULL,
+                               threads);
+        yBackwards=new mcrfft1d(ny,nx,1,1,cdist,rdist,f,NULL,threads);
+      }
+      this->threads=xForwards->Threads();
+    } else {
+      Backwards=new crfft2d(nx,ny,f,NULL,threads);
+      Forwards=new rcfft2d(nx,ny,f,threads);
+      this->threads=Forwards->Threads();
+    }
+  }
+  
+  ~ExplicitHConvolution2() {
+    if(prune) {
+      delete xForwards;
+      delete yForwards;
+      delete yBackwards;
+      delete xBackwards;
+    } else {
+      delete Forwards;
+      delete Backwards;
+    }
+  }    
+  
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f, bool shift=true);
+  void forwards(Complex *f);
+
+  // Compute the sum over s < M of F[s] (*) G[s].
+  void convolve(Complex **F, Complex **G, bool symmetrize=true);
+  
+  // Constructor for special case M=1:
+  void convolve(Complex *f, Complex *g, bool symmetrize=true) {
+    convolve(&f,&g,symmetrize);
+  }
+
+  // F is an array of max(A,B) pointers to distinct nx x (ny/2+1) data
+  // blocks, with the data in the first my columns of the 2mx-1 rows
+  // centered on row nx/2 (contents not preserved). The real multiplier is
+  // applied to the nx*ny padded real values; nx and ny must be large
+  // enough to dealias its product.
+  void convolve(Complex **F, realmultiplier *pmult, bool symmetrize=true);
+};
+
+// In-place explicitly dealiased 3D complex convolution.
+class ExplicitConvolution3 : public ThreadBase {
+protected:
+  unsigned int nx,ny,nz;
+  unsigned int mx,my,mz;
+  unsigned int A,B;
+  bool prune; // Skip Fourier transforming rows containing all zeroes?
+  fftguru *xBackwards, *xForwards;
+  fftguru *yBackwards, *yForwards;
+  mfft1d *zBackwards, *zForwards;
+  fft3d *Backwards, *Forwards;
+public:
+  ExplicitConvolution3(unsigned int nx, unsigned int ny, unsigned int nz,
+                       unsigned int mx, unsigned int my, unsigned int mz,
+                       Complex *f, bool prune=false,
+                       unsigned int A=2, unsigned int B=1,
+                       unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), nx(nx), ny(ny), nz(nz), mx(mx), my(my), mz(mz),
+    A(A), B(B), prune(prune) {
+    unsigned int nxy=nx*ny;
+    unsigned int nyz=ny*nz;
+    if(prune) {
+      // Transform the mz nonzero columns of the my nonzero rows in y of
+      // the mx nonzero planes, then all ny rows in x, each in one call.
+      fftw_iodim ydims[]={{(int) ny,(int) nz,(int) nz}};
+      fftw_iodim yhowmany[]={{(int) mx,(int) nyz,(int) nyz},{(int) mz,1,1}};
+      fftw_iodim xdims[]={{(int) nx,(int) nyz,(int) nyz}};
+      fftw_iodim xhowmany[]={{(int) ny,(int) nz,(int) nz},{(int) mz,1,1}};
+      xBackwards=new fftguru(1,xdims,2,xhowmany,1,f,NULL,threads);
+      yBackwards=new fftguru(1,ydims,2,yhowmany,1,f,NULL,threads);
+      zBackwards=new mfft1d(nz,1,nxy,1,nz,f,NULL,threads);
+      zForwards=new mfft1d(nz,-1,nxy,1,nz,f,NULL,threads);
+      yForwards=new fftguru(1,ydims,2,yhowmany,-1,f,NULL,threads);
+      xForwards=new fftguru(1,xdims,2,xhowmany,-1,f,NULL,threads);
+      this->threads=zForwards->Threads();
+    } else {
+      Backwards=new fft3d(nx,ny,nz,1,f,NULL,threads);
+      Forwards=new fft3d(nx,ny,nz,-1,f,NULL,threads);
+      this->threads=Forwards->Threads();
+    }
+  }
+  
+  ~ExplicitConvolution3() {
+    if(prune) {
+      delete xForwards;
+      delete yForwards;
+      delete zForwards;
+      delete zBackwards;
+      delete yBackwards;
+      delete xBackwards;
+    } else {
+      delete Forwards;
+      delete Backwards;
+    }
+  }    
+  
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f);
+  void forwards(Complex *f);
+
+  // F is an array of max(A,B) pointers to distinct nx x ny x nz data
+  // blocks, with the data in the first mx x my x mz corner (contents not
+  // preserved).
+  void convolve(Complex **F, multiplier *pmult);
+
+  void convolve(Complex *f, Complex *g) {
+    checkBinary(A,B);
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+};
+
+// In-place explicitly dealiased Hermitian ternary convolution.
+class ExplicitHTConvolution : public ThreadBase  {
+protected:
+  unsigned int n;
+  unsigned int m;
+  unsigned int A,B;
+  rcfft1d *rc;
+  crfft1d *cr;
+public:
+  // u is a temporary array of size n/2+1.
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ExplicitHTConvolution(unsigned int n, unsigned int m, Complex *u,
+                        unsigned int A=3, unsigned int B=1,
+                        unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), n(n), m(m), A(A), B(B) {
+    rc=new rcfft1d(n,u,threads);
+    cr=new crfft1d(n,u,NULL,threads);
+
+    this->threads=cr->Threads();
+  }
+  
+  ~ExplicitHTConvolution() {
+    delete cr;
+    delete rc;
+  }
+    
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f);
+  void forwards(Complex *f);
+  
+  // F is an array of max(A,B) pointers to distinct data blocks each of
+  // size n/2+1, containing the m non-negative Fourier components of real
+  // functions (contents not preserved). The real multiplier is applied to
+  // the n padded real values. The outputs are returned in the first m
+  // elements of F[0],...,F[B-1].
+  void convolve(Complex **F, realmultiplier *pmult);
+  
+// Compute the ternary convolution of f, and g, and h, where f, and g, and h
+// contain the m non-negative Fourier components of real
+// functions. Dealiasing is internally implemented via explicit
+// zero-padding to size n >= 3*m. The (distinct) input arrays f, g, and h
+// must each be allocated to size n/2+1 (contents not preserved).
+// The output is returned in the first m elements of f.
+  void convolve(Complex *f, Complex *g, Complex *h);
+};
+
+// In-place explicitly dealiased 2D Hermitian ternary convolution.
+class ExplicitHTConvolution2 : public ThreadBase {
+protected:
+  unsigned int nx,ny;
+  unsigned int mx,my;
+  unsigned int A,B;
+  bool prune; // Skip Fourier transforming rows containing all zeroes?
+  mfft1d *xBackwards;
+  mfft1d *xForwards;
+  mcrfft1d *yBackwards;
+  mrcfft1d *yForwards;
+  crfft2d *Backwards;
+  rcfft2d *Forwards;
+  unsigned int s;
+  Complex *ZetaH,*ZetaL;
+
+public:  
+  ExplicitHTConvolution2(unsigned int nx, unsigned int ny, 
+                         unsigned int mx, unsigned int my, Complex *f,
+                         bool pruned=false,
+                         unsigned int A=3, unsigned int B=1,
+                         unsigned int threads=fftw::maxthreads) :
+    ThreadBase(threads), nx(nx), ny(ny), mx(mx), my(my), A(A), B(B),
+    prune(pruned) {
+    unsigned int nyp=ny/2+1;
+    // Odd nx requires interleaving of shift with x and y transforms.
+    unsigned int My=my;
+    if(nx % 2) {
+      if(!prune) My=nyp;
+      prune=true;
+      s=BuildZeta(2*nx,nx,ZetaH,ZetaL);
+    }
+    
+    if(prune) {
+      xBackwards=new mfft1d(nx,1,My,nyp,1,f,NULL,threads);
+      xForwards=new mfft1d(nx,-1,My,nyp,1,f,NULL,threads);
+      {
+        ptrdiff_t cdist=nyp;
+        ptrdiff_t rdist=2*cdist; // in-place transform
+        yForwards=new mrcfft1d(ny,nx,1,1,rdist,cdist,(double*) f,NULL,
+                               threads);
+        yBackwards=new mcrfft1d(ny,nx,1,1,cdist,rdist,f,NULL,threads);
+      }
+
+      this->threads=xForwards->Threads();
+    } else {
+      Backwards=new crfft2d(nx,ny,f,NULL,threads);
+      Forwards=new rcfft2d(nx,ny,f,threads);
+      this->threads=Forwards->Threads();
+    }
+  }
+  
+  ~ExplicitHTConvolution2() {
+    if(prune) {
+      delete xForwards;
+      delete yForwards;
+      delete yBackwards;
+      delete xBackwards;
+    } else {
+      delete Forwards;
+      delete Backwards;
+    }
+  }    
+  
+  void pad(Complex *f);
+  void unpad(Complex *f);
+  void backwards(Complex *f, bool shift=true);
+  void forwards(Complex *f, bool shift=true);
+  void convolve(Complex *f, Complex *g, Complex *h, bool symmetrize=true);
+
+  // F is an array of max(A,B) pointers to distinct nx x (ny/2+1) data
+  // blocks, with the data in the first my columns of the 2mx-1 rows
+  // centered on row nx/2 (contents not preserved). The real multiplier,
+  // which need not be quadratic, is applied to the nx*ny padded real
+  // values.
+  void convolve(Complex **F, realmultiplier *pmult, bool symmetrize=true);
+};
+
+}
+
+#endif
+
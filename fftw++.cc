@@ -11,6 +11,7 @@ const double fftw::twopi=2.0*acos(-1.0);
 // User settings:
 unsigned int fftw::effort=FFTW_MEASURE;
 const char *fftw::WisdomName="wisdom3.txt";
+bool fftw::wisdomLoaded=false;
 unsigned int fftw::maxthreads=1;
 double fftw::testseconds=0.2; // Time limit for threading efficiency tests
 
@@ -27,6 +28,11 @@ crfft1d::Table crfft1d::threadtable;
 mrcfft1d::Table mrcfft1d::threadtable;
 mcrfft1d::Table mcrfft1d::threadtable;
 fft2d::Table fft2d::threadtable;
+rrfft1d::Table rrfft1d::threadtable;
+mrrfft1d::Table mrrfft1d::threadtable;
+fftguru::Table fftguru::threadtable;
+rcfftguru::Table rcfftguru::threadtable;
+crfftguru::Table crfftguru::threadtable;
 
 void LoadWisdom()
 {
@@ -38,7 +44,8 @@ void LoadWisdom()
     wisdom << ifWisdom.rdbuf();
     ifWisdom.close();
     const string& s=wisdom.str();
-    fftw_import_wisdom_from_string(s.c_str());
+    if(!s.empty() && fftw_import_wisdom_from_string(s.c_str()))
+      fftw::wisdomLoaded=true;
     Wise=true;
   }
 }
@@ -55,10 +62,12 @@ void SaveWisdom()
 
 fftw_plan Planner(fftw *F, Complex *in, Complex *out)
 {
+  PlanLock lock;
   LoadWisdom();
+  unsigned int effort=fftw::effort;
   fftw::effort |= FFTW_WISDOM_ONLY;
   fftw_plan plan=F->Plan(in,out);
-  fftw::effort &= !FFTW_WISDOM_ONLY;
+  fftw::effort=effort;
   if(!plan) {
     plan=F->Plan(in,out);
     SaveWisdom();
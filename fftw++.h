@@ -28,6 +28,9 @@
 #include <fftw3.h>
 #include <cerrno>
 #include <map>
+#include <vector>
+
+#include "instrument.h"
 
 #ifndef _OPENMP
 #ifndef FFTWPP_SINGLE_THREAD
@@ -39,6 +42,10 @@
 #include <omp.h>
 #endif
 
+#ifdef FFTWPP_THREADPOOL
+#include <unistd.h>
+#endif
+
 inline int get_thread_num() 
 {
 #ifdef FFTWPP_SINGLE_THREAD
@@ -51,13 +58,22 @@ inline int get_thread_num()
 inline int get_max_threads() 
 {
 #ifdef FFTWPP_SINGLE_THREAD
+#ifdef FFTWPP_THREADPOOL
+  long n=sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? n : 1;
+#else
   return 1;
+#endif
 #else
   return omp_get_max_threads();
 #endif  
 }
 
-#ifndef FFTWPP_SINGLE_THREAD
+// The library's own loops use parallel() instead; PARALLEL remains for the
+// MPI layer and for user code. With the thread pool, these loops are run
+// serially, so that they do not start OpenMP threads that compete with the
+// spinning pool workers.
+#if !defined FFTWPP_SINGLE_THREAD && !defined FFTWPP_THREADPOOL
 #define PARALLEL(code)                                  \
   if(threads > 1) {                                     \
     _Pragma("omp parallel for num_threads(threads)")    \
@@ -80,9 +96,89 @@ typedef std::complex<double> Complex;
 #include "seconds.h"
 #include "statistics.h"
 #include "align.h"
+#include "threadpool.h"
 
 namespace fftwpp {
 
+// Loop bodies for parallel(): scale element i by norm, or zero length
+// elements starting at element i*stride.
+template<class T>
+struct Scale {
+  T *out;
+  double norm;
+  Scale(T *out, double norm) : out(out), norm(norm) {}
+  void operator()(unsigned int i, unsigned int) const {
+    out[i] *= norm;
+  }
+};
+
+struct Zero {
+  Complex *f;
+  size_t stride;
+  unsigned int length;
+  Zero(Complex *f, size_t stride, unsigned int length=1) :
+    f(f), stride(stride), length(length) {}
+  void operator()(unsigned int i, unsigned int) const {
+    Complex *p=f+i*stride;
+    for(unsigned int k=0; k < length; ++k)
+      p[k]=0.0;
+  }
+};
+
+// Scale the M elements, separated by dist, of row i (at offset i*stride).
+template<class T>
+struct ScaleRows {
+  T *out;
+  size_t stride,dist;
+  unsigned int M;
+  double norm;
+  ScaleRows(T *out, size_t stride, size_t dist, unsigned int M,
+            double norm) :
+    out(out), stride(stride), dist(dist), M(M), norm(norm) {}
+  void operator()(unsigned int i, unsigned int) const {
+    T *p=out+i*stride;
+    T *pstop=p+M*dist;
+    for(; p < pstop; p += dist)
+      *p *= norm;
+  }
+};
+
+// The FFTW planner is not thread safe: only the execution of plans is.
+// A PlanLock serializes, across threads, plan creation and destruction
+// together with the planning state of FFTW++ (the effort flags, the wisdom
+// file, and the tables of optimal thread counts). Locks may be nested.
+class PlanLock {
+#ifdef FFTWPP_THREADS
+  static pthread_mutex_t& mutex() {
+    static pthread_mutex_t m;
+    return m;
+  }
+
+  static void init() {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr,PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex(),&attr);
+    pthread_mutexattr_destroy(&attr);
+  }
+public:
+  PlanLock() {
+    static pthread_once_t once=PTHREAD_ONCE_INIT;
+    pthread_once(&once,init);
+    pthread_mutex_lock(&mutex());
+  }
+
+  ~PlanLock() {
+    pthread_mutex_unlock(&mutex());
+  }
+#else
+public:
+  // User-provided so that unused-variable warnings are not issued.
+  PlanLock() {}
+  ~PlanLock() {}
+#endif
+};
+
 // Obsolete names:
 #define FFTWComplex ComplexAlign
 #define FFTWdouble doubleAlign
@@ -142,7 +238,102 @@ inline unsigned int realsize(unsigned int n, double *in, Complex *out)
 {
  return realsize(n,(Complex *) in,out);
 }
+
+// Return the logical size of a real-to-real transform of n values of the
+// given kind, so that a forward transform followed by its inverse
+// multiplies the data by this factor.
+inline unsigned int r2rsize(unsigned int n, fftw_r2r_kind kind)
+{
+  switch(kind) {
+    case FFTW_REDFT00: return 2*(n-1);
+    case FFTW_RODFT00: return 2*(n+1);
+    case FFTW_R2HC: case FFTW_HC2R: case FFTW_DHT: return n;
+    default: return 2*n;
+  }
+}
   
+// Negate the length doubles starting at data+start+k*inc.
+struct NegateRows {
+  double *data;
+  size_t start,inc;
+  unsigned int length;
+  NegateRows(double *data, size_t start, size_t inc, unsigned int length) :
+    data(data), start(start), inc(inc), length(length) {}
+  void operator()(unsigned int k, unsigned int) const {
+    double *p=data+start+k*inc;
+    for(unsigned int j=0; j < length; ++j) p[j]=-p[j];
+  }
+};
+
+// Negate every second block of n doubles in plane i of an array of planes
+// of size planesize, starting with the second block of the even planes.
+struct NegatePlanes {
+  double *data;
+  unsigned int planesize,n;
+  NegatePlanes(double *data, unsigned int planesize, unsigned int n) :
+    data(data), planesize(planesize), n(n) {}
+  void operator()(unsigned int i, unsigned int) const {
+    double *pstart=data+(size_t) i*planesize;
+    double *pstop=pstart+planesize;
+    unsigned int inc=2*n;
+    for(double *p=pstart+(1-(i % 2))*n; p < pstop; p += inc)
+      for(unsigned int j=0; j < n; ++j) p[j]=-p[j];
+  }
+};
+
+// Negate n elements with the given stride of vector 2k+1 of an array of
+// vectors separated by dist.
+template<class T>
+struct NegateStrided {
+  T *data;
+  size_t stride,dist;
+  unsigned int n;
+  NegateStrided(T *data, size_t stride, size_t dist, unsigned int n) :
+    data(data), stride(stride), dist(dist), n(n) {}
+  void operator()(unsigned int k, unsigned int) const {
+    T *p=data+(2*k+1)*dist;
+    size_t nstride=n*stride;
+    for(size_t j=0; j < nstride; j += stride) p[j]=-p[j];
+  }
+};
+
+// Exchange row (i,j) of an nx*ny array of rows of length n with row
+// (i+nx/2,j+ny/2 mod ny), for i < nx/2, which moves the Fourier origin of a
+// Hermitian array with even nx (and ny, unless ny=1) to (nx/2,ny/2,0).
+// In the same pass, zero the Nyquist modes of the shifted array: the rows
+// with i=0 or (for ny > 1) j=0 and, if last is true, the last element of
+// each row. The array is shifted after the exchange if forward is true and
+// before it otherwise.
+struct SwapNyquist {
+  Complex *data;
+  unsigned int nx2,ny,ny2,n;
+  bool last,forward;
+  SwapNyquist(Complex *data, unsigned int nx, unsigned int ny,
+              unsigned int n, bool last, bool forward) :
+    data(data), nx2(nx/2), ny(ny), ny2(ny/2), n(n), last(last),
+    forward(forward) {}
+  void operator()(unsigned int r, unsigned int) const {
+    unsigned int i=r/ny;
+    unsigned int j=r-i*ny;
+    unsigned int jq=j+ny2;
+    if(jq >= ny) jq -= ny;
+    Complex *p=data+(size_t) r*n;
+    Complex *q=data+((size_t) (i+nx2)*ny+jq)*n;
+    bool zp=i == 0 || (ny > 1 && j == 0);
+    bool zq=ny > 1 && jq == 0;
+    if(!forward) std::swap(zp,zq);
+    for(unsigned int k=0; k < n; ++k) {
+      Complex t=p[k];
+      p[k]=zp ? 0.0 : q[k];
+      q[k]=zq ? 0.0 : t;
+    }
+    if(last) {
+      p[n-1]=0.0;
+      q[n-1]=0.0;
+    }
+  }
+};
+
 // Base clase for fft routines
 //
 class fftw : public ThreadBase {
@@ -166,27 +357,25 @@ public:
   static unsigned int maxthreads;
   static double testseconds;
   static const char *WisdomName;
+  static bool wisdomLoaded; // Set once LoadWisdom has read a wisdom file.
   static fftw_plan (*planner)(fftw *f, Complex *in, Complex *out);
   
   virtual unsigned int Threads() {return threads;}
   
   static const char *oddshift;
   
+  // Negate n consecutive doubles (written so that compilers vectorize it).
+  static inline void negate(double *p, unsigned int n) {
+    for(unsigned int j=0; j < n; ++j) p[j]=-p[j];
+  }
+
   // Inplace shift of Fourier origin to (nx/2,0) for even nx.
   static void Shift(Complex *data, unsigned int nx, unsigned int ny,
                     unsigned int threads) {
     unsigned int nyp=ny/2+1;
-    unsigned int stop=nx*nyp;
-    if(nx % 2 == 0) {
-      unsigned int inc=2*nyp;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=nyp; i < stop; i += inc) {
-        Complex *p=data+i;
-        for(unsigned int j=0; j < nyp; j++) p[j]=-p[j];
-      }
-    } else {
+    if(nx % 2 == 0)
+      parallel(nx/2,NegateRows((double *) data,2*nyp,4*nyp,2*nyp),threads);
+    else {
       std::cerr << oddshift << std::endl;
       exit(1);
     }
@@ -195,17 +384,9 @@ public:
   // Out-of-place shift of Fourier origin to (nx/2,0) for even nx.
   static void Shift(double *data, unsigned int nx, unsigned int ny,
                     unsigned int threads) {
-    if(nx % 2 == 0) {
-      unsigned int stop=nx*ny;
-      unsigned int inc=2*ny;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=ny; i < stop; i += inc) {
-        double *p=data+i;
-        for(unsigned int j=0; j < ny; j++) p[j]=-p[j];
-      }
-    } else {
+    if(nx % 2 == 0)
+      parallel(nx/2,NegateRows(data,ny,2*ny,ny),threads);
+    else {
       std::cerr << oddshift << std::endl;
       exit(1);
     }
@@ -216,19 +397,9 @@ public:
                     unsigned int nz, unsigned int threads) {
     unsigned int nzp=nz/2+1;
     unsigned int nyzp=ny*nzp;
-    if(nx % 2 == 0 && ny % 2 == 0) {
-      unsigned int pinc=2*nzp;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; i++) {
-        Complex *pstart=data+i*nyzp;
-        Complex *pstop=pstart+nyzp;
-        for(Complex *p=pstart+(1-(i % 2))*nzp; p < pstop; p += pinc) {
-          for(unsigned int k=0; k < nzp; k++) p[k]=-p[k];
-        }
-      }
-    } else {
+    if(nx % 2 == 0 && ny % 2 == 0)
+      parallel(nx,NegatePlanes((double *) data,2*nyzp,2*nzp),threads);
+    else {
       std::cerr << oddshift << " or odd ny" << std::endl;
       exit(1);
     }
@@ -238,35 +409,64 @@ public:
   static void Shift(double *data, unsigned int nx, unsigned int ny,
                     unsigned int nz, unsigned int threads) {
     unsigned int nyz=ny*nz;
-    if(nx % 2 == 0 && ny % 2 == 0) {
-      unsigned int pinc=2*nz;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; i++) {
-        double *pstart=data+i*nyz;
-        double *pstop=pstart+nyz;
-        for(double *p=pstart+(1-(i % 2))*nz; p < pstop; p += pinc) {
-          for(unsigned int k=0; k < nz; k++) p[k]=-p[k];
-        }
-      }
-    } else {
+    if(nx % 2 == 0 && ny % 2 == 0)
+      parallel(nx,NegatePlanes(data,nyz,nz),threads);
+    else {
       std::cerr << oddshift << " or odd ny" << std::endl;
       exit(1);
     }
   }
   
+  // Shift the origin of the vector index of M vectors, each of length n,
+  // to M/2 for even M, by negating the odd vectors.
+  template<class T>
+  static void Shift(T *data, unsigned int n, unsigned int M, size_t stride,
+                    size_t dist, unsigned int threads) {
+    if(M % 2 == 0) {
+      if(stride == 1) {
+        size_t size=sizeof(T)/sizeof(double);
+        parallel(M/2,NegateRows((double *) data,size*dist,2*size*dist,
+                                n*size),threads);
+      } else
+        parallel(M/2,NegateStrided<T>(data,stride,dist,n),threads);
+    } else {
+      std::cerr << "Shift is not implemented for odd M" << std::endl;
+      exit(1);
+    }
+  }
+
+  // Shift the Fourier origin of the Hermitian array f of nx*ny rows of n
+  // Complex values to (nx/2,ny/2,0) (ny=1 in two dimensions) and zero its
+  // Nyquist modes in one pass; the last element of each row is a Nyquist
+  // mode if nz, the real length of a row, is even. If forward is false, f
+  // is instead restored from a shifted array.
+  static void ShiftdeNyquist(Complex *f, unsigned int nx, unsigned int ny,
+                             unsigned int nz, bool forward,
+                             unsigned int threads) {
+    parallel(nx/2*ny,SwapNyquist(f,nx,ny,nz/2+1,nz % 2 == 0,forward),
+             threads);
+  }
+
   fftw() : plan(NULL) {}
   fftw(unsigned int doubles, int sign, unsigned int threads,
        unsigned int n=0) :
     doubles(doubles), sign(sign), threads(threads), 
     norm(1.0/(n ? n : doubles/2)), plan(NULL) {
-#ifndef FFTWPP_SINGLE_THREAD
-    fftw_init_threads();
+#ifdef FFTWPP_THREADS
+    PlanLock lock;
+    static bool initialized=false;
+    if(!initialized) {
+      fftw_init_threads();
+#ifdef FFTWPP_THREADPOOL
+      if(fftwCallback()) fftw_threads_set_callback(fftwThreadPool,NULL);
+#endif      
+      initialized=true;
+    }
 #endif      
   }
   
   virtual ~fftw() {
+    PlanLock lock;
     if(plan) fftw_destroy_plan(plan);
   }
   
@@ -283,9 +483,10 @@ public:
     exit(1);
   }
   
+  // Set the number of threads of subsequent plans (the caller must hold a
+  // PlanLock).
   static void planThreads(unsigned int threads) {
-#ifndef FFTWPP_SINGLE_THREAD
-    omp_set_num_threads(threads);
+#ifdef FFTWPP_THREADS
     fftw_plan_with_nthreads(threads);
 #endif    
   }
@@ -353,6 +554,7 @@ public:
   }
   
   threaddata Setup(Complex *in, Complex *out=NULL) {
+    PlanLock lock;
     bool alloc=!in;
     if(alloc) in=utils::ComplexAlign((doubles+1)/2);
     out=CheckAlign(in,out);
@@ -391,6 +593,10 @@ public:
   threaddata Setup(double *in, Complex *out=NULL) {
     return Setup((Complex *) in,out);
   }
+
+  threaddata Setup(double *in, double *out) {
+    return Setup((Complex *) in,(Complex *) out);
+  }
   
   virtual void Execute(Complex *in, Complex *out, bool=false) {
     fftw_execute_dft(plan,(fftw_complex *) in,(fftw_complex *) out);
@@ -406,6 +612,8 @@ public:
   }
   
   void fft(Complex *in, Complex *out=NULL) {
+    FFTWPP_PHASE(FFT,2.0*sizeof(double)*doubles,
+                 instrument::fftflops(0.5*doubles,1.0/norm));
     out=Setout(in,out);
     Execute(in,out);
   }
@@ -417,8 +625,14 @@ public:
   void fft(Complex *in, double *out) {
     fft(in,(Complex *) out);
   }
+
+  void fft(double *in, double *out) {
+    fft((Complex *) in,(Complex *) out);
+  }
   
   void fft0(Complex *in, Complex *out=NULL) {
+    FFTWPP_PHASE(FFT,2.0*sizeof(double)*doubles,
+                 instrument::fftflops(0.5*doubles,1.0/norm));
     out=Setout(in,out);
     Execute(in,out,true);
   }
@@ -432,18 +646,11 @@ public:
   }
   
   void Normalize(Complex *out) {
-    unsigned int stop=doubles/2;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-    for(unsigned int i=0; i < stop; i++) out[i] *= norm;
+    parallel(doubles/2,Scale<Complex>(out,norm),threads);
   }
 
   void Normalize(double *out) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-    for(unsigned int i=0; i < doubles; i++) out[i] *= norm;
+    parallel(doubles,Scale<double>(out,norm),threads);
   }
   
   virtual void fftNormalized(Complex *in, Complex *out=NULL, bool shift=false) 
@@ -471,17 +678,7 @@ public:
   template<class O>
   void Normalize(unsigned int nx, unsigned int M, size_t ostride,
                  size_t odist, O *out) {
-    unsigned int stop=nx*ostride;
-    O *outMdist=out+M*odist;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-    for(unsigned int i=0; i < stop; i += ostride) {
-      O *pstop=outMdist+i;
-      for(O *p=out+i; p < pstop; p += odist) {
-        *p *= norm;
-      }
-    }
+    parallel(nx,ScaleRows<O>(out,ostride,odist,M,norm),threads);
   }
   
   template<class I, class O>
@@ -520,6 +717,8 @@ public:
     size /= sizeof(double);
     length *= size;
 
+    PlanLock lock;
+
     if(!out) out=in;
     inplace=(out==in);
     if(inplace) {
@@ -577,6 +776,7 @@ public:
   }
 
   ~Transpose() {
+    PlanLock lock;
     if(plan) fftw_destroy_plan(plan);
     if(plan2) fftw_destroy_plan(plan2);
   }
@@ -589,42 +789,31 @@ public:
       std::cerr << "ERROR: Transpose " << inout << std::endl;
       exit(1);
     }
-#ifndef FFTWPP_SINGLE_THREAD
-    if(a > 1) {
-      if(b > 1) {
-        int A=a, B=b;
-#pragma omp parallel for num_threads(A)
-        for(unsigned int i=0; i < a; ++i) {
-          unsigned int I=i*nlength;
-#pragma omp parallel for num_threads(B)
-          for(unsigned int j=0; j < b; ++j) {
-            unsigned int J=j*mlength;
-            fftw_execute_r2r((i < ilast && j < jlast) ? plan : plan2,
-                             (double *) in+cols*I+J,
-                             (double *) out+rows*J+I);
-          }
-        }
-      } else {
-        int A=a;
-#pragma omp parallel for num_threads(A)
-        for(unsigned int i=0; i < a; ++i) {
-          unsigned int I=i*nlength;
-          fftw_execute_r2r(i < ilast ? plan : plan2,
-                           (double *) in+cols*I,(double *) out+I);
-        }
-      }
-    } else if(b > 1) {
-      int B=b;
-#pragma omp parallel for num_threads(B)
-      for(unsigned int j=0; j < b; ++j) {
-        unsigned int J=j*mlength;
-        fftw_execute_r2r(j < jlast ? plan : plan2,
-                         (double *) in+J,(double *) out+rows*J);
-      }
-    } else
-#endif
+    unsigned int n=a*b;
+    if(n > 1)
+      parallel(n,Blocks(this,(double *) in,(double *) out),n);
+    else
       fftw_execute_r2r(plan,(double *) in,(double*) out);
   }
+
+  // Transpose block k=i*b+j of the a*b blocks.
+  void block(double *in, double *out, unsigned int k) const {
+    unsigned int i=k/b, j=k % b;
+    unsigned int I=i*nlength;
+    unsigned int J=j*mlength;
+    fftw_execute_r2r((i < ilast && j < jlast) ? plan : plan2,
+                     in+cols*I+J,out+rows*J+I);
+  }
+
+  struct Blocks {
+    const Transpose *T;
+    double *in,*out;
+    Blocks(const Transpose *T, double *in, double *out) :
+      T(T), in(in), out(out) {}
+    void operator()(unsigned int k, unsigned int) const {
+      T->block(in,out,k);
+    }
+  };
 };
 
 template<class T, class L>
@@ -701,6 +890,66 @@ struct keyless3 {
   }
 };
 
+struct keytype4 {
+  unsigned int nx;
+  unsigned int ny;
+  unsigned int nz;
+  unsigned int nw;
+  unsigned int threads;
+  bool inplace;
+  keytype4(unsigned int nx, unsigned int ny, unsigned int nz,
+           unsigned int nw, unsigned int threads, bool inplace) : 
+    nx(nx), ny(ny), nz(nz), nw(nw), threads(threads), inplace(inplace) {}
+};
+  
+struct keyless4 {
+  bool operator()(const keytype4& a, const keytype4& b) const {
+    return a.nx < b.nx || (a.nx == b.nx && 
+                           (a.ny < b.ny || (a.ny == b.ny &&
+                                            (a.nz < b.nz ||
+                                             (a.nz == b.nz &&
+                                              (a.nw < b.nw ||
+                                               (a.nw == b.nw &&
+                                                (a.threads < b.threads ||
+                                                 (a.threads == b.threads &&
+                                                  a.inplace < b.inplace)))))))));
+  }
+};
+
+// Key for guru transforms: the rank followed by the length and input and
+// output strides of each transform and batch dimension, so that
+// transforms of the same size but different layouts are timed separately.
+struct keytypeguru {
+  std::vector<ptrdiff_t> layout;
+  unsigned int threads;
+  bool inplace;
+  keytypeguru(int rank, const fftw_iodim *dims, int howmany_rank,
+              const fftw_iodim *howmany, unsigned int threads, bool inplace)
+    : threads(threads), inplace(inplace) {
+    layout.reserve(1+3*(rank+howmany_rank));
+    layout.push_back(rank);
+    for(int i=0; i < rank; ++i) {
+      layout.push_back(dims[i].n);
+      layout.push_back(dims[i].is);
+      layout.push_back(dims[i].os);
+    }
+    for(int i=0; i < howmany_rank; ++i) {
+      layout.push_back(howmany[i].n);
+      layout.push_back(howmany[i].is);
+      layout.push_back(howmany[i].os);
+    }
+  }
+};
+
+struct keylessguru {
+  bool operator()(const keytypeguru& a, const keytypeguru& b) const {
+    return a.layout < b.layout ||
+      (a.layout == b.layout && (a.threads < b.threads ||
+                                (a.threads == b.threads &&
+                                 a.inplace < b.inplace)));
+  }
+};
+
 // Compute the complex Fourier transform of n complex values.
 // Before calling fft(), the arrays in and out (which may coincide) must be
 // allocated as Complex[n].
@@ -771,6 +1020,7 @@ public:
     Q=M;
     R=0;
     
+    PlanLock lock;
     threaddata S1=Setup(in,out);
     fftw_plan planT1=plan;
     
@@ -822,6 +1072,13 @@ public:
     return fftw_plan_many_dft_c2r(1,&nx,Q,in,NULL,istride,idist,
                                   out,NULL,ostride,odist,effort);
   }
+
+  // For real-to-real transforms, sign holds the fftw_r2r_kind.
+  fftw_plan Plan(int Q, double *in, double *out) {
+    fftw_r2r_kind kind=(fftw_r2r_kind) sign;
+    return fftw_plan_many_r2r(1,&nx,Q,in,NULL,istride,idist,
+                              out,NULL,ostride,odist,&kind,effort);
+  }
   
   fftw_plan Plan(Complex *in, Complex *out) {
     if(R > 0) {
@@ -844,29 +1101,42 @@ public:
     fftw_execute_dft_c2r(plan,in,out);
   }
 
+  void Execute(fftw_plan plan, double *in, double *out) {
+    fftw_execute_r2r(plan,in,out);
+  }
+
   void Execute(Complex *in, Complex *out, bool=false) {
     if(T == 1)
       Execute(plan,(I *) in,(O *) out);
+    else
+      parallel(T,Block(this,in,out),T);
+  }
+
+  // Transform block i of the T blocks of vectors.
+  void ExecuteBlock(Complex *in, Complex *out, unsigned int i) {
+    unsigned int extra=T-R;
+    unsigned int iQ=i*Q;
+    if(i < extra)
+      Execute(plan,(I *) in+iQ*idist,(O *) out+iQ*odist);
     else {
-      unsigned int extra=T-R;
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(T)
-#endif
-      for(unsigned int i=0; i < T; ++i) {
-        unsigned int iQ=i*Q;
-        if(i < extra)
-          Execute(plan,(I *) in+iQ*idist,(O *) out+iQ*odist);
-        else {
-          unsigned int offset=iQ+i-extra;
-          Execute(plan2,(I *) in+offset*idist,(O *) out+offset*odist);
-        }
-      }
+      unsigned int offset=iQ+i-extra;
+      Execute(plan2,(I *) in+offset*idist,(O *) out+offset*odist);
     }
   }
+
+  struct Block {
+    fftwblock *F;
+    Complex *in,*out;
+    Block(fftwblock *F, Complex *in, Complex *out) : F(F), in(in), out(out) {}
+    void operator()(unsigned int i, unsigned int) const {
+      F->ExecuteBlock(in,out,i);
+    }
+  };
   
   unsigned int Threads() {return std::max(T,threads);}
   
   ~fftwblock() {
+    PlanLock lock;
     if(plan2) fftw_destroy_plan(plan2);
   }
 };
@@ -1035,7 +1305,9 @@ public:
 //   idist is the spacing between the first elements of the real vectors;
 //   odist is the spacing between the first elements of the Complex vectors;
 //   in contains the n real values stored as a Complex array;
-//   out contains the first n/2+1 Complex Fourier values.
+//   out contains the first n/2+1 Complex Fourier values;
+//   fft0 shifts the origin of the vector index to M/2 (for even M);
+//   fft0deNyquist also zeroes the Nyquist modes in the same pass.
 //
 class mrcfft1d : public fftwblock<double,fftw_complex>,
                  public Threadtable<keytype3,keyless3> {
@@ -1070,6 +1342,62 @@ public:
   void fft0Normalized(double *in, Complex *out=NULL) {
     fftw::fftNormalized<double,Complex>(nx/2+1,M,ostride,odist,in,out,true);
   }
+
+  // The shift is applied to the output, leaving the input intact.
+  void Execute(Complex *in, Complex *out, bool shift=false) {
+    fftwblock<double,fftw_complex>::Execute(in,out);
+    if(shift) Shift(out,nx/2+1,M,ostride,odist,Threads());
+  }
+
+  // Set Nyquist modes of even shifted transforms to zero.
+  void deNyquist(Complex *f) {
+    unsigned int nstride=(nx/2+1)*ostride;
+    if(M % 2 == 0)
+      for(unsigned int j=0; j < nstride; j += ostride)
+        f[j]=0.0;
+    if(nx % 2 == 0) {
+      parallel(M,Zero(f+nstride-ostride,odist),Threads());
+    }
+  }
+
+  // Shifted transform with the Nyquist modes zeroed in the same pass over
+  // the output.
+  void fft0deNyquist(double *in, Complex *out=NULL) {
+    if(M % 2) {
+      std::cerr << "Shift is not implemented for odd M" << std::endl;
+      exit(1);
+    }
+    out=Setout((Complex *) in,out);
+    fftwblock<double,fftw_complex>::Execute((Complex *) in,out);
+    parallel(M,Rows(this,out),Threads());
+  }
+
+  // Shift row r of the output of fft0deNyquist and zero its Nyquist modes.
+  void row(Complex *out, unsigned int r) const {
+    unsigned int n=nx/2+1;
+    unsigned int nstride=n*ostride;
+    Complex *p=out+r*odist;
+    if(r == 0) {
+      for(unsigned int j=0; j < nstride; j += ostride)
+        p[j]=0.0;
+    } else {
+      if(r % 2) {
+        if(ostride == 1) negate((double *) p,2*n);
+        else
+          for(unsigned int j=0; j < nstride; j += ostride) p[j]=-p[j];
+      }
+      if(nx % 2 == 0) p[nstride-ostride]=0.0;
+    }
+  }
+
+  struct Rows {
+    const mrcfft1d *F;
+    Complex *out;
+    Rows(const mrcfft1d *F, Complex *out) : F(F), out(out) {}
+    void operator()(unsigned int r, unsigned int) const {
+      F->row(out,r);
+    }
+  };
 };
 
 // Compute the real inverse Fourier transform of M complex vectors, each of
@@ -1093,7 +1421,8 @@ public:
 //   stride is the spacing between the elements of each Complex vector;
 //   dist is the spacing between the first elements of the vectors;
 //   in contains the first n/2+1 Complex Fourier values;
-//   out contains the n real values stored as a Complex array.
+//   out contains the n real values stored as a Complex array;
+//   fft0 shifts the origin of the vector index to M/2 (for even M).
 //
 class mcrfft1d : public fftwblock<fftw_complex,double>,
                  public Threadtable<keytype3,keyless3> {
@@ -1126,6 +1455,295 @@ public:
   void fft0Normalized(Complex *in, double *out=NULL) {
     fftw::fftNormalized<Complex,double>(nx,M,ostride,odist,in,out,true);
   }
+
+  void Execute(Complex *in, Complex *out, bool shift=false) {
+    fftwblock<fftw_complex,double>::Execute(in,out);
+    if(shift) Shift((double *) out,nx,M,ostride,odist,Threads());
+  }
+
+  // Set Nyquist modes of even shifted transforms to zero.
+  void deNyquist(Complex *f) {
+    unsigned int nstride=(nx/2+1)*istride;
+    if(M % 2 == 0)
+      for(unsigned int j=0; j < nstride; j += istride)
+        f[j]=0.0;
+    if(nx % 2 == 0) {
+      parallel(M,Zero(f+nstride-istride,idist),Threads());
+    }
+  }
+};
+  
+// Return the number of elements spanned by the input (or output) strides of
+// a guru transform over the dimensions dims of the batch dimensions
+// howmany; if half is true, the last transform dimension has length n/2+1.
+// Negative strides are not supported.
+inline size_t guruspan(int rank, const fftw_iodim *dims, int howmany_rank,
+                       const fftw_iodim *howmany, bool output,
+                       bool half=false)
+{
+  size_t span=1;
+  for(int i=0; i < rank+howmany_rank; ++i) {
+    const fftw_iodim& d=i < rank ? dims[i] : howmany[i-rank];
+    int stride=output ? d.os : d.is;
+    if(stride < 0) {
+      std::cerr << "ERROR: negative guru strides are not supported"
+                << std::endl;
+      exit(1);
+    }
+    int n=(half && i == rank-1) ? d.n/2+1 : d.n;
+    span += (size_t) (n-1)*stride;
+  }
+  return span;
+}
+
+// Return the product of the lengths of the given guru dimensions.
+inline unsigned int gurusize(int rank, const fftw_iodim *dims)
+{
+  unsigned int size=1;
+  for(int i=0; i < rank; ++i)
+    size *= dims[i].n;
+  return size;
+}
+
+// Base class for guru transforms: a rank-dimensional transform (with
+// dimensions dims) over a howmany_rank-dimensional batch (with dimensions
+// howmany), where each dimension has its own input and output stride.
+// This allows, for example, sub-arrays of larger arrays to be transformed
+// in place, without copying.
+template<class I, class O>
+class fftwguru : public virtual fftw {
+public:
+  int rank;
+  int howmany_rank;
+  fftw_iodim *dims;
+  fftw_iodim *howmany;
+  fftw_iodim *odims; // Output dimensions (batch dimensions first)
+  unsigned int size,batch;
+  fftwguru(int rank, const fftw_iodim *Dims, int howmany_rank,
+           const fftw_iodim *Howmany, bool half)
+    : rank(rank), howmany_rank(howmany_rank),
+      size(gurusize(rank,Dims)), batch(gurusize(howmany_rank,Howmany)) {
+    dims=new fftw_iodim[rank];
+    for(int i=0; i < rank; ++i)
+      dims[i]=Dims[i];
+    howmany=new fftw_iodim[std::max(howmany_rank,1)];
+    for(int i=0; i < howmany_rank; ++i)
+      howmany[i]=Howmany[i];
+    int orank=howmany_rank+rank;
+    odims=new fftw_iodim[orank];
+    for(int i=0; i < howmany_rank; ++i)
+      odims[i]=Howmany[i];
+    for(int i=0; i < rank; ++i)
+      odims[howmany_rank+i]=Dims[i];
+    if(half) odims[orank-1].n=odims[orank-1].n/2+1;
+  }
+
+  keytypeguru key(unsigned int threads, bool inplace) {
+    return keytypeguru(rank,dims,howmany_rank,howmany,threads,inplace);
+  }
+
+  ~fftwguru() {
+    delete [] odims;
+    delete [] howmany;
+    delete [] dims;
+  }
+
+  fftw_plan Plan(fftw_complex *in, fftw_complex *out) {
+    return fftw_plan_guru_dft(rank,dims,howmany_rank,howmany,in,out,sign,
+                              effort);
+  }
+
+  fftw_plan Plan(double *in, fftw_complex *out) {
+    return fftw_plan_guru_dft_r2c(rank,dims,howmany_rank,howmany,in,out,
+                                  effort);
+  }
+
+  fftw_plan Plan(fftw_complex *in, double *out) {
+    return fftw_plan_guru_dft_c2r(rank,dims,howmany_rank,howmany,in,out,
+                                  effort);
+  }
+
+  fftw_plan Plan(Complex *in, Complex *out) {
+    return Plan((I *) in,(O *) out);
+  }
+
+  void Execute(fftw_complex *in, fftw_complex *out) {
+    fftw_execute_dft(plan,in,out);
+  }
+
+  void Execute(double *in, fftw_complex *out) {
+    fftw_execute_dft_r2c(plan,in,out);
+  }
+
+  void Execute(fftw_complex *in, double *out) {
+    fftw_execute_dft_c2r(plan,in,out);
+  }
+
+  void Execute(Complex *in, Complex *out, bool=false) {
+    Execute((I *) in,(O *) out);
+  }
+
+  // Normalize only the strided output elements, leaving the rest of the
+  // enclosing array untouched.
+  template<class T>
+  void Normalize(T *out, int d) {
+    unsigned int n=odims[d].n;
+    size_t os=odims[d].os;
+    if(d == howmany_rank+rank-1) {
+      for(unsigned int k=0; k < n; ++k)
+        out[k*os] *= norm;
+    } else {
+      for(unsigned int k=0; k < n; ++k)
+        Normalize(out+k*os,d+1);
+    }
+  }
+
+  template<class T>
+  void Normalize(T *out) {
+    unsigned int n=odims[0].n;
+    size_t os=odims[0].os;
+    if(howmany_rank+rank == 1) {
+      Normalize(out,0);
+      return;
+    }
+    parallel(n,Planes<T>(this,out,os),threads);
+  }
+
+  template<class T>
+  struct Planes {
+    fftwguru *F;
+    T *out;
+    size_t os;
+    Planes(fftwguru *F, T *out, size_t os) : F(F), out(out), os(os) {}
+    void operator()(unsigned int k, unsigned int) const {
+      F->Normalize(out+k*os,1);
+    }
+  };
+
+  template<class T, class U>
+  void fftNormalized(T *in, U *out) {
+    out=(U *) Setout((Complex *) in,(Complex *) out);
+    Execute((Complex *) in,(Complex *) out);
+    Normalize(out);
+  }
+};
+
+// Compute the complex guru Fourier transform of a rank-dimensional array,
+// with dimensions dims, over a howmany_rank-dimensional batch, with
+// dimensions howmany. Each fftw_iodim {n,is,os} specifies a length and an
+// input and output stride (in Complex units).
+//
+// Usage (2D transforms of the nz x nw slices of an nx*ny*nz*nw array):
+//
+//   fftw_iodim dims[]={{nz,nw,nw},{nw,1,1}};
+//   fftw_iodim howmany[]={{nx,ny*nz*nw,ny*nz*nw},{ny,nz*nw,nz*nw}};
+//   fftguru Forward(2,dims,2,howmany,-1,in,out);
+//   Forward.fft(in,out);
+//
+class fftguru : public fftwguru<fftw_complex,fftw_complex>,
+                public Threadtable<keytypeguru,keylessguru> {
+  static Table threadtable;
+public:
+  fftguru(int rank, const fftw_iodim *dims, int howmany_rank,
+          const fftw_iodim *howmany, int sign, Complex *in=NULL,
+          Complex *out=NULL, unsigned int threads=maxthreads)
+    : fftw(2*std::max(guruspan(rank,dims,howmany_rank,howmany,false),
+                      guruspan(rank,dims,howmany_rank,howmany,true)),
+           sign,threads,gurusize(rank,dims)),
+      fftwguru<fftw_complex,fftw_complex>(rank,dims,howmany_rank,howmany,
+                                          false) {
+    Setup(in,out);
+  }
+
+  threaddata lookup(bool inplace, unsigned int threads) {
+    return Lookup(threadtable,key(threads,inplace));
+  }
+  void store(bool inplace, const threaddata& data) {
+    Store(threadtable,key(data.threads,inplace),data);
+  }
+
+  void fftNormalized(Complex *in, Complex *out=NULL) {
+    fftwguru<fftw_complex,fftw_complex>::fftNormalized(in,out);
+  }
+};
+
+// Compute the real-to-complex guru Fourier transform of a rank-dimensional
+// array, with dimensions dims, over a howmany_rank-dimensional batch, with
+// dimensions howmany, using phase sign -1. Input strides are in double
+// units and output strides in Complex units; the last transform dimension
+// of the output has length n/2+1.
+//
+// Usage (2D transforms of the nz x nw slices of an nx*ny*nz*nw array):
+//
+//   unsigned int nwp=nw/2+1;
+//   fftw_iodim dims[]={{nz,nw,nwp},{nw,1,1}};
+//   fftw_iodim howmany[]={{nx,ny*nz*nw,ny*nz*nwp},{ny,nz*nw,nz*nwp}};
+//   rcfftguru Forward(2,dims,2,howmany,in,out);
+//   Forward.fft(in,out);
+//
+class rcfftguru : public fftwguru<double,fftw_complex>,
+                  public Threadtable<keytypeguru,keylessguru> {
+  static Table threadtable;
+public:
+  rcfftguru(int rank, const fftw_iodim *dims, int howmany_rank,
+            const fftw_iodim *howmany, double *in=NULL, Complex *out=NULL,
+            unsigned int threads=maxthreads)
+    : fftw(std::max(guruspan(rank,dims,howmany_rank,howmany,false),
+                    2*guruspan(rank,dims,howmany_rank,howmany,true,true)),
+           -1,threads,gurusize(rank,dims)),
+      fftwguru<double,fftw_complex>(rank,dims,howmany_rank,howmany,true) {
+    Setup(in,out);
+  }
+
+  threaddata lookup(bool inplace, unsigned int threads) {
+    return Lookup(threadtable,key(threads,inplace));
+  }
+  void store(bool inplace, const threaddata& data) {
+    Store(threadtable,key(data.threads,inplace),data);
+  }
+
+  void fftNormalized(double *in, Complex *out=NULL) {
+    fftwguru<double,fftw_complex>::fftNormalized(in,out);
+  }
+};
+
+// Compute the complex-to-real guru Fourier transform of a rank-dimensional
+// array, with dimensions dims, over a howmany_rank-dimensional batch, with
+// dimensions howmany, using phase sign +1. Input strides are in Complex
+// units and output strides in double units; the last transform dimension
+// of the input has length n/2+1. The input is destroyed.
+//
+// Usage (inverse of the rcfftguru example, with is and os interchanged):
+//
+//   fftw_iodim idims[]={{nz,nwp,nw},{nw,1,1}};
+//   fftw_iodim ihowmany[]={{nx,ny*nz*nwp,ny*nz*nw},{ny,nz*nwp,nz*nw}};
+//   crfftguru Backward(2,idims,2,ihowmany,in,out);
+//   Backward.fftNormalized(in,out);
+//
+class crfftguru : public fftwguru<fftw_complex,double>,
+                  public Threadtable<keytypeguru,keylessguru> {
+  static Table threadtable;
+public:
+  crfftguru(int rank, const fftw_iodim *dims, int howmany_rank,
+            const fftw_iodim *howmany, Complex *in=NULL, double *out=NULL,
+            unsigned int threads=maxthreads)
+    : fftw(std::max(2*guruspan(rank,dims,howmany_rank,howmany,false,true),
+                    guruspan(rank,dims,howmany_rank,howmany,true)),
+           1,threads,gurusize(rank,dims)),
+      fftwguru<fftw_complex,double>(rank,dims,howmany_rank,howmany,false) {
+    Setup(in,out);
+  }
+
+  threaddata lookup(bool inplace, unsigned int threads) {
+    return Lookup(threadtable,key(threads,inplace));
+  }
+  void store(bool inplace, const threaddata& data) {
+    Store(threadtable,key(data.threads,inplace),data);
+  }
+
+  void fftNormalized(Complex *in, double *out=NULL) {
+    fftwguru<fftw_complex,double>::fftNormalized(in,out);
+  }
 };
   
 // Compute the complex two-dimensional Fourier transform of nx times ny
@@ -1210,7 +1828,8 @@ public:
 // 
 // Notes:
 //   in contains the nx*ny real values stored as a Complex array;
-//   out contains the upper-half portion (ky >= 0) of the Complex transform.
+//   out contains the upper-half portion (ky >= 0) of the Complex transform;
+//   fft0deNyquist also zeroes the Nyquist modes in the same pass.
 //
 class rcfft2d : public fftw {
   unsigned int nx;
@@ -1243,17 +1862,21 @@ public:
   void deNyquist(Complex *f) {
     unsigned int nyp=ny/2+1;
     if(nx % 2 == 0)
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int j=0; j < nyp; ++j)
-        f[j]=0.0;
+      parallel(nyp,Zero(f,1),threads);
     if(ny % 2 == 0)
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; ++i)
-        f[(i+1)*nyp-1]=0.0;
+      parallel(nx,Zero(f+nyp-1,nyp),threads);
+  }
+  // Shifted transform with the Nyquist modes zeroed in the same pass. The
+  // origin is shifted by exchanging the halves of the output, which leaves
+  // the input intact.
+  void fft0deNyquist(double *in, Complex *out=NULL) {
+    if(nx % 2) {
+      std::cerr << oddshift << std::endl;
+      exit(1);
+    }
+    out=Setout((Complex *) in,out);
+    fft(in,out);
+    ShiftdeNyquist(out,nx,1,ny,true,threads);
   }
 };
   
@@ -1279,7 +1902,8 @@ public:
 // 
 // Notes:
 //   in contains the upper-half portion (ky >= 0) of the Complex transform;
-//   out contains the nx*ny real values stored as a Complex array.
+//   out contains the nx*ny real values stored as a Complex array;
+//   fft0deNyquist also zeroes the Nyquist modes in the same pass.
 //
 class crfft2d : public fftw {
   unsigned int nx;
@@ -1312,17 +1936,19 @@ public:
   void deNyquist(Complex *f) {
     unsigned int nyp=ny/2+1;
     if(nx % 2 == 0)
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int j=0; j < nyp; ++j)
-        f[j]=0.0;
+      parallel(nyp,Zero(f,1),threads);
     if(ny % 2 == 0)
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; ++i)
-        f[(i+1)*nyp-1]=0.0;
+      parallel(nx,Zero(f+nyp-1,nyp),threads);
+  }
+  // Shifted transform with the Nyquist modes of the input zeroed in the
+  // same pass that restores its origin; the input is modified.
+  void fft0deNyquist(Complex *in, double *out=NULL) {
+    if(nx % 2) {
+      std::cerr << oddshift << std::endl;
+      exit(1);
+    }
+    ShiftdeNyquist(in,nx,1,ny,false,threads);
+    fft(in,out);
   }
 };
 
@@ -1397,7 +2023,8 @@ public:
 // 
 // Notes:
 //   in contains the nx*ny*nz real values stored as a Complex array;
-//   out contains the upper-half portion (kz >= 0) of the Complex transform.
+//   out contains the upper-half portion (kz >= 0) of the Complex transform;
+//   fft0deNyquist also zeroes the Nyquist modes in the same pass.
 //
 class rcfft3d : public fftw {
   unsigned int nx;
@@ -1432,32 +2059,26 @@ public:
   void deNyquist(Complex *f) {
     unsigned int nzp=nz/2+1;
     unsigned int yz=ny*nzp;
-    if(nx % 2 == 0) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int k=0; k < yz; ++k)
-        f[k]=0.0;
-    }
+    if(nx % 2 == 0)
+      parallel(yz,Zero(f,1),threads);
     
-    if(ny % 2 == 0) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; ++i) {
-        unsigned int iyz=i*yz;
-        for(unsigned int k=0; k < nzp; ++k)
-          f[iyz+k]=0.0;
-      }
-    }
+    if(ny % 2 == 0)
+      parallel(nx,Zero(f,yz,nzp),threads);
         
     if(nz % 2 == 0)
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; ++i)
-        for(unsigned int j=0; j < ny; ++j)
-          f[i*yz+(j+1)*nzp-1]=0.0;
+      parallel(nx*ny,Zero(f+nzp-1,nzp),threads);
+  }
+  // Shifted transform with the Nyquist modes zeroed in the same pass. The
+  // origin is shifted by exchanging opposite rows of the output, which
+  // leaves the input intact.
+  void fft0deNyquist(double *in, Complex *out=NULL) {
+    if(nx % 2 || ny % 2) {
+      std::cerr << oddshift << " or odd ny" << std::endl;
+      exit(1);
+    }
+    out=Setout((Complex *) in,out);
+    fft(in,out);
+    ShiftdeNyquist(out,nx,ny,nz,true,threads);
   }
 };
   
@@ -1483,7 +2104,8 @@ public:
 // 
 // Notes:
 //   in contains the upper-half portion (kz >= 0) of the Complex transform;
-//   out contains the nx*ny*nz real values stored as a Complex array.
+//   out contains the nx*ny*nz real values stored as a Complex array;
+//   fft0deNyquist also zeroes the Nyquist modes in the same pass.
 //
 class crfft3d : public fftw {
   unsigned int nx;
@@ -1517,32 +2139,225 @@ public:
   void deNyquist(Complex *f) {
     unsigned int nzp=nz/2+1;
     unsigned int yz=ny*nzp;
-    if(nx % 2 == 0) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int k=0; k < yz; ++k)
-        f[k]=0.0;
-    }
+    if(nx % 2 == 0)
+      parallel(yz,Zero(f,1),threads);
     
-    if(ny % 2 == 0) {
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; ++i) {
-        unsigned int iyz=i*yz;
-        for(unsigned int k=0; k < nzp; ++k)
-          f[iyz+k]=0.0;
-      }
-    }
+    if(ny % 2 == 0)
+      parallel(nx,Zero(f,yz,nzp),threads);
         
     if(nz % 2 == 0)
-#ifndef FFTWPP_SINGLE_THREAD
-#pragma omp parallel for num_threads(threads)
-#endif
-      for(unsigned int i=0; i < nx; ++i)
-        for(unsigned int j=0; j < ny; ++j)
-          f[i*yz+(j+1)*nzp-1]=0.0;
+      parallel(nx*ny,Zero(f+nzp-1,nzp),threads);
+  }
+  // Shifted transform with the Nyquist modes of the input zeroed in the
+  // same pass that restores its origin; the input is modified.
+  void fft0deNyquist(Complex *in, double *out=NULL) {
+    if(nx % 2 || ny % 2) {
+      std::cerr << oddshift << " or odd ny" << std::endl;
+      exit(1);
+    }
+    ShiftdeNyquist(in,nx,ny,nz,false,threads);
+    fft(in,out);
+  }
+};
+
+// Compute the real-to-real transform of n real values of the given FFTW
+// kind, e.g. FFTW_REDFT10 (DCT-II), FFTW_REDFT01 (DCT-III),
+// FFTW_REDFT00 (DCT-I), or FFTW_RODFT10 (DST-II).
+// Before calling fft(), the arrays in and out (which may coincide) must be
+// allocated as double[n].
+//
+// Out-of-place usage:
+//
+//   rrfft1d Forward(n,FFTW_REDFT10,in,out);
+//   Forward.fft(in,out);
+//
+//   rrfft1d Backward(n,FFTW_REDFT01,out,in);
+//   Backward.fftNormalized(out,in); // True inverse of Forward.fft(in,out);
+//
+// In-place usage:
+//
+//   rrfft1d Forward(n,FFTW_REDFT10);
+//   Forward.fft(in);
+//
+// Notes:
+//   the normalization factor is 1/r2rsize(n,kind) of the inverse kind.
+//
+class rrfft1d : public fftw, public Threadtable<keytype2,keyless2> {
+  unsigned int nx;
+  static Table threadtable;
+public:
+  rrfft1d(unsigned int nx, fftw_r2r_kind kind, double *in=NULL,
+          double *out=NULL, unsigned int threads=maxthreads)
+    : fftw(nx,kind,threads,r2rsize(nx,kind)), nx(nx) {Setup(in,out);}
+
+  threaddata lookup(bool inplace, unsigned int threads) {
+    return Lookup(threadtable,keytype2(nx,sign,threads,inplace));
+  }
+  void store(bool inplace, const threaddata& data) {
+    Store(threadtable,keytype2(nx,sign,data.threads,inplace),data);
+  }
+
+  fftw_plan Plan(Complex *in, Complex *out) {
+    return fftw_plan_r2r_1d(nx,(double *) in,(double *) out,
+                            (fftw_r2r_kind) sign,effort);
+  }
+
+  void Execute(Complex *in, Complex *out, bool=false) {
+    fftw_execute_r2r(plan,(double *) in,(double *) out);
+  }
+
+  void fftNormalized(double *in, double *out=NULL) {
+    out=(double *) Setout((Complex *) in,(Complex *) out);
+    Execute((Complex *) in,(Complex *) out);
+    Normalize(out);
+  }
+};
+
+// Compute the real-to-real transform of the given FFTW kind of M real
+// vectors, each of length n.
+// Before calling fft(), the arrays in and out (which may coincide) must be
+// allocated as double[M*n].
+//
+// Out-of-place usage:
+//
+//   mrrfft1d Forward(n,FFTW_REDFT10,M,stride,dist,in,out);
+//   Forward.fft(in,out);
+//
+// In-place usage:
+//
+//   mrrfft1d Forward(n,FFTW_REDFT10,M,stride,dist);
+//   Forward.fft(in);
+//
+// Notes:
+//   stride is the spacing between the elements of each vector;
+//   dist is the spacing between the first elements of the vectors.
+//
+class mrrfft1d : public fftwblock<double,double>,
+                 public Threadtable<keytype4,keyless4> {
+  static Table threadtable;
+public:
+  mrrfft1d(unsigned int nx, fftw_r2r_kind kind, unsigned int M=1,
+           size_t stride=1, size_t dist=0, double *in=NULL, double *out=NULL,
+           unsigned int threads=maxthreads) :
+    fftw((nx-1)*stride+(M-1)*Dist(nx,stride,dist)+1,kind,threads,
+         r2rsize(nx,kind)),
+    fftwblock<double,double>
+    (nx,M,stride,stride,dist,dist,(Complex *) in,(Complex *) out,threads) {}
+
+  mrrfft1d(unsigned int nx, fftw_r2r_kind kind, unsigned int M,
+           size_t istride, size_t ostride, size_t idist, size_t odist,
+           double *in=NULL, double *out=NULL,
+           unsigned int threads=maxthreads) :
+    fftw(std::max((nx-1)*istride+(M-1)*Dist(nx,istride,idist)+1,
+                  (nx-1)*ostride+(M-1)*Dist(nx,ostride,odist)+1),kind,
+         threads,r2rsize(nx,kind)),
+    fftwblock<double,double>(nx,M,istride,ostride,idist,odist,(Complex *) in,
+                             (Complex *) out,threads) {}
+
+  threaddata lookup(bool inplace, unsigned int threads) {
+    return Lookup(threadtable,keytype4(nx,sign,Q,R,threads,inplace));
+  }
+  void store(bool inplace, const threaddata& data) {
+    Store(threadtable,keytype4(nx,sign,Q,R,data.threads,inplace),data);
+  }
+
+  void Normalize(double *out) {
+    fftw::Normalize<double>(nx,M,ostride,odist,out);
+  }
+
+  void fftNormalized(double *in, double *out=NULL) {
+    fftw::fftNormalized<double,double>(nx,M,ostride,odist,in,out,false);
+  }
+};
+
+// Compute the two-dimensional real-to-real transform of nx times ny real
+// values, using the FFTW kinds kindx and kindy in the x and y directions.
+// Before calling fft(), the arrays in and out (which may coincide) must be
+// allocated as double[nx*ny].
+//
+// Out-of-place usage:
+//
+//   rrfft2d Forward(nx,ny,FFTW_REDFT10,FFTW_REDFT10,in,out);
+//   Forward.fft(in,out);
+//
+// In-place usage:
+//
+//   rrfft2d Forward(nx,ny,FFTW_REDFT10,FFTW_REDFT10);
+//   Forward.fft(in);
+//
+class rrfft2d : public fftw {
+  unsigned int nx;
+  unsigned int ny;
+  fftw_r2r_kind kindx;
+  fftw_r2r_kind kindy;
+public:
+  rrfft2d(unsigned int nx, unsigned int ny, fftw_r2r_kind kindx,
+          fftw_r2r_kind kindy, double *in=NULL, double *out=NULL,
+          unsigned int threads=maxthreads)
+    : fftw(nx*ny,kindx,threads,r2rsize(nx,kindx)*r2rsize(ny,kindy)),
+      nx(nx), ny(ny), kindx(kindx), kindy(kindy) {Setup(in,out);}
+
+  fftw_plan Plan(Complex *in, Complex *out) {
+    return fftw_plan_r2r_2d(nx,ny,(double *) in,(double *) out,kindx,kindy,
+                            effort);
+  }
+
+  void Execute(Complex *in, Complex *out, bool=false) {
+    fftw_execute_r2r(plan,(double *) in,(double *) out);
+  }
+
+  void fftNormalized(double *in, double *out=NULL) {
+    out=(double *) Setout((Complex *) in,(Complex *) out);
+    Execute((Complex *) in,(Complex *) out);
+    Normalize(out);
+  }
+};
+
+// Compute the three-dimensional real-to-real transform of nx times ny times
+// nz real values, using the FFTW kinds kindx, kindy, and kindz.
+// Before calling fft(), the arrays in and out (which may coincide) must be
+// allocated as double[nx*ny*nz].
+//
+// Out-of-place usage:
+//
+//   rrfft3d Forward(nx,ny,nz,FFTW_REDFT10,FFTW_REDFT10,FFTW_REDFT10,in,out);
+//   Forward.fft(in,out);
+//
+// In-place usage:
+//
+//   rrfft3d Forward(nx,ny,nz,FFTW_REDFT10,FFTW_REDFT10,FFTW_REDFT10);
+//   Forward.fft(in);
+//
+class rrfft3d : public fftw {
+  unsigned int nx;
+  unsigned int ny;
+  unsigned int nz;
+  fftw_r2r_kind kindx;
+  fftw_r2r_kind kindy;
+  fftw_r2r_kind kindz;
+public:
+  rrfft3d(unsigned int nx, unsigned int ny, unsigned int nz,
+          fftw_r2r_kind kindx, fftw_r2r_kind kindy, fftw_r2r_kind kindz,
+          double *in=NULL, double *out=NULL, unsigned int threads=maxthreads)
+    : fftw(nx*ny*nz,kindx,threads,
+           r2rsize(nx,kindx)*r2rsize(ny,kindy)*r2rsize(nz,kindz)),
+      nx(nx), ny(ny), nz(nz), kindx(kindx), kindy(kindy), kindz(kindz) {
+    Setup(in,out);
+  }
+
+  fftw_plan Plan(Complex *in, Complex *out) {
+    return fftw_plan_r2r_3d(nx,ny,nz,(double *) in,(double *) out,
+                            kindx,kindy,kindz,effort);
+  }
+
+  void Execute(Complex *in, Complex *out, bool=false) {
+    fftw_execute_r2r(plan,(double *) in,(double *) out);
+  }
+
+  void fftNormalized(double *in, double *out=NULL) {
+    out=(double *) Setout((Complex *) in,(Complex *) out);
+    Execute((Complex *) in,(Complex *) out);
+    Normalize(out);
   }
 };
 
@@ -0,0 +1,284 @@
+/* Optional per-phase instrumentation for FFTW++
+   Copyright (C) 2016
+   John C. Bowman, University of Alberta
+   Malcolm Roberts, University of Strasbourg
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#ifndef __instrument_h__
+#define __instrument_h__ 1
+
+// Compile with -DFFTWPP_INSTRUMENT to accumulate, for each thread and
+// phase, the wall time, number of calls, bytes moved and estimated
+// floating-point operations of the convolution, padding, FFT and MPI
+// transpose stages. Otherwise the FFTWPP_PHASE hooks expand to nothing
+// and their arguments are not evaluated.
+//
+// The phases pretransform, backwards, multiply, forwards and
+// posttransform partition ImplicitConvolution*::convolve; padbackwards and
+// padforwards time the padded transforms of the outer dimensions; fft
+// counts every call to fftw::fft and fftw::fft0 (including those made
+// within the other phases); transpose and wait time the communication and
+// synchronization stages of mpitranspose. Byte counts are reads plus
+// writes of the data being transformed; FFT operation counts use the
+// standard 5 n log2 n estimate per complex transform of length n.
+// FFTWPP_PHASE times the remainder of the enclosing scope, while
+// FFTWPP_TIME times a single statement.
+//
+// Usage:
+//   fftwpp::instrument::reset();
+//   ...
+//   fftwpp::instrument::counter c=
+//     fftwpp::instrument::get(fftwpp::instrument::FFT);
+//   fftwpp::instrument::dumpJSON("profile.json");
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <math.h>
+
+#include "seconds.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef FFTWPP_INSTRUMENT_MAXTHREADS
+#define FFTWPP_INSTRUMENT_MAXTHREADS 64
+#endif
+
+namespace fftwpp {
+namespace instrument {
+
+enum phase {PRETRANSFORM,BACKWARDS,MULTIPLY,FORWARDS,POSTTRANSFORM,
+            PADBACKWARDS,PADFORWARDS,FFT,TRANSPOSE,WAIT,PHASES};
+
+inline const char *name(unsigned int p)
+{
+  static const char *names[]={"pretransform","backwards","multiply",
+                              "forwards","posttransform","padbackwards",
+                              "padforwards","fft","transpose","wait"};
+  return p < PHASES ? names[p] : "unknown";
+}
+
+// Accumulated statistics of one phase.
+struct counter {
+  double seconds;
+  double calls;
+  double bytes;
+  double flops;
+
+  counter() : seconds(0.0), calls(0.0), bytes(0.0), flops(0.0) {}
+
+  counter& operator += (const counter& c) {
+    seconds += c.seconds;
+    calls += c.calls;
+    bytes += c.bytes;
+    flops += c.flops;
+    return *this;
+  }
+
+  // Achieved bandwidth in GB/s and throughput in GFLOP/s.
+  double bandwidth() const {return seconds > 0.0 ? 1e-9*bytes/seconds : 0.0;}
+  double throughput() const {return seconds > 0.0 ? 1e-9*flops/seconds : 0.0;}
+};
+
+// Counters indexed by thread and phase; each thread writes only its own row.
+inline counter *table()
+{
+  static counter t[FFTWPP_INSTRUMENT_MAXTHREADS*PHASES];
+  return t;
+}
+
+// The MPI rank recorded in the JSON output (set by mpitranspose).
+inline int& rank()
+{
+  static int r=0;
+  return r;
+}
+
+inline void setRank(int r)
+{
+  rank()=r;
+}
+
+// Exit if a thread has no row of its own in the table.
+inline unsigned int checkIndex(unsigned int index)
+{
+  if(index >= FFTWPP_INSTRUMENT_MAXTHREADS) {
+    std::cerr << "ERROR: more than FFTWPP_INSTRUMENT_MAXTHREADS="
+              << FFTWPP_INSTRUMENT_MAXTHREADS
+              << " threads recorded instrumentation; recompile with a larger"
+              << " value" << std::endl;
+    exit(1);
+  }
+  return index;
+}
+
+// The row of the calling thread. Each thread (whether started by OpenMP,
+// the thread pool, a ThreadGroup or the application) is given the next
+// free row the first time that it records, so that threads outside of an
+// OpenMP team do not share row 0. Rows are never shared: a program that
+// records from more than FFTWPP_INSTRUMENT_MAXTHREADS threads exits.
+inline unsigned int threadIndex()
+{
+#ifdef __GNUC__
+  static unsigned int next=0;
+  static __thread int index=-1;
+  if(index < 0) index=checkIndex(__sync_fetch_and_add(&next,1));
+  return index;
+#elif defined _OPENMP
+  return checkIndex(omp_get_thread_num());
+#else
+  return 0;
+#endif
+}
+
+inline double wallclock()
+{
+#ifdef _OPENMP
+  return omp_get_wtime();
+#else
+  return utils::totalseconds();
+#endif
+}
+
+// Number of threads that have recorded any activity.
+inline unsigned int threadsUsed()
+{
+  counter *t=table();
+  unsigned int used=1;
+  for(unsigned int i=0; i < FFTWPP_INSTRUMENT_MAXTHREADS; ++i)
+    for(unsigned int p=0; p < PHASES; ++p)
+      if(t[i*PHASES+p].calls > 0) used=i+1;
+  return used;
+}
+
+inline void reset()
+{
+  counter *t=table();
+  for(unsigned int i=0; i < FFTWPP_INSTRUMENT_MAXTHREADS*PHASES; ++i)
+    t[i]=counter();
+}
+
+// Return the statistics of phase p for the given thread, or summed over
+// all threads if thread < 0.
+inline counter get(phase p, int thread=-1)
+{
+  counter *t=table();
+  if(thread >= 0)
+    return t[(thread % FFTWPP_INSTRUMENT_MAXTHREADS)*PHASES+p];
+  counter sum;
+  for(unsigned int i=0; i < FFTWPP_INSTRUMENT_MAXTHREADS; ++i)
+    sum += t[i*PHASES+p];
+  return sum;
+}
+
+inline void record(phase p, double seconds, double bytes, double flops)
+{
+  counter& c=table()[threadIndex()*PHASES+p];
+  c.seconds += seconds;
+  c.calls += 1.0;
+  c.bytes += bytes;
+  c.flops += flops;
+}
+
+// Accumulate the wall time spent in the enclosing scope.
+class scope {
+  phase p;
+  double bytes,flops;
+  double start;
+public:
+  scope(phase p, double bytes=0.0, double flops=0.0) :
+    p(p), bytes(bytes), flops(flops), start(wallclock()) {}
+  ~scope() {record(p,wallclock()-start,bytes,flops);}
+};
+
+// Estimated operation count of complex transforms of total size n
+// (in Complex values) and length length.
+inline double fftflops(double n, double length)
+{
+  return length > 1.0 ? 5.0*n*log2(length) : 0.0;
+}
+
+inline void dumpJSON(std::ostream& os, const counter& c)
+{
+  os << "{\"seconds\": " << c.seconds << ", \"calls\": " << c.calls
+     << ", \"bytes\": " << c.bytes << ", \"flops\": " << c.flops
+     << ", \"GBps\": " << c.bandwidth() << ", \"GFlops\": "
+     << c.throughput() << "}";
+}
+
+// Write the totals and per-thread statistics of every phase as one JSON
+// object.
+inline void dumpJSON(std::ostream& os)
+{
+  std::streamsize precision=os.precision(9);
+  unsigned int threads=threadsUsed();
+  os << "{\"rank\": " << rank() << ", \"threads\": " << threads
+     << ", \"phases\": {";
+  for(unsigned int p=0; p < PHASES; ++p) {
+    if(p > 0) os << ", ";
+    os << std::endl << "  \"" << name(p) << "\": {\"total\": ";
+    dumpJSON(os,get((phase) p));
+    os << ", \"thread\": [";
+    for(unsigned int i=0; i < threads; ++i) {
+      if(i > 0) os << ", ";
+      dumpJSON(os,get((phase) p,i));
+    }
+    os << "]}";
+  }
+  os << std::endl << "}}" << std::endl;
+  os.precision(precision);
+}
+
+// Write the JSON statistics to filename; a "%d" in filename is replaced
+// by the rank, so that each MPI process can write its own file.
+inline void dumpJSON(const char *filename)
+{
+  std::string name(filename);
+  size_t pos=name.find("%d");
+  if(pos != std::string::npos) {
+    std::ostringstream buf;
+    buf << rank();
+    name.replace(pos,2,buf.str());
+  }
+  std::ofstream fout(name.c_str());
+  if(!fout) {
+    std::cerr << "Cannot write instrumentation file " << name
+              << std::endl;
+    return;
+  }
+  dumpJSON(fout);
+}
+
+}
+}
+
+#ifdef FFTWPP_INSTRUMENT
+#define FFTWPP_PHASE(p,bytes,flops)                                     \
+  fftwpp::instrument::scope instrument_scope(fftwpp::instrument::p,bytes,flops)
+#define FFTWPP_TIME(p,bytes,flops,statement)                            \
+  do {FFTWPP_PHASE(p,bytes,flops); statement;} while(0)
+#define FFTWPP_RANK(r) fftwpp::instrument::setRank(r)
+#else
+#define FFTWPP_PHASE(p,bytes,flops)
+#define FFTWPP_TIME(p,bytes,flops,statement) statement
+#define FFTWPP_RANK(r)
+#endif
+
+#endif
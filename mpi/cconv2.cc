@@ -63,7 +63,7 @@ int main(int argc, char* argv[])
   optind=0;
 #endif  
   for (;;) {
-    int c = getopt(argc,argv,"hqta:A:B:N:m:s:x:y:n:T:S:i");
+    int c = getopt(argc,argv,"hbqta:A:B:N:m:s:x:y:n:T:S:i");
     if (c == -1) break;
                 
     switch (c) {
@@ -111,11 +111,15 @@ int main(int argc, char* argv[])
       case 'q':
         quiet=true;
         break;
+      case 'b':
+        balance=true;
+        break;
       case 'h':
       default:
         if(rank == 0) {
           usage(2);
           usageTranspose();
+          cerr << "-b\t\t balanced decomposition" << endl;
         }
         exit(1);
     }
@@ -93,7 +93,7 @@ int main(int argc, char* argv[])
   optind=0;
 #endif  
   for (;;) {
-    int c = getopt(argc,argv,"ihtqa:A:B:N:T:S:m:n:s:x:y:z:");
+    int c = getopt(argc,argv,"ibhtqa:A:B:N:T:S:m:n:s:x:y:z:");
     if (c == -1) break;
                 
     switch (c) {
@@ -135,6 +135,9 @@ int main(int argc, char* argv[])
       case 'q':
         quiet=true;
         break;
+      case 'b':
+        balance=true;
+        break;
       case 'T':
         fftw::maxthreads=atoi(optarg);
         break;
@@ -149,6 +152,7 @@ int main(int argc, char* argv[])
         if(rank == 0) {
           usage(3);
           usageTranspose();
+          cerr << "-b\t\t balanced decomposition" << endl;
         }
         exit(1);
     }
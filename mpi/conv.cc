@@ -0,0 +1,267 @@
+#include "mpiconvolution.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+using namespace Array;
+
+// Store modes k and m-k at each local transposed position of F.
+inline void init(Complex **F, split dr, split dc, unsigned int A) 
+{
+  unsigned int m=dr.X*dr.Y;
+  unsigned int M=A/2;
+  double factor=1.0/sqrt((double) M);
+  for(unsigned int s=0; s < M; ++s) {
+    Complex *f=F[s];
+    Complex *g=F[M+s];
+    double S=sqrt(1.0+s);
+    double ffactor=S*factor;
+    double gfactor=1.0/S*factor;
+    for(unsigned int i=0; i < dc.x; ++i) {
+      unsigned int k1=dc.x0+i;
+      for(unsigned int j=0; j < dc.Y; ++j) {
+        unsigned int p=i*dc.Y+j;
+        unsigned int K=k1+dr.X*j;
+        unsigned int L=K == 0 ? 0 : m-K;
+        f[p]=ffactor*Complex(K+1,K);
+        g[p]=gfactor*Complex(2*K+1,K);
+        f[dc.n+p]=ffactor*Complex(L+1,L);
+        g[dc.n+p]=gfactor*Complex(2*L+1,L);
+      }
+    }
+  }
+}
+
+// Gather F into the natural order of the m modes.
+void gathermodes(Complex *F, Complex *f, split dr, split dc,
+                 const MPI_Comm& communicator)
+{
+  unsigned int m=dr.X*dr.Y;
+  unsigned int n=dc.X*dc.Y;
+  Complex *lower=ComplexAlign(n);
+  Complex *upper=ComplexAlign(n);
+  gatherx(F,lower,dc,1,communicator);
+  gatherx(F+dc.n,upper,dc,1,communicator);
+  for(unsigned int k1=0; k1 < dc.X; ++k1) {
+    for(unsigned int j=0; j < dc.Y; ++j) {
+      unsigned int K=k1+dr.X*j;
+      f[K]=lower[k1*dc.Y+j];
+      if(K > 0) f[m-K]=upper[k1*dc.Y+j];
+    }
+  }
+  deleteAlign(upper);
+  deleteAlign(lower);
+}
+
+int main(int argc, char* argv[])
+{
+  // Number of iterations.
+  unsigned int N0=1000000;
+  unsigned int N=0;
+  unsigned int mx=4;
+  unsigned int my=4;
+  int divisor=0; // Test for best block divisor
+  int alltoall=-1; // Test for best alltoall routine
+
+  unsigned int outlimit=100;
+    
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+  int retval=0;
+  bool test=false;
+  bool quiet=false;
+  
+  unsigned int A=2; // Number of independent inputs
+  unsigned int B=1; // Number of outputs
+
+  int stats=0;
+  
+  int provided;
+  MPI_Init_thread(&argc,&argv,MPI_THREAD_FUNNELED,&provided);
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  if(rank != 0) opterr=0;
+#ifdef __GNUC__ 
+  optind=0;
+#endif  
+  for (;;) {
+    int c = getopt(argc,argv,"hqta:A:B:N:m:s:x:y:n:T:S:");
+    if (c == -1) break;
+                
+    switch (c) {
+      case 0:
+        break;
+      case 'a':
+        divisor=atoi(optarg);
+        break;
+      case 'A':
+        A=atoi(optarg);
+        break;
+      case 'B':
+        B=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=atoi(optarg);
+        break;
+      case 's':
+        alltoall=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=atoi(optarg);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 't':
+        test=true;
+        break;
+      case 'q':
+        quiet=true;
+        break;
+      case 'h':
+      default:
+        if(rank == 0) {
+          usage(2);
+          usageTranspose();
+          cerr << "The convolution length is x*y." << endl;
+        }
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+
+  unsigned int m=mx*my;
+  if(N == 0) {
+    N=N0/m;
+    if(N < 20) N=20;
+  }
+  
+  MPIgroup group(MPI_COMM_WORLD,mx/2+1);
+
+  if(group.size > 1 && provided < MPI_THREAD_FUNNELED)
+    fftw::maxthreads=1;
+  
+  defaultmpithreads=fftw::maxthreads;
+
+  if(group.rank < group.size) {
+    bool main=group.rank == 0;
+    if(!quiet && main) {
+      seconds();
+      cout << "Configuration: " 
+           << group.size << " nodes X " << fftw::maxthreads 
+           << " threads/node" << endl;
+      cout << "Using MPI VERSION " << MPI_VERSION << endl;
+    } 
+
+    split dr(mx,my,group.active);
+    split dc(mx/2+1,my,group.active);
+  
+    if(B != 1) {
+      cerr << "Only B=1 is implemented" << endl;
+      exit(1);
+    }
+    
+    Complex **F=new Complex *[A];
+    for(unsigned int a=0; a < A; ++a) {
+      F[a]=ComplexAlign(2*dc.n);
+    }
+
+    realmultiplier *mult;
+  
+    switch(A) {
+      case 2: mult=multbinary; break;
+      case 4: mult=multbinary2; break;
+      default: if(main) cout << "A=" << A << " is not yet implemented" << endl;
+        exit(1);
+    }
+
+    if(!quiet && main) {
+      if(!test)
+        cout << "N=" << N << endl;
+      cout << "A=" << A << endl;
+      cout << "m=" << m << " (mx=" << mx << ", my=" << my << ")" << endl;
+    }
+
+    bool showresult = m < outlimit;
+    
+    ImplicitHConvolutionMPI C(dr,dc,mpiOptions(divisor,alltoall),A,B);
+
+    if(test) {
+      init(F,dr,dc,A);
+
+      Complex **Flocal=new Complex *[A];
+      for(unsigned int a=0; a < A; ++a) {
+        Flocal[a]=ComplexAlign(m);
+        gathermodes(F[a],Flocal[a],dr,dc,group.active);
+      }
+      
+      C.convolve(F,mult);
+
+      Complex *Foutgather=ComplexAlign(m);
+      gathermodes(F[0],Foutgather,dr,dc,group.active);
+
+      if(main) {
+        ImplicitHConvolution Clocal(m,true,A,1);
+        Clocal.convolve(Flocal,mult);
+        if(!quiet && showresult) {
+          cout << "Distributed output:" << endl;
+          for(unsigned int k=0; k < m; ++k)
+            cout << Foutgather[k] << endl;
+          cout << "Local output:" << endl;
+          for(unsigned int k=0; k < m; ++k)
+            cout << Flocal[0][k] << endl;
+        }
+        retval += checkerror(Flocal[0],Foutgather,m);
+      }
+
+      deleteAlign(Foutgather);
+      for(unsigned int a=0; a < A; ++a)
+        deleteAlign(Flocal[a]);
+      delete [] Flocal;
+      
+      MPI_Barrier(group.active);
+
+    } else {
+      if(!quiet && main)
+        cout << "Initialized after " << seconds() << " seconds." << endl;
+
+      MPI_Barrier(group.active);
+      
+      double *T=new double[N];
+      for(unsigned int i=0; i < N; ++i) {
+        init(F,dr,dc,A);
+        if(main) seconds();
+        C.convolve(F,mult);
+        if(main) T[i]=seconds();
+      }
+    
+      if(main) 
+        timings("Implicit",m,T,N,stats);
+      delete [] T;
+    }   
+
+    for(unsigned int a=0; a < A; ++a)
+      deleteAlign(F[a]);
+    delete [] F;
+  }
+
+  MPI_Finalize();
+  
+  return retval;
+}
@@ -66,6 +66,7 @@ int main(int argc, char* argv[])
 
   bool xcompact=true;
   bool ycompact=true;
+  bool implicitsymmetry=false;
   int divisor=0; // Test for best block divisor
   int alltoall=-1; // Test for best alltoall routine
 
@@ -82,7 +83,7 @@ int main(int argc, char* argv[])
   optind=0;
 #endif  
   for (;;) {
-    int c = getopt(argc,argv,"hqtA:B:iH:N:a:m:n:s:x:y:T:S:X:Y:");
+    int c = getopt(argc,argv,"hqtA:B:iHN:a:m:n:s:x:y:T:S:X:Y:");
     if (c == -1) break;
                 
     switch (c) {
@@ -133,6 +134,9 @@ int main(int argc, char* argv[])
       case 'Y':
         ycompact=atoi(optarg) == 0;
         break;
+      case 'H':
+        implicitsymmetry=true;
+        break;
       case 'i':
 	// Added for compatibility with the OpenMP version.
         break;
@@ -141,6 +145,7 @@ int main(int argc, char* argv[])
         if(rank == 0) {
           usage(2);
           usageCompact(2);
+          usageSymmetry();
           usageTranspose();
         }
         exit(1);
@@ -211,6 +216,7 @@ int main(int argc, char* argv[])
     
     ImplicitHConvolution2MPI C(mx,my,xcompact,ycompact,d,du,F[0],
                                mpiOptions(divisor,alltoall),A,B);
+    C.ImplicitSymmetry(implicitsymmetry);
     
     if(test) {
       init(F,d,A,xcompact,ycompact);
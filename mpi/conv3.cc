@@ -82,6 +82,7 @@ int main(int argc, char* argv[])
   bool xcompact=true;
   bool ycompact=true;
   bool zcompact=true;
+  bool implicitsymmetry=false;
   int divisor=0; // Test for best block divisor
   int alltoall=-1; // Test for best alltoall routine
 
@@ -100,7 +101,7 @@ int main(int argc, char* argv[])
   optind=0;
 #endif  
   for (;;) {
-    int c = getopt(argc,argv,"hitqA:B:N:a:m:s:x:y:z:n:T:S:X:Y:Z:");
+    int c = getopt(argc,argv,"hitqA:B:HN:a:m:s:x:y:z:n:T:S:X:Y:Z:");
     if (c == -1) break;
                 
     switch (c) {
@@ -157,6 +158,9 @@ int main(int argc, char* argv[])
       case 'Z':
         zcompact=atoi(optarg) == 0;
         break;
+      case 'H':
+        implicitsymmetry=true;
+        break;
       case 'i':
 	// For compatibility reasons with -i option in OpenMP version.
 	break;
@@ -165,6 +169,7 @@ int main(int argc, char* argv[])
         if(rank == 0) {
           usage(3);
           usageCompact(3);
+          usageSymmetry();
           usageTranspose();
         }
         exit(1);
@@ -247,6 +252,7 @@ int main(int argc, char* argv[])
     
     ImplicitHConvolution3MPI C(mx,my,mz,xcompact,ycompact,zcompact,d,du,F[0],
                                mpiOptions(divisor,alltoall),A,B);
+    C.ImplicitSymmetry(implicitsymmetry);
     
     if(test) {
       init(F,d,A,xcompact,ycompact,zcompact);
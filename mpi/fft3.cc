@@ -151,6 +151,7 @@ int main(int argc, char* argv[])
     bool showresult = nx*ny*nz < outlimit;
     
     split3 d(nx,ny,nz,group);
+    if(!quiet) showvolume(d,group);
     
     Complex *f=ComplexAlign(d.n);
     Complex *g=inplace ? f : ComplexAlign(d.n);
@@ -0,0 +1,225 @@
+#include "Array.h"
+#include "mpifftw++.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+using namespace Array;
+
+inline void init(Complex *f,
+                 unsigned int X, unsigned int Y, unsigned int Z,
+                 unsigned int x0, unsigned int y0, unsigned int z0,
+                 unsigned int x, unsigned int y, unsigned int z,
+                 unsigned int stride)
+{
+  for(unsigned int i=0; i < x; ++i) {
+    unsigned int ii=x0+i;
+    for(unsigned int j=0; j < y; j++) {
+      unsigned int jj=y0+j;
+      Complex *fij=f+(i*y+j)*stride;
+      for(unsigned int k=0; k < z; k++) {
+        unsigned int kk=z0+k;
+        fij[k]=Complex(10*kk+ii,jj);
+      }
+    }
+  }
+}
+
+// Compare a local block with the data read back from the file.
+int compare(const Complex *f, const Complex *g, unsigned int n,
+            unsigned int length, unsigned int stride)
+{
+  int retval=0;
+  for(unsigned int i=0; i < n; ++i)
+    for(unsigned int k=0; k < length; ++k)
+      if(f[i*stride+k] != g[i*stride+k])
+        retval=1;
+  return retval;
+}
+
+// Compare the file contents with the expected global array.
+int check(const char *filename, unsigned int X, unsigned int Y,
+          unsigned int Z)
+{
+  unsigned int n=X*Y*Z;
+  Complex *f=ComplexAlign(n);
+  Complex *g=ComplexAlign(n);
+  init(g,X,Y,Z,0,0,0,X,Y,Z,Z);
+  FILE *fin=fopen(filename,"rb");
+  int retval=0;
+  if(!fin || fread(f,sizeof(Complex),n,fin) != n) retval=1;
+  else retval=compare(f,g,1,n,n);
+  if(fin) fclose(fin);
+  deleteAlign(g);
+  deleteAlign(f);
+  return retval;
+}
+
+int main(int argc, char* argv[])
+{
+  int retval=0; // success!
+
+  bool quiet=false;
+  unsigned int mx=4;
+  unsigned int my=4;
+  unsigned int mz=4;
+  unsigned int pad=0;
+  
+  int provided;
+  MPI_Init_thread(&argc,&argv,MPI_THREAD_FUNNELED,&provided);
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  if(rank != 0) opterr=0;
+#ifdef __GNUC__ 
+  optind=0;
+#endif  
+  for (;;) {
+    int c=getopt(argc,argv,"hm:p:x:y:z:q");
+    if (c == -1) break;
+                
+    switch (c) {
+      case 0:
+        break;
+      case 'm':
+        mx=my=atoi(optarg);
+        break;
+      case 'p':
+        pad=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'q':
+        quiet=true;
+        break;
+      case 'h':
+      default:
+        if(rank == 0) {
+          usageGather();
+          cerr << "-p\t\t row padding of the x*y*Z array" << endl;
+        }
+        exit(1);
+    }
+  }
+
+  if(mx == 0) mx=4;
+  if(my == 0) my=mx;
+  if(mz == 0) mz=mx;
+  
+  MPIgroup group(MPI_COMM_WORLD,mx,my);
+
+  // If the process is unused, then do nothing.
+  if(group.rank < group.size) {
+    
+    bool main=group.rank == 0;
+    const char *filename="io.dat";
+
+    // x*y*Z layout, with padded rows.
+    {
+      split3 d(mx,my,mz,group);
+      unsigned int stride=d.Z+pad;
+      unsigned int n=d.x*d.yz.x;
+      Complex *f=ComplexAlign(n*stride);
+      Complex *g=ComplexAlign(n*stride);
+      init(f,d.X,d.Y,d.Z,d.x0,d.yz.x0,0,d.x,d.yz.x,d.Z,stride);
+      writexy(f,filename,d,group.active,stride);
+      readxy(g,filename,d,group.active,stride);
+      int localerr=compare(f,g,n,d.Z,stride);
+      if(!quiet && localerr)
+        cout << "process " << group.rank << ": readxy FAILED" << endl;
+      retval += localerr;
+      if(main && check(filename,d.X,d.Y,d.Z)) {
+        if(!quiet) cout << "writexy FAILED" << endl;
+        retval++;
+      }
+      deleteAlign(g);
+      deleteAlign(f);
+    }
+
+    // X*y*z layout.
+    {
+      split3 d(mx,my,mz,group,true);
+      unsigned int n=d.X*d.xy.y;
+      Complex *f=ComplexAlign(n*d.z);
+      Complex *g=ComplexAlign(n*d.z);
+      init(f,d.X,d.Y,d.Z,0,d.xy.y0,d.z0,d.X,d.xy.y,d.z,d.z);
+      writeyz(f,filename,d,group.active);
+      readyz(g,filename,d,group.active);
+      int localerr=compare(f,g,n,d.z,d.z);
+      if(!quiet && localerr)
+        cout << "process " << group.rank << ": readyz FAILED" << endl;
+      retval += localerr;
+      if(main && check(filename,d.X,d.Y,d.Z)) {
+        if(!quiet) cout << "writeyz FAILED" << endl;
+        retval++;
+      }
+      deleteAlign(g);
+      deleteAlign(f);
+    }
+
+    // x*Y*Z layout.
+    {
+      split d(mx,my,group.active);
+      unsigned int n=d.x*d.Y;
+      Complex *f=ComplexAlign(n*mz);
+      Complex *g=ComplexAlign(n*mz);
+      init(f,d.X,d.Y,mz,d.x0,0,0,d.x,d.Y,mz,mz);
+      writex(f,filename,d,mz,group.active);
+      readx(g,filename,d,mz,group.active);
+      int localerr=compare(f,g,n,mz,mz);
+      if(!quiet && localerr)
+        cout << "process " << group.rank << ": readx FAILED" << endl;
+      retval += localerr;
+      if(main && check(filename,d.X,d.Y,mz)) {
+        if(!quiet) cout << "writex FAILED" << endl;
+        retval++;
+      }
+      deleteAlign(g);
+      deleteAlign(f);
+    }
+
+    // X*y*Z layout.
+    {
+      split d(mx,my,group.active);
+      unsigned int n=d.X*d.y;
+      Complex *f=ComplexAlign(n*mz);
+      Complex *g=ComplexAlign(n*mz);
+      init(f,d.X,d.Y,mz,0,d.y0,0,d.X,d.y,mz,mz);
+      writey(f,filename,d,mz,group.active);
+      ready(g,filename,d,mz,group.active);
+      int localerr=compare(f,g,n,mz,mz);
+      if(!quiet && localerr)
+        cout << "process " << group.rank << ": ready FAILED" << endl;
+      retval += localerr;
+      if(main && check(filename,d.X,d.Y,mz)) {
+        if(!quiet) cout << "writey FAILED" << endl;
+        retval++;
+      }
+      deleteAlign(g);
+      deleteAlign(f);
+    }
+
+    if(main) remove(filename);
+  }
+
+  int total=0;
+  MPI_Reduce(&retval,&total,1,MPI_INT,MPI_SUM,0,MPI_COMM_WORLD);
+  if(rank == 0) {
+    if(total == 0) {
+      cout << "Test passed." << endl;
+    } else {
+      cout << "Test FAILED!!!" << endl;
+    }
+  }
+
+  MPI_Finalize();
+  return rank == 0 ? total : 0;
+}
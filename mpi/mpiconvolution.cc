@@ -4,6 +4,144 @@ using namespace utils;
 
 namespace fftwpp {
 
+void ImplicitConvolutionMPI::expand(Complex *f, Complex *u)
+{
+  PARALLEL(
+    for(unsigned int K=0; K < m; K += s) {
+      Complex *ZetaL0=ZetaL-K;
+      unsigned int stop=min(K+s,m);
+      Vec H=LOAD(ZetaH+K/s);
+      for(unsigned int k=K; k < stop; ++k)
+        STORE(u+k,ZMULT(ZMULT(H,LOAD(ZetaL0+k)),LOAD(f+k)));
+    }
+    );
+}
+
+void ImplicitConvolutionMPI::reduce(Complex *f, Complex *u)
+{
+  double ninv=0.5/(d.X*d.Y);
+  Vec Ninv=LOAD(ninv);
+  PARALLEL(
+    for(unsigned int K=0; K < m; K += s) {
+      Complex *ZetaL0=ZetaL-K;
+      unsigned int stop=min(K+s,m);
+      Vec H=Ninv*LOAD(ZetaH+K/s);
+      for(unsigned int k=K; k < stop; ++k)
+        STORE(f+k,LOAD(f+k)*Ninv+ZMULTC(ZMULT(H,LOAD(ZetaL0+k)),
+                                           LOAD(u+k)));
+    }
+    );
+}
+
+void ImplicitConvolutionMPI::convolve(Complex **F, multiplier *pmult)
+{
+  for(unsigned int a=0; a < A; ++a) {
+    Complex *f=F[a];
+    Complex *u=U[a];
+    expand(f,u);
+    Fft->iForward(f);
+    Uft->iForward(u);
+    Fft->ForwardWait(f);
+    Uft->ForwardWait(u);
+  }
+
+  unsigned int n=d.x*d.Y;
+  (*pmult)(F,n,0,NULL,0,threads);
+  (*pmult)(U,n,0,NULL,1,threads);
+
+  for(unsigned int b=0; b < B; ++b) {
+    Complex *f=F[b];
+    Complex *u=U[b];
+    Fft->iBackward(f);
+    Uft->iBackward(u);
+    Fft->BackwardWait(f);
+    Uft->BackwardWait(u);
+    reduce(f,u);
+  }
+}
+
+void ImplicitHConvolutionMPI::pretransform(Complex *f, Complex *w,
+                                           unsigned int r)
+{
+  Complex *g=f+dc.n;
+  unsigned int X=dr.X;
+  unsigned int Y=dc.Y;
+  // exp(-2*pi*I*r/3)
+  Complex Omega=r == 0 ? 1.0 : (r == 1 ? conj(zeta3) : zeta3);
+  PARALLEL(
+    for(unsigned int i=0; i < dc.x; ++i) {
+      unsigned int k1=dc.x0+i;
+      unsigned int stop=(i+1)*Y;
+      for(unsigned int p=i*Y, k=k1; p < stop; ++p, k += X) {
+        Complex F=f[p]+conj(g[p])*Omega;
+        if(r > 0) {
+          Complex zeta=ZetaH[k/s]*ZetaL[k % s];
+          w[p]=(r == 1 ? zeta : zeta*zeta)*F;
+        } else w[p]=F;
+      }
+    }
+    );
+  if(dc.x0 == 0 && dc.x > 0) w[0]=f[0];
+}
+
+void ImplicitHConvolutionMPI::posttransform(Complex *w, Complex *h,
+                                            unsigned int r)
+{
+  Complex *H=h+dc.n;
+  unsigned int X=dr.X;
+  unsigned int Y=dc.Y;
+  double ninv=1.0/(3.0*m);
+  // exp(-2*pi*I*r/3)
+  Complex Omega=r == 0 ? 1.0 : (r == 1 ? conj(zeta3) : zeta3);
+  PARALLEL(
+    for(unsigned int i=0; i < dc.x; ++i) {
+      unsigned int k1=dc.x0+i;
+      unsigned int stop=(i+1)*Y;
+      for(unsigned int p=i*Y, k=k1; p < stop; ++p, k += X) {
+        Complex T=ninv*w[p];
+        if(r > 0) {
+          Complex zeta=ZetaH[k/s]*ZetaL[k % s];
+          T *= conj(r == 1 ? zeta : zeta*zeta);
+          h[p] += T;
+          H[p] += Omega*conj(T);
+        } else {
+          h[p]=T;
+          H[p]=conj(T);
+        }
+      }
+    }
+    );
+  if(dc.x0 == 0 && dc.x > 0) H[0]=0.0;
+}
+
+void ImplicitHConvolutionMPI::convolve(Complex **F, realmultiplier *pmult)
+{
+  unsigned int n=dr.x*dr.Y;
+  for(unsigned int r=0; r < 3; ++r) {
+    for(unsigned int a=0; a < A; ++a) {
+      pretransform(F[a],w,r);
+      fft->Backward(w,U[a]);
+    }
+
+    if(n > 0) (*pmult)(U,n,0,NULL,r,threads);
+
+    for(unsigned int b=0; b < B; ++b) {
+      fft->Forward(U[b],w);
+      posttransform(w,v+2*b*dc.n,r);
+    }
+  }
+
+  unsigned int stop=dc.x*dc.Y;
+  for(unsigned int b=0; b < B; ++b) {
+    Complex *f=F[b];
+    Complex *h=v+2*b*dc.n;
+    for(unsigned int i=0; i < stop; ++i) {
+      f[i]=h[i];
+      f[dc.n+i]=h[dc.n+i];
+    }
+  }
+}
+
 void ImplicitConvolution2MPI::convolve(Complex **F, multiplier *pmult,
                                        unsigned int i, unsigned int offset)
 {
@@ -50,8 +188,12 @@ void ImplicitHConvolution2MPI::convolve(Complex **F, realmultiplier *pmult,
   for(unsigned int a=0; a < A; ++a) {
     Complex *f=F[a]+offset;
     Complex *u=U2[a];
-    if(symmetrize)
-      HermitianSymmetrizeX(mx,d.y,mx-xcompact,f);
+    if(symmetrize) {
+      if(implicitsymmetry)
+        HermitianHalfX(mx,d.y,mx-xcompact,f);
+      else
+        HermitianSymmetrizeX(mx,d.y,mx-xcompact,f,threads);
+    }
     xfftpad->expand(f,u);
     xfftpad->Backwards->fft(f);
     if(a > 0) {
@@ -241,6 +383,30 @@ void HermitianSymmetrizeXYMPI(unsigned int mx, unsigned int my,
   if(nu < nx) deleteAlign(u);
 }
 
+// Prepare given (x,y > 0,z=0) and (x > 0,y=0,z=0) data for an implicitly
+// Hermitian transform by zeroing the remaining half of the z=0 plane and
+// doubling the given half. Unlike HermitianSymmetrizeXYMPI, this is local.
+void HermitianHalfXYMPI(unsigned int mx, unsigned int my,
+                        const split3& d, bool xcompact, bool ycompact,
+                        Complex *f)
+{
+  if(d.z0 != 0) return;
+  unsigned int xorigin=mx-xcompact;
+  unsigned int yorigin=my-ycompact;
+  unsigned int stride=d.y*d.z;
+  unsigned int j0=d.y0 == 0 ? !ycompact : 0;
+  for(unsigned int j=j0; j < d.y; ++j) {
+    unsigned int J=d.y0+j;
+    Complex *fj=f+d.z*j;
+    for(unsigned int i=!xcompact; i < d.X; ++i) {
+      if(J < yorigin || (J == yorigin && i < xorigin))
+        fj[stride*i]=0.0;
+      else if(J > yorigin || i > xorigin)
+        fj[stride*i] *= 2.0;
+    }
+  }
+}
+
 void ImplicitHConvolution3MPI::convolve(Complex **F, realmultiplier *pmult,
                                         bool symmetrize, unsigned int i,
                                         unsigned int offset)
@@ -248,8 +414,12 @@ void ImplicitHConvolution3MPI::convolve(Complex **F, realmultiplier *pmult,
   for(unsigned int a=0; a < A; ++a) {
     Complex *f=F[a]+offset;
     Complex *u=U3[a];
-    if(symmetrize)
-      HermitianSymmetrizeXYMPI(mx,my,d,xcompact,ycompact,f,du.n,u);
+    if(symmetrize) {
+      if(implicitsymmetry)
+        HermitianHalfXYMPI(mx,my,d,xcompact,ycompact,f);
+      else
+        HermitianSymmetrizeXYMPI(mx,my,d,xcompact,ycompact,f,du.n,u);
+    }
     xfftpad->expand(f,u);
     xfftpad->Backwards->fft(f);
     if(T && a > 0) {
@@ -296,4 +466,33 @@ void ImplicitHConvolution3MPI::convolve(Complex **F, realmultiplier *pmult,
   }
 }
 
+void ImplicitHTConvolution3MPI::convolve(Complex **F, Complex **G,
+                                         Complex **H, bool symmetrize,
+                                         unsigned int offset)
+{
+  backwards(F,U3,symmetrize,offset);
+  backwards(G,V3,symmetrize,offset);
+  backwards(H,W3,symmetrize,offset);
+  
+  if(T) {
+    for(unsigned int s=0; s < M; ++s) {
+      T->localize1(F[s]+offset);
+      T->localize1(G[s]+offset);
+      T->localize1(H[s]+offset);
+      T->localize1(U3[s]);
+      T->localize1(V3[s]);
+      T->localize1(W3[s]);
+    }
+  }
+  
+  subconvolution(F,G,H,d.x,offset);
+  subconvolution(U3,V3,W3,d.x);
+  
+  if(T) {
+    T->localize0(F[0]+offset);
+    T->localize0(U3[0]);
+  }
+  xfftpad->forwards(F[0]+offset,U3[0]);
+}
+
 } // namespace fftwpp
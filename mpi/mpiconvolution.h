@@ -9,6 +9,196 @@
 
 namespace fftwpp {
 
+// In-place implicitly dealiased distributed 1D complex convolution of
+// length m=d.X*d.Y, where d=split(X,Y,group.active). Each process holds the
+// d.x*d.Y contiguous Fourier modes starting at d.x0*d.Y.
+// The even and odd padded modes are computed with the four-step fft1dMPI;
+// the multiplier sees d.x*d.Y values in transposed order.
+//
+// Example:
+//
+// MPIgroup group(MPI_COMM_WORLD,X);
+// split d(X,Y,group.active);
+// Complex *f=ComplexAlign(d.n);
+// Complex *g=ComplexAlign(d.n);
+// ImplicitConvolutionMPI C(d);
+// C.convolve(f,g);
+class ImplicitConvolutionMPI : public ThreadBase {
+protected:
+  utils::split d;
+  unsigned int m;             // local number of modes
+  unsigned int A,B;
+  Complex *u;
+  Complex **U;
+  bool allocated;
+  unsigned int s;
+  Complex *ZetaH,*ZetaL;
+  fft1dMPI *Fft,*Uft;
+public:
+
+  void init(const utils::mpiOptions& mpi) {
+    unsigned int C=max(A,B);
+    U=new Complex*[C];
+    for(unsigned int a=0; a < C; ++a)
+      U[a]=u+a*d.n;
+
+    d.Activate();
+    Fft=new fft1dMPI(d,U[0],mpi,1);
+    Uft=new fft1dMPI(d,U[0],Fft->T->Options(),1);
+    d.Deactivate();
+
+    m=d.x*d.Y;
+    double arg=twopi/(2.0*d.X*d.Y);
+    s=BuildZeta(arg,m,ZetaH,ZetaL,threads);
+    
+    // Shift the table to the local origin.
+    double theta=arg*d.x0*d.Y;
+    Complex Zeta0=Complex(cos(theta),sin(theta));
+    unsigned int t=utils::ceilquotient(m,s);
+    for(unsigned int a=0; a < t; ++a)
+      ZetaH[a] *= Zeta0;
+  }
+
+  // u is a temporary array of size split(X,Y).n*max(A,B).
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ImplicitConvolutionMPI(const utils::split& d, Complex *u,
+                         utils::mpiOptions mpi=utils::defaultmpiOptions,
+                         unsigned int A=2, unsigned int B=1) :
+    ThreadBase(mpi.threads), d(d), A(A), B(B), u(u), allocated(false) {
+    init(mpi);
+  }
+
+  ImplicitConvolutionMPI(const utils::split& d,
+                         utils::mpiOptions mpi=utils::defaultmpiOptions,
+                         unsigned int A=2, unsigned int B=1) :
+    ThreadBase(mpi.threads), d(d), A(A), B(B),
+    u(utils::ComplexAlign(max(A,B)*d.n)), allocated(true) {
+    init(mpi);
+  }
+
+  virtual ~ImplicitConvolutionMPI() {
+    utils::deleteAlign(ZetaL);
+    utils::deleteAlign(ZetaH);
+    delete Uft;
+    delete Fft;
+    delete [] U;
+    if(allocated) utils::deleteAlign(u);
+  }
+
+  // Compute u[k]=zeta^(k+d.x0*d.Y)*f[k], where zeta=exp(2*pi*I/(2*d.X*d.Y)).
+  void expand(Complex *f, Complex *u);
+
+  // Combine the even and odd padded modes.
+  void reduce(Complex *f, Complex *u);
+
+  // F is an array of max(A,B) pointers to distinct data blocks each of
+  // size d.n (contents not preserved).
+  void convolve(Complex **F, multiplier *pmult);
+
+  // Binary convolution:
+  void convolve(Complex *f, Complex *g) {
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+};
+
+// In-place implicitly dealiased distributed 1D Hermitian convolution of
+// the modes 0 <= k < m=dr.X*dr.Y, where dr=split(X,Y,group.active) and
+// dc=split(X/2+1,Y,group.active). The data use the transposed order of
+// rcfft1dMPI: local element i*dc.Y+j of the first dc.n words of each array
+// holds mode k=(dc.x0+i)+X*j and the same element of the next dc.n words
+// holds mode m-k (ignored for k=0). Mode 0 must be real.
+// The three residues of the 3m padded modes are computed with rcfft1dMPI;
+// the multiplier sees dr.x*dr.Y real values in natural order.
+//
+// Example:
+//
+// MPIgroup group(MPI_COMM_WORLD,X/2+1);
+// split dr(X,Y,group.active);
+// split dc(X/2+1,Y,group.active);
+// Complex *f=ComplexAlign(2*dc.n);
+// Complex *g=ComplexAlign(2*dc.n);
+// ImplicitHConvolutionMPI C(dr,dc);
+// C.convolve(f,g);
+class ImplicitHConvolutionMPI : public ThreadBase {
+protected:
+  utils::split dr,dc;
+  unsigned int m;             // total number of modes
+  unsigned int A,B;
+  unsigned int nr;            // dr.n rounded up to keep U[a] aligned
+  double *u;
+  double **U;
+  Complex *w;
+  Complex *v;
+  bool allocated;
+  unsigned int s;
+  Complex *ZetaH,*ZetaL;
+  rcfft1dMPI *fft;
+public:
+
+  void init(const utils::mpiOptions& mpi) {
+    unsigned int C=max(A,B);
+    U=new double*[C];
+    for(unsigned int a=0; a < C; ++a)
+      U[a]=u+a*nr;
+
+    w=utils::ComplexAlign(dc.n);
+    v=utils::ComplexAlign(2*B*dc.n);
+    fft=new rcfft1dMPI(dr,dc,U[0],w,mpi);
+
+    m=dr.X*dr.Y;
+    s=BuildZeta(3*m,m,ZetaH,ZetaL,threads);
+  }
+
+  // u is a temporary array of size (dr.n+dr.n%2)*max(A,B).
+  // A is the number of inputs.
+  // B is the number of outputs.
+  ImplicitHConvolutionMPI(const utils::split& dr, const utils::split& dc,
+                          double *u,
+                          utils::mpiOptions mpi=utils::defaultmpiOptions,
+                          unsigned int A=2, unsigned int B=1) :
+    ThreadBase(mpi.threads), dr(dr), dc(dc), A(A), B(B), nr(dr.n+dr.n%2),
+    u(u), allocated(false) {
+    init(mpi);
+  }
+
+  ImplicitHConvolutionMPI(const utils::split& dr, const utils::split& dc,
+                          utils::mpiOptions mpi=utils::defaultmpiOptions,
+                          unsigned int A=2, unsigned int B=1) :
+    ThreadBase(mpi.threads), dr(dr), dc(dc), A(A), B(B), nr(dr.n+dr.n%2),
+    u(utils::doubleAlign(max(A,B)*nr)), allocated(true) {
+    init(mpi);
+  }
+
+  virtual ~ImplicitHConvolutionMPI() {
+    utils::deleteAlign(ZetaL);
+    utils::deleteAlign(ZetaH);
+    delete fft;
+    utils::deleteAlign(v);
+    utils::deleteAlign(w);
+    delete [] U;
+    if(allocated) utils::deleteAlign(u);
+  }
+
+  // Fold the modes of f, twiddled for residue r, into the Hermitian
+  // transposed array w.
+  void pretransform(Complex *f, Complex *w, unsigned int r);
+
+  // Accumulate the contribution of residue r in w to the modes of h.
+  void posttransform(Complex *w, Complex *h, unsigned int r);
+
+  // F is an array of max(A,B) pointers to distinct data blocks each of
+  // size 2*dc.n (contents not preserved).
+  void convolve(Complex **F, realmultiplier *pmult);
+
+  // Binary convolution:
+  void convolve(Complex *f, Complex *g) {
+    Complex *F[]={f,g};
+    convolve(F,multbinary);
+  }
+};
+
 // In-place implicitly dealiased 2D complex convolution.
 class ImplicitConvolution2MPI : public ImplicitConvolution2 {
 protected:
@@ -282,6 +472,10 @@ public:
 void HermitianSymmetrizeXYMPI(unsigned int mx, unsigned int my,
                               utils::split3& d, bool xcompact, bool ycompact,
                               Complex *f, unsigned int nu=0, Complex *u=NULL);
+
+void HermitianHalfXYMPI(unsigned int mx, unsigned int my,
+                        const utils::split3& d, bool xcompact, bool ycompact,
+                        Complex *f);
  
 // In-place implicitly dealiased 3D complex convolution.
 class ImplicitHConvolution3MPI : public ImplicitHConvolution3 {
@@ -398,6 +592,10 @@ public:
     HermitianSymmetrizeXYMPI(mx,my,d,xcompact,ycompact,f,du.n,u);
   }
   
+  void HermitianHalf(Complex *f) {
+    HermitianHalfXYMPI(mx,my,d,xcompact,ycompact,f);
+  }
+  
   // F is a pointer to A distinct data blocks each of size
   // (2mx-xcompact)*d.y*d.z, shifted by offset (contents not preserved).
   void convolve(Complex **F, realmultiplier *pmult, bool symmetrize=true,
@@ -411,6 +609,83 @@ public:
 };
 
 
+// In-place implicitly dealiased 3D Hermitian ternary convolution
+// distributed over the x-y plane (slab decomposition only).
+class ImplicitHTConvolution3MPI : public ImplicitHTConvolution3 {
+protected:
+  utils::split3 d;
+  utils::mpitranspose<Complex> *T;
+public:  
+  void initMPI(Complex *f, const utils::mpiOptions& mpi, Complex *work,
+               MPI_Comm global) {
+    if(d.z < d.Z) {
+      int rank;
+      MPI_Comm_rank(d.communicator,&rank);
+      if(rank == 0)
+        std::cerr << "ImplicitHTConvolution3MPI requires a slab decomposition."
+                  << std::endl;
+      exit(1);
+    }
+    global=global ? global : d.communicator;
+    if(d.xy.y < d.Y)
+      T=new utils::mpitranspose<Complex>(d.X,d.Y,d.x,d.xy.y,d.z,f,work,
+                                         d.xy.communicator,mpi,global);
+    else T=NULL;
+  }
+  
+  // d is a spectral split3 of dimensions 2mx x 2my x (mz+1).
+  // f is a temporary array of size d.n needed only during construction.
+  // u1, v1, and w1 are temporary arrays of size (mz+1)*M*threads;
+  // u2, v2, and w2 are temporary arrays of size 2my*(mz+1)*M*threads;
+  // u3, v3, and w3 are temporary arrays of size d.n*M.
+  // M is the number of data blocks (each corresponding to a dot product term).
+  ImplicitHTConvolution3MPI(unsigned int mx, unsigned int my, unsigned int mz,
+                            const utils::split3& d, Complex *f,
+                            Complex *u1, Complex *v1, Complex *w1, 
+                            Complex *u2, Complex *v2, Complex *w2,
+                            Complex *u3, Complex *v3, Complex *w3,
+                            utils::mpiOptions mpi=utils::defaultmpiOptions,
+                            unsigned int M=1,
+                            unsigned int threads=fftw::maxthreads,
+                            Complex *work=NULL, MPI_Comm global=0) :
+    ImplicitHTConvolution3(mx,my,mz,u1,v1,w1,u2,v2,w2,u3,v3,w3,M,threads,
+                           convolveOptions(d.xy.y*d.Z,d.z,0,d.n,mpi)),
+    d(d) {
+    initMPI(f,mpi,work,global);
+  }
+  
+  ImplicitHTConvolution3MPI(unsigned int mx, unsigned int my, unsigned int mz,
+                            const utils::split3& d, Complex *f,
+                            utils::mpiOptions mpi=utils::defaultmpiOptions,
+                            unsigned int M=1,
+                            unsigned int threads=fftw::maxthreads,
+                            Complex *work=NULL, MPI_Comm global=0) :
+    ImplicitHTConvolution3(mx,my,mz,M,threads,
+                           convolveOptions(d.xy.y*d.Z,d.z,0,d.n,mpi)),
+    d(d) {
+    initMPI(f,mpi,work,global);
+  }
+  
+  virtual ~ImplicitHTConvolution3MPI() {
+    if(T) delete T;
+  }
+  
+  void HermitianSymmetrize(Complex *f, Complex *u) {
+    HermitianSymmetrizeXYMPI(mx,my,d,false,false,f,d.n,u);
+  }
+  
+  // F, G, and H are distinct pointers to M distinct data blocks each of size
+  // 2mx*d.xy.y*(mz+1), shifted by offset (contents not preserved).
+  // The output is returned in F[0].
+  void convolve(Complex **F, Complex **G, Complex **H, bool symmetrize=true,
+                unsigned int offset=0);
+  
+  void convolve(Complex *f, Complex *g, Complex *h, bool symmetrize=true) {
+    convolve(&f,&g,&h,symmetrize);
+  }
+};
+
+
 } // namespace fftwpp
 
 #endif
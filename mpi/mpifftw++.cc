@@ -19,6 +19,63 @@ void fft2dMPI::iBackward(Complex *in, Complex *out)
   T->ilocalize1(out);
 }
 
+void fft1dMPI::BuildTwiddle()
+{
+  size_t N=(size_t) d.X*d.Y;
+  s=(unsigned int) sqrt((double) N);
+  unsigned int t=N/s;
+  if((size_t) s*t < N) ++t;
+  double arg=sign*twopi/N;
+  ZetaH=utils::ComplexAlign(t);
+  PARALLEL(
+    for(unsigned int a=0; a < t; ++a) {
+      double theta=(double) s*a*arg;
+      ZetaH[a]=Complex(cos(theta),sin(theta));
+    }
+    );
+  ZetaL=utils::ComplexAlign(s);
+  PARALLEL(
+    for(unsigned int b=0; b < s; ++b) {
+      double theta=b*arg;
+      ZetaL[b]=Complex(cos(theta),sin(theta));
+    }
+    );
+}
+
+void fft1dMPI::Twiddle(Complex *f, int sign)
+{
+  bool Conj=sign != this->sign;
+  PARALLEL(
+    for(unsigned int i=1; i < d.X; ++i) {
+      Complex *fi=f+i*d.y;
+      for(unsigned int j=0; j < d.y; ++j) {
+        size_t k=(size_t) i*(d.y0+j);
+        Complex zeta=ZetaH[k/s]*ZetaL[k % s];
+        fi[j] *= Conj ? conj(zeta) : zeta;
+      }
+    }
+    );
+}
+
+void fft1dMPI::iForward(Complex *in, Complex *out)
+{
+  out=Setout(in,out);
+  T->localize0(in,out);
+  xForward->fft(out);
+  Twiddle(out,sign);
+  T->ilocalize1(out);
+}
+
+void fft1dMPI::iBackward(Complex *in, Complex *out)
+{
+  out=Setout(in,out);
+  yBackward->fft(in,out);
+  T->localize0(out);
+  Twiddle(out,-sign);
+  xBackward->fft(out);
+  T->ilocalize1(out);
+}
+
 void fft3dMPI::iForward(Complex *in, Complex *out)
 {
   out=Setout(in,out);
@@ -78,6 +135,61 @@ void fft3dMPI::BackwardWait0(Complex *out)
   }
 }
 
+void rcfft1dMPI::BuildTwiddle()
+{
+  size_t N=(size_t) dr.X*dr.Y;
+  s=(unsigned int) sqrt((double) N);
+  unsigned int t=N/s;
+  if((size_t) s*t < N) ++t;
+  double arg=sign*twopi/N;
+  ZetaH=utils::ComplexAlign(t);
+  PARALLEL(
+    for(unsigned int a=0; a < t; ++a) {
+      double theta=(double) s*a*arg;
+      ZetaH[a]=Complex(cos(theta),sin(theta));
+    }
+    );
+  ZetaL=utils::ComplexAlign(s);
+  PARALLEL(
+    for(unsigned int b=0; b < s; ++b) {
+      double theta=b*arg;
+      ZetaL[b]=Complex(cos(theta),sin(theta));
+    }
+    );
+}
+
+void rcfft1dMPI::Twiddle(Complex *f, int sign)
+{
+  bool Conj=sign != this->sign;
+  PARALLEL(
+    for(unsigned int i=1; i < dc.X; ++i) {
+      Complex *fi=f+i*dc.y;
+      for(unsigned int j=0; j < dc.y; ++j) {
+        size_t k=(size_t) i*(dc.y0+j);
+        Complex zeta=ZetaH[k/s]*ZetaL[k % s];
+        fi[j] *= Conj ? conj(zeta) : zeta;
+      }
+    }
+    );
+}
+
+void rcfft1dMPI::iForward(double *in, Complex *out)
+{
+  Tr->localize0(in);
+  xForward->fft(in,out);
+  Twiddle(out,sign);
+  Tc->ilocalize1(out);
+}
+
+void rcfft1dMPI::iBackward(Complex *in, double *out)
+{
+  yBackward->fft(in);
+  Tc->localize0(in);
+  Twiddle(in,-sign);
+  xBackward->fft(in,out);
+  Tr->ilocalize1(out);
+}
+
 void rcfft2dMPI::Shift(double *f)
 {
   if(dr.X % 2 == 0) {
@@ -118,6 +118,110 @@ public:
   
 };
 
+// 1D OpenMP/MPI complex in-place and out-of-place
+// Fourier transform of length X*Y, using the four-step factorization
+// j=Y*j1+j2, k=k1+X*k2 of an X x Y matrix, distributed over x.
+// The input is in natural order: each process holds the d.x*d.Y contiguous
+// samples starting at d.x0*d.Y. The output is in transposed order:
+// each process holds the Fourier coefficients k=k1+X*k2 for the d.x values
+// of k1 starting at d.x0 as a d.x x d.Y matrix. Backward inverts Forward.
+// The array must be allocated as split::n Complex words.
+// The sign argument (default -1) of the constructor specfies the sign
+// of the forward transform.
+//
+// Example:
+//
+// MPIgroup group(MPI_COMM_WORLD,nx);
+// split d(nx,ny,group.active);
+// Complex *f=ComplexAlign(d.n);
+// fft1dMPI fft(d,f);
+// fft.Forward(f);
+// fft.Backward(f);
+// fft.Normalize(f);
+// deleteAlign(f);
+//
+// Non-blocking interface:
+//
+// fft.iForward(f);
+// User computation
+// fft.ForwardWait(f);
+
+class fft1dMPI : public fftw {
+protected:
+  utils::split d;
+  mfft1d *xForward,*xBackward;
+  mfft1d *yForward,*yBackward;
+  unsigned int s;
+  Complex *ZetaH,*ZetaL;
+public:
+  utils::mpitranspose<Complex> *T;
+
+  void init(Complex *in, Complex *out, const utils::mpiOptions& options) {
+    d.Activate();
+    out=CheckAlign(in,out);
+    inplace=(in == out);
+
+    T=new utils::mpitranspose<Complex>(d.X,d.Y,d.x,d.y,1,out,d.communicator,
+                                       options);
+    xForward=new mfft1d(d.X,sign,d.y,d.y,1,out,out,threads);
+    xBackward=new mfft1d(d.X,-sign,d.y,d.y,1,out,out,threads);
+    yForward=new mfft1d(d.Y,sign,d.x,1,d.Y,out,out,threads);
+    yBackward=new mfft1d(d.Y,-sign,d.x,1,d.Y,in,out,threads);
+
+    BuildTwiddle();
+    d.Deactivate();
+  }
+
+  fft1dMPI(const utils::split& d, Complex *in,
+           const utils::mpiOptions& options=utils::defaultmpiOptions,
+           int sign=-1) :
+    fftw(2*d.x*d.Y,sign,options.threads,d.X*d.Y), d(d) {
+    init(in,in,options);
+  }
+
+  fft1dMPI(const utils::split& d, Complex *in, Complex *out,
+           const utils::mpiOptions& options=utils::defaultmpiOptions,
+           int sign=-1) :
+    fftw(2*d.x*d.Y,sign,options.threads,d.X*d.Y), d(d) {
+    init(in,out,options);
+  }
+
+  virtual ~fft1dMPI() {
+    utils::deleteAlign(ZetaL);
+    utils::deleteAlign(ZetaH);
+    delete yBackward;
+    delete yForward;
+    delete xBackward;
+    delete xForward;
+    delete T;
+  }
+
+  // Build the factored table of the four-step twiddle factors.
+  void BuildTwiddle();
+
+  // Multiply the X x d.y matrix f by the twiddle factors exp(sign*2*pi*I*
+  // k1*j2/(X*Y)).
+  void Twiddle(Complex *f, int sign);
+
+  virtual void iForward(Complex *in, Complex *out=NULL);
+  virtual void ForwardWait(Complex *out) {
+    T->wait();
+    yForward->fft(out);
+  }
+  void Forward(Complex *in, Complex *out=NULL) {
+    iForward(in,out);
+    ForwardWait(out);
+  }
+  virtual void iBackward(Complex *in, Complex *out=NULL);
+  virtual void BackwardWait(Complex *out) {
+    T->wait();
+  }
+  void Backward(Complex *in, Complex *out=NULL) {
+    iBackward(in,out);
+    BackwardWait(out);
+  }
+};
+
 // 3D OpenMP/MPI complex in-place and out-of-place 
 // xyZ -> Xyz
 // Fourier transform an nx*ny*nz array, distributed first over x and
@@ -259,6 +363,122 @@ public:
   
 };
 
+// 1D OpenMP/MPI real-to-complex and complex-to-real out-of-place
+// Fourier transform of length X*Y, using the four-step factorization
+// j=Y*j1+j2, k=k1+X*k2 of an X x Y matrix.
+//
+// The real array has size X*Y in natural order: each process holds the
+// dr.x*dr.Y contiguous samples starting at dr.x0*dr.Y.
+// The complex array holds the Fourier coefficients k=k1+X*k2 for
+// 0 <= k1 <= X/2 in transposed order, as a dc.x x dc.Y matrix starting at
+// k1=dc.x0; the remaining coefficients follow from Hermitian symmetry.
+// The real array must be allocated as dr.n doubles and the complex
+// array as dc.n Complex words, where dr=split(X,Y) and dc=split(X/2+1,Y).
+//
+// Basic interface:
+// Forward(double *in, Complex *out);   // input destroyed.
+// Backward(Complex *in, double *out);  // input destroyed.
+// Normalize(double *out);
+//
+// Example:
+//
+// MPIgroup group(MPI_COMM_WORLD,nx/2+1);
+// split dr(nx,ny,group.active);
+// split dc(nx/2+1,ny,group.active);
+// double *f=doubleAlign(dr.n);
+// Complex *g=ComplexAlign(dc.n);
+// rcfft1dMPI fft(dr,dc,f,g);
+// fft.Forward(f,g);
+// fft.Backward(g,f);
+// fft.Normalize(f);
+// deleteAlign(g);
+// deleteAlign(f);
+//
+// Non-blocking interface:
+//
+// fft.iForward(f,g);
+// User computation
+// fft.ForwardWait(g);
+
+class rcfft1dMPI : public fftw {
+protected:
+  utils::split dr,dc; // real and complex MPI dimensions.
+  mrcfft1d *xForward;
+  mcrfft1d *xBackward;
+  mfft1d *yForward,*yBackward;
+  unsigned int s;
+  Complex *ZetaH,*ZetaL;
+public:
+  utils::mpitranspose<double> *Tr;
+  utils::mpitranspose<Complex> *Tc;
+
+  void init(double *in, Complex *out, const utils::mpiOptions& options) {
+    if((Complex *) in == out) {
+      std::cerr << "ERROR: rcfft1dMPI requires distinct input and output"
+                << std::endl;
+      exit(1);
+    }
+    dc.Activate();
+    out=CheckAlign((Complex *) in,out);
+    inplace=false;
+
+    Tr=new utils::mpitranspose<double>(dr.X,dr.Y,dr.x,dr.y,1,in,
+                                       dr.communicator,options);
+    Tc=new utils::mpitranspose<Complex>(dc.X,dc.Y,dc.x,dc.y,1,out,
+                                        dc.communicator,options);
+    xForward=new mrcfft1d(dr.X,dr.y,dr.y,dc.y,1,1,in,out,threads);
+    xBackward=new mcrfft1d(dr.X,dr.y,dc.y,dr.y,1,1,out,in,threads);
+    yForward=new mfft1d(dc.Y,-1,dc.x,1,dc.Y,out,out,threads);
+    yBackward=new mfft1d(dc.Y,1,dc.x,1,dc.Y,out,out,threads);
+
+    BuildTwiddle();
+    dc.Deactivate();
+  }
+
+  rcfft1dMPI(const utils::split& dr, const utils::split& dc, double *in,
+             Complex *out,
+             const utils::mpiOptions& options=utils::defaultmpiOptions) :
+    fftw(dr.x*dr.Y,-1,options.threads,dr.X*dr.Y), dr(dr), dc(dc) {
+    init(in,out,options);
+  }
+
+  virtual ~rcfft1dMPI() {
+    utils::deleteAlign(ZetaL);
+    utils::deleteAlign(ZetaH);
+    delete yBackward;
+    delete yForward;
+    delete xBackward;
+    delete xForward;
+    delete Tc;
+    delete Tr;
+  }
+
+  // Build the factored table of the four-step twiddle factors.
+  void BuildTwiddle();
+
+  // Multiply the (X/2+1) x dc.y matrix f by the twiddle factors
+  // exp(sign*2*pi*I*k1*j2/(X*Y)).
+  void Twiddle(Complex *f, int sign);
+
+  virtual void iForward(double *in, Complex *out);
+  virtual void ForwardWait(Complex *out) {
+    Tc->wait();
+    yForward->fft(out);
+  }
+  void Forward(double *in, Complex *out) {
+    iForward(in,out);
+    ForwardWait(out);
+  }
+  virtual void iBackward(Complex *in, double *out);
+  virtual void BackwardWait(double *out) {
+    Tr->wait();
+  }
+  void Backward(Complex *in, double *out) {
+    iBackward(in,out);
+    BackwardWait(out);
+  }
+};
+
 // 2D OpenMP/MPI real-to-complex and complex-to-real in-place and out-of-place
 // xY->Xy distributed FFT.
 //
@@ -13,6 +13,8 @@ public:
   int rank,size;
   MPI_Comm active;                     // active communicator 
   MPI_Comm communicator,communicator2; // 3D transpose communicators
+  int nodesize;                        // processes per shared-memory node
+  int peers,peers2;                    // on-node peers in each communicator
   
   void init(const MPI_Comm& comm) {
     MPI_Comm_rank(comm,&rank);
@@ -30,9 +32,13 @@ public:
     size=ceilquotient(X,xblock);
     activate(comm);
     communicator=communicator2=MPI_COMM_NULL;
+    nodesize=1;
+    peers=peers2=0;
   }
   
 // Distribute first X, then (if allowpencil=true) Y.
+// The process grid is oriented so that, where possible, the transpose over
+// the larger communicator stays within a shared-memory node.
   MPIgroup(const MPI_Comm& comm, unsigned int X, unsigned int Y,
            bool allowPencil=true) {
     init(comm);
@@ -41,17 +47,80 @@ public:
     size=ceilquotient(X,x)*ceilquotient(Y,y);
     
     activate(comm);
+    peers=peers2=0;
     if(rank < size) {
       int major=ceilquotient(size,X);
-      int p=rank % major;
-      int q=rank / major;
+      int minor=size/major;
+      
+      // Number the processes so that those on the same node are contiguous.
+      MPI_Comm ordered;
+      int noderank=nodeinfo();
+      MPI_Comm_split(active,0,noderank,&ordered);
+      int r;
+      MPI_Comm_rank(ordered,&r);
+      MPI_Comm_free(&ordered);
+      
+      // Contiguous processes share communicator2 by default; swap the
+      // orientation if the larger communicator then fits within a node.
+      bool fits=nodesize % minor == 0;
+      bool fits2=nodesize % major == 0;
+      int p,q;
+      if(fits && minor > 1 && (minor > major || !fits2)) {
+        p=r / minor;
+        q=r % minor;
+      } else {
+        p=r % major;
+        q=r / major;
+      }
   
       /* Split nodes into row and columns */ 
       MPI_Comm_split(active,p,q,&communicator);
       MPI_Comm_split(active,q,p,&communicator2);
+      
+      peers=nodepeers(communicator);
+      peers2=nodepeers(communicator2);
     }
   }
 
+  // Determine the (uniform) number of active processes per shared-memory
+  // node, or 1 if this is unknown. Return a key that orders the processes
+  // by node.
+  int nodeinfo() {
+    nodesize=1;
+    int key=rank;
+#if MPI_VERSION >= 3
+    MPI_Comm node;
+    MPI_Comm_split_type(active,MPI_COMM_TYPE_SHARED,rank,MPI_INFO_NULL,&node);
+    int noderank,n;
+    MPI_Comm_rank(node,&noderank);
+    MPI_Comm_size(node,&n);
+    int leader=rank;
+    MPI_Bcast(&leader,1,MPI_INT,0,node);
+    MPI_Comm_free(&node);
+    key=leader*size+noderank;
+    
+    int range[]={-n,n};
+    MPI_Allreduce(MPI_IN_PLACE,range,2,MPI_INT,MPI_MAX,active);
+    if(-range[0] == range[1]) nodesize=n;
+#endif
+    return key;
+  }
+  
+  // Return the number of other processes in communicator on this node.
+  int nodepeers(const MPI_Comm& comm) {
+#if MPI_VERSION >= 3
+    MPI_Comm node;
+    int r,n;
+    MPI_Comm_rank(comm,&r);
+    MPI_Comm_split_type(comm,MPI_COMM_TYPE_SHARED,r,MPI_INFO_NULL,&node);
+    MPI_Comm_size(node,&n);
+    MPI_Comm_free(&node);
+    return n-1;
+#else
+    return 0;
+#endif
+  }
+
   ~MPIgroup(){
     int final;
     MPI_Finalized(&final);
@@ -69,6 +138,8 @@ public:
 // Big letters denote global dimensions; small letters denote local dimensions.
 //            local matrix is X * y
 // local transposed matrix is x * Y
+// If utils::balance=true, remainders are spread one row at a time over the
+// processes; mpitranspose then pads the blocks internally.
 class split {
 public:
   unsigned int X,Y;     // global matrix dimensions
@@ -85,8 +156,8 @@ public:
     MPI_Comm_rank(communicator,&rank);
     MPI_Comm_size(communicator,&size);
     
-    localdimension xdim(X,rank,size);
-    localdimension ydim(Y,rank,size);
+    localdimension xdim(X,rank,size,balance);
+    localdimension ydim(Y,rank,size,balance);
     
     x=xdim.n;
     y=ydim.n;
@@ -188,6 +259,33 @@ public:
   }
 };
 
+// Output the number of words sent by all processes over on-node and
+// off-node links during the xy and yz transposes of a split3 array.
+inline void showvolume(const split3& d, const MPIgroup& group)
+{
+  if(group.rank >= group.size || group.communicator == MPI_COMM_NULL) return;
+  int s,s2;
+  MPI_Comm_size(group.communicator,&s);
+  MPI_Comm_size(group.communicator2,&s2);
+  double xy=(double) d.xy.x*d.Y*d.z/s;
+  double yz=(double) d.x*d.yz.x*d.Z/s2;
+  double volume[]={xy*group.peers,xy*(s-1-group.peers),
+                   yz*group.peers2,yz*(s2-1-group.peers2)};
+  int rank;
+  MPI_Comm_rank(group.active,&rank);
+  MPI_Reduce(rank == 0 ? MPI_IN_PLACE : volume,volume,4,MPI_DOUBLE,MPI_SUM,
+             0,group.active);
+  if(rank == 0) {
+    std::cout << "processes/node=" << group.nodesize << std::endl;
+    std::cout << "xy transpose over " << s << " processes: " << volume[0]
+              << " words on-node, " << volume[1] << " words off-node"
+              << std::endl;
+    std::cout << "yz transpose over " << s2 << " processes: " << volume[2]
+              << " words on-node, " << volume[3] << " words off-node"
+              << std::endl;
+  }
+}
+
 }
 
 #endif
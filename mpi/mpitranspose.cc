@@ -6,6 +6,7 @@ namespace utils {
 double safetyfactor=2.0;
 bool overlap=true;
 double testseconds=0.2;
+bool balance=false;
 mpiOptions defaultmpiOptions;
 
 /* Given a process which_pe and a number of processes npes, fills
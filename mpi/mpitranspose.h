@@ -29,6 +29,10 @@
    wait0();
    // User computation 1      
    wait1();
+
+   If options.compress is set, double-precision data is rounded to float
+   before the transpose and restored to double afterwards, halving the
+   communication volume at the cost of single-precision accuracy.
 */  
   
 #include <mpi.h>
@@ -43,11 +47,16 @@
 #include "transposeoptions.h"
 #include "fftw++.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace utils {
 
 extern double safetyfactor; // For conservative latency estimate.
 extern bool overlap; // Allow overlapped communication.
 extern double testseconds; // Limit for transpose timing tests
+extern bool balance; // Spread remainders evenly over processes in split
 extern mpiOptions defaultmpiOptions;
 
 template<class T>
@@ -84,6 +93,54 @@ inline void copyfromblock(const T *src, T *dest,
     );
 }
 
+// Round length doubles in src to floats in dest.
+inline void double2float(const double *src, float *dest, size_t length,
+                         unsigned int threads=1)
+{
+#ifdef __SSE2__
+  using namespace fftwpp; // cmult-sse2.h includes emmintrin.h in fftwpp
+  size_t stop=length-length % 4;
+  PARALLEL(
+    for(size_t i=0; i < stop; i += 4) {
+      __m128 lo=_mm_cvtpd_ps(_mm_loadu_pd(src+i));
+      __m128 hi=_mm_cvtpd_ps(_mm_loadu_pd(src+i+2));
+      _mm_storeu_ps(dest+i,_mm_movelh_ps(lo,hi));
+    }
+    );
+  for(size_t i=stop; i < length; ++i)
+    dest[i]=src[i];
+#else
+  PARALLEL(
+    for(size_t i=0; i < length; ++i)
+      dest[i]=src[i];
+    );
+#endif
+}
+
+// Convert length floats in src to doubles in dest.
+inline void float2double(const float *src, double *dest, size_t length,
+                         unsigned int threads=1)
+{
+#ifdef __SSE2__
+  using namespace fftwpp; // cmult-sse2.h includes emmintrin.h in fftwpp
+  size_t stop=length-length % 4;
+  PARALLEL(
+    for(size_t i=0; i < stop; i += 4) {
+      __m128 v=_mm_loadu_ps(src+i);
+      _mm_storeu_pd(dest+i,_mm_cvtps_pd(v));
+      _mm_storeu_pd(dest+i+2,_mm_cvtps_pd(_mm_movehl_ps(v,v)));
+    }
+    );
+  for(size_t i=stop; i < length; ++i)
+    dest[i]=src[i];
+#else
+  PARALLEL(
+    for(size_t i=0; i < length; ++i)
+      dest[i]=src[i];
+    );
+#endif
+}
+
 void fill1_comm_sched(int *sched, int which_pe, int npes);
 
 #if MPI_VERSION < 3
@@ -116,12 +173,23 @@ inline void Wait(MPI_Request *request)
 }
 #endif
 
+// Compute the local dimension and offset of process rank when N rows are
+// distributed over size processes. By default each process receives
+// ceil(N/size) rows, leaving the remainder to the last active process;
+// if balance=true, the first N % size processes receive one extra row.
 class localdimension {
 public:
   int n;
   int start;
   
-  localdimension(int N, int rank, int size) {
+  localdimension(int N, int rank, int size, bool balance=false) {
+    if(balance) {
+      int q=N/size;
+      int r=N % size;
+      n=q+(rank < r);
+      start=q*rank+std::min(rank,r);
+      return;
+    }
     n=utils::ceilquotient(N,size);
     start=n*rank;
     int extra=N-start;
@@ -199,6 +267,14 @@ private:
   bool subblock;
   bool compact;
   bool schedule;
+  mpitranspose<double> *Tf; // Single-precision transpose
+  double *fdata;
+  unsigned int fsize;
+  mpitranspose<T> *Tp; // Uniform transpose of padded balanced blocks
+  T *pdata;
+  unsigned int psize;
+  int *nstart,*ncount,*mstart,*mcount;
+  template<class U> friend class mpitranspose;
 public:
 
   mpiOptions Options() {return options;}
@@ -253,6 +329,18 @@ public:
     return latency;
   }
 
+  // Return true if the local dimensions follow the balanced decomposition
+  // (and not the default one) on every process.
+  bool balanced(MPI_Comm Communicator) {
+    int flags[2];
+    flags[0]=n == (unsigned int) localdimension(N,rank,size).n &&
+      m == (unsigned int) localdimension(M,rank,size).n;
+    flags[1]=n == (unsigned int) localdimension(N,rank,size,true).n &&
+      m == (unsigned int) localdimension(M,rank,size,true).n;
+    MPI_Allreduce(MPI_IN_PLACE,flags,2,MPI_INT,MPI_LAND,Communicator);
+    return !flags[0] && flags[1];
+  }
+  
   void setup(T *data, MPI_Comm Communicator) {
     if(N < n) Array::ArrayExit("N must be >= n");
     if(M < m) Array::ArrayExit("M must be >= m");
@@ -262,6 +350,51 @@ public:
     MPI_Comm_rank(Communicator,&rank);
     
     MPI_Comm_rank(global,&globalrank);
+    FFTWPP_RANK(globalrank);
+    
+    Tf=NULL;
+    Tp=NULL;
+    unsigned int c=sizeof(T)/sizeof(double);
+    if(options.compress && size > 1 && sizeof(T) % sizeof(double) == 0 &&
+       L*c % 2 == 0) {
+      // Transpose pairs of floats, each occupying the space of a double.
+      fsize=std::max(n*M,N*m)*L*c/2;
+      Array::newAlign(fdata,fsize,sizeof(Complex));
+      mpiOptions foptions=options;
+      foptions.compress=false;
+      Tf=new mpitranspose<double>(N,M,n,m,L*c/2,fdata,NULL,Communicator,
+                                  foptions,global);
+      options=Tf->Options();
+      options.compress=true;
+      allocated=0;
+      return;
+    }
+    
+    if(size > 1 && balanced(Communicator)) {
+      // Pad each block to the largest local dimensions, so that the
+      // uniform transpose can be used.
+      unsigned int n0=utils::ceilquotient(N,size);
+      unsigned int m0=utils::ceilquotient(M,size);
+      nstart=new int[size];
+      ncount=new int[size];
+      mstart=new int[size];
+      mcount=new int[size];
+      for(int p=0; p < size; ++p) {
+        localdimension ni(N,p,size,true);
+        nstart[p]=ni.start;
+        ncount[p]=ni.n;
+        localdimension mi(M,p,size,true);
+        mstart[p]=mi.start;
+        mcount[p]=mi.n;
+      }
+      psize=size*n0*m0*L;
+      Array::newAlign(pdata,psize,sizeof(T));
+      Tp=new mpitranspose<T>(size*n0,size*m0,n0,m0,L,pdata,NULL,Communicator,
+                             options,global);
+      options=Tp->Options();
+      allocated=0;
+      return;
+    }
     
     n0=localdimension(N,0,size).n;
     nlast=std::min((int) utils::ceilquotient(N,n0),size)-1;
@@ -376,7 +509,7 @@ public:
     init(data);
   }
   
-  mpitranspose(){}
+  mpitranspose() : Tf(NULL), Tp(NULL) {}
 
   // data and work are arrays of size max(n*M,N*m)*L.
   mpitranspose(unsigned int N, unsigned int M, unsigned int n, unsigned int m,
@@ -518,6 +651,22 @@ public:
   }
   
   void deallocate() {
+    if(Tf) {
+      delete Tf;
+      Array::deleteAlign(fdata,fsize);
+      Tf=NULL;
+      return;
+    }
+    if(Tp) {
+      delete Tp;
+      Array::deleteAlign(pdata,psize);
+      delete [] mcount;
+      delete [] mstart;
+      delete [] ncount;
+      delete [] nstart;
+      Tp=NULL;
+      return;
+    }
     if(size == 1) return;
     
     if(compact) work=NULL;
@@ -625,8 +774,74 @@ public:
            threads);
   }
 
+  // Round length words of input to float.
+  void pack(unsigned int length) {
+    unsigned int c=sizeof(T)/sizeof(double);
+    double2float((double *) input,(float *) fdata,length*L*c,threads);
+  }
+
+  // Restore length words of output to double precision.
+  void unpack(unsigned int length) {
+    unsigned int c=sizeof(T)/sizeof(double);
+    float2double((float *) fdata,(double *) output,length*L*c,threads);
+  }
+  
+  // Copy the N x m input to the padded size*n0 x m0 array.
+  void padrows() {
+    unsigned int n0=Tp->n, m0=Tp->m;
+    for(int q=0; q < size; ++q)
+      copyfromblock(input+nstart[q]*m*L,pdata+q*n0*m0*L,ncount[q],m*L,
+                    m0*L,threads);
+  }
+  
+  // Copy the padded size*n0 x m0 array to the N x m output.
+  void unpadrows() {
+    unsigned int n0=Tp->n, m0=Tp->m;
+    for(int q=0; q < size; ++q)
+      copytoblock(pdata+q*n0*m0*L,output+nstart[q]*m*L,ncount[q],m*L,
+                  m0*L,threads);
+  }
+  
+  // Copy the n x M input to the padded n0 x size*m0 array.
+  void padcols() {
+    unsigned int m0=Tp->m;
+    unsigned int stride=size*m0*L;
+    PARALLEL(
+      for(unsigned int i=0; i < n; ++i) {
+        T *src=input+i*M*L;
+        T *dest=pdata+i*stride;
+        for(int p=0; p < size; ++p)
+          copy(src+mstart[p]*L,dest+p*m0*L,mcount[p]*L);
+      });
+  }
+  
+  // Copy the padded n0 x size*m0 array to the n x M output.
+  void unpadcols() {
+    unsigned int m0=Tp->m;
+    unsigned int stride=size*m0*L;
+    PARALLEL(
+      for(unsigned int i=0; i < n; ++i) {
+        T *src=pdata+i*stride;
+        T *dest=output+i*M*L;
+        for(int p=0; p < size; ++p)
+          copy(src+p*m0*L,dest+mstart[p]*L,mcount[p]*L);
+      });
+  }
+  
 // inphase: N x m -> n x M
   void inphase0() {
+    if(Tf) {
+      pack(N*m);
+      Tf->input=Tf->output=fdata;
+      Tf->inphase0();
+      return;
+    }
+    if(Tp) {
+      padrows();
+      Tp->input=Tp->output=pdata;
+      Tp->inphase0();
+      return;
+    }
     if(rank >= size) return;
     if(size == 1) {
       if(input != output)
@@ -648,6 +863,8 @@ public:
   }
   
   void insync0() {
+    if(Tf) {Tf->insync0(); return;}
+    if(Tp) {Tp->insync0(); return;}
     if(size == 1 || rank >= size) return;
     if(uniform || subblock)
       Wait(2*(split2size-1),Request,schedule);
@@ -660,6 +877,8 @@ public:
   }
   
   void inphase1() {
+    if(Tf) {Tf->inphase1(); return;}
+    if(Tp) {Tp->inphase1(); return;}
     if(rank >= size) return;
     if(subblock) {
       Tin2->transpose(work,output); // a x n*b x m*L
@@ -668,12 +887,24 @@ public:
   }
 
   void insync1() {
+    if(Tf) {Tf->insync1(); return;}
+    if(Tp) {Tp->insync1(); return;}
     if(rank >= size) return;
     if(subblock)
       Wait(2*(splitsize-1),Request,schedule);
   }
 
   void inpost() {
+    if(Tf) {
+      Tf->inpost();
+      unpack(n*M);
+      return;
+    }
+    if(Tp) {
+      Tp->inpost();
+      unpadcols();
+      return;
+    }
     if(size == 1 || rank >= size) return;
     if(uniform)
       Tin1->transpose(work,output); // b x n*a x m*L
@@ -735,6 +966,18 @@ public:
   
 // outphase: n x M -> N x m
   void outphase0() {
+    if(Tf) {
+      pack(n*M);
+      Tf->input=Tf->output=fdata;
+      Tf->outphase0();
+      return;
+    }
+    if(Tp) {
+      padcols();
+      Tp->input=Tp->output=pdata;
+      Tp->outphase0();
+      return;
+    }
     if(rank >= size) return;
     if(size == 1) {
       if(input != output)
@@ -806,6 +1049,8 @@ public:
   }             
   
   void outsync0() {
+    if(Tf) {Tf->outsync0(); return;}
+    if(Tp) {Tp->outsync0(); return;}
     if(rank >= size) return;
     if(subblock)
       Wait(2*(splitsize-1),Request,schedule);
@@ -832,7 +1077,9 @@ public:
   }
   
   void outphase1() {
-    if(subblock) outphase();
+    if(Tf) Tf->outphase1();
+    else if(Tp) Tp->outphase1();
+    else if(subblock) outphase();
   }
   
   void outsync() {
@@ -848,10 +1095,22 @@ public:
   }
   
   void outsync1() {
-    if(subblock) outsync();
+    if(Tf) {
+      Tf->outsync1();
+      unpack(N*m);
+    } else if(Tp) {
+      Tp->outsync1();
+      unpadrows();
+    } else if(subblock) outsync();
   }
 
+  // Bytes sent plus bytes received by this process in one transpose.
+  double Bytes() {
+    return 2.0*sizeof(T)*L*std::max(n*M,N*m);
+  }
+  
   void Wait0() {
+    FFTWPP_PHASE(WAIT,0.0,0.0);
     if(outflag) {
       outsync0();
       outphase1();
@@ -862,6 +1121,7 @@ public:
   }
   
   void Wait1() {
+    FFTWPP_PHASE(WAIT,0.0,0.0);
     if(outflag)
       outsync1();
     else {
@@ -902,7 +1162,7 @@ public:
     if(!out) out=in;
     input=in;
     output=out;
-    outphase0();
+    FFTWPP_TIME(TRANSPOSE,Bytes(),0.0,outphase0());
     outflag=true;
     if(!overlap) {
       Wait0();
@@ -914,7 +1174,7 @@ public:
     if(!out) out=in;
     input=in;
     output=out;
-    inphase0();
+    FFTWPP_TIME(TRANSPOSE,Bytes(),0.0,inphase0());
     outflag=false;
     if(!overlap) {
       Wait0();
@@ -237,6 +237,170 @@ void gatherxy(const ftype *part,
 }
 
 
+// Read or write the local block of an MPI-distributed 3D array directly
+// to a binary file using collective MPI-IO; the global array is never
+// assembled on any process. The file contains the X*Y*Z array in
+// row-major order, as would be produced by fwrite of a gathered array.
+// global: global dimensions; local: local dimensions; start: local offsets.
+// stride: row length of the local array in memory (>= local[2]), to
+// allow for padded in-place real data.
+template<class ftype>
+void blockio(ftype *part, const char *filename, const int *global,
+             const int *local, const int *start, unsigned int stride,
+             const MPI_Comm& communicator, bool write)
+{
+  MPI_Datatype etype;
+  MPI_Type_contiguous(sizeof(ftype),MPI_BYTE,&etype);
+  MPI_Type_commit(&etype);
+
+  MPI_File fh;
+  int mode=write ? MPI_MODE_CREATE | MPI_MODE_WRONLY : MPI_MODE_RDONLY;
+  if(MPI_File_open(communicator,(char *) filename,mode,MPI_INFO_NULL,&fh)
+     != MPI_SUCCESS) {
+    std::cerr << "Cannot open " << filename << std::endl;
+    exit(1);
+  }
+  if(write) {
+    MPI_Offset size=(MPI_Offset) global[0]*global[1]*global[2]*sizeof(ftype);
+    MPI_File_set_size(fh,size);
+  }
+
+  unsigned int n=local[0]*local[1]*local[2];
+  if(n > 0) {
+    MPI_Datatype filetype;
+    MPI_Type_create_subarray(3,(int *) global,(int *) local,(int *) start,
+                             MPI_ORDER_C,etype,&filetype);
+    MPI_Type_commit(&filetype);
+    MPI_File_set_view(fh,0,etype,filetype,(char *) "native",MPI_INFO_NULL);
+
+    MPI_Datatype memtype=etype;
+    int count=n;
+    if(stride != (unsigned int) local[2]) {
+      int padded[]={local[0],local[1],(int) stride};
+      int zero[]={0,0,0};
+      MPI_Type_create_subarray(3,padded,(int *) local,zero,MPI_ORDER_C,etype,
+                               &memtype);
+      MPI_Type_commit(&memtype);
+      count=1;
+    }
+
+    if(write)
+      MPI_File_write_all(fh,part,count,memtype,MPI_STATUS_IGNORE);
+    else
+      MPI_File_read_all(fh,part,count,memtype,MPI_STATUS_IGNORE);
+
+    if(memtype != etype) MPI_Type_free(&memtype);
+    MPI_Type_free(&filetype);
+  } else {
+    // Processes without data must still take part in the collective call.
+    MPI_File_set_view(fh,0,etype,etype,(char *) "native",MPI_INFO_NULL);
+    if(write)
+      MPI_File_write_all(fh,part,0,etype,MPI_STATUS_IGNORE);
+    else
+      MPI_File_read_all(fh,part,0,etype,MPI_STATUS_IGNORE);
+  }
+
+  MPI_File_close(&fh);
+  MPI_Type_free(&etype);
+}
+
+// Write an MPI-distributed array of dimensions x*Y*Z to a file containing
+// the X*Y*Z array.
+template<class ftype>
+void writex(const ftype *part, const char *filename, const split& d,
+            unsigned int Z, const MPI_Comm& communicator)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) Z};
+  int local[]={(int) d.x,(int) d.Y,(int) Z};
+  int start[]={(int) d.x0,0,0};
+  blockio((ftype *) part,filename,global,local,start,Z,communicator,true);
+}
+
+// Read the local x*Y*Z block of an X*Y*Z array from a file.
+template<class ftype>
+void readx(ftype *part, const char *filename, const split& d,
+           unsigned int Z, const MPI_Comm& communicator)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) Z};
+  int local[]={(int) d.x,(int) d.Y,(int) Z};
+  int start[]={(int) d.x0,0,0};
+  blockio(part,filename,global,local,start,Z,communicator,false);
+}
+
+// Write an MPI-distributed array of dimensions X*y*Z to a file containing
+// the X*Y*Z array.
+template<class ftype>
+void writey(const ftype *part, const char *filename, const split& d,
+            unsigned int Z, const MPI_Comm& communicator)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) Z};
+  int local[]={(int) d.X,(int) d.y,(int) Z};
+  int start[]={0,(int) d.y0,0};
+  blockio((ftype *) part,filename,global,local,start,Z,communicator,true);
+}
+
+// Read the local X*y*Z block of an X*Y*Z array from a file.
+template<class ftype>
+void ready(ftype *part, const char *filename, const split& d,
+           unsigned int Z, const MPI_Comm& communicator)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) Z};
+  int local[]={(int) d.X,(int) d.y,(int) Z};
+  int start[]={0,(int) d.y0,0};
+  blockio(part,filename,global,local,start,Z,communicator,false);
+}
+
+// Write an MPI-distributed array of dimensions X*y*z to a file containing
+// the X*Y*Z array. For the Hermitian-compact output of rcfft3dMPI, pass
+// the spectral split3 (with Z=nz/2+1).
+template<class ftype>
+void writeyz(const ftype *part, const char *filename, const split3& d,
+             const MPI_Comm& communicator)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) d.Z};
+  int local[]={(int) d.X,(int) d.xy.y,(int) d.z};
+  int start[]={0,(int) d.xy.y0,(int) d.z0};
+  blockio((ftype *) part,filename,global,local,start,d.z,communicator,true);
+}
+
+// Read the local X*y*z block of an X*Y*Z array from a file.
+template<class ftype>
+void readyz(ftype *part, const char *filename, const split3& d,
+            const MPI_Comm& communicator)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) d.Z};
+  int local[]={(int) d.X,(int) d.xy.y,(int) d.z};
+  int start[]={0,(int) d.xy.y0,(int) d.z0};
+  blockio(part,filename,global,local,start,d.z,communicator,false);
+}
+
+// Write an MPI-distributed array of dimensions x*y*Z to a file containing
+// the X*Y*Z array. The local rows are stride >= Z words apart in memory
+// (e.g. stride=2*(Z/2+1) for the in-place real input of rcfft3dMPI).
+template<class ftype>
+void writexy(const ftype *part, const char *filename, const split3& d,
+             const MPI_Comm& communicator, unsigned int stride=0)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) d.Z};
+  int local[]={(int) d.x,(int) d.yz.x,(int) d.Z};
+  int start[]={(int) d.x0,(int) d.yz.x0,0};
+  blockio((ftype *) part,filename,global,local,start,stride ? stride : d.Z,
+          communicator,true);
+}
+
+// Read the local x*y*Z block of an X*Y*Z array from a file.
+template<class ftype>
+void readxy(ftype *part, const char *filename, const split3& d,
+            const MPI_Comm& communicator, unsigned int stride=0)
+{
+  int global[]={(int) d.X,(int) d.Y,(int) d.Z};
+  int local[]={(int) d.x,(int) d.yz.x,(int) d.Z};
+  int start[]={(int) d.x0,(int) d.yz.x0,0};
+  blockio(part,filename,global,local,start,stride ? stride : d.Z,
+          communicator,false);
+}
+
+
 template<class T>
 int checkerror(const T *f, const T *control, unsigned int n, unsigned int M,
                unsigned int dist)
@@ -0,0 +1,294 @@
+#include "mpiconvolution.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+using namespace Array;
+
+inline void init(Complex **F, Complex **G, Complex **H, const split3& d,
+                 unsigned int mz, unsigned int M=1)
+{
+  double factor=1.0/cbrt((double) M);
+  for(unsigned int s=0; s < M; ++s) {
+    double S=sqrt(1.0+s);
+    double efactor=1.0/S*factor;
+    double ffactor=(1.0+S)*S*factor;
+    double gfactor=1.0/(1.0+S)*factor;
+    array3<Complex> e(d.X,d.y,d.z,F[s]);
+    array3<Complex> f(d.X,d.y,d.z,G[s]);
+    array3<Complex> g(d.X,d.y,d.z,H[s]);
+    for(unsigned int i=0; i < d.X; ++i) {
+      for(unsigned int j=0; j < d.y; ++j) {
+        unsigned int jj=d.y0+j;
+        for(unsigned int k=0; k < d.z; ++k) {
+          if(i == 0 || jj == 0 || k == mz) {
+            e[i][j][k]=0.0;
+            f[i][j][k]=0.0;
+            g[i][j][k]=0.0;
+          } else {
+            unsigned int ii=i-1;
+            unsigned int JJ=jj-1;
+            e[i][j][k]=efactor*Complex(ii+k,JJ);
+            f[i][j][k]=ffactor*Complex(ii+1,JJ+2+k);
+            g[i][j][k]=gfactor*Complex(2*ii,JJ+1.0-k);
+          }
+        }
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  // Number of iterations.
+  unsigned int N0=1000000;
+  unsigned int N=0;
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+  int retval=0;
+
+  unsigned int M=1; // Number of dot product terms
+
+  unsigned int mx=4;
+  unsigned int my=4;
+  unsigned int mz=4;
+
+  int divisor=0; // Test for best block divisor
+  int alltoall=-1; // Test for best alltoall routine
+
+  bool test=false;
+  bool quiet=false;
+
+  int stats=0;
+
+  int provided;
+  MPI_Init_thread(&argc,&argv,MPI_THREAD_FUNNELED,&provided);
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  if(rank != 0) opterr=0;
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hitqA:N:a:m:s:x:y:z:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'a':
+        divisor=atoi(optarg);
+        break;
+      case 'A':
+        M=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=atoi(optarg);
+        break;
+      case 's':
+        alltoall=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 't':
+        test=true;
+        break;
+      case 'q':
+        quiet=true;
+        break;
+      case 'T':
+        fftw::maxthreads=atoi(optarg);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'i':
+	// For compatibility reasons with -i option in OpenMP version.
+	break;
+      case 'h':
+      default:
+        if(rank == 0) {
+          usage(3);
+          usageTranspose();
+        }
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+  if(mz == 0) mz=mx;
+
+  if(N == 0) {
+    N=N0/mx/my/mz;
+    if(N < 10) N=10;
+  }
+
+  unsigned int nx=2*mx;
+  unsigned int ny=2*my;
+  unsigned int nzp=mz+1;
+
+  MPIgroup group(MPI_COMM_WORLD,ny,nzp,false);
+
+  if(group.size > 1 && provided < MPI_THREAD_FUNNELED)
+    fftw::maxthreads=1;
+
+  defaultmpithreads=fftw::maxthreads;
+
+  if(group.rank < group.size) {
+    bool main=group.rank == 0;
+    if(!quiet && main) {
+      seconds();
+      cout << "Configuration: "
+           << group.size << " nodes X " << fftw::maxthreads
+           << " threads/node" << endl;
+      cout << "Using MPI VERSION " << MPI_VERSION << endl;
+    }
+
+    split3 d(nx,ny,nzp,group,true);
+
+    Complex **F=new Complex*[M];
+    Complex **G=new Complex*[M];
+    Complex **H=new Complex*[M];
+    for(unsigned int s=0; s < M; s++) {
+      F[s]=ComplexAlign(d.n);
+      G[s]=ComplexAlign(d.n);
+      H[s]=ComplexAlign(d.n);
+    }
+
+    if(!quiet && main) {
+      if(!test)
+        cout << "N=" << N << endl;
+      cout << "M=" << M << endl;
+      cout << "mx=" << mx << ", my=" << my << ", mz=" << mz << endl;
+      cout << "nx=" << nx << ", ny=" << ny << ", nzp=" << nzp << endl;
+    }
+
+    unsigned int outlimit=3000;
+
+    bool showresult = nx*ny*mz < outlimit;
+
+    ImplicitHTConvolution3MPI C(mx,my,mz,d,F[0],mpiOptions(divisor,alltoall),
+                                M);
+
+    if(test) {
+      init(F,G,H,d,mz,M);
+
+      unsigned int n=d.X*d.Y*d.Z;
+      Complex **F0=new Complex*[M];
+      Complex **G0=new Complex*[M];
+      Complex **H0=new Complex*[M];
+      for(unsigned int s=0; s < M; s++) {
+        if(main) {
+          F0[s]=ComplexAlign(n);
+          G0[s]=ComplexAlign(n);
+          H0[s]=ComplexAlign(n);
+        }
+        gatheryz(F[s],F0[s],d,group.active);
+        gatheryz(G[s],G0[s],d,group.active);
+        gatheryz(H[s],H0[s],d,group.active);
+      }
+
+      C.convolve(F,G,H);
+
+      if(!quiet && showresult) {
+        if(main) cout << "Distributed output: " << endl;
+        show(F[0],d.X,d.y,d.z,group.active);
+      }
+
+      Complex *F0out=main ? ComplexAlign(n) : NULL;
+      gatheryz(F[0],F0out,d,group.active);
+      if(!quiet && main && showresult) {
+        cout << "Gathered output:" << endl;
+        show(F0out,d.X,d.Y,d.Z,0,0,0,d.X,d.Y,d.Z);
+      }
+
+      if(main) {
+        ImplicitHTConvolution3 Clocal(mx,my,mz,M);
+        Clocal.convolve(F0,G0,H0);
+        if(!quiet && showresult) {
+          cout << "Local output:" << endl;
+          show(F0[0],d.X,d.Y,d.Z,0,0,0,d.X,d.Y,d.Z);
+        }
+
+        // Compare only the specified (non-padding) modes.
+        array3<Complex> f0(d.X,d.Y,d.Z,F0[0]);
+        array3<Complex> f0out(d.X,d.Y,d.Z,F0out);
+        array3<Complex> control(d.X-1,d.Y-1,mz,ComplexAlign(n));
+        array3<Complex> result(d.X-1,d.Y-1,mz,ComplexAlign(n));
+        for(unsigned int i=1; i < d.X; ++i) {
+          for(unsigned int j=1; j < d.Y; ++j) {
+            for(unsigned int k=0; k < mz; ++k) {
+              control[i-1][j-1][k]=f0[i][j][k];
+              result[i-1][j-1][k]=f0out[i][j][k];
+            }
+          }
+        }
+        retval += checkerror(result(),control(),(d.X-1)*(d.Y-1)*mz);
+        deleteAlign(result());
+        deleteAlign(control());
+
+        for(unsigned int s=0; s < M; s++) {
+          deleteAlign(H0[s]);
+          deleteAlign(G0[s]);
+          deleteAlign(F0[s]);
+        }
+        deleteAlign(F0out);
+      }
+      delete[] H0;
+      delete[] G0;
+      delete[] F0;
+
+    } else {
+      if(!quiet && main)
+        cout << "Initialized after " << seconds() << " seconds." << endl;
+
+      MPI_Barrier(group.active);
+
+      double *T=new double[N];
+      for(unsigned int i=0; i < N; ++i) {
+        init(F,G,H,d,mz,M);
+        if(main) seconds();
+        C.convolve(F,G,H);
+        if(main) T[i]=seconds();
+      }
+      if(main)
+        timings("Implicit",mx,T,N,stats);
+      delete [] T;
+
+      if(!quiet && showresult) {
+        if(main) cout << "output: " << endl;
+        show(F[0],d.X,d.y,d.z,group.active);
+      }
+    }
+
+    for(unsigned int s=0; s < M; s++) {
+      deleteAlign(H[s]);
+      deleteAlign(G[s]);
+      deleteAlign(F[s]);
+    }
+    delete[] H;
+    delete[] G;
+    delete[] F;
+  }
+
+  MPI_Finalize();
+
+  return retval;
+}
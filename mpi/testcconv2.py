@@ -74,6 +74,8 @@ def main(argv):
                         args.append("-T" + str(T))
                         args.append("-tq")
                         testcases.append(args)
+                        # Spread the remainders over the processes.
+                        testcases.append(args + ["-b"])
 
         tstart = time.time()
         ntest = len(testcases)*len(Plist)
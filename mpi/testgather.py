@@ -37,6 +37,7 @@ def main(argv):
     proglist.append("gather")
     proglist.append("gatheryz")
     proglist.append("gatherxy")
+    proglist.append("io")
 
     logfile = 'testgather.log' 
     Print("MPI gather unit test")
@@ -8,6 +8,20 @@ import os.path
 from testutils import *
 from math import sqrt
 
+# Run a single-precision (compressed) transpose test and return the
+# maximum error relative to the double-precision data (or None on failure).
+def compresserror(P, args):
+    cmd = ["mpirun", "-n", str(P), "./transpose"] + args + ["-c"]
+    DEVNULL = open(os.devnull, 'wb')
+    proc = Popen(cmd, stdout = PIPE, stderr = DEVNULL, stdin = DEVNULL)
+    out, err = proc.communicate()
+    if proc.returncode != 0:
+        return None
+    for line in out.splitlines():
+        if line.startswith("Maximum relative error:"):
+            return float(line.split(":")[1])
+    return None
+
 def main(argv):
     retval = 0
     
@@ -58,20 +72,26 @@ def main(argv):
 
 
         argslist = []
+        compresslist = []
         for X in Xlist:
             for Y in Ylist:
                 for Z in Zlist:
                     for P in Plist:
                         for a in range(1,int(sqrt(P)+1.5)):
                             for s in range(0,3):
-                                args = []
-                                args.append("-x" + str(X))
-                                args.append("-y" + str(Y))
-                                args.append("-z" + str(Z))
-                                args.append("-s" + str(s))
-                                args.append("-a" + str(a))
-                                args.append("-tq")
-                                argslist.append(args)
+                                for b in [False,True]:
+                                    args = []
+                                    args.append("-x" + str(X))
+                                    args.append("-y" + str(Y))
+                                    args.append("-z" + str(Z))
+                                    args.append("-s" + str(s))
+                                    args.append("-a" + str(a))
+                                    if b:
+                                        args.append("-b")
+                                    args.append("-tq")
+                                    argslist.append(args)
+                                    if P > 1:
+                                        compresslist.append((P, args))
 
 
         Print("Running " + str(len(argslist)) + " tests:")
@@ -106,6 +126,23 @@ def main(argv):
                 print "\nElapsed time (s):", tend - tstart
         except:
             pass
+
+        Print("\nSingle-precision communication (-c):")
+        maxerr = 0.0
+        ncfails = 0
+        for P, args in compresslist:
+            error = compresserror(P, args)
+            if error == None:
+                ncfails += 1
+                Print("mpirun -n " + str(P) + " ./transpose "
+                      + " ".join(args) + " -c FAILED")
+            else:
+                maxerr = max(maxerr, error)
+        Print("Maximum error relative to double-precision transpose: "
+              + str(maxerr))
+        if ncfails > 0:
+            print ncfails, "single-precision failures."
+            retval += 1
     
         
     sys.exit(retval)
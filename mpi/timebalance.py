@@ -0,0 +1,97 @@
+#!/usr/bin/python -u
+
+# Compare the speed of the MPI transpose for the default decomposition,
+# which leaves the remainder to the last process, with the balanced
+# decomposition (-b), which pads the blocks internally to use the uniform
+# transpose. The sizes are chosen so that they are not divisible by the
+# number of processes.
+
+import sys
+import getopt
+import os.path
+from subprocess import * # so that we can run commands
+
+# Return the mean times of the forward and backward transposes.
+def timing(P, args):
+    cmd = ["mpirun", "-n", str(P), "./transpose"] + args
+    DEVNULL = open(os.devnull, 'wb')
+    proc = Popen(cmd, stdout = PIPE, stderr = DEVNULL, stdin = DEVNULL)
+    out, err = proc.communicate()
+    if proc.returncode != 0:
+        return None
+    lines = out.splitlines()
+    T = {}
+    for i in range(len(lines) - 1):
+        if lines[i] in ("Tin:", "Tout:"):
+            T[lines[i]] = float(lines[i + 1].split()[1])
+    if len(T) != 2:
+        return None
+    return T["Tin:"], T["Tout:"]
+
+def main(argv):
+    usage = "Usage:\n"\
+            "./timebalance.py\n"\
+            "\t-P<int>\t\tNumber of MPI processes [4]\n"\
+            "\t-m<int>\t\tSmallest size [32]\n"\
+            "\t-M<int>\t\tLargest size [1024]\n"\
+            "\t-z<int>\t\tNumber of complex words per element [1]\n"\
+            "\t-N<int>\t\tNumber of iterations [transpose default]\n"\
+            "\t-h\t\tShow usage"
+
+    P = 4
+    mstart = 32
+    mstop = 1024
+    Z = 1
+    N = 0
+    try:
+        opts, args = getopt.getopt(argv,"P:m:M:z:N:h")
+    except getopt.GetoptError:
+        print "Error in arguments"
+        print usage
+        sys.exit(2)
+    for opt, arg in opts:
+        if opt in ("-P"):
+            P = int(arg)
+        if opt in ("-m"):
+            mstart = int(arg)
+        if opt in ("-M"):
+            mstop = int(arg)
+        if opt in ("-z"):
+            Z = int(arg)
+        if opt in ("-N"):
+            N = int(arg)
+        if opt in ("-h"):
+            print usage
+            sys.exit(0)
+
+    if not os.path.isfile("transpose"):
+        print "Error: transpose executable not present!"
+        sys.exit(1)
+
+    print "P=" + str(P) + ", Z=" + str(Z)
+    print "m\tdefault\t\tbalanced\tspeedup"
+
+    retval = 0
+    m = mstart
+    while m <= mstop:
+        # One more than a multiple of P leaves the last process nearly idle
+        # in the default decomposition.
+        X = P * (m // P) + 1
+        args = ["-x" + str(X), "-y" + str(X), "-z" + str(Z), "-q"]
+        if N > 0:
+            args.append("-N" + str(N))
+        T0 = timing(P, args)
+        T1 = timing(P, args + ["-b"])
+        if T0 == None or T1 == None:
+            print str(X) + "\tFAILED"
+            retval += 1
+        else:
+            t0 = 0.5 * (T0[0] + T0[1])
+            t1 = 0.5 * (T1[0] + T1[1])
+            print "%d\t%e\t%e\t%.2f" % (X, t0, t1, t0 / t1)
+        m *= 2
+
+    sys.exit(retval)
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -19,8 +19,8 @@ void init(Complex *data, unsigned int X, unsigned int y, unsigned int Z,
   for(unsigned int i=0; i < X; ++i) { 
     for(unsigned int j=0; j < y; ++j) {
       for(unsigned int k=0; k < Z; ++k) {
-        data[(y*i+j)*Z+k].re=x0+i;
-        data[(y*i+j)*Z+k].im=y0+j;
+        data[(y*i+j)*Z+k].re=x0+i+1.0/3.0;
+        data[(y*i+j)*Z+k].im=y0+j+k/7.0;
       }
     }
   }
@@ -41,6 +41,8 @@ inline void usage()
   cerr << "-p<int>\t\t which part of the transpose to time" << endl;
   usageTranspose();
   cerr << "-L\t\t locally transpose output" << endl;
+  cerr << "-b\t\t balanced decomposition" << endl;
+  cerr << "-c\t\t communicate in single precision" << endl;
   exit(1);
 }
 
@@ -48,6 +50,7 @@ int main(int argc, char **argv)
 {
   bool test=false;
   bool quiet=false;
+  bool compress=false;
 
  unsigned int X=8, Y=8, Z=1;
  int a=0; // Test for best block divisor
@@ -74,12 +77,18 @@ int main(int argc, char **argv)
   optind=0;
 #endif  
   for (;;) {
-    int c=getopt(argc,argv,"hN:A:a:m:n:s:T:S:x:y:z:qt");
+    int c=getopt(argc,argv,"hbcN:A:a:m:n:s:T:S:x:y:z:qt");
     if (c == -1) break;
                 
     switch (c) {
       case 0:
         break;
+      case 'b':
+        balance=true;
+        break;
+      case 'c':
+        compress=true;
+        break;
       case 'N':
         N=atoi(optarg);
         break;
@@ -162,7 +171,7 @@ int main(int argc, char **argv)
   //    show(data,X,y*Z,communicator);
     
   mpitranspose<Complex> T(X,Y,x,y,Z,data,NULL,communicator,
-			  mpiOptions(a,alltoall,defaultmpithreads,!quiet));
+			  mpiOptions(a,alltoall,defaultmpithreads,!quiet,compress));
   init(data,X,y,Z,0,y0);
   T.localize1(data);
   
@@ -226,9 +235,22 @@ int main(int argc, char **argv)
 
       bool success=true;
       const unsigned int stop=X*Y*Z;
-      for(unsigned int pos=0; pos < stop; ++pos) {
-	if(wholedata[pos] != wholeoutput[pos])
-	  success=false;
+      if(compress) {
+        // Compare with the double-precision data.
+        double maxerr=0.0, norm=0.0;
+        for(unsigned int pos=0; pos < stop; ++pos) {
+          maxerr=max(maxerr,abs(wholedata[pos]-wholeoutput[pos]));
+          norm=max(norm,abs(wholedata[pos]));
+        }
+        double error=norm > 0.0 ? maxerr/norm : maxerr;
+        cout << "\nMaximum relative error: " << error << endl;
+        if(error > FLT_EPSILON)
+          success=false;
+      } else {
+        for(unsigned int pos=0; pos < stop; ++pos) {
+          if(wholedata[pos] != wholeoutput[pos])
+            success=false;
+        }
       }
                 
       if(success == true) {
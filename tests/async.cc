@@ -0,0 +1,153 @@
+#include "convolution.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Independent 2D complex convolutions executed concurrently on separate
+// thread groups, checked against the synchronous convolutions.
+
+unsigned int N=10;
+unsigned int mx=64;
+unsigned int my=0;
+unsigned int K=2; // Number of concurrent convolutions
+
+inline void init(Complex *f, Complex *g, unsigned int k)
+{
+  unsigned int n=mx*my;
+  double factor=1.0/(k+1);
+  for(unsigned int i=0; i < n; ++i) {
+    f[i]=factor*Complex(i % 11,(2*i+1) % 7);
+    g[i]=Complex((3*i+2) % 5,(i+k) % 3);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned int threads=1; // Threads per group
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hK:N:m:x:y:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'K':
+        K=max(atoi(optarg),1);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'T':
+        threads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(2);
+        cerr << "-K\t\t number of concurrent convolutions" << endl;
+        cerr << "-T\t\t number of threads in each group" << endl;
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+  if(N == 0) N=1;
+
+  cout << "K=" << K << ", mx=" << mx << ", my=" << my << endl;
+  cout << "threads=" << threads << " per group" << endl;
+
+  unsigned int n=mx*my;
+  Complex **f=new Complex*[K];
+  Complex **g=new Complex*[K];
+  Complex **h=new Complex*[K];
+  ImplicitConvolution2 **C=new ImplicitConvolution2*[K];
+  ThreadGroup **group=new ThreadGroup*[K];
+  Request *request=new Request[K];
+  for(unsigned int k=0; k < K; ++k) {
+    f[k]=ComplexAlign(n);
+    g[k]=ComplexAlign(n);
+    h[k]=ComplexAlign(n);
+    C[k]=new ImplicitConvolution2(mx,my,2,1,threads);
+    group[k]=new ThreadGroup(threads,k*threads);
+  }
+
+  double *T=new double[N];
+  double *Ta=new double[N];
+
+  for(unsigned int i=0; i < N; ++i) {
+    for(unsigned int k=0; k < K; ++k)
+      init(h[k],g[k],k);
+    seconds();
+    for(unsigned int k=0; k < K; ++k)
+      C[k]->convolve(h[k],g[k]);
+    T[i]=seconds();
+  }
+
+  for(unsigned int i=0; i < N; ++i) {
+    for(unsigned int k=0; k < K; ++k)
+      init(f[k],g[k],k);
+    seconds();
+    for(unsigned int k=0; k < K; ++k)
+      request[k]=iconvolve(*group[k],*C[k],f[k],g[k]);
+    for(unsigned int k=0; k < K; ++k)
+      request[k].wait();
+    Ta[i]=seconds();
+  }
+
+  timings("Sequential",mx,T,N,stats);
+  timings("Concurrent",mx,Ta,N,stats);
+
+  double error=0.0, norm=0.0;
+  for(unsigned int k=0; k < K; ++k) {
+    for(unsigned int i=0; i < n; ++i) {
+      error += abs2(f[k][i]-h[k][i]);
+      norm += abs2(h[k][i]);
+    }
+  }
+  if(norm > 0.0) error=sqrt(error/norm);
+  cout << "error=" << error << endl;
+  if(error > 1e-12) {
+    cerr << "Caution! error=" << error << endl;
+    exit(1);
+  }
+
+  delete [] Ta;
+  delete [] T;
+  for(unsigned int k=0; k < K; ++k) {
+    delete group[k];
+    delete C[k];
+    deleteAlign(h[k]);
+    deleteAlign(g[k]);
+    deleteAlign(f[k]);
+  }
+  delete [] request;
+  delete [] group;
+  delete [] C;
+  delete [] h;
+  delete [] g;
+  delete [] f;
+
+  return 0;
+}
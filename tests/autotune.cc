@@ -0,0 +1,223 @@
+#include <string>
+#include "tuner.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Auto-tuned convolutions versus the implicitly dealiased convolutions.
+
+unsigned int N=100;
+unsigned int mx=16;
+unsigned int my=0;
+unsigned int mz=0;
+
+inline void init(Complex *f, unsigned int n, double factor)
+{
+  for(unsigned int i=0; i < n; ++i)
+    f[i]=factor*Complex(i % 11,(2*i+1) % 7);
+}
+
+// Enforce Hermitian symmetry along the x=0 column of the compact 2D
+// Hermitian layout.
+inline void hermitian(Complex *f, unsigned int mx, unsigned int my)
+{
+  unsigned int origin=(mx-1)*my;
+  f[origin].im=0.0;
+  for(unsigned int i=1; i < mx; ++i)
+    f[origin-i*my]=conj(f[origin+i*my]);
+}
+
+template<class T, class I>
+void test(T& C, I& Implicit, unsigned int n, bool real,
+          const string& type, double *t)
+{
+  Complex *f=ComplexAlign(n);
+  Complex *g=ComplexAlign(n);
+  Complex *h=ComplexAlign(n);
+
+  for(unsigned int k=0; k < N; ++k) {
+    init(f,n,1.0);
+    init(g,n,0.5);
+    if(real) {
+      f[0].im=g[0].im=0.0;
+      if(type == "conv2") {
+        hermitian(f,mx,my);
+        hermitian(g,mx,my);
+      }
+    }
+    seconds();
+    C.convolve(f,g);
+    t[k]=seconds();
+  }
+
+  init(h,n,1.0);
+  init(g,n,0.5);
+  if(real) {
+    h[0].im=g[0].im=0.0;
+    if(type == "conv2") {
+      hermitian(h,mx,my);
+      hermitian(g,mx,my);
+    }
+  }
+  Implicit.convolve(h,g);
+
+  double error=0.0, norm=0.0;
+  for(unsigned int i=0; i < n; ++i) {
+    error += abs2(f[i]-h[i]);
+    norm += abs2(h[i]);
+  }
+  if(norm > 0.0) error=sqrt(error/norm);
+  cout << "engine=" << C.EngineName() << endl;
+  cout << "error=" << error << endl;
+  if(error > 1e-12) {
+    cerr << "Caution! error=" << error << endl;
+    exit(1);
+  }
+
+  deleteAlign(h);
+  deleteAlign(g);
+  deleteAlign(f);
+}
+
+// Return the engine chosen for the given convolution of size m in each
+// dimension.
+unsigned int engine(const string& type, unsigned int m)
+{
+  if(type == "cconv") return TunedConvolution(m).Engine();
+  if(type == "conv") return TunedHConvolution(m).Engine();
+  if(type == "cconv2") return TunedConvolution2(m,m).Engine();
+  if(type == "conv2") return TunedHConvolution2(m,m).Engine();
+  return TunedConvolution3(m,m,m).Engine();
+}
+
+// Report the smallest size above which direct summation is no longer the
+// fastest engine (ignoring isolated timing fluctuations).
+void crossover(const string& type)
+{
+  const unsigned int patience=4;
+  unsigned int last=0;
+  for(unsigned int m=1; m <= last+patience; ++m) {
+    unsigned int e=engine(type,m);
+    cout << "m=" << m << " " << (e == DIRECT ? "direct" : "FFT") << endl;
+    if(e == DIRECT) last=m;
+  }
+  cout << "crossover=" << last+1 << endl;
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  string type="cconv";
+  int stats=0; // Type of statistics used in timing test.
+  bool scan=false;
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hct:N:m:x:y:z:D:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'c':
+        scan=true;
+        break;
+      case 'D':
+        TunedConvolutionBase::directlimit=atoi(optarg);
+        break;
+      case 't':
+        type=optarg;
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(3);
+        cerr << "-t\t\t convolution: cconv, conv, cconv2, conv2, cconv3"
+             << endl;
+        cerr << "-c\t\t report the crossover from direct summation"
+             << endl;
+        cerr << "-D\t\t largest input size considered for direct summation"
+             << endl;
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+  if(mz == 0) mz=mx;
+  if(N == 0) N=1;
+
+  cout << type << ": mx=" << mx << ", my=" << my << ", mz=" << mz << endl;
+  cout << "threads=" << fftw::maxthreads << endl;
+
+  if(scan) {
+    if(type != "cconv" && type != "conv" && type != "cconv2" &&
+       type != "conv2" && type != "cconv3") {
+      cerr << "Unknown convolution " << type << endl;
+      exit(1);
+    }
+    crossover(type);
+    return 0;
+  }
+
+  double *T=new double[N];
+
+  if(type == "cconv") {
+    TunedConvolution C(mx);
+    ImplicitConvolution I(mx);
+    test(C,I,mx,false,type,T);
+  } else if(type == "conv") {
+    TunedHConvolution C(mx);
+    ImplicitHConvolution I(mx);
+    test(C,I,mx,true,type,T);
+  } else if(type == "cconv2") {
+    TunedConvolution2 C(mx,my);
+    ImplicitConvolution2 I(mx,my);
+    test(C,I,mx*my,false,type,T);
+  } else if(type == "conv2") {
+    TunedHConvolution2 C(mx,my);
+    ImplicitHConvolution2 I(mx,my);
+    test(C,I,(2*mx-1)*my,true,type,T);
+  } else if(type == "cconv3") {
+    TunedConvolution3 C(mx,my,mz);
+    ImplicitConvolution3 I(mx,my,mz);
+    test(C,I,mx*my*mz,false,type,T);
+  } else {
+    cerr << "Unknown convolution " << type << endl;
+    exit(1);
+  }
+
+  timings("Tuned",mx,T,N,stats);
+
+  delete [] T;
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+#include <string>
+#include "convolution.h"
+#include "utils.h"
+#include "roofline.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Unified benchmark driver for the FFTW++ transforms and convolutions.
+// Set FFTWPP_BENCHMARK=file.json (or file.csv) for machine-readable output.
+
+unsigned int mx=64;
+unsigned int my=0;
+unsigned int mz=0;
+
+inline void init(Complex *f, unsigned int n, double factor)
+{
+  for(unsigned int i=0; i < n; ++i)
+    f[i]=factor*Complex(i % 11,(2*i+1) % 7);
+}
+
+// Return the roofline model of the given benchmark.
+rooflineModel model(const string& type)
+{
+  if(type == "fft1") return fftModel(1);
+  if(type == "rcfft1") return fftModel(1,true);
+  if(type == "fft2") return fftModel(2);
+  if(type == "fft3") return fftModel(3);
+  if(type == "cconv") return cconvModel(1);
+  if(type == "conv") return convModel(1);
+  if(type == "cconv2") return cconvModel(2);
+  if(type == "conv2") return convModel(2);
+  if(type == "cconv3") return cconvModel(3);
+  return convModel(3);
+}
+
+// An in-place transform of n Complex values.
+class transformOperation : public benchmarkOperation {
+  fftw *F;
+  Complex *f;
+  unsigned int n;
+public:
+  transformOperation(fftw *F, Complex *f, unsigned int n) :
+    F(F), f(f), n(n) {}
+  void init() {::init(f,n,1.0);}
+  void run() {F->fft(f);}
+};
+
+// A binary convolution of data blocks of size n (c is deleted on
+// destruction).
+template<class C>
+class convolutionOperation : public benchmarkOperation {
+  C *c;
+  Complex *f,*g;
+  unsigned int n;
+public:
+  convolutionOperation(C *c, Complex *f, Complex *g, unsigned int n) :
+    c(c), f(f), g(g), n(n) {}
+  ~convolutionOperation() {delete c;}
+  void init() {
+    ::init(f,n,1.0);
+    ::init(g,n,0.5);
+    f[0].im=g[0].im=0.0;
+  }
+  void run() {c->convolve(f,g);}
+};
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  string type="cconv";
+  unsigned int N=1000; // Maximum number of timed runs
+  unsigned int warmup=1;
+  double tolerance=0.01;
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"ht:N:m:x:y:z:w:e:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 't':
+        type=optarg;
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'w':
+        warmup=atoi(optarg);
+        break;
+      case 'e':
+        tolerance=atof(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(3);
+        cerr << "-t\t\t benchmark: fft1, rcfft1, fft2, fft3, "
+             << "cconv, conv, cconv2, conv2, cconv3, conv3" << endl;
+        cerr << "-w\t\t number of untimed warmup runs" << endl;
+        cerr << "-e\t\t relative 95% confidence tolerance (0=run N times)"
+             << endl;
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+  if(mz == 0) mz=mx;
+
+  unsigned int hx=2*mx-1;
+  unsigned int hy=2*my-1;
+  unsigned int n=0;
+  fftw *F=NULL;
+
+  if(type == "fft1") n=mx;
+  else if(type == "rcfft1") n=mx/2+1;
+  else if(type == "fft2") n=mx*my;
+  else if(type == "fft3") n=mx*my*mz;
+  else if(type == "cconv" || type == "conv") n=mx;
+  else if(type == "cconv2") n=mx*my;
+  else if(type == "conv2") n=hx*my;
+  else if(type == "cconv3") n=mx*my*mz;
+  else if(type == "conv3") n=hx*hy*mz;
+  else {
+    cerr << "Unknown benchmark " << type << endl;
+    exit(1);
+  }
+
+  Complex *f=ComplexAlign(n);
+  Complex *g=ComplexAlign(n);
+  benchmarkOperation *op=NULL;
+
+  if(type == "fft1") F=new fft1d(mx,-1,f);
+  else if(type == "rcfft1") F=new rcfft1d(mx,f);
+  else if(type == "fft2") F=new fft2d(mx,my,-1,f);
+  else if(type == "fft3") F=new fft3d(mx,my,mz,-1,f);
+
+  if(F) op=new transformOperation(F,f,n);
+  else if(type == "cconv")
+    op=new convolutionOperation<ImplicitConvolution>
+      (new ImplicitConvolution(mx),f,g,n);
+  else if(type == "conv")
+    op=new convolutionOperation<ImplicitHConvolution>
+      (new ImplicitHConvolution(mx),f,g,n);
+  else if(type == "cconv2")
+    op=new convolutionOperation<ImplicitConvolution2>
+      (new ImplicitConvolution2(mx,my),f,g,n);
+  else if(type == "conv2")
+    op=new convolutionOperation<ImplicitHConvolution2>
+      (new ImplicitHConvolution2(mx,my),f,g,n);
+  else if(type == "cconv3")
+    op=new convolutionOperation<ImplicitConvolution3>
+      (new ImplicitConvolution3(mx,my,mz),f,g,n);
+  else if(type == "conv3")
+    op=new convolutionOperation<ImplicitHConvolution3>
+      (new ImplicitHConvolution3(mx,my,mz),f,g,n);
+
+  cout << type << ": mx=" << mx << ", my=" << my << ", mz=" << mz << endl;
+  cout << "threads=" << fftw::maxthreads << endl;
+
+  double *T=new double[N];
+  unsigned int count=benchmark(*op,T,N,warmup,tolerance);
+  cout << "runs=" << count << endl;
+  timings(type.c_str(),mx,T,count,stats);
+  roofline(model(type),mean(T,count,stats),mx,my,mz);
+
+  delete [] T;
+  delete op;
+  delete F;
+  deleteAlign(g);
+  deleteAlign(f);
+
+  return 0;
+}
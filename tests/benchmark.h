@@ -0,0 +1,178 @@
+#ifndef __benchmark_h__
+#define __benchmark_h__ 1
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <fftw3.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "seconds.h"
+#include "statistics.h"
+
+namespace utils {
+
+// Machine-readable benchmark records.
+//
+// If the environment variable FFTWPP_BENCHMARK names a file, every result
+// reported through timings() is appended to it: as a CSV row (preceded by
+// a header when the file is new) if the name ends in ".csv", and otherwise
+// as one JSON object per line. Each record includes the host, the number
+// of online processors, the OpenMP thread count and binding, the FFTW
+// version, and whether fftw++ loaded a wisdom file. For reproducible
+// timings, pin the threads with OMP_PROC_BIND=close (or spread).
+
+inline const char *benchmarkStatistic(int algorithm)
+{
+  static const char *names[]={"write","mean","min","max","median","p90",
+                              "p80","p50"};
+  return (algorithm >= -1 && algorithm <= 6) ? names[algorithm+1] :
+    "unknown";
+}
+
+// Write str as a quoted CSV field or JSON string.
+inline void benchmarkQuote(std::ostream& os, const char *str, bool csv)
+{
+  os << "\"";
+  for(const char *p=str; *p; ++p) {
+    char c=*p;
+    if(csv) {
+      if(c == '"') os << "\"\"";
+      else os << c;
+    } else if(c == '"' || c == '\\') os << "\\" << c;
+    else if(c == '\n') os << "\\n";
+    else if(c == '\t') os << "\\t";
+    else if((unsigned char) c < 0x20) {
+      char buf[8];
+      snprintf(buf,sizeof(buf),"\\u%04x",(unsigned int) c);
+      os << buf;
+    } else os << c;
+  }
+  os << "\"";
+}
+
+inline void benchmarkRecord(const char *text, unsigned int m,
+                            unsigned int count, double mean, double sigmaL,
+                            double sigmaH, int algorithm)
+{
+  const char *filename=getenv("FFTWPP_BENCHMARK");
+  if(!filename || !*filename) return;
+
+  char host[256]="unknown";
+  long cpus=0;
+#ifndef _WIN32
+  gethostname(host,sizeof(host));
+  host[sizeof(host)-1]=0;
+  cpus=sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+  int threads=1;
+  int bind=0;
+#ifdef _OPENMP
+  threads=omp_get_max_threads();
+#if _OPENMP >= 201307
+  bind=(int) omp_get_proc_bind();
+#endif
+#endif
+
+  // Only fftw++ reads a wisdom file (in LoadWisdom).
+#ifdef __fftwpp_h__
+  bool wise=fftwpp::fftw::wisdomLoaded;
+#else
+  bool wise=false;
+#endif
+
+  size_t length=strlen(filename);
+  bool csv=length >= 4 && strcmp(filename+length-4,".csv") == 0;
+
+  std::ifstream exists(filename);
+  bool fresh=!exists.good();
+  exists.close();
+
+  std::ofstream fout(filename,std::ios::app);
+  if(!fout) {
+    std::cerr << "Cannot write benchmark file " << filename << std::endl;
+    return;
+  }
+  fout.precision(9);
+
+  if(csv) {
+    if(fresh)
+      fout << "name,m,count,statistic,mean,sigmaL,sigmaH,host,cpus,threads,"
+           << "bind,fftw,wisdom,time" << std::endl;
+    benchmarkQuote(fout,text,csv);
+    fout << "," << m << "," << count << ","
+         << benchmarkStatistic(algorithm) << "," << mean << "," << sigmaL
+         << "," << sigmaH << ",";
+    benchmarkQuote(fout,host,csv);
+    fout << "," << cpus << "," << threads << "," << bind << ",";
+    benchmarkQuote(fout,fftw_version,csv);
+    fout << "," << wise << "," << (long) time(NULL) << std::endl;
+  } else {
+    fout << "{\"name\": ";
+    benchmarkQuote(fout,text,csv);
+    fout << ", \"m\": " << m << ", \"count\": " << count
+         << ", \"statistic\": \"" << benchmarkStatistic(algorithm) << "\""
+         << ", \"mean\": " << mean << ", \"sigmaL\": " << sigmaL
+         << ", \"sigmaH\": " << sigmaH << ", \"host\": ";
+    benchmarkQuote(fout,host,csv);
+    fout << ", \"cpus\": " << cpus << ", \"threads\": " << threads
+         << ", \"bind\": " << bind << ", \"fftw\": ";
+    benchmarkQuote(fout,fftw_version,csv);
+    fout << ", \"wisdom\": " << (wise ? "true" : "false")
+         << ", \"time\": " << (long) time(NULL) << "}" << std::endl;
+  }
+}
+
+// A timed operation: init() prepares the data and is not timed; run() is
+// the operation being timed.
+class benchmarkOperation {
+public:
+  virtual ~benchmarkOperation() {}
+  virtual void init() {}
+  virtual void run()=0;
+};
+
+// Time op after warmup untimed runs, storing up to N timings in T.
+// Repetition stops after at least minimum runs once the half-width of the
+// 95% confidence interval of the mean is less than tolerance times the
+// mean (tolerance=0 always performs N runs). Return the number of
+// timings stored in T.
+inline unsigned int benchmark(benchmarkOperation& op, double *T,
+                              unsigned int N, unsigned int warmup=1,
+                              double tolerance=0.01,
+                              unsigned int minimum=10)
+{
+  for(unsigned int i=0; i < warmup; ++i) {
+    op.init();
+    op.run();
+  }
+
+  statistics S;
+  for(unsigned int i=0; i < N; ++i) {
+    op.init();
+    seconds();
+    op.run();
+    T[i]=seconds();
+    S.add(T[i]);
+    if(tolerance > 0.0 && i+1 >= minimum &&
+       1.96*S.stdev() < tolerance*S.mean()*sqrt(S.count()))
+      return i+1;
+  }
+  return N;
+}
+
+}
+
+#endif
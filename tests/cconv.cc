@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -158,8 +159,8 @@ int main(int argc, char* argv[])
   }
   cout << "N=" << N << endl;
 
-  // Explicit and direct methods are only implemented for binary convolutions.
-  if(!Implicit)
+  // Direct methods are only implemented for binary convolutions.
+  if(!Implicit && !Explicit)
     A=2;
 
   if(B < 1)
@@ -179,36 +180,31 @@ int main(int argc, char* argv[])
 
   double *T=new double[N];
   
+  multiplier *mult=NULL;
+  switch(B) {
+    case 1:
+      switch(A) {
+        case 1: mult=multautoconvolution; break;
+        case 2: mult=multbinary; break;
+        case 4: mult=multbinary2; break;
+        case 6: mult=multbinary3; break;
+        case 8: mult=multbinary4; break;
+        case 16: mult=multbinary8; break;
+        default:
+          cerr << "A=" << A << ", B=" << B << " is not yet implemented"
+               << endl;
+          exit(1);
+      }
+      break;
+    default:
+      mult=multA;
+      break;
+  }
+
   if(Implicit) {
     ImplicitConvolution C(m,A,B);
     cout << "threads=" << C.Threads() << endl << endl;
 
-    multiplier *mult=NULL;
-    switch(B) {
-      case 1:
-	switch(A) {
-	  case 1: mult=multautoconvolution; break;
-	  case 2: mult=multbinary; break;
-	  case 4: mult=multbinary2; break;
-	  case 6: mult=multbinary3; break;
-	  case 8: mult=multbinary4; break;
-	  case 16: mult=multbinary8; break;
-	  default:
-	    cerr << "A=" << A << ", B=" << B << " is not yet implemented"
-		 << endl;
-	    exit(1);
-	}
-	break;
-      default:
-	  mult=multA;
-	break;
-    }
-    if(!mult) {
-      cerr << "A=" << A << ", B=" << B << " is not yet implemented"
-           << endl;
-      exit(1);
-    }
-
     for(unsigned int i=0; i < N; ++i) {
       init(F,m,A);
       seconds();
@@ -218,6 +214,7 @@ int main(int argc, char* argv[])
     }
 
     timings("Implicit",m,T,N,stats);
+    roofline(cconvModel(1,A,B),mean(T,N,stats),m);
 
     if(m < 100) {
       for(unsigned int b=0; b < B; ++b) {
@@ -240,25 +237,28 @@ int main(int argc, char* argv[])
   }
   
   if(Explicit) {
-    ExplicitConvolution C(n,m,F[0]);
+    ExplicitConvolution C(n,m,F[0],A,B);
     for(unsigned int i=0; i < N; ++i) {
       init(F,m,A);
       seconds();
-      C.convolve(F[0],F[1]);
+      C.convolve(F,mult);
       T[i]=seconds();
     }
 
     cout << endl;
     timings("Explicit",m,T,N,stats);
 
-    if(m < 100) 
-      for(unsigned int i=0; i < m; i++)
-        cout << F[0][i] << endl;
-    else cout << F[0][0] << endl;
-    cout << endl;
+    for(unsigned int b=0; b < B; ++b) {
+      if(m < 100) 
+        for(unsigned int i=0; i < m; i++)
+          cout << F[b][i] << endl;
+      else cout << F[b][0] << endl;
+      cout << endl;
+    }
     if(Test || Direct)
-      for(unsigned int i=0; i < m; i++)
-	h0[i]=F[0][i];
+      for(unsigned int b=0; b < B; ++b)
+        for(unsigned int i=0; i < m; i++)
+          h0[i+b*m]=F[b][i];
   }
   
   if(Direct) {
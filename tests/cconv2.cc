@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 #include "Array.h"
 
 using namespace std;
@@ -153,7 +154,7 @@ int main(int argc, char* argv[])
   int nxp=Explicit ? nx : mx;
   int nyp=Explicit ? ny : my;
 
-  if(!Implicit)
+  if(!Implicit && !Explicit)
     A=2;
 
   if(B < 1) B=1;
@@ -172,19 +173,19 @@ int main(int argc, char* argv[])
     
   double *T=new double[N];
     
-  if(Implicit) {
-    multiplier *mult;
-  
-    switch(A) {
-      case 2: mult=multbinary; break;
-      case 4: mult=multbinary2; break;
-      case 6: mult=multbinary3; break;
-      case 8: mult=multbinary4; break;
-      case 16: mult=multbinary8; break;
-      default: cout << "Multiplication for A=" << A 
-                    << " is not yet implemented" << endl; exit(1);
-    }
+  multiplier *mult;
+
+  switch(A) {
+    case 2: mult=multbinary; break;
+    case 4: mult=multbinary2; break;
+    case 6: mult=multbinary3; break;
+    case 8: mult=multbinary4; break;
+    case 16: mult=multbinary8; break;
+    default: cout << "Multiplication for A=" << A 
+                  << " is not yet implemented" << endl; exit(1);
+  }
 
+  if(Implicit) {
     ImplicitConvolution2 C(mx,my,A,B);
     cout << "threads=" << C.Threads() << endl << endl;;
 
@@ -197,6 +198,7 @@ int main(int argc, char* argv[])
     }
     
     timings("Implicit",mx,T,N,stats);
+    roofline(cconvModel(2,A,B),mean(T,N,stats),mx,my);
 
     if(Direct) {
       for(unsigned int i=0; i < mx; i++)
@@ -216,16 +218,11 @@ int main(int argc, char* argv[])
   }
   
   if(Explicit) {
-    if(A != 2) {
-      cerr << "Explicit convolutions for A=" << A << " are not yet implemented" << endl;
-      exit(1);
-    }
-
-    ExplicitConvolution2 C(nx,ny,mx,my,F[0],Pruned);
+    ExplicitConvolution2 C(nx,ny,mx,my,F[0],Pruned,A,B);
     for(unsigned int i=0; i < N; ++i) {
       init(F,nxp,nyp,A);
       seconds();
-      C.convolve(F[0],F[1]);
+      C.convolve(F,mult);
       T[i]=seconds();
     }
 
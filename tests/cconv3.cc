@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 #include "Array.h"
 
 using namespace std;
@@ -159,7 +160,7 @@ int main(int argc, char* argv[])
   int nyp=Explicit ? ny : my;
   int nzp=Explicit ? nz : mz;
 
-  if(!Implicit)
+  if(!Implicit && !Explicit)
     A=2;
 
   if(B < 1) B=1;
@@ -178,19 +179,19 @@ int main(int argc, char* argv[])
 
   double *T=new double[N];
   
-  if(Implicit) {
-    multiplier *mult;
-  
-    switch(A) {
-      case 2: mult=multbinary; break;
-      case 4: mult=multbinary2; break;
-      case 6: mult=multbinary3; break;
-      case 8: mult=multbinary4; break;
-      case 16: mult=multbinary8; break;
-      default: cout << "mult for A=" << A 
-                    << " is not yet implemented" << endl; exit(1);
-    }
+  multiplier *mult;
+
+  switch(A) {
+    case 2: mult=multbinary; break;
+    case 4: mult=multbinary2; break;
+    case 6: mult=multbinary3; break;
+    case 8: mult=multbinary4; break;
+    case 16: mult=multbinary8; break;
+    default: cout << "mult for A=" << A 
+                  << " is not yet implemented" << endl; exit(1);
+  }
 
+  if(Implicit) {
     ImplicitConvolution3 C(mx,my,mz,A,B);
     cout << "Using " << C.Threads() << " threads."<< endl;
     for(unsigned int i=0; i < N; ++i) {
@@ -203,6 +204,7 @@ int main(int argc, char* argv[])
     
     cout << endl;
     timings("Implicit",mx,T,N,stats);
+    roofline(cconvModel(3,A,B),mean(T,N,stats),mx,my,mz);
     
     if(Direct)
       for(unsigned int i=0; i < mx; i++) 
@@ -218,18 +220,12 @@ int main(int argc, char* argv[])
   }
   
   if(Explicit) {
-    if(A != 2) {
-      cerr << "Explicit convolutions for A=" << A
-           << " are not yet implemented" << endl;
-      exit(1);
-    }
-
-    ExplicitConvolution3 C(nx,ny,nz,mx,my,mz,f,Pruned);
+    ExplicitConvolution3 C(nx,ny,nz,mx,my,mz,f,Pruned,A,B);
 
     for(unsigned int i=0; i < N; ++i) {
       init(F,nxp,nyp,nzp,A);
       seconds();
-      C.convolve(F[0],F[1]);
+      C.convolve(F,mult);
       T[i]=seconds();
     }
     
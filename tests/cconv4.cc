@@ -0,0 +1,237 @@
+#include "convolution.h"
+#include "direct.h"
+#include "utils.h"
+#include "Array.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int mx=4;
+unsigned int my=4;
+unsigned int mz=4;
+unsigned int mw=4;
+
+bool Direct=false, Implicit=true;
+
+inline void init(Complex **F, unsigned int A) 
+{
+  if(A %2 == 0) {
+    unsigned int M=A/2;
+    double factor=1.0/sqrt((double) M);
+    for(unsigned int s=0; s < M; ++s) {
+      double S=sqrt(1.0+s);
+      double ffactor=S*factor;
+      double gfactor=1.0/S*factor;
+      array4<Complex> f(mx,my,mz,mw,F[s]);
+      array4<Complex> g(mx,my,mz,mw,F[M+s]);
+#pragma omp parallel for
+      for(unsigned int i=0; i < mx; ++i) {
+        for(unsigned int j=0; j < my; j++) {
+          for(unsigned int k=0; k < mz; k++) {
+            for(unsigned int l=0; l < mw; l++) {
+              f[i][j][k][l]=ffactor*Complex(i+k,j+k+l);
+              g[i][j][k][l]=gfactor*Complex((double) (2*i+k)-l,j+1+k);
+            }
+          }
+        }
+      }
+    }
+  } else {
+    cerr << "Init not implemented for A=" << A << endl;
+    exit(1);
+  }
+}
+
+unsigned int outlimit=3000;
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+  
+  unsigned int A=2; // Number of independent inputs
+  unsigned int B=1; // Number of outputs
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif  
+  
+#ifdef __GNUC__ 
+  optind=0;
+#endif  
+  for (;;) {
+    int c = getopt(argc,argv,"hdiA:B:N:m:x:y:z:w:n:T:S:");
+    if (c == -1) break;
+                
+    switch (c) {
+      case 0:
+        break;
+      case 'd':
+        Direct=true;
+        break;
+      case 'i':
+        Implicit=true;
+        break;
+      case 'A':
+        A=atoi(optarg);
+        break;
+      case 'B':
+        B=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=mw=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'w':
+        mw=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usage(3);
+        usageDirect();
+        cerr << "-w\t\t size of fourth dimension" << endl;
+        exit(1);
+    }
+  }
+
+  cout << "mx=" << mx << ", my=" << my << ", mz=" << mz << ", mw=" << mw
+       << endl;
+  
+  if(N == 0) {
+    N=N0/(2*mx)/(2*my)/(2*mz)/(2*mw);
+    N = max(N, 20);
+  }
+  cout << "N=" << N << endl;
+  
+  if(B < 1) B=1;
+  if(B > A) {
+    cerr << "B=" << B << " is not yet implemented for A=" << A << endl;
+    exit(1);
+  }
+  
+  size_t align=sizeof(Complex);
+  unsigned int n=mx*my*mz*mw;
+  
+  Complex **F=new Complex *[A];
+  for(unsigned int a=0; a < A; ++a)
+    F[a]=ComplexAlign(n);
+  array4<Complex> f(mx,my,mz,mw,F[0]);
+  
+  array4<Complex> h0;
+  if(Direct) h0.Allocate(mx,my,mz,mw,align);
+
+  double *T=new double[N];
+
+  if(Implicit) {
+    ImplicitConvolution4 C(mx,my,mz,mw,A,B);
+    cout << "threads=" << C.Threads() << endl << endl;
+    
+    multiplier *mult;
+    switch(A) {
+      case 2: mult=multbinary; break;
+      case 4: mult=multbinary2; break;
+      default: cout << "A=" << A << " is not yet implemented" << endl; exit(1);
+    }
+
+    for(unsigned int i=0; i < N; ++i) {
+      init(F,A);
+      seconds();
+      C.convolve(F,mult);
+      T[i]=seconds();
+    }
+    
+    timings("Implicit",mx,T,N,stats);
+
+    if(Direct)
+      for(unsigned int i=0; i < n; i++) 
+        h0(i)=F[0][i];
+
+    if(n < outlimit) {
+      for(unsigned int i=0; i < mx; i++) {
+        for(unsigned int j=0; j < my; j++) {
+          for(unsigned int k=0; k < mz; k++) {
+            for(unsigned int l=0; l < mw; l++)
+              cout << f[i][j][k][l] << "\t";
+            cout << endl;
+          }
+          cout << endl;
+        }
+        cout << endl;
+      }
+    } else cout << f[0][0][0][0] << endl;
+  }
+  
+  if(Direct) {
+    array4<Complex> h(mx,my,mz,mw,align);
+    Complex *G[]={ComplexAlign(n),ComplexAlign(n)};
+    DirectConvolution4 C(mx,my,mz,mw);
+    init(G,2);
+    seconds();
+    C.convolve(h,G[0],G[1]);
+    T[0]=seconds();
+    
+    timings("Direct",mx,T,1);
+
+    if(n < outlimit) {
+      for(unsigned int i=0; i < mx; i++) {
+        for(unsigned int j=0; j < my; j++) {
+          for(unsigned int k=0; k < mz; k++) {
+            for(unsigned int l=0; l < mw; l++)
+              cout << h[i][j][k][l] << "\t";
+            cout << endl;
+          }
+          cout << endl;
+        }
+        cout << endl;
+      }
+    } else cout << h[0][0][0][0] << endl;
+
+    if(Implicit) { // compare implicit version with direct verion:
+      double error=0.0;
+      double norm=0.0;
+      for(unsigned int i=0; i < n; i++) {
+        error += abs2(h0(i)-h(i));
+        norm += abs2(h(i));
+      }
+      if(norm > 0) error=sqrt(error/norm);
+      cout << "error=" << error << endl;
+      if (error > 1e-12) 
+        cerr << "Caution! error=" << error << endl;
+    }
+    deleteAlign(G[1]);
+    deleteAlign(G[0]);
+  }
+
+  delete [] T;
+  for(unsigned int a=0; a < A; ++a)
+    deleteAlign(F[a]);
+  delete [] F;
+
+  return 0;
+}
@@ -0,0 +1,240 @@
+#include "convolution.h"
+#include "direct.h"
+#include "utils.h"
+#include "Array.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int D=5; // Rank of the convolution
+const unsigned int Dmax=6;
+unsigned int m[]={4,4,4,4,4,4};
+
+bool Direct=false, Implicit=true;
+
+unsigned int outlimit=3000;
+
+// Initialize the A inputs, each of size m[0]*...*m[D-1].
+inline void init(Complex **F, unsigned int A, unsigned int n)
+{
+  if(A % 2 == 0) {
+    unsigned int M=A/2;
+    double factor=1.0/sqrt((double) M);
+    for(unsigned int s=0; s < M; ++s) {
+      double S=sqrt(1.0+s);
+      double ffactor=S*factor;
+      double gfactor=1.0/S*factor;
+      Complex *f=F[s];
+      Complex *g=F[M+s];
+      for(unsigned int i=0; i < n; ++i) {
+        f[i]=ffactor*Complex(i % 7,i % 5);
+        g[i]=gfactor*Complex(i % 3,1.0+i % 4);
+      }
+    }
+  } else {
+    cerr << "Init not implemented for A=" << A << endl;
+    exit(1);
+  }
+}
+
+template<unsigned int D>
+void run(Complex **F, multiplier *mult, unsigned int A, unsigned int B,
+         unsigned int n, double *T, unsigned int N)
+{
+  ImplicitConvolutionN<D> C(m,A,B);
+  cout << "threads=" << C.Threads() << endl << endl;
+  for(unsigned int i=0; i < N; ++i) {
+    init(F,A,n);
+    seconds();
+    C.convolve(F,mult);
+    T[i]=seconds();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+  
+  unsigned int A=2; // Number of independent inputs
+  unsigned int B=1; // Number of outputs
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif  
+  
+#ifdef __GNUC__ 
+  optind=0;
+#endif  
+  for (;;) {
+    int c = getopt(argc,argv,"hdiA:B:D:N:m:x:y:z:w:n:T:S:");
+    if (c == -1) break;
+                
+    switch (c) {
+      case 0:
+        break;
+      case 'd':
+        Direct=true;
+        break;
+      case 'i':
+        Implicit=true;
+        break;
+      case 'A':
+        A=atoi(optarg);
+        break;
+      case 'B':
+        B=atoi(optarg);
+        break;
+      case 'D':
+        D=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        for(unsigned int d=0; d < Dmax; ++d)
+          m[d]=atoi(optarg);
+        break;
+      case 'x':
+        m[0]=atoi(optarg);
+        break;
+      case 'y':
+        m[1]=atoi(optarg);
+        break;
+      case 'z':
+        m[2]=atoi(optarg);
+        break;
+      case 'w':
+        m[3]=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usage(3);
+        usageDirect();
+        cerr << "-D\t\t rank of the convolution (2 to 6)" << endl;
+        cerr << "-w\t\t size of fourth dimension" << endl;
+        exit(1);
+    }
+  }
+
+  if(D < 2 || D > Dmax) {
+    cerr << "D=" << D << " is not yet implemented" << endl;
+    exit(1);
+  }
+  
+  unsigned int n=1;
+  for(unsigned int d=0; d < D; ++d)
+    n *= m[d];
+  
+  cout << "D=" << D << ", m=" << m[0];
+  for(unsigned int d=1; d < D; ++d)
+    cout << "x" << m[d];
+  cout << endl;
+  
+  if(N == 0) {
+    N=N0/n;
+    N = max(N, 20);
+  }
+  cout << "N=" << N << endl;
+  
+  if(B < 1) B=1;
+  if(B > A) {
+    cerr << "B=" << B << " is not yet implemented for A=" << A << endl;
+    exit(1);
+  }
+  
+  Complex **F=new Complex *[A];
+  for(unsigned int a=0; a < A; ++a)
+    F[a]=ComplexAlign(n);
+
+  double *T=new double[N];
+
+  if(Implicit) {
+    multiplier *mult;
+    switch(A) {
+      case 2: mult=multbinary; break;
+      case 4: mult=multbinary2; break;
+      default: cout << "A=" << A << " is not yet implemented" << endl; exit(1);
+    }
+
+    switch(D) {
+      case 2: run<2>(F,mult,A,B,n,T,N); break;
+      case 3: run<3>(F,mult,A,B,n,T,N); break;
+      case 4: run<4>(F,mult,A,B,n,T,N); break;
+      case 5: run<5>(F,mult,A,B,n,T,N); break;
+      case 6: run<6>(F,mult,A,B,n,T,N); break;
+    }
+    
+    timings("Implicit",m[0],T,N,stats);
+
+    if(n < outlimit) {
+      for(unsigned int i=0; i < n; ++i) {
+        cout << F[0][i] << "\t";
+        if((i+1) % m[D-1] == 0) cout << endl;
+      }
+    } else cout << F[0][0] << endl;
+  }
+  
+  if(Direct) {
+    Complex *h=ComplexAlign(n);
+    Complex *G[]={ComplexAlign(n),ComplexAlign(n)};
+    init(G,2,n);
+    seconds();
+    switch(D) {
+      case 2: DirectConvolution2(m[0],m[1]).convolve(h,G[0],G[1]); break;
+      case 3: DirectConvolution3(m[0],m[1],m[2]).convolve(h,G[0],G[1]); break;
+      case 4: DirectConvolution4(m[0],m[1],m[2],m[3]).convolve(h,G[0],G[1]);
+        break;
+      case 5: DirectConvolutionN<5>(m).convolve(h,G[0],G[1]); break;
+      case 6: DirectConvolutionN<6>(m).convolve(h,G[0],G[1]); break;
+    }
+    T[0]=seconds();
+    
+    timings("Direct",m[0],T,1);
+
+    if(n < outlimit) {
+      for(unsigned int i=0; i < n; ++i) {
+        cout << h[i] << "\t";
+        if((i+1) % m[D-1] == 0) cout << endl;
+      }
+    } else cout << h[0] << endl;
+
+    if(Implicit && A == 2) { // compare implicit version with direct verion:
+      double error=0.0;
+      double norm=0.0;
+      for(unsigned int i=0; i < n; i++) {
+        error += abs2(F[0][i]-h[i]);
+        norm += abs2(h[i]);
+      }
+      if(norm > 0) error=sqrt(error/norm);
+      cout << "error=" << error << endl;
+      if (error > 1e-12) 
+        cerr << "Caution! error=" << error << endl;
+    }
+    deleteAlign(G[1]);
+    deleteAlign(G[0]);
+    deleteAlign(h);
+  }
+
+  delete [] T;
+  for(unsigned int a=0; a < A; ++a)
+    deleteAlign(F[a]);
+  delete [] F;
+
+  return 0;
+}
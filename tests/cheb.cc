@@ -0,0 +1,173 @@
+#include "convolution.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int m=12;
+
+inline void init(double *f, double *g, unsigned int A)
+{
+  for(unsigned int k=0; k < m; ++k) {
+    f[k]=1.0/(1.0+k);
+    if(A > 1) g[k]=(k % 3)-0.5*k/m;
+  }
+}
+
+// Direct product of the m-term Chebyshev series f and g, truncated to m
+// terms, using T_i T_j=(T_{i+j}+T_{|i-j|})/2.
+void direct(double *h, double *f, double *g)
+{
+  for(unsigned int k=0; k < m; ++k)
+    h[k]=0.0;
+  for(unsigned int i=0; i < m; ++i) {
+    for(unsigned int j=0; j < m; ++j) {
+      double p=0.5*f[i]*g[j];
+      if(i+j < m) h[i+j] += p;
+      h[i > j ? i-j : j-i] += p;
+    }
+  }
+}
+
+// Return the relative error of a normalized forward/backward round trip.
+double roundtrip(double *f, unsigned int n, fftw& Forward,
+                 rrfft1d *Backward1, mrrfft1d *BackwardM,
+                 rrfft2d *Backward2, rrfft3d *Backward3)
+{
+  double *g=doubleAlign(n);
+  for(unsigned int i=0; i < n; ++i)
+    f[i]=g[i]=i % 5+1.0/(1.0+i);
+  Forward.fft(f,f);
+  if(Backward1) Backward1->fftNormalized(f,f);
+  if(BackwardM) BackwardM->fftNormalized(f,f);
+  if(Backward2) Backward2->fftNormalized(f,f);
+  if(Backward3) Backward3->fftNormalized(f,f);
+  double error=0.0;
+  double norm=0.0;
+  for(unsigned int i=0; i < n; ++i) {
+    error += (f[i]-g[i])*(f[i]-g[i]);
+    norm += g[i]*g[i];
+  }
+  deleteAlign(g);
+  return sqrt(error/norm);
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  unsigned int A=2; // Number of inputs
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"haN:m:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'a':
+        A=1;
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        m=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(1);
+        cerr << "-a\t\t autoconvolution" << endl;
+        exit(1);
+    }
+  }
+
+  cout << "m=" << m << ", A=" << A << endl;
+
+  if(N == 0) {
+    N=N0/m;
+    N=max(N,20);
+  }
+  cout << "N=" << N << endl;
+
+  // Check that the real-to-real transforms invert each other.
+  unsigned int M=3;
+  double *w=doubleAlign(M*M*m);
+  rrfft1d Forward1(m,FFTW_REDFT10,w,w);
+  rrfft1d Backward1(m,FFTW_REDFT01,w,w);
+  mrrfft1d ForwardM(m,FFTW_RODFT10,M,1,m,w,w);
+  mrrfft1d BackwardM(m,FFTW_RODFT01,M,1,m,w,w);
+  rrfft2d Forward2(M,m,FFTW_REDFT00,FFTW_REDFT10,w,w);
+  rrfft2d Backward2(M,m,FFTW_REDFT00,FFTW_REDFT01,w,w);
+  rrfft3d Forward3(M,M,m,FFTW_REDFT10,FFTW_RODFT00,FFTW_REDFT01,w,w);
+  rrfft3d Backward3(M,M,m,FFTW_REDFT01,FFTW_RODFT00,FFTW_REDFT10,w,w);
+  double error=0.0;
+  error=max(error,roundtrip(w,m,Forward1,&Backward1,NULL,NULL,NULL));
+  error=max(error,roundtrip(w,M*m,ForwardM,NULL,&BackwardM,NULL,NULL));
+  error=max(error,roundtrip(w,M*m,Forward2,NULL,NULL,&Backward2,NULL));
+  error=max(error,roundtrip(w,M*M*m,Forward3,NULL,NULL,NULL,&Backward3));
+  deleteAlign(w);
+  cout << "r2r error=" << error << endl;
+  if(error > 1e-12) cerr << "Caution! error=" << error << endl;
+
+  double *f=doubleAlign(m);
+  double *g=doubleAlign(m);
+
+  ChebyshevConvolution C(m,A);
+
+  double *T=new double[N];
+  for(unsigned int i=0; i < N; ++i) {
+    init(f,g,A);
+    seconds();
+    if(A == 1) C.autoconvolve(f);
+    else C.convolve(f,g);
+    T[i]=seconds();
+  }
+  timings("Chebyshev",m,T,N,stats);
+  delete [] T;
+
+  // Compare with the direct Chebyshev product.
+  double *h=doubleAlign(m);
+  init(f,g,A);
+  direct(h,f,A == 1 ? f : g);
+  if(A == 1) C.autoconvolve(f);
+  else C.convolve(f,g);
+
+  error=0.0;
+  double norm=0.0;
+  for(unsigned int k=0; k < m; ++k) {
+    error += (f[k]-h[k])*(f[k]-h[k]);
+    norm += h[k]*h[k];
+  }
+  if(norm > 0) error=sqrt(error/norm);
+  cout << endl << "error=" << error << endl;
+  if(error > 1e-12) cerr << "Caution! error=" << error << endl;
+
+  deleteAlign(h);
+  deleteAlign(g);
+  deleteAlign(f);
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include <pthread.h>
+#include "convolution.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Independent 2D complex convolutions issued concurrently by C client
+// threads, each using its own convolution objects. With -P, each request
+// constructs (and plans) a new convolution object, exercising concurrent
+// planning.
+
+unsigned int N=10; // Requests per client
+unsigned int mx=32;
+unsigned int my=0;
+unsigned int threads=1; // Threads per convolution
+bool plan=false;
+
+Complex *reference; // Convolution of the common inputs
+
+inline void init(Complex *f, Complex *g)
+{
+  unsigned int n=mx*my;
+  for(unsigned int i=0; i < n; ++i) {
+    f[i]=Complex(i % 11,(2*i+1) % 7);
+    g[i]=Complex((3*i+2) % 5,i % 3);
+  }
+}
+
+struct client {
+  pthread_t id;
+  double *T;     // Time of each request
+  double error;  // Maximum relative error
+};
+
+void *run(void *arg)
+{
+  client *c=(client *) arg;
+  unsigned int n=mx*my;
+  Complex *f=ComplexAlign(n);
+  Complex *g=ComplexAlign(n);
+  ImplicitConvolution2 *C=plan ? NULL :
+    new ImplicitConvolution2(mx,my,2,1,threads);
+
+  c->error=0.0;
+  for(unsigned int k=0; k < N; ++k) {
+    init(f,g);
+    double start=totalseconds();
+    if(plan) {
+      ImplicitConvolution2 P(mx,my,2,1,threads);
+      P.convolve(f,g);
+    } else
+      C->convolve(f,g);
+    c->T[k]=totalseconds()-start;
+
+    double error=0.0, norm=0.0;
+    for(unsigned int i=0; i < n; ++i) {
+      error += abs2(f[i]-reference[i]);
+      norm += abs2(reference[i]);
+    }
+    if(norm > 0.0) c->error=max(c->error,sqrt(error/norm));
+  }
+
+  delete C;
+  deleteAlign(g);
+  deleteAlign(f);
+  return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned int K=4; // Number of clients
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hC:PN:m:x:y:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'C':
+        K=max(atoi(optarg),1);
+        break;
+      case 'P':
+        plan=true;
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'T':
+        threads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(2);
+        cerr << "-C\t\t number of concurrent clients" << endl;
+        cerr << "-P\t\t construct a new convolution for each request"
+             << endl;
+        cerr << "-T\t\t number of threads per convolution" << endl;
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+  if(N == 0) N=1;
+  fftw::maxthreads=threads;
+
+  cout << "clients=" << K << ", mx=" << mx << ", my=" << my << endl;
+  cout << "threads=" << threads << " per convolution" << endl;
+
+  unsigned int n=mx*my;
+  reference=ComplexAlign(n);
+  Complex *g=ComplexAlign(n);
+  {
+    ImplicitConvolution2 C(mx,my,2,1,threads);
+    init(reference,g);
+    C.convolve(reference,g);
+  }
+
+  client *clients=new client[K];
+  double start=totalseconds();
+  for(unsigned int k=0; k < K; ++k) {
+    clients[k].T=new double[N];
+    if(pthread_create(&clients[k].id,NULL,run,clients+k) != 0) {
+      cerr << "Cannot create client thread" << endl;
+      exit(1);
+    }
+  }
+  for(unsigned int k=0; k < K; ++k)
+    pthread_join(clients[k].id,NULL);
+  double elapsed=totalseconds()-start;
+
+  double *T=new double[K*N];
+  double error=0.0;
+  for(unsigned int k=0; k < K; ++k) {
+    for(unsigned int i=0; i < N; ++i)
+      T[N*k+i]=clients[k].T[i];
+    error=max(error,clients[k].error);
+    delete [] clients[k].T;
+  }
+
+  timings("Request",mx,T,K*N,stats);
+  cout << "throughput=" << K*N/elapsed << " requests/s" << endl;
+  cout << "error=" << error << endl;
+  if(error > 1e-12) {
+    cerr << "Caution! error=" << error << endl;
+    exit(1);
+  }
+
+  delete [] T;
+  delete [] clients;
+  deleteAlign(g);
+  deleteAlign(reference);
+
+  return 0;
+}
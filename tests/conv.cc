@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -197,9 +198,8 @@ int main(int argc, char* argv[])
   
   unsigned int np=Explicit ? n/2+1 : m+!compact;
 
-  // explicit and direct convolutions are only implemented for binary
-  // convolutions.
-  if(!Implicit) 
+  // Direct convolutions are only implemented for binary convolutions.
+  if(!Implicit && !Explicit) 
     A=2;
   
   if(B < 1)
@@ -217,25 +217,25 @@ int main(int argc, char* argv[])
 
   double* T=new double[N];
 
+  if (A % 2 != 0) {
+    cerr << "A=" << A << " is not yet implemented" << endl; 
+    exit(1);
+  }
+    
+  realmultiplier *mult=0;
+  if(B == 1) {
+    switch(A) {
+      case 2: mult=multbinary; break;
+      case 4: mult=multbinary2; break;
+      default: mult=multA;
+    }
+  } else
+    mult=multA;
+    
   if(Implicit) {
     ImplicitHConvolution C(m,compact,A,B);
     cout << "threads=" << C.Threads() << endl << endl;
 
-    if (A % 2 != 0) {
-      cerr << "A=" << A << " is not yet implemented" << endl; 
-      exit(1);
-    }
-    
-    realmultiplier *mult=0;
-    if(B == 1) {
-      switch(A) {
-        case 2: mult=multbinary; break;
-        case 4: mult=multbinary2; break;
-        default: mult=multA;
-      }
-    } else
-      mult=multA;
-    
     for(unsigned int i=0; i < N; ++i) {
       init(F,m,A);
       seconds();
@@ -245,6 +245,7 @@ int main(int argc, char* argv[])
     }
 
     timings("Implicit",m,T,N,stats);
+    roofline(convModel(1,A,B),mean(T,N,stats),m);
 
     
     if(m < 100) {
@@ -267,25 +268,29 @@ int main(int argc, char* argv[])
   }
   
   if(Explicit) {
-    ExplicitHConvolution C(n,m,f);
+    ExplicitHConvolution C(n,m,f,A,B);
     for(unsigned int i=0; i < N; ++i) {
-      init(F,m,2);
+      init(F,m,A);
       seconds();
-      C.convolve(F[0],F[1]);
+      C.convolve(F,mult);
       T[i]=seconds();
     }
 
     cout << endl;
     timings("Explicit",m,T,N,stats);
 
-    if(m < 100) 
-      for(unsigned int i=0; i < m; i++)
-	cout << f[i] << endl;
-    else
-      cout << f[0] << endl;
+    for(unsigned int b=0; b < B; ++b) {
+      if(m < 100) 
+        for(unsigned int i=0; i < m; i++)
+          cout << F[b][i] << endl;
+      else
+        cout << F[b][0] << endl;
+      cout << endl;
+    }
     if(Test || Direct) 
-      for(unsigned int i=0; i < m; i++)
-	h0[i]=f[i];
+      for(unsigned int b=0; b < B; ++b)
+        for(unsigned int i=0; i < m; i++)
+          h0[i+b*m]=F[b][i];
   }
   
   if(Direct) {
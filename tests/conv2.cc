@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 #include "Array.h"
 
 using namespace std;
@@ -20,6 +21,7 @@ unsigned int nxp;
 unsigned int nyp;
 bool xcompact=true;
 bool ycompact=true;
+bool implicitsymmetry=false;
 
 bool Direct=false, Implicit=true, Explicit=false, Pruned=false;
 
@@ -88,7 +90,7 @@ int main(int argc, char* argv[])
   optind=0;
 #endif  
   for (;;) {
-    int c = getopt(argc,argv,"hdeipA:B:N:m:x:y:n:T:S:X:Y:");
+    int c = getopt(argc,argv,"hdeipA:B:HN:m:x:y:n:T:S:X:Y:");
     if (c == -1) break;
                 
     switch (c) {
@@ -144,11 +146,15 @@ int main(int argc, char* argv[])
       case 'Y':
         ycompact=atoi(optarg) == 0;
         break;
+      case 'H':
+        implicitsymmetry=true;
+        break;
       case 'h':
       default:
         usage(2);
         usageExplicit(2);
         usageCompact(2);
+        usageSymmetry();
         exit(1);
     }
   }
@@ -167,8 +173,11 @@ int main(int argc, char* argv[])
     
   size_t align=sizeof(Complex);
 
+  // The explicit convolution is checked both directly and through its
+  // multiplier interface.
+  unsigned int checks=Explicit ? 2 : 1;
   array2<Complex> h0;
-  if(Direct) h0.Allocate(mx,my,align);
+  if(Direct) h0.Allocate(checks*mx,my,align);
 
   nxp=Explicit ? nx : 2*mx-xcompact;
   nyp=Explicit ? ny/2+1 : my+!ycompact;
@@ -191,18 +200,18 @@ int main(int argc, char* argv[])
 
   double *T=new double[N];
 
+  realmultiplier *mult;
+  switch(A) {
+    case 2: mult=multbinary; break;
+    case 4: mult=multbinary2; break;
+    default: cerr << "A=" << A << " is not yet implemented" << endl; exit(1);
+  }
+    
   if(Implicit) {
     ImplicitHConvolution2 C(mx,my,xcompact,ycompact,A,B);
+    C.ImplicitSymmetry(implicitsymmetry);
     cout << "threads=" << C.Threads() << endl << endl;
 
-    realmultiplier *mult;
-    switch(A) {
-      case 2: mult=multbinary; break;
-      case 4: mult=multbinary2; break;
-      default: cerr << "A=" << A << " is not yet implemented" << endl; exit(1);
-    }
-    
-    
     for(unsigned int i=0; i < N; ++i) {
       init(F,mx,my,nxp,nyp,A,xcompact,ycompact);
       seconds();
@@ -212,6 +221,7 @@ int main(int argc, char* argv[])
     }
     
     timings("Implicit",mx,T,N,stats);
+    roofline(convModel(2,A,B),mean(T,N,stats),mx,my);
 
     if(Direct) {
       for(unsigned int i=0; i < mx; i++) 
@@ -230,7 +240,7 @@ int main(int argc, char* argv[])
   
   if(Explicit) {
     unsigned int M=A/2;
-    ExplicitHConvolution2 C(nx,ny,mx,my,f,M,Pruned);
+    ExplicitHConvolution2 C(nx,ny,mx,my,f,M,Pruned,A,B);
     
     for(unsigned int i=0; i < N; ++i) {
       init(F,mx,my,nxp,nyp,A,true,true);
@@ -248,6 +258,11 @@ int main(int argc, char* argv[])
       for(unsigned int i=0; i < mx; i++) 
         for(unsigned int j=0; j < my; j++)
           h0[i][j]=f[offset+i][j];
+      init(F,mx,my,nxp,nyp,A,true,true);
+      C.convolve(F,mult);
+      for(unsigned int i=0; i < mx; i++) 
+        for(unsigned int j=0; j < my; j++)
+          h0[mx+i][j]=f[offset+i][j];
     }
 
     if(2*(mx-1)*my < outlimit) { 
@@ -284,10 +299,12 @@ int main(int argc, char* argv[])
       double error=0.0;
       cout << endl;
       double norm=0.0;
-      for(unsigned int i=0; i < mx; i++) {
-        for(unsigned int j=0; j < my; j++) {
-          error += abs2(h0[i][j]-h[i][j]);
-          norm += abs2(h[i][j]);
+      for(unsigned int c=0; c < checks; ++c) {
+        for(unsigned int i=0; i < mx; i++) {
+          for(unsigned int j=0; j < my; j++) {
+            error += abs2(h0[c*mx+i][j]-h[i][j]);
+            norm += abs2(h[i][j]);
+          }
         }
       }
       if(norm > 0) error=sqrt(error/norm);
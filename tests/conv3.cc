@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 #include "Array.h"
 
 using namespace std;
@@ -24,6 +25,7 @@ unsigned int nzp;
 bool xcompact=true;
 bool ycompact=true;
 bool zcompact=true;
+bool implicitsymmetry=false;
 
 bool Direct=false, Implicit=true;
 
@@ -135,7 +137,7 @@ int main(int argc, char* argv[])
   optind=0;
 #endif  
   for (;;) {
-    int c = getopt(argc,argv,"hdeipA:B:N:m:x:y:z:n:T:S:X:Y:Z:");
+    int c = getopt(argc,argv,"hdeipA:B:HN:m:x:y:z:n:T:S:X:Y:Z:");
     if (c == -1) break;
                 
     switch (c) {
@@ -192,11 +194,15 @@ int main(int argc, char* argv[])
       case 'Z':
         zcompact=atoi(optarg) == 0;
         break;
+      case 'H':
+        implicitsymmetry=true;
+        break;
       case 'h':
       default:
         usage(3);
         usageDirect();
         usageCompact(3);
+        usageSymmetry();
         exit(1);
     }
   }
@@ -241,6 +247,7 @@ int main(int argc, char* argv[])
 
   if(Implicit) {
     ImplicitHConvolution3 C(mx,my,mz,xcompact,ycompact,zcompact,A,B);
+    C.ImplicitSymmetry(implicitsymmetry);
     cout << "threads=" << C.Threads() << endl << endl;
     
     realmultiplier *mult;
@@ -259,6 +266,7 @@ int main(int argc, char* argv[])
     }
     
     timings("Implicit",mx,T,N,stats);
+    roofline(convModel(3,A,B),mean(T,N,stats),mx,my,mz);
 
     if(Direct) {
       for(unsigned int i=0; i < mx; i++) 
@@ -0,0 +1,286 @@
+#include "convolution.h"
+#include "direct.h"
+#include "utils.h"
+#include "Array.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int mx=4;
+unsigned int my=4;
+unsigned int mz=4;
+unsigned int mw=4;
+bool xcompact=true;
+bool ycompact=true;
+bool zcompact=true;
+bool wcompact=true;
+
+bool Direct=false, Implicit=true;
+
+unsigned int outlimit=300;
+
+// Initialize the A inputs, each of size nxp*nyp*nzp*nwp, where the
+// first !xcompact, !ycompact, !zcompact, and !wcompact entries are padding.
+inline void init(Complex **F, unsigned int nxp, unsigned int nyp,
+                 unsigned int nzp, unsigned int nwp, unsigned int A,
+                 bool xcompact, bool ycompact, bool zcompact, bool wcompact)
+{
+  if(A % 2 == 0) {
+    unsigned int M=A/2;
+    unsigned int nx=2*mx-1;
+    unsigned int ny=2*my-1;
+    unsigned int nz=2*mz-1;
+    
+    double factor=1.0/sqrt((double) M);
+    for(unsigned int s=0; s < M; ++s) {
+      double S=sqrt(1.0+s);
+      double ffactor=S*factor;
+      double gfactor=1.0/S*factor;
+
+      array4<Complex> f(nxp,nyp,nzp,nwp,F[s]);
+      array4<Complex> g(nxp,nyp,nzp,nwp,F[M+s]);
+      f=0.0;
+      g=0.0;
+
+#pragma omp parallel for
+      for(unsigned int i=0; i < nx; ++i) {
+        unsigned int I=i+!xcompact;
+        for(unsigned int j=0; j < ny; ++j) {
+          unsigned int J=j+!ycompact;
+          for(unsigned int k=0; k < nz; ++k) {
+            unsigned int K=k+!zcompact;
+            for(unsigned int l=0; l < mw; ++l) {
+              f[I][J][K][l]=ffactor*Complex(i+k,j+k+l);
+              g[I][J][K][l]=gfactor*Complex((double) (2*i+k)-l,j+1+k);
+            }
+          }
+        }
+      }
+    }
+  } else {
+    cerr << "Init not implemented for A=" << A << endl;
+    exit(1);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+  
+  unsigned int A=2; // Number of independent inputs
+  unsigned int B=1; // Number of outputs
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif  
+  
+#ifdef __GNUC__ 
+  optind=0;
+#endif  
+  for (;;) {
+    int c = getopt(argc,argv,"hdiA:B:N:m:x:y:z:w:n:T:S:X:Y:Z:W:");
+    if (c == -1) break;
+                
+    switch (c) {
+      case 0:
+        break;
+      case 'd':
+        Direct=true;
+        break;
+      case 'i':
+        Implicit=true;
+        break;
+      case 'A':
+        A=atoi(optarg);
+        break;
+      case 'B':
+        B=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=mw=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'w':
+        mw=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;     
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'X':
+        xcompact=atoi(optarg) == 0;
+        break;
+      case 'Y':
+        ycompact=atoi(optarg) == 0;
+        break;
+      case 'Z':
+        zcompact=atoi(optarg) == 0;
+        break;
+      case 'W':
+        wcompact=atoi(optarg) == 0;
+        break;
+      case 'h':
+      default:
+        usage(3);
+        usageDirect();
+        usageCompact(3);
+        cerr << "-w\t\t size of fourth dimension" << endl;
+        cerr << "-W\t\t 0=compact, 1=noncompact storage in fourth dimension"
+             << endl;
+        exit(1);
+    }
+  }
+
+  cout << "mx=" << mx << ", my=" << my << ", mz=" << mz << ", mw=" << mw
+       << endl;
+  
+  if(N == 0) {
+    N=N0/(2*mx)/(2*my)/(2*mz)/(2*mw);
+    N = max(N, 20);
+  }
+  cout << "N=" << N << endl;
+    
+  size_t align=sizeof(Complex);
+  unsigned int nxp=2*mx-xcompact;
+  unsigned int nyp=2*my-ycompact;
+  unsigned int nzp=2*mz-zcompact;
+  unsigned int nwp=mw+!wcompact;
+
+  cout << "nxp=" << nxp << ", nyp=" << nyp << ", nzp=" << nzp
+       << ", nwp=" << nwp << endl;
+  
+  if(B < 1) B=1;
+  if(B > A) {
+    cerr << "B=" << B << " is not yet implemented for A=" << A << endl;
+    exit(1);
+  }
+  
+  Complex **F=new Complex *[A];
+  for(unsigned int a=0; a < A; ++a)
+    F[a]=ComplexAlign(nxp*nyp*nzp*nwp);
+
+  // For easy access of first element
+  array4<Complex> f(nxp,nyp,nzp,nwp,F[0]);
+
+  unsigned int nx=2*mx-1;
+  unsigned int ny=2*my-1;
+  unsigned int nz=2*mz-1;
+  array4<Complex> h0;
+  if(Direct && Implicit) h0.Allocate(nx,ny,nz,mw,align);
+
+  double *T=new double[N];
+
+  if(Implicit) {
+    ImplicitHConvolution4 C(mx,my,mz,mw,xcompact,ycompact,zcompact,wcompact,
+                            A,B);
+    cout << "threads=" << C.Threads() << endl << endl;
+    
+    realmultiplier *mult;
+    switch(A) {
+      case 2: mult=multbinary; break;
+      case 4: mult=multbinary2; break;
+      default: cerr << "A=" << A << " is not yet implemented" << endl; exit(1);
+    }
+
+    for(unsigned int i=0; i < N; ++i) {
+      init(F,nxp,nyp,nzp,nwp,A,xcompact,ycompact,zcompact,wcompact);
+      seconds();
+      C.convolve(F,mult);
+      T[i]=seconds();
+    }
+    
+    timings("Implicit",mx,T,N,stats);
+
+    if(Direct) {
+      for(unsigned int i=0; i < nx; i++) 
+        for(unsigned int j=0; j < ny; j++)
+          for(unsigned int k=0; k < nz; k++)
+            for(unsigned int l=0; l < mw; l++)
+              h0[i][j][k][l]=f[i+!xcompact][j+!ycompact][k+!zcompact][l];
+    }
+
+    if(nx*ny*nz*mw < outlimit) {
+      for(unsigned int i=!xcompact; i < nxp; ++i) {
+        for(unsigned int j=!ycompact; j < nyp; ++j) {
+          for(unsigned int k=!zcompact; k < nzp; ++k) {
+            for(unsigned int l=0; l < mw; ++l)
+              cout << f[i][j][k][l] << "\t";
+            cout << endl;
+          }
+          cout << endl;
+        }
+        cout << endl;
+      }
+    } else cout << f[!xcompact][!ycompact][!zcompact][0] << endl;
+  }
+  
+  if(Direct) {
+    array4<Complex> h(nx,ny,nz,mw,align);
+    Complex *G[]={ComplexAlign(nx*ny*nz*mw),ComplexAlign(nx*ny*nz*mw)};
+    DirectHConvolution4 C(mx,my,mz,mw);
+    init(G,nx,ny,nz,mw,2,true,true,true,true);
+    seconds();
+    C.convolve(h,G[0],G[1]);
+    T[0]=seconds();
+
+    timings("Direct",mx,T,1);
+
+    if(nx*ny*nz*mw < outlimit) {
+      for(unsigned int i=0; i < nx; ++i) {
+        for(unsigned int j=0; j < ny; ++j) {
+          for(unsigned int k=0; k < nz; ++k) {
+            for(unsigned int l=0; l < mw; ++l)
+              cout << h[i][j][k][l] << "\t";
+            cout << endl;
+          }
+          cout << endl;
+        }
+        cout << endl;
+      }
+    } else cout << h[0][0][0][0] << endl;
+    
+    if(Implicit) { // compare implicit version with direct verion:
+      double error=0.0;
+      double norm=0.0;
+      for(unsigned int i=0; i < h.Size(); i++) {
+        error += abs2(h0(i)-h(i));
+        norm += abs2(h(i));
+      }
+      if(norm > 0) error=sqrt(error/norm);
+      cout << "error=" << error << endl;
+      if (error > 1e-12) cerr << "Caution! error=" << error << endl;
+    }
+    deleteAlign(G[1]);
+    deleteAlign(G[0]);
+  }
+  
+  delete [] T;
+  for(unsigned int a=0; a < A; ++a)
+    deleteAlign(F[a]);
+  delete [] F;
+
+  return 0;
+}
@@ -0,0 +1,224 @@
+#include "convolution.h"
+#include "utils.h"
+#include "Array.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int mx=4;
+unsigned int my=4;
+unsigned int mz=4;
+
+bool autocorrelation=false;
+
+// Initialize the Hermitian-symmetric array f of size
+// (2mx-1)*(2my-1)*(2mz-1) centered on (mx-1,my-1,mz-1).
+inline void init(array3<Complex>& f, double factor)
+{
+  int xorigin=mx-1;
+  int yorigin=my-1;
+  int zorigin=mz-1;
+  for(int i=-xorigin; i <= xorigin; ++i) {
+    for(int j=-yorigin; j <= yorigin; ++j) {
+      for(int k=0; k <= zorigin; ++k) {
+        Complex v=factor*Complex(i+2*k+1,j-k+factor);
+        if(k == 0 && (j < 0 || (j == 0 && i < 0))) continue;
+        if(i == 0 && j == 0 && k == 0) v.im=0.0;
+        f[xorigin+i][yorigin+j][zorigin+k]=v;
+        f[xorigin-i][yorigin-j][zorigin-k]=conj(v);
+      }
+    }
+  }
+}
+
+// Copy the z >= 0 half of the full array f into the Hermitian array h.
+inline void half(array3<Complex>& h, array3<Complex>& f)
+{
+  unsigned int nx=2*mx-1;
+  unsigned int ny=2*my-1;
+  for(unsigned int i=0; i < nx; ++i)
+    for(unsigned int j=0; j < ny; ++j)
+      for(unsigned int k=0; k < mz; ++k)
+        h[i][j][k]=f[i][j][mz-1+k];
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  unsigned int dimension=2;
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"had:N:m:x:y:z:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'a':
+        autocorrelation=true;
+        break;
+      case 'd':
+        dimension=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(3);
+        cerr << "-a\t\t autocorrelation" << endl;
+        cerr << "-d\t\t dimension (1, 2, or 3)" << endl;
+        exit(1);
+    }
+  }
+
+  if(dimension < 1 || dimension > 3) {
+    cerr << "dimension=" << dimension << " is not implemented" << endl;
+    exit(1);
+  }
+
+  // Lower-dimensional problems use the trailing dimensions.
+  if(dimension < 3) {
+    mz=my;
+    my=mx;
+    mx=1;
+  }
+  if(dimension < 2) {
+    mz=my;
+    my=1;
+  }
+
+  cout << "mx=" << mx << ", my=" << my << ", mz=" << mz << endl;
+
+  if(N == 0) {
+    N=N0/(2*mx)/(2*my)/(2*mz);
+    N=max(N,20);
+  }
+  cout << "N=" << N << endl;
+
+  unsigned int nx=2*mx-1;
+  unsigned int ny=2*my-1;
+  unsigned int nz=2*mz-1;
+  unsigned int A=autocorrelation ? 1 : 2;
+  size_t align=sizeof(Complex);
+
+  array3<Complex> f(nx,ny,nz,align), g(nx,ny,nz,align);
+  array3<Complex> hf(nx,ny,mz,align), hg(nx,ny,mz,align);
+  array3<Complex> F(nx,ny,nz,align), G(nx,ny,nz,align);
+
+  double *T=new double[N];
+
+  // Correlation of Hermitian-compact data.
+  ImplicitHConvolution *H1=NULL;
+  ImplicitHConvolution2 *H2=NULL;
+  ImplicitHConvolution3 *H3=NULL;
+  if(dimension == 1) H1=new ImplicitHConvolution(mz,true,A,1);
+  if(dimension == 2) H2=new ImplicitHConvolution2(my,mz,true,true,A,1);
+  if(dimension == 3) H3=new ImplicitHConvolution3(mx,my,mz,true,true,true,A,1);
+
+  for(unsigned int i=0; i < N; ++i) {
+    init(f,1.0);
+    init(g,0.5);
+    half(hf,f);
+    half(hg,g);
+    seconds();
+    if(autocorrelation) {
+      if(H1) H1->autocorrelate(hf());
+      if(H2) H2->autocorrelate(hf());
+      if(H3) H3->autocorrelate(hf());
+    } else {
+      if(H1) H1->correlate(hf(),hg());
+      if(H2) H2->correlate(hf(),hg());
+      if(H3) H3->correlate(hf(),hg());
+    }
+    T[i]=seconds();
+  }
+  timings("Hermitian",mz,T,N,stats);
+
+  // Correlation of the full complex data.
+  ImplicitConvolution *C1=NULL;
+  ImplicitConvolution2 *C2=NULL;
+  ImplicitConvolution3 *C3=NULL;
+  if(dimension == 1) C1=new ImplicitConvolution(nz,A,1);
+  if(dimension == 2) C2=new ImplicitConvolution2(ny,nz,A,1);
+  if(dimension == 3) C3=new ImplicitConvolution3(nx,ny,nz,A,1);
+
+  for(unsigned int i=0; i < N; ++i) {
+    init(F,1.0);
+    init(G,0.5);
+    seconds();
+    if(autocorrelation) {
+      if(C1) C1->autocorrelate(F());
+      if(C2) C2->autocorrelate(F());
+      if(C3) C3->autocorrelate(F());
+    } else {
+      if(C1) C1->correlate(F(),G());
+      if(C2) C2->correlate(F(),G());
+      if(C3) C3->correlate(F(),G());
+    }
+    T[i]=seconds();
+  }
+  timings("Complex",mz,T,N,stats);
+
+  // Compare the nonnegative lags.
+  double error=0.0;
+  double norm=0.0;
+  for(unsigned int i=0; i < mx; ++i) {
+    for(unsigned int j=0; j < my; ++j) {
+      for(unsigned int k=0; k < mz; ++k) {
+        Complex h=hf[mx-1+i][my-1+j][k];
+        error += abs2(h-F[i][j][k]);
+        norm += abs2(F[i][j][k]);
+      }
+    }
+  }
+  if(norm > 0) error=sqrt(error/norm);
+  cout << endl << "error=" << error << endl;
+  if(error > 1e-12) cerr << "Caution! error=" << error << endl;
+
+  delete C3;
+  delete C2;
+  delete C1;
+  delete H3;
+  delete H2;
+  delete H1;
+  delete [] T;
+
+  return 0;
+}
@@ -173,6 +173,8 @@ def check_ternary(proglist):
     nfails = 0
     xlist = [0,8,9,10]
     ylist = [0,8,9,10]
+    # 3D direct ternary convolutions are slow, so keep every dimension small.
+    zlist = [1,2,3]
     Alist = [2,4]
     typearg = "-i"
     for prog in proglist:
@@ -195,6 +197,11 @@ def check_ternary(proglist):
                     ntests2, nfails2 = run2d(preprint, command, xlist, ylist)
                     ntests += ntests2
                     nfails += nfails2
+                if dimension == 3:
+                    ntests3, nfails3 = run3d(preprint, command, zlist,
+                                             zlist, zlist)
+                    ntests += ntests3
+                    nfails += nfails3
             else:
                 print(prog + " does not exist; please compile.")
                 nfails += 1
@@ -319,36 +326,51 @@ def check_explicit(proglist):
     xlist = [0,8,9,10]
     ylist = [0,8,9,10]
     zlist = [0,8,9,10]
-    Alist = [2]
     typearg = "-e"
     for prog in proglist:
+        dimension = progdim(prog)
+        # The explicit ternary convolutions have no M-sum; the others are
+        # tested through their multipliers with A=2 and A=4.
+        if prog.startswith("tconv"):
+            Alist = [2]
+        else:
+            Alist = [2,4]
+        # Pruning skips the zero-padded rows of the 2D and 3D transforms;
+        # the x and y lists include sizes with nx != ny.
+        if dimension == 1:
+            prunelist = [""]
+        else:
+            prunelist = ["", "-p"]
         for A in Alist:
-            preprint = prog + "\texplicit\tA=" + str(A)
-            command = []
-            command.append("./" + prog)
-            command.append("-N1")
-            command.append(typearg)
-            command.append("-d")
-            command.append("-A" + str(A))
-            command.append("-T1")
-            if os.path.isfile(prog):
-                dimension = progdim(prog)
-                if dimension == 1:
-                    ntests1, nfails1 = run1d(preprint, command, xlist)
-                    ntests += ntests1
-                    nfails += nfails1
-                if dimension == 2:
-                    ntests2, nfails2 = run2d(preprint, command, xlist, ylist)
-                    ntests += ntests2
-                    nfails += nfails2
-                if dimension == 3:
-                    ntests3, nfails3 = run3d(preprint, command, \
-                                             xlist, ylist, zlist)
-                    ntests += ntests3
-                    nfails += nfails3
-            else:
-                print(prog + " does not exist; please compile.")
-                nfails += 1
+            for prune in prunelist:
+                preprint = prog + "\texplicit" + prune + "\tA=" + str(A)
+                command = []
+                command.append("./" + prog)
+                command.append("-N1")
+                command.append(typearg)
+                if prune:
+                    command.append(prune)
+                command.append("-d")
+                command.append("-A" + str(A))
+                command.append("-T1")
+                if os.path.isfile(prog):
+                    if dimension == 1:
+                        ntests1, nfails1 = run1d(preprint, command, xlist)
+                        ntests += ntests1
+                        nfails += nfails1
+                    if dimension == 2:
+                        ntests2, nfails2 = run2d(preprint, command,
+                                                 xlist, ylist)
+                        ntests += ntests2
+                        nfails += nfails2
+                    if dimension == 3:
+                        ntests3, nfails3 = run3d(preprint, command, \
+                                                 xlist, ylist, zlist)
+                        ntests += ntests3
+                        nfails += nfails3
+                else:
+                    print(prog + " does not exist; please compile.")
+                    nfails += 1
     return ntests, nfails
 
 
@@ -366,7 +388,7 @@ atests, afails = check_auto(autolist)
 ntests += atests
 nfails += afails
 
-tconvlist = ["tconv", "tconv2"]
+tconvlist = ["tconv", "tconv2", "tconv3"]
 ttests, tfails = check_ternary(tconvlist)
 ntests += ttests
 nfails += tfails
@@ -381,7 +403,7 @@ cotests, cofails = check_compact(compactlist)
 ntests += cotests
 nfails += cofails
 
-elist = ["cconv", "cconv2", "cconv3", "conv", "conv2"] 
+elist = ["cconv", "cconv2", "cconv3", "conv", "conv2", "tconv", "tconv2"]
 etests, efails = check_explicit(elist)
 ntests += etests
 nfails += efails
@@ -2,6 +2,7 @@
 #include "Array.h"
 #include "fftw++.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -82,6 +83,7 @@ int main(int argc, char* argv[])
     }
 
     timings("fft1 in-place",m,T,N,stats);
+    roofline(fftModel(1),mean(T,N,stats),m);
   }
 
   if(r == -1 || r == 1) {
@@ -94,6 +96,7 @@ int main(int argc, char* argv[])
     }
 
     timings("fft1 out-of-place",m,T,N,stats);
+    roofline(fftModel(1),mean(T,N,stats),m);
   }
 
   //cout << "\nback to input:\n" << f << endl;
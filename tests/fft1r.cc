@@ -2,6 +2,7 @@
 #include "Array.h"
 #include "fftw++.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -81,6 +82,7 @@ int main(int argc, char* argv[])
       Backward.Normalize(f);
     }
     timings("fft1 in-place",m,T,N,stats);
+    roofline(fftModel(1,true),mean(T,N,stats),m);
   }
 
   if(r == -1 || r == 1) {
@@ -96,6 +98,7 @@ int main(int argc, char* argv[])
       Backward0.Normalize(f);
     }
     timings("fft1 out-of-place",m,T,N,stats);
+    roofline(fftModel(1,true),mean(T,N,stats),m);
   }
 
   //cout << "\nback to input:\n" << f << endl;
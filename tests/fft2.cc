@@ -2,6 +2,7 @@
 #include "Array.h"
 #include "fftw++.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -107,6 +108,7 @@ int main(int argc, char* argv[])
       Backward2.Normalize(f);
     }
     timings("fft2d, in-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
   
   if(r == -1 || r == 1) { // conventional FFT, out-of-place
@@ -123,6 +125,7 @@ int main(int argc, char* argv[])
       Backward2.Normalize(f);
     }
     timings("fft2d, out-of-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
 
   if(r == -1 || r == 2)  { // using the transpose, in-place
@@ -152,6 +155,7 @@ int main(int argc, char* argv[])
       Backwardy.Normalize(f);
     }
     timings("transpose and mfft, in-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
 
   if(r == -1 || r == 3)  { // using the transpose, out-of-place
@@ -181,6 +185,7 @@ int main(int argc, char* argv[])
       Backwardy.Normalize(f);
     }
     timings("transpose and mfft, out-of-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
   
   if(r == -1 || r == 4) { // full transpose, in-place
@@ -213,6 +218,7 @@ int main(int argc, char* argv[])
       Backwardy.Normalize(f);
     }
     timings("2 transposes and mfft, in-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
 
   if(r == -1 || r == 5) { // full transpose, out-of-place
@@ -246,6 +252,7 @@ int main(int argc, char* argv[])
       Backwardy.Normalize(f);
     }
     timings("2 transposes and mfft, out-of-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
   
   if(r == -1 || r == 6)  { // using strides, in-place
@@ -270,6 +277,7 @@ int main(int argc, char* argv[])
       Backwardy.Normalize(f);
     }
     timings("strided mfft in-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
 
 
@@ -295,6 +303,7 @@ int main(int argc, char* argv[])
       Backwardy.Normalize(f);
     }
     timings("strided mfft out-of-place",mx,T,N,stats);
+    roofline(fftModel(2),mean(T,N,stats),mx,my);
   }
   
   cout << endl;
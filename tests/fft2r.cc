@@ -2,6 +2,7 @@
 #include "Array.h"
 #include "fftw++.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -91,6 +92,35 @@ int main(int argc, char* argv[])
   rcfft2d Forward(nx,ny,f,g);
   crfft2d Backward(nx,ny,g,f);
 
+  if(nx % 2 == 0) {
+    // Check the fused shift and Nyquist removal against fft0 and deNyquist.
+    array2<Complex> h0(nx,nyp,align);
+    array2<Complex> h(nx,nyp,align);
+    array2<double> f0(nx,ny,align);
+    finit(f,nx,ny);
+    Forward.fft0(f,g);
+    for(unsigned int i=0; i < nx*nyp; ++i) h0(i)=g(i);
+    Forward.deNyquist(g);
+    for(unsigned int i=0; i < nx*nyp; ++i) h(i)=g(i);
+    finit(f,nx,ny);
+    Forward.fft0deNyquist(f,g);
+    double error=0.0;
+    for(unsigned int i=0; i < nx*nyp; ++i)
+      error=max(error,abs(g(i)-h(i)));
+    for(unsigned int i=0; i < nx*nyp; ++i) g(i)=h(i);
+    Backward.fft0(g,f);
+    for(unsigned int i=0; i < nx; ++i)
+      for(unsigned int j=0; j < ny; ++j)
+        f0(i,j)=f(i,j);
+    for(unsigned int i=0; i < nx*nyp; ++i) g(i)=h0(i);
+    Backward.fft0deNyquist(g,f);
+    for(unsigned int i=0; i < nx; ++i)
+      for(unsigned int j=0; j < ny; ++j)
+        error=max(error,abs(f(i,j)-f0(i,j)));
+    cout << "fft0 error=" << error << endl;
+    if(error > 1e-10) cerr << "Caution! error=" << error << endl;
+  }
+
   if(!quiet) {
     finit(f,nx,ny);
     cout << endl << "Input:" << endl;
@@ -141,5 +171,6 @@ int main(int argc, char* argv[])
   }
 
   timings("fft2 out-of-place",nx,T,N,stats);
+  roofline(fftModel(2,true),mean(T,N,stats),nx,ny);
  
 }
@@ -2,6 +2,7 @@
 #include "Array.h"
 #include "fftw++.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -113,6 +114,7 @@ int main(int argc, char* argv[])
       Backward3.Normalize(f);
     }
     timings("fft3d, in-place", mx, T, N, stats);
+    roofline(fftModel(3),mean(T,N,stats),mx,my,mz);
   }
   
   if(r == -1 || r == 1) { // conventional FFT, out-of-place
@@ -128,6 +130,7 @@ int main(int argc, char* argv[])
       Backward3.Normalize(f);
     }
     timings("fft3d, out-of-place", mx, T, N, stats);
+    roofline(fftModel(3),mean(T,N,stats),mx,my,mz);
   }
 
   delete [] T;
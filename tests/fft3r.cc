@@ -2,6 +2,7 @@
 #include "Array.h"
 #include "fftw++.h"
 #include "utils.h"
+#include "roofline.h"
 
 using namespace std;
 using namespace utils;
@@ -94,6 +95,38 @@ int main(int argc,char* argv[])
   rcfft3d Forward(nx,ny,nz,f,g);
   crfft3d Backward(nx,ny,nz,g,f);
   
+  if(nx % 2 == 0 && ny % 2 == 0) {
+    // Check the fused shift and Nyquist removal against fft0 and deNyquist.
+    unsigned int n=nx*ny*nzp;
+    array3<Complex> h0(nx,ny,nzp,align);
+    array3<Complex> h(nx,ny,nzp,align);
+    array3<double> f0(nx,ny,nz,align);
+    finit(f,nx,ny,nz);
+    Forward.fft0(f,g);
+    for(unsigned int i=0; i < n; ++i) h0(i)=g(i);
+    Forward.deNyquist(g);
+    for(unsigned int i=0; i < n; ++i) h(i)=g(i);
+    finit(f,nx,ny,nz);
+    Forward.fft0deNyquist(f,g);
+    double error=0.0;
+    for(unsigned int i=0; i < n; ++i)
+      error=max(error,abs(g(i)-h(i)));
+    for(unsigned int i=0; i < n; ++i) g(i)=h(i);
+    Backward.fft0(g,f);
+    for(unsigned int i=0; i < nx; ++i)
+      for(unsigned int j=0; j < ny; ++j)
+        for(unsigned int k=0; k < nz; ++k)
+          f0(i,j,k)=f(i,j,k);
+    for(unsigned int i=0; i < n; ++i) g(i)=h0(i);
+    Backward.fft0deNyquist(g,f);
+    for(unsigned int i=0; i < nx; ++i)
+      for(unsigned int j=0; j < ny; ++j)
+        for(unsigned int k=0; k < nz; ++k)
+          error=max(error,abs(f(i,j,k)-f0(i,j,k)));
+    cout << "fft0 error=" << error << endl;
+    if(error > 1e-10) cerr << "Caution! error=" << error << endl;
+  }
+
   if(!quiet) {
     finit(f,nx,ny,nz);
     cout << endl << "Input:" << endl;
@@ -145,5 +178,6 @@ int main(int argc,char* argv[])
     }
   }
   timings("fft3 out-of-place",nx,T,N,stats);
+  roofline(fftModel(3,true),mean(T,N,stats),nx,ny,nz);
   
 }
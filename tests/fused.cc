@@ -0,0 +1,254 @@
+#include "convolution.h"
+#include "direct.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int m=11;
+
+bool Hermitian=true;
+
+enum Fused {DOT,CROSS,ADVECTION3};
+
+inline void init(Complex **F, unsigned int A)
+{
+  for(unsigned int s=0; s < A; ++s) {
+    double factor=1.0/(1.0+s);
+    Complex *f=F[s];
+    for(unsigned int k=0; k < m; ++k)
+      f[k]=factor*Complex(k+s,2.0*k-s+1.0);
+    if(Hermitian) f[0].im=0.0;
+  }
+}
+
+// Return in h the sum of the direct convolutions of the pairs
+// (F[p[2i]],F[p[2i+1]]), weighted by c[i], for i < n.
+void direct(Complex *h, Complex **F, const unsigned int *p, const double *c,
+            unsigned int n)
+{
+  Complex *g=ComplexAlign(m);
+  for(unsigned int k=0; k < m; ++k)
+    h[k]=0.0;
+  for(unsigned int i=0; i < n; ++i) {
+    if(Hermitian) {
+      DirectHConvolution C(m);
+      C.convolve(g,F[p[2*i]],F[p[2*i+1]]);
+    } else {
+      DirectConvolution C(m);
+      C.convolve(g,F[p[2*i]],F[p[2*i+1]]);
+    }
+    for(unsigned int k=0; k < m; ++k)
+      h[k] += c[i]*g[k];
+  }
+  deleteAlign(g);
+}
+
+template<unsigned int A>
+void dotmultipliers(multiplier *&mult, realmultiplier *&realmult)
+{
+  mult=multdot<A>;
+  realmult=multdot<A>;
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  unsigned int A=4; // Number of inputs for the dot product
+  int fused=DOT;
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hcA:F:N:m:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'c':
+        Hermitian=false;
+        break;
+      case 'A':
+        A=atoi(optarg);
+        break;
+      case 'F':
+        fused=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        m=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(1);
+        cerr << "-c\t\t complex (instead of Hermitian) convolution" << endl;
+        cerr << "-A\t\t number of dot product inputs" << endl;
+        cerr << "-F\t\t fused multiplier: 0=dot, 1=cross, 2=advection3"
+             << endl;
+        exit(1);
+    }
+  }
+
+  multiplier *mult=NULL;
+  realmultiplier *realmult=NULL;
+  unsigned int B=1;
+  switch(fused) {
+    case DOT:
+      switch(A) {
+        case 2: dotmultipliers<2>(mult,realmult); break;
+        case 4: dotmultipliers<4>(mult,realmult); break;
+        case 6: dotmultipliers<6>(mult,realmult); break;
+        case 8: dotmultipliers<8>(mult,realmult); break;
+        case 12: dotmultipliers<12>(mult,realmult); break;
+        case 16: dotmultipliers<16>(mult,realmult); break;
+        default:
+          cerr << "A=" << A << " is not yet implemented" << endl;
+          exit(1);
+      }
+      break;
+    case CROSS:
+      A=6;
+      B=3;
+      mult=multcross;
+      realmult=multcross;
+      break;
+    case ADVECTION3:
+      if(!Hermitian) {
+        cerr << "advection3 requires Hermitian data" << endl;
+        exit(1);
+      }
+      A=3;
+      B=5;
+      realmult=multadvection3;
+      break;
+    default:
+      cerr << "fused multiplier " << fused << " is not implemented" << endl;
+      exit(1);
+  }
+
+  cout << "m=" << m << ", A=" << A << ", B=" << B << endl;
+
+  if(N == 0) {
+    N=N0/m;
+    N=max(N,20);
+  }
+  cout << "N=" << N << endl;
+
+  unsigned int C=max(A,B);
+  Complex *f=ComplexAlign(C*m);
+  Complex **F=new Complex *[C];
+  for(unsigned int s=0; s < C; ++s)
+    F[s]=f+s*m;
+
+  ImplicitHConvolution *H=Hermitian ? new ImplicitHConvolution(m,true,A,B) :
+    NULL;
+  ImplicitConvolution *Z=Hermitian ? NULL : new ImplicitConvolution(m,A,B);
+
+  double *T=new double[N];
+  for(unsigned int i=0; i < N; ++i) {
+    init(F,A);
+    seconds();
+    if(H) H->convolve(F,realmult);
+    else Z->convolve(F,mult);
+    T[i]=seconds();
+  }
+  timings("Fused",m,T,N,stats);
+
+  // Time the same products computed as separate binary convolutions.
+  unsigned int products=fused == DOT ? A/2 : 6;
+  Complex *g=ComplexAlign(2*m);
+  Complex *G[]={g,g+m};
+  ImplicitHConvolution Hbinary(m);
+  ImplicitConvolution Zbinary(m);
+  for(unsigned int i=0; i < N; ++i) {
+    init(G,2);
+    seconds();
+    for(unsigned int p=0; p < products; ++p) {
+      if(Hermitian) Hbinary.convolve(G,multbinary);
+      else Zbinary.convolve(G,multbinary);
+    }
+    T[i]=seconds();
+  }
+  timings("Separate",m,T,N,stats);
+  deleteAlign(g);
+
+  // Compare with linear combinations of direct binary convolutions.
+  Complex *inputs=ComplexAlign(C*m);
+  Complex **I=new Complex *[C];
+  for(unsigned int s=0; s < C; ++s)
+    I[s]=inputs+s*m;
+  init(I,A);
+  init(F,A);
+  if(H) H->convolve(F,realmult);
+  else Z->convolve(F,mult);
+
+  Complex *h=ComplexAlign(m);
+  double error=0.0;
+  double norm=0.0;
+  for(unsigned int b=0; b < B; ++b) {
+    if(fused == DOT) {
+      unsigned int M=A/2;
+      unsigned int *p=new unsigned int[A];
+      double *c=new double[M];
+      for(unsigned int s=0; s < M; ++s) {
+        p[2*s]=s;
+        p[2*s+1]=M+s;
+        c[s]=1.0;
+      }
+      direct(h,I,p,c,M);
+      delete [] c;
+      delete [] p;
+    } else if(fused == CROSS) {
+      static const unsigned int p[][4]={{1,5,2,4},{2,3,0,5},{0,4,1,3}};
+      static const double c[]={1.0,-1.0};
+      direct(h,I,p[b],c,2);
+    } else {
+      static const unsigned int p[][4]={{0,0,2,2},{1,1,2,2},{0,1},{0,2},
+                                        {1,2}};
+      static const double c[]={1.0,-1.0};
+      direct(h,I,p[b],c,b < 2 ? 2 : 1);
+    }
+    for(unsigned int k=0; k < m; ++k) {
+      error += abs2(F[b][k]-h[k]);
+      norm += abs2(h[k]);
+    }
+  }
+  if(norm > 0) error=sqrt(error/norm);
+  cout << endl << "error=" << error << endl;
+  if(error > 1e-12) cerr << "Caution! error=" << error << endl;
+
+  deleteAlign(h);
+  delete [] I;
+  deleteAlign(inputs);
+  delete [] T;
+  delete Z;
+  delete H;
+  delete [] F;
+  deleteAlign(f);
+
+  return 0;
+}
@@ -0,0 +1,192 @@
+#include "Complex.h"
+#include "Array.h"
+#include "fftw++.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int mx=4;
+unsigned int my=4;
+
+inline void init(array4<double>& f)
+{
+  unsigned int n=f.Size();
+  for(unsigned int i=0; i < n; ++i)
+    f(i)=(i % 7)+1.0/(1.0+i);
+}
+
+inline void init(array3<Complex>& f)
+{
+  unsigned int n=f.Size();
+  for(unsigned int i=0; i < n; ++i)
+    f(i)=Complex(i % 5,1.0/(1.0+i));
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hN:m:x:y:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(2);
+        exit(1);
+    }
+  }
+
+  cout << "mx=" << mx << ", my=" << my << endl;
+
+  if(N == 0) {
+    N=N0/mx/my/16;
+    N=max(N,20);
+  }
+  cout << "N=" << N << endl;
+
+  size_t align=sizeof(Complex);
+  double error=0.0;
+
+  // Real 2D transforms of the mx*my slices of a 3*2*mx*my array.
+  unsigned int nx=3, ny=2;
+  unsigned int myp=my/2+1;
+  array4<double> f(nx,ny,mx,my,align), f0(nx,ny,mx,my,align);
+  array4<Complex> g(nx,ny,mx,myp,align);
+
+  fftw_iodim dims[]={{(int) mx,(int) my,(int) myp},{(int) my,1,1}};
+  fftw_iodim howmany[]={{(int) nx,(int) (ny*mx*my),(int) (ny*mx*myp)},
+                        {(int) ny,(int) (mx*my),(int) (mx*myp)}};
+  fftw_iodim idims[]={{(int) mx,(int) myp,(int) my},{(int) my,1,1}};
+  fftw_iodim ihowmany[]={{(int) nx,(int) (ny*mx*myp),(int) (ny*mx*my)},
+                         {(int) ny,(int) (mx*myp),(int) (mx*my)}};
+  rcfftguru Forward(2,dims,2,howmany,f(),g());
+  crfftguru Backward(2,idims,2,ihowmany,g(),f());
+
+  init(f);
+  init(f0);
+  Forward.fft(f(),g());
+
+  array2<double> s(mx,my,align);
+  array2<Complex> S(mx,myp,align);
+  rcfft2d Forward2(mx,my,s(),S());
+  for(unsigned int i=0; i < nx; ++i) {
+    for(unsigned int j=0; j < ny; ++j) {
+      for(unsigned int k=0; k < mx; ++k)
+        for(unsigned int l=0; l < my; ++l)
+          s[k][l]=f0[i][j][k][l];
+      Forward2.fft(s(),S());
+      for(unsigned int k=0; k < mx; ++k)
+        for(unsigned int l=0; l < myp; ++l)
+          error=max(error,abs(S[k][l]-g[i][j][k][l]));
+    }
+  }
+
+  Backward.fftNormalized(g(),f());
+  for(unsigned int i=0; i < f.Size(); ++i)
+    error=max(error,abs(f(i)-f0(i)));
+
+  // Complex 2D transform of an mx*my sub-box of a (mx+3)*(my+2)*4 array,
+  // in place, on the k=1 plane with stride 4.
+  unsigned int Nx=mx+3, Ny=my+2, Nz=4;
+  unsigned int x0=1, y0=2, z0=1;
+  array3<Complex> h(Nx,Ny,Nz,align), h0(Nx,Ny,Nz,align);
+  Complex *box=h()+(x0*Ny+y0)*Nz+z0;
+  fftw_iodim bdims[]={{(int) mx,(int) (Ny*Nz),(int) (Ny*Nz)},
+                      {(int) my,(int) Nz,(int) Nz}};
+  fftguru BoxForward(2,bdims,0,NULL,-1,box);
+  fftguru BoxBackward(2,bdims,0,NULL,1,box);
+
+  init(h);
+  init(h0);
+  BoxForward.fft(box);
+
+  array2<Complex> b(mx,my,align);
+  fft2d Forward2c(mx,my,-1,b());
+  for(unsigned int i=0; i < mx; ++i)
+    for(unsigned int j=0; j < my; ++j)
+      b[i][j]=h0[x0+i][y0+j][z0];
+  Forward2c.fft(b());
+  for(unsigned int i=0; i < Nx; ++i) {
+    for(unsigned int j=0; j < Ny; ++j) {
+      for(unsigned int k=0; k < Nz; ++k) {
+        bool inside=k == z0 && i >= x0 && i < x0+mx && j >= y0 && j < y0+my;
+        Complex v=inside ? b[i-x0][j-y0] : h0[i][j][k];
+        error=max(error,abs(h[i][j][k]-v));
+      }
+    }
+  }
+
+  BoxBackward.fftNormalized(box);
+  for(unsigned int i=0; i < h.Size(); ++i)
+    error=max(error,abs(h(i)-h0(i)));
+
+  cout << "error=" << error << endl;
+  if(error > 1e-10) cerr << "Caution! error=" << error << endl;
+
+  // Compare in-place sub-box transforms with copying to a buffer.
+  double *T=new double[N];
+  for(unsigned int i=0; i < N; ++i) {
+    init(h);
+    seconds();
+    BoxForward.fft(box);
+    T[i]=seconds();
+  }
+  timings("guru",mx,T,N,stats);
+
+  for(unsigned int i=0; i < N; ++i) {
+    init(h);
+    seconds();
+    for(unsigned int k=0; k < mx; ++k)
+      for(unsigned int l=0; l < my; ++l)
+        b[k][l]=h[x0+k][y0+l][z0];
+    Forward2c.fft(b());
+    for(unsigned int k=0; k < mx; ++k)
+      for(unsigned int l=0; l < my; ++l)
+        h[x0+k][y0+l][z0]=b[k][l];
+    T[i]=seconds();
+  }
+  timings("copy",mx,T,N,stats);
+  delete [] T;
+
+  return 0;
+}
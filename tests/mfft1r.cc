@@ -138,6 +138,33 @@ int main(int argc, char* argv[])
 
 
   cout << endl;
+  if(M % 2 == 0) {
+    // Check the shifted transforms against explicitly shifted data.
+    array2<Complex> h(np,my,align);
+    init(f,mx,my);
+    Forward.fft(f,h);
+    for(unsigned int i=1; i < M; i += 2)
+      for(unsigned int j=0; j < np; ++j)
+        h(i*cdist+j)=-h(i*cdist+j);
+    Forward.fft0(f,g);
+    double error=0.0;
+    for(unsigned int i=0; i < M*np; ++i)
+      error=max(error,abs(g(i)-h(i)));
+    Backward.fft0Normalized(g,f);
+    array2<double> f0(mx,my,align);
+    init(f0,mx,my);
+    for(unsigned int i=0; i < M*mx; ++i)
+      error=max(error,abs(f(i)-f0(i)));
+    Forward.deNyquist(h);
+    init(f,mx,my);
+    Forward.fft0deNyquist(f,g);
+    for(unsigned int i=0; i < M*np; ++i)
+      error=max(error,abs(g(i)-h(i)));
+    cout << "fft0 error=" << error << endl;
+    if(error > 1e-10) cerr << "Caution! error=" << error << endl;
+    cout << endl;
+  }
+
   if(N > 0) {
     double *T=new double[N];
     for(unsigned int i=0; i < N; ++i) {
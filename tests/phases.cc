@@ -0,0 +1,175 @@
+#include <string>
+#include "convolution.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace fftwpp;
+
+// Per-phase breakdown of implicitly dealiased convolutions.
+// This driver is compiled with -DFFTWPP_INSTRUMENT.
+
+unsigned int N=100;
+unsigned int mx=64;
+unsigned int my=0;
+
+inline void init(Complex *f, unsigned int n, double factor)
+{
+  for(unsigned int i=0; i < n; ++i)
+    f[i]=factor*Complex(i % 11,(2*i+1) % 7);
+}
+
+void report()
+{
+  instrument::counter sum;
+  for(unsigned int p=0; p < instrument::FFT; ++p)
+    sum += instrument::get((instrument::phase) p);
+
+  cout << endl << "phase\t\tseconds\t\tpercent\tcalls\tGB/s\t\tGFLOP/s"
+       << endl;
+  for(unsigned int p=0; p < instrument::PHASES; ++p) {
+    instrument::counter c=instrument::get((instrument::phase) p);
+    if(c.calls == 0) continue;
+    cout << instrument::name(p) << (strlen(instrument::name(p)) < 8 ?
+                                    "\t\t" : "\t")
+         << c.seconds << "\t"
+         << (p < instrument::FFT && sum.seconds > 0.0 ?
+             100.0*c.seconds/sum.seconds : 0.0) << "\t" << c.calls << "\t"
+         << c.bandwidth() << "\t" << c.throughput() << endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  string type="cconv";
+  const char *output=NULL;
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"ht:N:m:x:y:o:T:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 't':
+        type=optarg;
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'o':
+        output=optarg;
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'h':
+      default:
+        cerr << "Usage: " << argv[0] << " [options]" << endl;
+        cerr << "-t\t\t convolution: cconv, conv, cconv2, conv2, tconv, tconv2"
+             << endl;
+        cerr << "-N\t\t number of iterations" << endl;
+        cerr << "-m\t\t size" << endl;
+        cerr << "-x\t\t x size" << endl;
+        cerr << "-y\t\t y size" << endl;
+        cerr << "-o\t\t JSON output file (%d is replaced by the rank)"
+             << endl;
+        cerr << "-T\t\t number of threads" << endl;
+        exit(1);
+    }
+  }
+
+  if(my == 0) my=mx;
+
+  unsigned int n=0;
+  if(type == "cconv" || type == "conv") n=mx;
+  else if(type == "cconv2") n=mx*my;
+  else if(type == "conv2") n=(2*mx-1)*my;
+  else if(type == "tconv") n=mx+1;
+  else if(type == "tconv2") n=2*mx*(my+1);
+  else {
+    cerr << "Unknown convolution " << type << endl;
+    exit(1);
+  }
+
+  Complex *f=ComplexAlign(n);
+  Complex *g=ComplexAlign(n);
+  Complex *h=ComplexAlign(n);
+
+  ImplicitConvolution *C=NULL;
+  ImplicitHConvolution *H=NULL;
+  ImplicitConvolution2 *C2=NULL;
+  ImplicitHConvolution2 *H2=NULL;
+  ImplicitHTConvolution *T=NULL;
+  ImplicitHTConvolution2 *T2=NULL;
+  if(type == "cconv") C=new ImplicitConvolution(mx);
+  else if(type == "conv") H=new ImplicitHConvolution(mx);
+  else if(type == "cconv2") C2=new ImplicitConvolution2(mx,my);
+  else if(type == "conv2") H2=new ImplicitHConvolution2(mx,my);
+  else if(type == "tconv") T=new ImplicitHTConvolution(mx);
+  else T2=new ImplicitHTConvolution2(mx,my);
+
+  cout << type << ": mx=" << mx << ", my=" << my << endl;
+  cout << "threads=" << fftw::maxthreads << endl;
+  cout << "N=" << N << endl;
+
+  // Exclude planning and the first (cold) call from the statistics.
+  init(f,n,1.0);
+  init(g,n,0.5);
+  init(h,n,0.25);
+  if(C) C->convolve(f,g);
+  if(H) H->convolve(f,g);
+  if(C2) C2->convolve(f,g);
+  if(H2) H2->convolve(f,g);
+  if(T) T->convolve(f,g,h);
+  if(T2) T2->convolve(f,g,h);
+  instrument::reset();
+
+  seconds();
+  for(unsigned int i=0; i < N; ++i) {
+    init(f,n,1.0);
+    init(g,n,0.5);
+    init(h,n,0.25);
+    if(C) C->convolve(f,g);
+    if(H) H->convolve(f,g);
+    if(C2) C2->convolve(f,g);
+    if(H2) H2->convolve(f,g);
+    if(T) T->convolve(f,g,h);
+    if(T2) T2->convolve(f,g,h);
+  }
+  double total=seconds();
+  cout << "total seconds=" << total << endl;
+
+  report();
+  if(output) instrument::dumpJSON(output);
+
+  delete T2;
+  delete T;
+  delete H2;
+  delete C2;
+  delete H;
+  delete C;
+  deleteAlign(h);
+  deleteAlign(g);
+  deleteAlign(f);
+
+  return 0;
+}
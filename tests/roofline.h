@@ -0,0 +1,270 @@
+#ifndef __roofline_h__
+#define __roofline_h__ 1
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "fftw++.h"
+#include "seconds.h"
+#include "align.h"
+
+namespace utils {
+
+// Roofline report.
+//
+// If the environment variable FFTWPP_ROOFLINE is set (and not "0"), the
+// drivers follow each implicit convolution or FFT timing with the
+// achieved GFLOP/s and GB/s and their ratios to the peak floating-point
+// rate and the STREAM triad bandwidth of this machine (both measured on
+// first use with fftw::maxthreads threads, unless given in GFLOP/s and
+// GB/s by FFTWPP_PEAK and FFTWPP_STREAM). The operation is classified as
+// compute- or memory-bound by comparing its arithmetic intensity with
+// respect to main memory to the ridge point peak/STREAM of the roofline,
+// and the smallest size m (the same in each dimension) at which it
+// becomes memory-bound is reported as the crossover.
+//
+// Operation counts use 5 n log2 n for a complex FFT of length n and
+// 2.5 n log2 n for a real FFT. A convolution is counted as A+B transforms
+// of the implicitly padded size (2m per dimension for complex, 3m for
+// Hermitian, and 4m for Hermitian ternary convolutions) plus the
+// pointwise multiplication. The reported bandwidth assumes that each
+// transform reads and writes its data once. Data that fits in the
+// last-level cache (FFTWPP_CACHE bytes, if set) generates no memory
+// traffic; otherwise each transform makes ceil(log n/log Z) passes over
+// memory, where Z is the number of values that fit in the cache.
+
+inline bool rooflineMode()
+{
+  const char *mode=getenv("FFTWPP_ROOFLINE");
+  return mode && *mode && strcmp(mode,"0") != 0;
+}
+
+// Return the STREAM triad bandwidth in GB/s.
+inline double streamBandwidth()
+{
+  static double bandwidth=0.0;
+  if(bandwidth > 0.0) return bandwidth;
+
+  const char *env=getenv("FFTWPP_STREAM");
+  if(env && *env) return bandwidth=atof(env);
+
+  unsigned int threads=fftwpp::fftw::maxthreads;
+  unsigned int n=1 << 23;
+  double *a,*b,*c;
+  Array::newAlign(a,n,sizeof(Complex));
+  Array::newAlign(b,n,sizeof(Complex));
+  Array::newAlign(c,n,sizeof(Complex));
+  const double s=3.0;
+#ifndef FFTWPP_SINGLE_THREAD
+#pragma omp parallel for num_threads(threads)
+#endif
+  for(unsigned int i=0; i < n; ++i) {
+    a[i]=0.0;
+    b[i]=1.0;
+    c[i]=2.0;
+  }
+
+  double best=0.0;
+  for(unsigned int k=0; k < 5; ++k) {
+    double start=totalseconds();
+#ifndef FFTWPP_SINGLE_THREAD
+#pragma omp parallel for num_threads(threads)
+#endif
+    for(unsigned int i=0; i < n; ++i)
+      a[i]=b[i]+s*c[i];
+    double t=totalseconds()-start;
+    if(t > 0.0) best=std::max(best,3.0*sizeof(double)*n/t);
+  }
+  if(a[n-1] != 7.0) std::cerr << "STREAM triad failed" << std::endl;
+
+  Array::deleteAlign(c,n);
+  Array::deleteAlign(b,n);
+  Array::deleteAlign(a,n);
+  return bandwidth=1e-9*best;
+}
+
+// Return the peak floating-point rate in GFLOP/s, measured with
+// independent multiply-add chains that fit in the L1 cache.
+inline double peakFlops()
+{
+  static double peak=0.0;
+  if(peak > 0.0) return peak;
+
+  const char *env=getenv("FFTWPP_PEAK");
+  if(env && *env) return peak=atof(env);
+
+  unsigned int threads=fftwpp::fftw::maxthreads;
+  const unsigned int n=64;
+  const unsigned int repeat=100000;
+  double best=0.0;
+  double check=0.0;
+  for(unsigned int k=0; k < 3; ++k) {
+    double start=totalseconds();
+#ifndef FFTWPP_SINGLE_THREAD
+#pragma omp parallel num_threads(threads) reduction(+:check)
+#endif
+    {
+      double x[n];
+      for(unsigned int i=0; i < n; ++i)
+        x[i]=i;
+      const double a=0.999999;
+      const double b=1e-6;
+      for(unsigned int r=0; r < repeat; ++r)
+        for(unsigned int i=0; i < n; ++i)
+          x[i]=x[i]*a+b;
+      for(unsigned int i=0; i < n; ++i)
+        check += x[i];
+    }
+    double t=totalseconds()-start;
+    if(t > 0.0) best=std::max(best,2.0*n*repeat*threads/t);
+  }
+  if(check < 0.0) std::cerr << "peak test failed" << std::endl;
+
+  return peak=1e-9*best;
+}
+
+// Return the size in bytes of the last-level cache.
+inline double cacheSize()
+{
+  const char *env=getenv("FFTWPP_CACHE");
+  if(env && *env) return atof(env);
+  long size=0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  size=sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  if(size <= 0) size=sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+  return size > 0 ? size : 8388608.0;
+}
+
+// Operation and memory-traffic model of one timed operation.
+class rooflineModel {
+public:
+  unsigned int dimensions;
+  double factor;     // Padded size per dimension in units of m
+  bool real;         // Real-data transforms
+  double transforms; // Number of transforms of the padded data
+  double extra;      // Additional operations per padded point
+
+  rooflineModel(unsigned int dimensions, double factor, bool real,
+                double transforms, double extra=0.0) :
+    dimensions(dimensions), factor(factor), real(real),
+    transforms(transforms), extra(extra) {}
+
+  // Number of padded points for size m in each dimension.
+  double points(double m) const {
+    return pow(factor*m,(double) dimensions);
+  }
+
+  // Operation count per transformed point per log2 of the size.
+  double coefficient() const {return real ? 2.5 : 5.0;}
+
+  // Size in bytes of one transformed point.
+  double pointsize() const {return (real ? 1.0 : 2.0)*sizeof(double);}
+
+  double flops(double N) const {
+    return N > 1.0 ?
+      transforms*coefficient()*N*log2(N)+extra*N : extra*N;
+  }
+
+  // Bytes read and written if each transform makes a single pass.
+  double bytes(double N) const {
+    return 2.0*transforms*pointsize()*N;
+  }
+
+  // Bytes transferred to and from main memory.
+  double traffic(double N, double cache) const {
+    if(transforms*pointsize()*N <= cache) return 0.0;
+    double Z=cache/pointsize();
+    double passes=Z > 2.0 ? ceil(log2(N)/log2(Z)) : log2(N);
+    return passes*bytes(N);
+  }
+
+  bool memoryBound(double N, double cache, double balance) const {
+    double t=traffic(N,cache);
+    return t > 0.0 && flops(N) < balance*t;
+  }
+
+  // Return the smallest size m at which the operation is memory-bound,
+  // or 0 if there is none below 1e9.
+  double crossover(double cache, double balance) const {
+    for(double m=1.0; m < 1e9; m *= 1.0905077) // 2^(1/8)
+      if(memoryBound(points(m),cache,balance)) return floor(m);
+    return 0.0;
+  }
+};
+
+// Complex FFTs and real-to-complex FFTs, timed per transform.
+inline rooflineModel fftModel(unsigned int dimensions, bool real=false)
+{
+  return rooflineModel(dimensions,1.0,real,1.0);
+}
+
+// Implicitly dealiased complex convolutions with A inputs and B outputs.
+inline rooflineModel cconvModel(unsigned int dimensions, unsigned int A=2,
+                                unsigned int B=1)
+{
+  return rooflineModel(dimensions,2.0,false,A+B,3.0*A);
+}
+
+// Implicitly dealiased Hermitian convolutions.
+inline rooflineModel convModel(unsigned int dimensions, unsigned int A=2,
+                               unsigned int B=1)
+{
+  return rooflineModel(dimensions,3.0,true,A+B,0.5*A);
+}
+
+// Implicitly dealiased Hermitian ternary convolutions.
+inline rooflineModel tconvModel(unsigned int dimensions, unsigned int A=3,
+                                unsigned int B=1)
+{
+  return rooflineModel(dimensions,4.0,true,A+B,2.0*A/3.0);
+}
+
+// Print the roofline report of an operation of size mx*my*mz that took
+// the given number of seconds.
+inline void roofline(const rooflineModel& model, double seconds,
+                     unsigned int mx, unsigned int my=1, unsigned int mz=1)
+{
+  if(!rooflineMode() || seconds <= 0.0) return;
+
+  unsigned int m[]={mx,my,mz};
+  double N=1.0;
+  for(unsigned int d=0; d < model.dimensions && d < 3; ++d)
+    N *= model.factor*m[d];
+
+  double gflops=1e-9*model.flops(N)/seconds;
+  double gbps=1e-9*model.bytes(N)/seconds;
+
+  double peak=peakFlops();
+  double stream=streamBandwidth();
+  double balance=peak/stream;
+  double cache=cacheSize();
+  double traffic=model.traffic(N,cache);
+  double crossover=model.crossover(cache,balance);
+
+  std::cout << "roofline: " << gflops << " GFLOP/s ("
+            << 100.0*gflops/peak << "% of " << peak << " peak), "
+            << gbps << " GB/s (" << 100.0*gbps/stream << "% of " << stream
+            << " STREAM)" << std::endl << "intensity=";
+  if(traffic > 0.0) std::cout << model.flops(N)/traffic << " flops/byte, ";
+  else std::cout << "in cache, ";
+  std::cout << (model.memoryBound(N,cache,balance) ? "memory" : "compute")
+            << "-bound (ridge=" << balance << " flops/byte; ";
+  if(crossover > 0.0)
+    std::cout << "memory-bound for m >= " << (unsigned long) crossover << ")"
+              << std::endl;
+  else
+    std::cout << "no crossover for m < 1e9)" << std::endl;
+}
+
+}
+
+#endif
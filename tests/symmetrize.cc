@@ -0,0 +1,152 @@
+#include "convolution.h"
+#include "Array.h"
+#include "utils.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int mx=4;
+unsigned int my=4;
+unsigned int mz=4;
+
+inline void init(Complex *f, unsigned int n)
+{
+  for(unsigned int i=0; i < n; ++i)
+    f[i]=Complex(i,2.0*i+1.0);
+}
+
+// Reference 3D Hermitian symmetrization of the z=0 plane of the
+// (2mx-1)*(2my-1)*mz array f.
+void SymmetrizeXY(array3<Complex>& f)
+{
+  unsigned int xorigin=mx-1;
+  unsigned int yorigin=my-1;
+  f[xorigin][yorigin][0].im=0.0;
+  for(unsigned int i=1; i < mx; ++i)
+    f[xorigin-i][yorigin][0]=conj(f[xorigin+i][yorigin][0]);
+  for(unsigned int i=0; i < 2*mx-1; ++i)
+    for(unsigned int j=1; j < my; ++j)
+      f[2*xorigin-i][yorigin-j][0]=conj(f[i][yorigin+j][0]);
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  int stats=0; // Type of statistics used in timing test.
+
+  unsigned int dimension=3;
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hd:N:m:x:y:z:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'd':
+        dimension=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usageCommon(3);
+        std::cerr << "-d\t\t dimension (2 or 3)" << std::endl;
+        exit(1);
+    }
+  }
+
+  if(dimension != 2 && dimension != 3) {
+    cerr << "dimension=" << dimension << " is not implemented" << endl;
+    exit(1);
+  }
+
+  if(dimension == 2) mz=1;
+
+  cout << "mx=" << mx << ", my=" << my << ", mz=" << mz << endl;
+  cout << "threads=" << fftw::maxthreads << endl;
+
+  unsigned int nx=2*mx-1;
+  unsigned int ny=dimension == 2 ? my : 2*my-1;
+  unsigned int n=nx*ny*mz;
+  size_t align=sizeof(Complex);
+
+  array3<Complex> f(nx,ny,mz,align);
+
+  if(N == 0) {
+    unsigned int n3=nx*(2*my-1)*mz;
+    array3<Complex> g(nx,2*my-1,mz,align);
+    array3<Complex> h(nx,2*my-1,mz,align);
+    init(g(),n3);
+    init(h(),n3);
+    if(dimension == 2) {
+      // The 2D y=0 column is the 3D (y=0,z=0) line.
+      HermitianSymmetrizeX(mx,(2*my-1)*mz,mx-1,g()+(my-1)*mz,
+                           fftw::maxthreads);
+      h[mx-1][my-1][0].im=0.0;
+      for(unsigned int i=1; i < mx; ++i)
+        h[mx-1-i][my-1][0]=conj(h[mx-1+i][my-1][0]);
+    } else {
+      HermitianSymmetrizeXY(mx,my,mz,mx-1,my-1,g(),fftw::maxthreads);
+      SymmetrizeXY(h);
+    }
+
+    double errmax=0.0;
+    for(unsigned int i=0; i < n3; ++i)
+      errmax=max(errmax,abs(g(i)-h(i)));
+    cout << "errmax: " << errmax << endl;
+    if(errmax > 0.0) {
+      cout << "Caution: error too large!" << endl;
+      return 1;
+    }
+  } else {
+    double *T=new double[N];
+
+    for(unsigned int i=0; i < N; ++i) {
+      init(f(),n);
+      seconds();
+      if(dimension == 2)
+        HermitianSymmetrizeX(mx,my,mx-1,f(),fftw::maxthreads);
+      else
+        HermitianSymmetrizeXY(mx,my,mz,mx-1,my-1,f(),fftw::maxthreads);
+      T[i]=seconds();
+    }
+
+    timings(dimension == 2 ? "HermitianSymmetrizeX" :
+            "HermitianSymmetrizeXY",mx,T,N,stats);
+    delete [] T;
+  }
+
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 #include "Array.h"
 
 using namespace std;
@@ -39,6 +40,21 @@ inline void init(Complex *e, Complex *f, Complex *g, unsigned int M=1)
   }
 }
 
+// Ternary multiply for the multiplier interface of the explicit
+// convolution.
+// NB: example function, not optimised or threaded.
+void multternary(double **F, unsigned int m,
+                 const unsigned int indexsize,
+                 const unsigned int *index,
+                 unsigned int r, unsigned int threads)
+{
+  double *F0=F[0];
+  double *F1=F[1];
+  double *F2=F[2];
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= F1[j]*F2[j];
+}
+
 int main(int argc, char* argv[])
 {
   fftw::maxthreads=get_max_threads();
@@ -113,7 +129,10 @@ int main(int argc, char* argv[])
   cout << "N=" << N << endl;
   
   Complex *h0=NULL;
-  if(Direct && ! Explicit) h0=ComplexAlign(m);
+  // The explicit convolution is checked both directly and through its
+  // multiplier interface.
+  unsigned int checks=Explicit ? 2 : 1;
+  if(Direct) h0=ComplexAlign(checks*m);
 
   unsigned int m1=m+1;
   unsigned int np=Explicit ? n/2+1 : m1;
@@ -151,6 +170,7 @@ int main(int argc, char* argv[])
     }
     
     timings("Implicit",m,T,N,stats);
+    roofline(tconvModel(1,3*M,B),mean(T,N,stats),m);
 
     if(Direct) for(unsigned int i=0; i < m; i++) h0[i]=e[i];
 
@@ -177,6 +197,14 @@ int main(int argc, char* argv[])
     if(m < 100) 
       for(unsigned int i=0; i < m; i++) cout << e[i] << endl;
     else cout << e[0] << endl;
+
+    if(Direct) {
+      for(unsigned int i=0; i < m; i++) h0[i]=e[i];
+      init(e,f,g);
+      Complex *F[]={e,f,g};
+      C.convolve(F,multternary);
+      for(unsigned int i=0; i < m; i++) h0[m+i]=e[i];
+    }
   }
   
   if(Direct) {
@@ -193,13 +221,15 @@ int main(int argc, char* argv[])
       for(unsigned int i=0; i < m; i++) cout << h[i] << endl;
     else cout << h[0] << endl;
 
-    if(Implicit) { // compare implicit or explicit version with direct verion:
+    { // compare implicit or explicit version with direct verion:
       double error=0.0;
       cout << endl;
       double norm=0.0;
-      for(unsigned long long k=0; k < m; k++) {
-        error += abs2(h0[k]-h[k]);
-        norm += abs2(h[k]);
+      for(unsigned int c=0; c < checks; ++c) {
+        for(unsigned long long k=0; k < m; k++) {
+          error += abs2(h0[c*m+k]-h[k]);
+          norm += abs2(h[k]);
+        }
       }
       if(norm > 0) error=sqrt(error/norm);
       cout << "error=" << error << endl;
@@ -207,6 +237,7 @@ int main(int argc, char* argv[])
     }
 
     deleteAlign(h);
+    deleteAlign(h0);
   }
 
   deleteAlign(g);
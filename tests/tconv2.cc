@@ -2,6 +2,7 @@
 #include "explicit.h"
 #include "direct.h"
 #include "utils.h"
+#include "roofline.h"
 #include "Array.h"
 
 using namespace std;
@@ -50,6 +51,21 @@ inline void init(Array2<Complex>& e, Array2<Complex>& f, Array2<Complex>& g,
   }
 }
 
+// Ternary multiply for the multiplier interface of the explicit
+// convolution.
+// NB: example function, not optimised or threaded.
+void multternary(double **F, unsigned int m,
+                 const unsigned int indexsize,
+                 const unsigned int *index,
+                 unsigned int r, unsigned int threads)
+{
+  double *F0=F[0];
+  double *F1=F[1];
+  double *F2=F[2];
+  for(unsigned int j=0; j < m; ++j)
+    F0[j] *= F1[j]*F2[j];
+}
+
 int main(int argc, char* argv[])
 {
   fftw::maxthreads=get_max_threads();
@@ -140,8 +156,11 @@ int main(int argc, char* argv[])
   }
     
   size_t align=sizeof(Complex);
+  // The explicit convolution is checked both directly and through its
+  // multiplier interface, as is the binary class with a ternary multiplier.
+  unsigned int checks=Explicit ? 3 : 1;
   array2<Complex> h0;
-  if(Direct) h0.Allocate(mx,my,align);
+  if(Direct) h0.Allocate(checks*mx,my,align);
   nxp=Explicit ? nx : (Implicit ? 2*mx : 2*mx-1);
   nyp=Explicit ? ny/2+1 : (Implicit ? my+1 : my);
   unsigned int nxp0=Implicit ? nxp*M : nxp;
@@ -174,6 +193,7 @@ int main(int argc, char* argv[])
     }
     
     timings("Implicit",mx,T,N,stats);
+    roofline(tconvModel(2,3*M,B),mean(T,N,stats),mx,my);
     
     if(Direct) {
       for(unsigned int i=0; i < mx; i++) 
@@ -205,12 +225,6 @@ int main(int argc, char* argv[])
     
     timings(Pruned ? "Pruned" : "Explicit",mx,T,N,stats);
 
-    if(Direct) {
-      for(unsigned int i=0; i < mx; i++) 
-        for(unsigned int j=0; j < my; j++)
-          h0[i][j]=e[i][j];
-    }
-
     unsigned int offset=nx/2-mx+1;
     if(2*(mx-1)*my < outlimit) 
       for(unsigned int i=offset; i < offset+2*mx-1; i++) {
@@ -218,6 +232,24 @@ int main(int argc, char* argv[])
           cout << e[i][j] << "\t";
         cout << endl;
       } else cout << e[offset][0] << endl;
+
+    if(Direct) {
+      for(unsigned int i=0; i < mx; i++) 
+        for(unsigned int j=0; j < my; j++)
+          h0[i][j]=e[offset+i][j];
+      init(e,f,g);
+      Complex *F[]={e,f,g};
+      C.convolve(F,multternary);
+      for(unsigned int i=0; i < mx; i++) 
+        for(unsigned int j=0; j < my; j++)
+          h0[mx+i][j]=e[offset+i][j];
+      ExplicitHConvolution2 H(nx,ny,mx,my,f,1,Pruned,3,1);
+      init(e,f,g);
+      H.convolve(F,multternary);
+      for(unsigned int i=0; i < mx; i++) 
+        for(unsigned int j=0; j < my; j++)
+          h0[2*mx+i][j]=e[offset+i][j];
+    }
   }
   
   if(Direct) {
@@ -242,14 +274,16 @@ int main(int argc, char* argv[])
         cout << endl;
       } else cout << h[0][0] << endl;
 
-    if(Implicit) { // compare implicit version with direct verion:
+    { // compare implicit or explicit version with direct verion:
       double error=0.0;
       cout << endl;
       double norm=0.0;
-      for(unsigned int i=0; i < mx; i++) {
-        for(unsigned int j=0; j < my; j++) {
-          error += abs2(h0[i][j]-h[i][j]);
-          norm += abs2(h[i][j]);
+      for(unsigned int c=0; c < checks; ++c) {
+        for(unsigned int i=0; i < mx; i++) {
+          for(unsigned int j=0; j < my; j++) {
+            error += abs2(h0[c*mx+i][j]-h[i][j]);
+            norm += abs2(h[i][j]);
+          }
         }
       }
       if(norm > 0) error=sqrt(error/norm);
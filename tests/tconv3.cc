@@ -0,0 +1,244 @@
+#include "convolution.h"
+#include "explicit.h"
+#include "direct.h"
+#include "utils.h"
+#include "roofline.h"
+#include "Array.h"
+
+using namespace std;
+using namespace utils;
+using namespace Array;
+using namespace fftwpp;
+
+// Number of iterations.
+unsigned int N0=10000000;
+unsigned int N=0;
+unsigned int mx=4;
+unsigned int my=4;
+unsigned int mz=4;
+unsigned int M=1;
+unsigned int B=1; // Number of independent outputs
+
+bool Direct=false, Implicit=true;
+
+unsigned int outlimit=300;
+
+inline void init(Complex **E, Complex **F, Complex **G, unsigned int nxp,
+                 unsigned int nyp, unsigned int nzp, int offset,
+                 unsigned int M=1)
+{
+  unsigned int xstop=2*mx-1;
+  unsigned int ystop=2*my-1;
+  double factor=1.0/cbrt((double) M);
+  for(unsigned int s=0; s < M; ++s) {
+    double S=sqrt(1.0+s);
+    double efactor=1.0/S*factor;
+    double ffactor=(1.0+S)*S*factor;
+    double gfactor=1.0/(1.0+S)*factor;
+    Array3<Complex> e(nxp,nyp,nzp,E[s],offset,offset,0);
+    Array3<Complex> f(nxp,nyp,nzp,F[s],offset,offset,0);
+    Array3<Complex> g(nxp,nyp,nzp,G[s],offset,offset,0);
+#pragma omp parallel for
+    for(unsigned int i=0; i < xstop; i++) {
+      for(unsigned int j=0; j < ystop; j++) {
+        for(unsigned int k=0; k < mz; k++) {
+          e[i][j][k]=efactor*Complex(i+k,j);
+          f[i][j][k]=ffactor*Complex(i+1,j+2+k);
+          g[i][j][k]=gfactor*Complex(2*i,j+1-k);
+        }
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  fftw::maxthreads=get_max_threads();
+
+  int stats=0; // Type of statistics used in timing test.
+
+#ifndef __SSE2__
+  fftw::effort |= FFTW_NO_SIMD;
+#endif
+
+#ifdef __GNUC__
+  optind=0;
+#endif
+  for (;;) {
+    int c = getopt(argc,argv,"hdiA:B:N:m:x:y:z:n:T:S:");
+    if (c == -1) break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'd':
+        Direct=true;
+        break;
+      case 'i':
+        Implicit=true;
+        break;
+      case 'A':
+        M=2*atoi(optarg);
+        break;
+      case 'B':
+        B=atoi(optarg);
+        break;
+      case 'N':
+        N=atoi(optarg);
+        break;
+      case 'm':
+        mx=my=mz=atoi(optarg);
+        break;
+      case 'x':
+        mx=atoi(optarg);
+        break;
+      case 'y':
+        my=atoi(optarg);
+        break;
+      case 'z':
+        mz=atoi(optarg);
+        break;
+      case 'n':
+        N0=atoi(optarg);
+        break;
+      case 'T':
+        fftw::maxthreads=max(atoi(optarg),1);
+        break;
+      case 'S':
+        stats=atoi(optarg);
+        break;
+      case 'h':
+      default:
+        usage(3);
+        exit(1);
+    }
+  }
+
+  cout << "mx=" << mx << ", my=" << my << ", mz=" << mz << endl;
+
+  if(N == 0) {
+    N=N0/(2*mx)/(2*my)/(2*mz);
+    N = max(N, 20);
+  }
+  cout << "N=" << N << endl;
+
+  if(B != 1) {
+    cerr << "B=" << B << " is not yet implemented" << endl;
+    exit(1);
+  }
+
+  size_t align=sizeof(Complex);
+  unsigned int nxd=2*mx-1;
+  unsigned int nyd=2*my-1;
+  array3<Complex> h0;
+  if(Direct) h0.Allocate(nxd,nyd,mz,align);
+
+  double *T=new double[N];
+
+  if(Implicit) {
+    unsigned int nxp=2*mx;
+    unsigned int nyp=2*my;
+    unsigned int nzp=mz+1;
+    unsigned int mf=nxp*nyp*nzp;
+    Complex *e=ComplexAlign(M*mf);
+    Complex *f=ComplexAlign(M*mf);
+    Complex *g=ComplexAlign(M*mf);
+
+    ImplicitHTConvolution3 C(mx,my,mz,M);
+    cout << "Using " << C.Threads() << " threads."<< endl;
+    Complex **E=new Complex *[M];
+    Complex **F=new Complex *[M];
+    Complex **G=new Complex *[M];
+    for(unsigned int s=0; s < M; ++s) {
+      unsigned int smf=s*mf;
+      E[s]=e+smf;
+      F[s]=f+smf;
+      G[s]=g+smf;
+    }
+    for(unsigned int i=0; i < N; ++i) {
+      init(E,F,G,nxp,nyp,nzp,-1,M);
+      seconds();
+      C.convolve(E,F,G);
+      T[i]=seconds();
+    }
+
+    timings("Implicit",mx,T,N,stats);
+    roofline(tconvModel(3,3*M,B),mean(T,N,stats),mx,my,mz);
+
+    Array3<Complex> e0(nxp,nyp,nzp,e,-1,-1,0);
+    if(Direct) {
+      for(unsigned int i=0; i < nxd; i++)
+        for(unsigned int j=0; j < nyd; j++)
+          for(unsigned int k=0; k < mz; k++)
+            h0[i][j][k]=e0[i][j][k];
+    }
+
+    if(nxd*nyd*mz < outlimit) {
+      for(unsigned int i=0; i < nxd; i++) {
+        for(unsigned int j=0; j < nyd; j++) {
+          for(unsigned int k=0; k < mz; k++)
+            cout << e0[i][j][k] << "\t";
+          cout << endl;
+        }
+        cout << endl;
+      }
+    } else cout << e0[0][0][0] << endl;
+    cout << endl;
+
+    delete [] G;
+    delete [] F;
+    delete [] E;
+    deleteAlign(g);
+    deleteAlign(f);
+    deleteAlign(e);
+  }
+
+  if(Direct) {
+    Array3<Complex> h(nxd,nyd,mz,0,0,0,align);
+    Array3<Complex> e(nxd,nyd,mz,0,0,0,align);
+    Array3<Complex> f(nxd,nyd,mz,0,0,0,align);
+    Array3<Complex> g(nxd,nyd,mz,0,0,0,align);
+    Complex *E[]={e};
+    Complex *F[]={f};
+    Complex *G[]={g};
+    DirectHTConvolution3 C(mx,my,mz);
+    init(E,F,G,nxd,nyd,mz,0);
+    seconds();
+    C.convolve(h,e,f,g);
+    T[0]=seconds();
+
+    timings("Direct",mx,T,1);
+
+    if(nxd*nyd*mz < outlimit) {
+      for(unsigned int i=0; i < nxd; i++) {
+        for(unsigned int j=0; j < nyd; j++) {
+          for(unsigned int k=0; k < mz; k++)
+            cout << h[i][j][k] << "\t";
+          cout << endl;
+        }
+        cout << endl;
+      }
+    } else cout << h[0][0][0] << endl;
+
+    if(Implicit) { // compare implicit version with direct verion:
+      double error=0.0;
+      cout << endl;
+      double norm=0.0;
+      for(unsigned int i=0; i < nxd; i++) {
+        for(unsigned int j=0; j < nyd; j++) {
+          for(unsigned int k=0; k < mz; k++) {
+            error += abs2(h0[i][j][k]-h[i][j][k]);
+            norm += abs2(h[i][j][k]);
+          }
+        }
+      }
+      if(norm > 0) error=sqrt(error/norm);
+      cout << "error=" << error << endl;
+      if (error > 1e-12) cerr << "Caution! error=" << error << endl;
+    }
+  }
+
+  delete [] T;
+
+  return 0;
+}
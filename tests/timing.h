@@ -7,6 +7,8 @@
 #include <iostream>
 #include <fstream>
 
+#include "benchmark.h"
+
 /*
   inline double emptytime(double *T, unsigned int N)
   {
@@ -164,7 +166,8 @@ inline void stdev(double *T, unsigned int N, double mean,
 }
 
 inline void timings(const char* text, unsigned int m, unsigned int count,
-                    double mean, double sigmaL, double sigmaH)
+                    double mean, double sigmaL, double sigmaH,
+                    int algorithm=MEAN)
 {
 //  mean -= emptytime(T,N);
 //  if(mean < 0.0) mean=0.0;
@@ -174,6 +177,7 @@ inline void timings(const char* text, unsigned int m, unsigned int count,
             << sigmaL << "\t" 
             << sigmaH 
             << std::endl;
+  utils::benchmarkRecord(text,m,count,mean,sigmaL,sigmaH,algorithm);
 }
 
 inline void timings(const char* text, unsigned int m, double *T, 
@@ -192,7 +196,7 @@ inline void timings(const char* text, unsigned int m, double *T,
 
   double avg=mean(T,N,algorithm);
   stdev(T,N,avg,sigmaL,sigmaH,algorithm);
-  timings(text,m,N,avg,sigmaL,sigmaH);
+  timings(text,m,N,avg,sigmaL,sigmaH,algorithm);
 }
 
 #endif
@@ -86,6 +86,11 @@ inline void usageCompact(unsigned int n)
     std::cerr << "-Z\t\t z Hermitian padding (0 or 1)" << std::endl;
 }
 
+inline void usageSymmetry()
+{
+  std::cerr << "-H\t\t implicit Hermitian symmetry" << std::endl;
+}
+
 inline void usageb()
 {
   std::cerr << "-b\t\t which output block to check" << std::endl;
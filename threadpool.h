@@ -0,0 +1,605 @@
+/* Persistent thread pool for FFTW++
+   Copyright (C) 2016 John C. Bowman and Malcolm Roberts, Univ. of Alberta
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#ifndef __threadpool_h__
+#define __threadpool_h__ 1
+
+// This header is included by fftw++.h.
+//
+// parallel(n,body,threads) calls body(i,thread) for i=0,...,n-1, where
+// thread < threads identifies the calling thread (for indexing per-thread
+// work arrays). By default the loop is an OpenMP parallel for. When
+// compiled with -DFFTWPP_THREADPOOL (and linked with -lpthread), the loop
+// is instead split into threads contiguous blocks that are run by a
+// persistent pool of POSIX threads; FFTW's own parallel loops are
+// dispatched to the same pool if FFTW is version 3.3.9 or later (this is
+// checked when the first plan is created). The pool does not require
+// OpenMP. The loops of the convolutions, including the built-in
+// multipliers, go through parallel() and so also run on the pool; only
+// the PARALLEL loops of the MPI layer (and of user code) are then run
+// serially by the caller, rather than starting OpenMP threads that compete
+// with the spinning workers.
+//
+// Idle workers spin for ThreadPool::spin iterations before sleeping, so
+// that closely spaced parallel loops avoid the cost of waking them up. On
+// Linux, worker t is bound to core t+1 of those in the affinity mask that
+// the process inherited (for example, from taskset or an MPI launcher),
+// modulo their number. The environment variables FFTWPP_SPIN and
+// FFTWPP_BIND (0 or 1) override these defaults. If the pool is already
+// busy (for example, in a nested call or a call from another thread), the
+// loop is run serially by the caller. Each worker uses its own pool for
+// any nested parallel loops, including those of FFTW.
+//
+// A ThreadGroup of T threads runs asynchronous requests, one at a time and
+// in the order submitted, on its own driver thread; with the thread pool,
+// the parallel loops of each request run on a private pool of T-1 further
+// workers. Several groups (bound to disjoint ranges of T cores with the
+// optional argument first) can thus execute independent transforms and
+// convolutions concurrently. Without the thread pool, the driver is bound
+// to the whole range, so that the OpenMP threads it starts may use each of
+// the T cores:
+//
+//   ThreadGroup group(4);
+//   ImplicitConvolution2 C(mx,my,2,1,group.Threads());
+//   Request request=iconvolve(group,C,f,g);
+//   ... // Overlap other work.
+//   request.wait(); // f now contains the convolution of f and g.
+//
+// A request is released by wait() or, at the latest, by the destructor of
+// the handle that owns it. Without multithreading support, requests are
+// executed immediately.
+
+#if !defined FFTWPP_SINGLE_THREAD || defined FFTWPP_THREADPOOL
+#define FFTWPP_THREADS 1
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#ifdef FFTWPP_THREADS
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+#ifdef FFTWPP_THREADPOOL
+// fftw_threads_set_callback first appeared in FFTW 3.3.9. Where possible,
+// it is referenced weakly, so that older libraries still link.
+extern "C" void fftw_threads_set_callback(void (*)(void *(*)(char *), char *,
+                                                   size_t, int, void *),
+                                          void *);
+#if defined(__GNUC__) && defined(__ELF__)
+#pragma weak fftw_threads_set_callback
+#endif
+#endif
+
+namespace fftwpp {
+
+#ifdef FFTWPP_THREADS
+// Return whether threads should be bound to cores.
+inline bool bindThreads()
+{
+  const char *env=getenv("FFTWPP_BIND");
+  return !(env && *env) || atoi(env) != 0;
+}
+
+// The cores in the affinity mask of the thread that first calls
+// Cores::get() (before any thread is bound).
+class Cores {
+  static std::vector<unsigned int>& list() {
+    static std::vector<unsigned int> cores;
+    return cores;
+  }
+
+  static void init() {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0,sizeof(set),&set) == 0) {
+      for(unsigned int c=0; c < CPU_SETSIZE; ++c)
+        if(CPU_ISSET(c,&set)) list().push_back(c);
+    }
+#endif
+    if(list().empty()) list().push_back(0);
+  }
+public:
+  static const std::vector<unsigned int>& get() {
+    static pthread_once_t once=PTHREAD_ONCE_INIT;
+    pthread_once(&once,init);
+    return list();
+  }
+};
+
+// Bind the calling thread to the count cores first,...,first+count-1 of
+// Cores::get(), modulo their number.
+inline void bindThread(unsigned int first, unsigned int count=1)
+{
+#ifdef __linux__
+  const std::vector<unsigned int>& cores=Cores::get();
+  unsigned int n=cores.size();
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for(unsigned int i=0; i < std::min(count,n); ++i)
+    CPU_SET(cores[(first+i) % n],&set);
+  pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+#endif
+}
+#endif
+
+#ifdef FFTWPP_THREADPOOL
+
+class ThreadPool {
+public:
+  // A task is called once by each of the threads participating in a job.
+  typedef void Task(void *data, unsigned int thread, unsigned int threads);
+
+  unsigned int spin;  // Number of polls before an idle worker sleeps
+  bool bind;          // Bind worker t to core first+t+1
+  unsigned int first; // Core of the calling thread
+
+private:
+  struct Worker {
+    ThreadPool *pool;
+    unsigned int index;
+    pthread_t id;
+    volatile unsigned int ready; // Number of jobs assigned to this worker
+  };
+
+  std::vector<Worker *> workers; // Worker t runs block t+1 of each job
+  pthread_mutex_t busy;  // Held by the caller for the duration of a job
+  pthread_mutex_t mutex; // Protects sleeping workers
+  pthread_cond_t wake;
+
+  Task *task;
+  void *data;
+  unsigned int active;            // Number of threads in the current job
+  volatile unsigned int pending;  // Number of workers still running
+  volatile unsigned int sleeping; // Number of workers waiting on wake
+  volatile bool quit;
+
+  static inline void pause() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __asm__ __volatile__("pause");
+#endif
+  }
+
+  static void *main(void *arg) {
+    Worker *w=(Worker *) arg;
+    ThreadPool *pool=w->pool;
+    if(pool->bind) bindThread(pool->first+w->index+1);
+    pool->assign();
+    unsigned int done=0;
+    for(;;) {
+      for(unsigned int k=0; w->ready == done && k < pool->spin; ++k)
+        pause();
+      if(w->ready == done) {
+        pthread_mutex_lock(&pool->mutex);
+        __sync_fetch_and_add(&pool->sleeping,1);
+        while(w->ready == done)
+          pthread_cond_wait(&pool->wake,&pool->mutex);
+        __sync_fetch_and_sub(&pool->sleeping,1);
+        pthread_mutex_unlock(&pool->mutex);
+      }
+      done=w->ready;
+      __sync_synchronize();
+      if(pool->quit) break;
+      pool->task(pool->data,w->index+1,pool->active);
+      __sync_fetch_and_sub(&pool->pending,1);
+    }
+    return NULL;
+  }
+
+  // Assign a job to workers 0,...,n-1, waking them if they are asleep.
+  void signal(unsigned int n) {
+    for(unsigned int t=0; t < n; ++t)
+      __sync_fetch_and_add(&workers[t]->ready,1);
+    if(__sync_fetch_and_add(&sleeping,0)) {
+      pthread_mutex_lock(&mutex);
+      pthread_cond_broadcast(&wake);
+      pthread_mutex_unlock(&mutex);
+    }
+  }
+
+  // Ensure that at least n workers exist.
+  void grow(unsigned int n) {
+    while(workers.size() < n) {
+      Worker *w=new Worker;
+      w->pool=this;
+      w->index=workers.size();
+      w->ready=0;
+      if(pthread_create(&w->id,NULL,main,w) != 0) {
+        std::cerr << "Cannot create thread pool worker" << std::endl;
+        exit(1);
+      }
+      workers.push_back(w);
+    }
+  }
+
+  static pthread_key_t& key() {
+    static pthread_key_t k;
+    return k;
+  }
+
+  static void makeKey() {
+    pthread_key_create(&key(),NULL);
+  }
+
+public:
+  ThreadPool(unsigned int first=0) :
+    spin(100000), bind(bindThreads()), first(first), task(NULL), data(NULL),
+    active(0), pending(0), sleeping(0), quit(false) {
+    const char *env=getenv("FFTWPP_SPIN");
+    if(env && *env) spin=atoi(env);
+    if(bind) Cores::get();
+    pthread_mutex_init(&busy,NULL);
+    pthread_mutex_init(&mutex,NULL);
+    pthread_cond_init(&wake,NULL);
+  }
+
+  ~ThreadPool() {
+    quit=true;
+    __sync_synchronize();
+    signal(workers.size());
+    for(unsigned int t=0; t < workers.size(); ++t) {
+      pthread_join(workers[t]->id,NULL);
+      delete workers[t];
+    }
+    pthread_cond_destroy(&wake);
+    pthread_mutex_destroy(&mutex);
+    pthread_mutex_destroy(&busy);
+  }
+
+  unsigned int size() {return workers.size()+1;}
+
+  // Return the pool assigned to the calling thread, or NULL.
+  static ThreadPool *current() {
+    static pthread_once_t once=PTHREAD_ONCE_INIT;
+    pthread_once(&once,makeKey);
+    return (ThreadPool *) pthread_getspecific(key());
+  }
+
+  // Use this pool for the parallel loops of the calling thread.
+  void assign() {
+    current();
+    pthread_setspecific(key(),this);
+  }
+
+  // Call task(data,t,threads) for t=0,...,threads-1 concurrently; the
+  // caller runs t=0.
+  void run(Task *task, void *data, unsigned int threads) {
+    if(threads <= 1 || pthread_mutex_trylock(&busy) != 0) {
+      for(unsigned int t=0; t < threads; ++t)
+        task(data,t,threads);
+      return;
+    }
+    grow(threads-1);
+    this->task=task;
+    this->data=data;
+    active=threads;
+    pending=threads-1;
+    __sync_synchronize();
+    signal(threads-1);
+    task(data,0,threads);
+    while(pending)
+      pause();
+    __sync_synchronize();
+    pthread_mutex_unlock(&busy);
+  }
+};
+
+// Return the thread pool of the calling thread (by default, the global
+// thread pool).
+inline ThreadPool& threadpool()
+{
+  ThreadPool *pool=ThreadPool::current();
+  if(pool) return *pool;
+  static ThreadPool global;
+  return global;
+}
+
+// Run block thread of the n iterations of a parallel loop.
+template<class T>
+struct ParallelLoop {
+  const T *body;
+  unsigned int n;
+
+  static void task(void *data, unsigned int thread, unsigned int threads) {
+    ParallelLoop *L=(ParallelLoop *) data;
+    unsigned int start=(size_t) L->n*thread/threads;
+    unsigned int stop=(size_t) L->n*(thread+1)/threads;
+    for(unsigned int i=start; i < stop; ++i)
+      (*L->body)(i,thread);
+  }
+};
+
+// A parallel loop of FFTW, one job per thread.
+struct FFTWLoop {
+  void *(*work)(char *);
+  char *jobdata;
+  size_t elsize;
+
+  static void task(void *data, unsigned int thread, unsigned int) {
+    FFTWLoop *L=(FFTWLoop *) data;
+    L->work(L->jobdata+L->elsize*thread);
+  }
+};
+
+extern "C" inline void fftwThreadPool(void *(*work)(char *), char *jobdata,
+                                      size_t elsize, int njobs, void *)
+{
+  FFTWLoop L={work,jobdata,elsize};
+  threadpool().run(FFTWLoop::task,&L,njobs);
+}
+
+// Return whether the FFTW library provides fftw_threads_set_callback
+// (version 3.3.9 or later); otherwise FFTW runs its own threads.
+inline bool fftwCallback()
+{
+#if defined(__GNUC__) && defined(__ELF__)
+  if(!&fftw_threads_set_callback) return false;
+#endif
+  int major=0, minor=0, patch=0;
+  sscanf(fftw_version,"fftw-%d.%d.%d",&major,&minor,&patch);
+  return major > 3 || (major == 3 && (minor > 3 ||
+                                      (minor == 3 && patch >= 9)));
+}
+
+#endif
+
+// Call body(i,thread) for i=0,...,n-1 with up to the given number of
+// threads.
+template<class T>
+inline void parallel(unsigned int n, const T& body, unsigned int threads)
+{
+  if(threads > 1 && n > 1) {
+#ifdef FFTWPP_THREADPOOL
+    ParallelLoop<T> L={&body,n};
+    threadpool().run(ParallelLoop<T>::task,&L,std::min(threads,n));
+    return;
+#elif !defined FFTWPP_SINGLE_THREAD
+#pragma omp parallel for num_threads(threads)
+    for(unsigned int i=0; i < n; ++i)
+      body(i,get_thread_num());
+    return;
+#endif
+  }
+  for(unsigned int i=0; i < n; ++i)
+    body(i,0);
+}
+
+// An asynchronous request.
+class Job {
+public:
+  Job *next;
+#ifdef FFTWPP_THREADS
+  pthread_mutex_t mutex;
+  pthread_cond_t finished;
+#endif
+  bool done;
+
+  Job() : next(NULL), done(false) {
+#ifdef FFTWPP_THREADS
+    pthread_mutex_init(&mutex,NULL);
+    pthread_cond_init(&finished,NULL);
+#endif
+  }
+
+  virtual ~Job() {
+#ifdef FFTWPP_THREADS
+    pthread_cond_destroy(&finished);
+    pthread_mutex_destroy(&mutex);
+#endif
+  }
+
+  virtual void run()=0;
+
+  void complete() {
+#ifdef FFTWPP_THREADS
+    pthread_mutex_lock(&mutex);
+    done=true;
+    pthread_cond_signal(&finished);
+    pthread_mutex_unlock(&mutex);
+#else
+    done=true;
+#endif
+  }
+};
+
+// Handle of an asynchronous request. Like std::auto_ptr, copying or
+// assigning a Request transfers the job to the destination, so that only
+// one handle ever releases it; a pending request is waited on when its
+// handle is destroyed or assigned to.
+class Request {
+  mutable Job *job;
+public:
+  Request(Job *job=NULL) : job(job) {}
+
+  Request(const Request& r) : job(r.job) {r.job=NULL;}
+
+  Request& operator=(const Request& r) {
+    if(&r != this) {
+      wait();
+      job=r.job;
+      r.job=NULL;
+    }
+    return *this;
+  }
+
+  ~Request() {wait();}
+
+  // Return whether the request has completed.
+  bool test() {
+    if(!job) return true;
+#ifdef FFTWPP_THREADS
+    pthread_mutex_lock(&job->mutex);
+    bool done=job->done;
+    pthread_mutex_unlock(&job->mutex);
+    return done;
+#else
+    return job->done;
+#endif
+  }
+
+  // Wait for the request to complete and release it.
+  void wait() {
+    if(!job) return;
+#ifdef FFTWPP_THREADS
+    pthread_mutex_lock(&job->mutex);
+    while(!job->done)
+      pthread_cond_wait(&job->finished,&job->mutex);
+    pthread_mutex_unlock(&job->mutex);
+#endif
+    delete job;
+    job=NULL;
+  }
+};
+
+class ThreadGroup {
+  unsigned int threads;
+  unsigned int first;
+#ifdef FFTWPP_THREADPOOL
+  ThreadPool pool;
+#endif
+#ifdef FFTWPP_THREADS
+  pthread_t driver;
+  pthread_mutex_t mutex; // Protects the queue
+  pthread_cond_t wake;
+  Job *head,*tail;
+  bool quit;
+
+  static void *main(void *arg) {
+    ThreadGroup *group=(ThreadGroup *) arg;
+    if(bindThreads()) {
+#ifdef FFTWPP_THREADPOOL
+      bindThread(group->first);
+#else
+      bindThread(group->first,group->threads);
+#endif
+    }
+#ifdef FFTWPP_THREADPOOL
+    group->pool.assign();
+#endif
+    for(;;) {
+      pthread_mutex_lock(&group->mutex);
+      while(!group->head && !group->quit)
+        pthread_cond_wait(&group->wake,&group->mutex);
+      Job *job=group->head;
+      if(job) {
+        group->head=job->next;
+        if(!group->head) group->tail=NULL;
+      }
+      pthread_mutex_unlock(&group->mutex);
+      if(!job) break;
+      job->run();
+      job->complete();
+    }
+    return NULL;
+  }
+#endif
+
+public:
+  // Create a group of the given number of threads, bound (if enabled) to
+  // cores first,...,first+threads-1 of Cores::get().
+  ThreadGroup(unsigned int threads, unsigned int first=0) :
+    threads(std::max(threads,1U)), first(first)
+#ifdef FFTWPP_THREADPOOL
+    , pool(first)
+#endif
+  {
+#ifdef FFTWPP_THREADS
+    if(bindThreads()) Cores::get();
+    head=tail=NULL;
+    quit=false;
+    pthread_mutex_init(&mutex,NULL);
+    pthread_cond_init(&wake,NULL);
+    if(pthread_create(&driver,NULL,main,this) != 0) {
+      std::cerr << "Cannot create thread group" << std::endl;
+      exit(1);
+    }
+#endif
+  }
+
+  // Complete all submitted requests.
+  ~ThreadGroup() {
+#ifdef FFTWPP_THREADS
+    pthread_mutex_lock(&mutex);
+    quit=true;
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(driver,NULL);
+    pthread_cond_destroy(&wake);
+    pthread_mutex_destroy(&mutex);
+#endif
+  }
+
+  unsigned int Threads() {return threads;}
+
+  // Queue job (allocated with new) for execution.
+  Request submit(Job *job) {
+#ifdef FFTWPP_THREADS
+    pthread_mutex_lock(&mutex);
+    if(tail) tail->next=job;
+    else head=job;
+    tail=job;
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&mutex);
+#else
+    job->run();
+    job->complete();
+#endif
+    return Request(job);
+  }
+};
+
+template<class T>
+class ConvolutionJob : public Job {
+  T *C;
+  Complex *f,*g;
+public:
+  ConvolutionJob(T *C, Complex *f, Complex *g) : C(C), f(f), g(g) {}
+  void run() {C->convolve(f,g);}
+};
+
+template<class T>
+class FFTJob : public Job {
+  T *F;
+  Complex *in,*out;
+public:
+  FFTJob(T *F, Complex *in, Complex *out) : F(F), in(in), out(out) {}
+  void run() {F->fft(in,out);}
+};
+
+// Compute C.convolve(f,g) asynchronously on group.
+template<class T>
+inline Request iconvolve(ThreadGroup& group, T& C, Complex *f, Complex *g)
+{
+  return group.submit(new ConvolutionJob<T>(&C,f,g));
+}
+
+// Compute F.fft(in,out) asynchronously on group.
+template<class T>
+inline Request ifft(ThreadGroup& group, T& F, Complex *in, Complex *out=NULL)
+{
+  return group.submit(new FFTJob<T>(&F,in,out));
+}
+
+}
+
+#endif
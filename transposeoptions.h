@@ -9,10 +9,12 @@ struct mpiOptions {
   int alltoall; // -1=Tune, 0=Optimized, 1=MPI, 2=Inplace
   unsigned int threads;
   unsigned int verbose;
+  bool compress; // Communicate double-precision data as float
   mpiOptions(int a=0, int alltoall=-1,
              unsigned int threads=defaultmpithreads,
-             unsigned int verbose=0) :
-    a(a), alltoall(alltoall), threads(threads), verbose(verbose) {}
+             unsigned int verbose=0, bool compress=false) :
+    a(a), alltoall(alltoall), threads(threads), verbose(verbose),
+    compress(compress) {}
 };
 
 }
@@ -0,0 +1,453 @@
+#include <fstream>
+#include <sstream>
+
+#include "tuner.h"
+
+using namespace std;
+using namespace utils;
+
+namespace fftwpp {
+
+const char *TunedConvolutionBase::TuningName="tuning3.txt";
+TunedConvolutionBase::Table TunedConvolutionBase::table;
+unsigned int TunedConvolutionBase::directlimit=1024;
+
+// Each line of the tuning file contains a problem key followed by the
+// index of the engine chosen for it.
+void LoadTuning()
+{
+  static bool Tuned=false;
+  if(!Tuned) {
+    ifstream fin(TunedConvolutionBase::TuningName);
+    string line;
+    while(getline(fin,line)) {
+      size_t pos=line.rfind(' ');
+      if(pos == string::npos) continue;
+      unsigned int e=atoi(line.c_str()+pos+1);
+      if(e < ENGINES)
+        TunedConvolutionBase::table[line.substr(0,pos)]=e;
+    }
+    Tuned=true;
+  }
+}
+
+void SaveTuning()
+{
+  ofstream fout(TunedConvolutionBase::TuningName);
+  for(TunedConvolutionBase::Table::iterator p=
+        TunedConvolutionBase::table.begin();
+      p != TunedConvolutionBase::table.end(); ++p)
+    fout << p->first << " " << p->second << endl;
+}
+
+unsigned int fftsize(unsigned int n, bool even)
+{
+  for(;; ++n) {
+    if(even && n % 2) continue;
+    unsigned int r=n;
+    while(r % 2 == 0) r /= 2;
+    while(r % 3 == 0) r /= 3;
+    while(r % 5 == 0) r /= 5;
+    while(r % 7 == 0) r /= 7;
+    if(r <= 1) return n;
+  }
+}
+
+double TunedConvolutionBase::time(unsigned int e, Complex *f, Complex *g,
+                                  Complex *f0, Complex *g0)
+{
+  // Untimed warmup call.
+  for(unsigned int i=0; i < size; ++i) {
+    f[i]=f0[i];
+    g[i]=g0[i];
+  }
+  run(f,g,e);
+
+  double best=0.0;
+  double stop=totalseconds()+fftw::testseconds/ENGINES;
+  for(unsigned int k=0; k < 3 || totalseconds() < stop; ++k) {
+    for(unsigned int i=0; i < size; ++i) {
+      f[i]=f0[i];
+      g[i]=g0[i];
+    }
+    double start=totalseconds();
+    run(f,g,e);
+    double t=totalseconds()-start;
+    if(k == 0 || t < best) best=t;
+  }
+  return best;
+}
+
+void TunedConvolutionBase::tune(const char *name, unsigned int mx,
+                                unsigned int my, unsigned int mz)
+{
+  ostringstream key;
+  key << name << " " << mx << " " << my << " " << mz << " " << threads;
+
+  PlanLock lock; // Also protects the tuning table and file
+  LoadTuning();
+  Table::iterator p=table.find(key.str());
+  if(p != table.end() && build(p->second)) {
+    engine=p->second;
+    return;
+  }
+
+  Complex *f=ComplexAlign(size);
+  Complex *g=ComplexAlign(size);
+  Complex *f0=ComplexAlign(size);
+  Complex *g0=ComplexAlign(size);
+  for(unsigned int i=0; i < size; ++i) {
+    f0[i]=Complex(i % 11,(2*i+1) % 7);
+    g0[i]=Complex((3*i+2) % 5,i % 3);
+  }
+
+  double best=0.0;
+  bool found=false;
+  for(unsigned int e=0; e < ENGINES; ++e) {
+    if(!build(e)) continue;
+    double t=time(e,f,g,f0,g0);
+    if(!found || t < best) {
+      if(found) release(engine);
+      best=t;
+      engine=e;
+      found=true;
+    } else release(e);
+  }
+
+  deleteAlign(g0);
+  deleteAlign(f0);
+  deleteAlign(g);
+  deleteAlign(f);
+
+  if(!found) {
+    cerr << "No convolution engine is available for " << key.str() << endl;
+    exit(1);
+  }
+
+  table[key.str()]=engine;
+  SaveTuning();
+}
+
+bool TunedConvolution::build(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      if(!I) I=new ImplicitConvolution(m,2,1,threads);
+      return true;
+    case EXPLICIT:
+      allocate();
+      if(!E) E=new ExplicitConvolution(n,m,u,2,1,threads);
+      return true;
+    case DIRECT:
+      if(size > directlimit) return false;
+      allocate();
+      if(!D) D=new DirectConvolution(m,1,0,threads);
+      return true;
+  }
+  return false;
+}
+
+void TunedConvolution::release(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      delete I;
+      I=NULL;
+      break;
+    case EXPLICIT:
+      delete E;
+      E=NULL;
+      break;
+    case DIRECT:
+      delete D;
+      D=NULL;
+      break;
+  }
+}
+
+void TunedConvolution::run(Complex *f, Complex *g, unsigned int e)
+{
+  if(e == IMPLICIT) {
+    I->convolve(f,g);
+    return;
+  }
+  if(e == DIRECT) {
+    D->convolve(u,f,g);
+    for(unsigned int i=0; i < size; ++i)
+      f[i]=u[i];
+    return;
+  }
+  for(unsigned int i=0; i < m; ++i) {
+    u[i]=f[i];
+    v[i]=g[i];
+  }
+  E->convolve(u,v);
+  for(unsigned int i=0; i < m; ++i)
+    f[i]=u[i];
+}
+
+bool TunedHConvolution::build(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      if(!I) I=new ImplicitHConvolution(m,true,2,1,threads);
+      return true;
+    case EXPLICIT:
+      allocate();
+      if(!E) E=new ExplicitHConvolution(2*(n-1),m,u,2,1,threads);
+      return true;
+    case DIRECT:
+      if(size > directlimit) return false;
+      allocate();
+      if(!D) D=new DirectHConvolution(m,1,0,threads);
+      return true;
+  }
+  return false;
+}
+
+void TunedHConvolution::release(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      delete I;
+      I=NULL;
+      break;
+    case EXPLICIT:
+      delete E;
+      E=NULL;
+      break;
+    case DIRECT:
+      delete D;
+      D=NULL;
+      break;
+  }
+}
+
+void TunedHConvolution::run(Complex *f, Complex *g, unsigned int e)
+{
+  if(e == IMPLICIT) {
+    I->convolve(f,g);
+    return;
+  }
+  if(e == DIRECT) {
+    D->convolve(u,f,g);
+    for(unsigned int i=0; i < size; ++i)
+      f[i]=u[i];
+    return;
+  }
+  for(unsigned int i=0; i < m; ++i) {
+    u[i]=f[i];
+    v[i]=g[i];
+  }
+  E->convolve(u,v);
+  for(unsigned int i=0; i < m; ++i)
+    f[i]=u[i];
+}
+
+bool TunedConvolution2::build(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      if(!I) I=new ImplicitConvolution2(mx,my,2,1,threads);
+      return true;
+    case EXPLICIT:
+    case PRUNED:
+      allocate();
+      if(!E[e-EXPLICIT])
+        E[e-EXPLICIT]=new ExplicitConvolution2(nx,ny,mx,my,u,e == PRUNED,
+                                               2,1,threads);
+      return true;
+    case DIRECT:
+      if(size > directlimit) return false;
+      allocate();
+      if(!D) D=new DirectConvolution2(mx,my,1,0,threads);
+      return true;
+  }
+  return false;
+}
+
+void TunedConvolution2::release(unsigned int e)
+{
+  if(e == IMPLICIT) {
+    delete I;
+    I=NULL;
+  } else if(e == DIRECT) {
+    delete D;
+    D=NULL;
+  } else if(e < ENGINES) {
+    delete E[e-EXPLICIT];
+    E[e-EXPLICIT]=NULL;
+  }
+}
+
+void TunedConvolution2::run(Complex *f, Complex *g, unsigned int e)
+{
+  if(e == IMPLICIT) {
+    I->convolve(f,g);
+    return;
+  }
+  if(e == DIRECT) {
+    D->convolve(u,f,g);
+    for(unsigned int i=0; i < size; ++i)
+      f[i]=u[i];
+    return;
+  }
+  for(unsigned int i=0; i < mx; ++i) {
+    unsigned int ny_i=ny*i;
+    unsigned int my_i=my*i;
+    for(unsigned int j=0; j < my; ++j) {
+      u[ny_i+j]=f[my_i+j];
+      v[ny_i+j]=g[my_i+j];
+    }
+  }
+  E[e-EXPLICIT]->convolve(u,v);
+  for(unsigned int i=0; i < mx; ++i) {
+    unsigned int ny_i=ny*i;
+    unsigned int my_i=my*i;
+    for(unsigned int j=0; j < my; ++j)
+      f[my_i+j]=u[ny_i+j];
+  }
+}
+
+bool TunedHConvolution2::build(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      if(!I) I=new ImplicitHConvolution2(mx,my,true,true,2,1,threads);
+      return true;
+    case EXPLICIT:
+    case PRUNED:
+      allocate();
+      if(!E[e-EXPLICIT])
+        E[e-EXPLICIT]=new ExplicitHConvolution2(nx,ny,mx,my,u,1,
+                                                e == PRUNED,2,1,threads);
+      return true;
+    case DIRECT:
+      if(size > directlimit) return false;
+      allocate();
+      if(!D) D=new DirectHConvolution2(mx,my,1,0,threads);
+      return true;
+  }
+  return false;
+}
+
+void TunedHConvolution2::release(unsigned int e)
+{
+  if(e == IMPLICIT) {
+    delete I;
+    I=NULL;
+  } else if(e == DIRECT) {
+    delete D;
+    D=NULL;
+  } else if(e < ENGINES) {
+    delete E[e-EXPLICIT];
+    E[e-EXPLICIT]=NULL;
+  }
+}
+
+// The explicit engines store the 2mx-1 rows of the compact layout
+// starting at row nx/2-mx+1 of an nx x (ny/2+1) array.
+void TunedHConvolution2::run(Complex *f, Complex *g, unsigned int e)
+{
+  if(e == IMPLICIT) {
+    I->convolve(f,g);
+    return;
+  }
+  if(e == DIRECT) {
+    D->convolve(u,f,g);
+    for(unsigned int i=0; i < size; ++i)
+      f[i]=u[i];
+    return;
+  }
+  unsigned int nyp=ny/2+1;
+  unsigned int offset=nx/2-mx+1;
+  unsigned int nx0=2*mx-1;
+  for(unsigned int i=0; i < nx0; ++i) {
+    unsigned int nyp_i=nyp*(offset+i);
+    unsigned int my_i=my*i;
+    for(unsigned int j=0; j < my; ++j) {
+      u[nyp_i+j]=f[my_i+j];
+      v[nyp_i+j]=g[my_i+j];
+    }
+  }
+  E[e-EXPLICIT]->convolve(u,v);
+  for(unsigned int i=0; i < nx0; ++i) {
+    unsigned int nyp_i=nyp*(offset+i);
+    unsigned int my_i=my*i;
+    for(unsigned int j=0; j < my; ++j)
+      f[my_i+j]=u[nyp_i+j];
+  }
+}
+
+bool TunedConvolution3::build(unsigned int e)
+{
+  switch(e) {
+    case IMPLICIT:
+      if(!I) I=new ImplicitConvolution3(mx,my,mz,2,1,threads);
+      return true;
+    case EXPLICIT:
+    case PRUNED:
+      allocate();
+      if(!E[e-EXPLICIT])
+        E[e-EXPLICIT]=new ExplicitConvolution3(nx,ny,nz,mx,my,mz,u,
+                                               e == PRUNED,2,1,threads);
+      return true;
+    case DIRECT:
+      if(size > directlimit) return false;
+      allocate();
+      if(!D) D=new DirectConvolution3(mx,my,mz,1,0,threads);
+      return true;
+  }
+  return false;
+}
+
+void TunedConvolution3::release(unsigned int e)
+{
+  if(e == IMPLICIT) {
+    delete I;
+    I=NULL;
+  } else if(e == DIRECT) {
+    delete D;
+    D=NULL;
+  } else if(e < ENGINES) {
+    delete E[e-EXPLICIT];
+    E[e-EXPLICIT]=NULL;
+  }
+}
+
+void TunedConvolution3::run(Complex *f, Complex *g, unsigned int e)
+{
+  if(e == IMPLICIT) {
+    I->convolve(f,g);
+    return;
+  }
+  if(e == DIRECT) {
+    D->convolve(u,f,g);
+    for(unsigned int i=0; i < size; ++i)
+      f[i]=u[i];
+    return;
+  }
+  unsigned int nyz=ny*nz;
+  unsigned int myz=my*mz;
+  for(unsigned int i=0; i < mx; ++i) {
+    for(unsigned int j=0; j < my; ++j) {
+      unsigned int N=nyz*i+nz*j;
+      unsigned int M=myz*i+mz*j;
+      for(unsigned int k=0; k < mz; ++k) {
+        u[N+k]=f[M+k];
+        v[N+k]=g[M+k];
+      }
+    }
+  }
+  E[e-EXPLICIT]->convolve(u,v);
+  for(unsigned int i=0; i < mx; ++i) {
+    for(unsigned int j=0; j < my; ++j) {
+      unsigned int N=nyz*i+nz*j;
+      unsigned int M=myz*i+mz*j;
+      for(unsigned int k=0; k < mz; ++k)
+        f[M+k]=u[N+k];
+    }
+  }
+}
+
+}
@@ -0,0 +1,260 @@
+/* Automatically tuned dealiased convolution routines.
+   Copyright (C) 2016 John C. Bowman and Malcolm Roberts, Univ. of Alberta
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#ifndef __tuner_h__
+#define __tuner_h__ 1
+
+#include <map>
+#include <string>
+
+#include "convolution.h"
+#include "explicit.h"
+#include "direct.h"
+
+namespace fftwpp {
+
+// The tuned convolutions below accept exactly the same input and output
+// layout as the corresponding implicitly dealiased convolutions, but
+// dispatch each call to whichever engine (implicit, explicitly padded,
+// explicitly padded with pruning of the zero rows, or, for inputs of at
+// most TunedConvolutionBase::directlimit values, direct summation) was
+// fastest when the object was constructed. The choice for each problem
+// size and number of threads is cached in the file
+// TunedConvolutionBase::TuningName (next to the FFTW wisdom file) and
+// reused by later runs.
+//
+// Usage:
+//   TunedConvolution2 C(mx,my);
+//   C.convolve(f,g);
+//   cout << C.EngineName() << endl;
+
+enum ConvolutionEngine {IMPLICIT,EXPLICIT,PRUNED,DIRECT,ENGINES};
+
+void LoadTuning();
+void SaveTuning();
+
+// Return the smallest (even, if requested) integer >= n whose only prime
+// factors are 2, 3, 5, and 7.
+unsigned int fftsize(unsigned int n, bool even=false);
+
+// Base class for tuned convolutions.
+class TunedConvolutionBase : public ThreadBase {
+protected:
+  unsigned int engine;
+  unsigned int size; // Number of Complex values in each input
+  unsigned int n;    // Number of Complex values in each padded work array
+  Complex *u,*v;     // Explicitly padded work arrays
+
+  // Construct engine e, returning false if e is not applicable.
+  virtual bool build(unsigned int e)=0;
+
+  // Delete engine e.
+  virtual void release(unsigned int e)=0;
+
+  // Compute the binary convolution of f and g with engine e.
+  virtual void run(Complex *f, Complex *g, unsigned int e)=0;
+
+  // Allocate the padded work arrays.
+  void allocate() {
+    if(!u) {
+      u=utils::ComplexAlign(n);
+      v=utils::ComplexAlign(n);
+    }
+  }
+
+  // Choose the fastest engine for the problem described by key.
+  void tune(const char *name, unsigned int mx, unsigned int my=1,
+            unsigned int mz=1);
+
+  // Time engine e on copies of f0 and g0 in f and g.
+  double time(unsigned int e, Complex *f, Complex *g, Complex *f0,
+              Complex *g0);
+
+public:
+  typedef std::map<std::string,unsigned int> Table;
+  static Table table; // Engine chosen for each problem key
+  static const char *TuningName;
+  static unsigned int directlimit; // Largest input size timed directly
+
+  TunedConvolutionBase(unsigned int size, unsigned int n,
+                       unsigned int threads) :
+    ThreadBase(threads), engine(IMPLICIT), size(size), n(n), u(NULL),
+    v(NULL) {}
+
+  virtual ~TunedConvolutionBase() {
+    if(u) {
+      utils::deleteAlign(v);
+      utils::deleteAlign(u);
+    }
+  }
+
+  unsigned int Engine() {return engine;}
+
+  const char *EngineName() {
+    static const char *names[]={"implicit","explicit","pruned",
+                                "direct"};
+    return names[engine];
+  }
+
+  // Compute f (*) g, returning the result in f (the contents of g are not
+  // preserved).
+  void convolve(Complex *f, Complex *g) {run(f,g,engine);}
+};
+
+// Tuned 1D complex convolution of f and g, each of size m.
+class TunedConvolution : public TunedConvolutionBase {
+protected:
+  unsigned int m;
+  ImplicitConvolution *I;
+  ExplicitConvolution *E;
+  DirectConvolution *D;
+
+  bool build(unsigned int e);
+  void release(unsigned int e);
+  void run(Complex *f, Complex *g, unsigned int e);
+public:
+  TunedConvolution(unsigned int m, unsigned int threads=fftw::maxthreads) :
+    TunedConvolutionBase(m,fftsize(2*m-1),threads), m(m), I(NULL),
+    E(NULL), D(NULL) {
+    tune("TunedConvolution",m);
+  }
+
+  ~TunedConvolution() {
+    release(IMPLICIT);
+    release(EXPLICIT);
+    release(DIRECT);
+  }
+};
+
+// Tuned 1D Hermitian convolution of f and g, each containing the m
+// non-negative Fourier modes of a real function.
+class TunedHConvolution : public TunedConvolutionBase {
+protected:
+  unsigned int m;
+  ImplicitHConvolution *I;
+  ExplicitHConvolution *E;
+  DirectHConvolution *D;
+
+  bool build(unsigned int e);
+  void release(unsigned int e);
+  void run(Complex *f, Complex *g, unsigned int e);
+public:
+  TunedHConvolution(unsigned int m, unsigned int threads=fftw::maxthreads) :
+    TunedConvolutionBase(m,fftsize(3*m-2,true)/2+1,threads), m(m), I(NULL),
+    E(NULL), D(NULL) {
+    tune("TunedHConvolution",m);
+  }
+
+  ~TunedHConvolution() {
+    release(IMPLICIT);
+    release(EXPLICIT);
+    release(DIRECT);
+  }
+};
+
+// Tuned 2D complex convolution of f and g, each of size mx*my.
+class TunedConvolution2 : public TunedConvolutionBase {
+protected:
+  unsigned int mx,my;
+  unsigned int nx,ny;
+  ImplicitConvolution2 *I;
+  ExplicitConvolution2 *E[2];
+  DirectConvolution2 *D;
+
+  bool build(unsigned int e);
+  void release(unsigned int e);
+  void run(Complex *f, Complex *g, unsigned int e);
+public:
+  TunedConvolution2(unsigned int mx, unsigned int my,
+                    unsigned int threads=fftw::maxthreads) :
+    TunedConvolutionBase(mx*my,fftsize(2*mx-1)*fftsize(2*my-1),threads),
+    mx(mx), my(my), nx(fftsize(2*mx-1)), ny(fftsize(2*my-1)), I(NULL),
+    D(NULL) {
+    E[0]=E[1]=NULL;
+    tune("TunedConvolution2",mx,my);
+  }
+
+  ~TunedConvolution2() {
+    for(unsigned int e=0; e < ENGINES; ++e)
+      release(e);
+  }
+};
+
+// Tuned 2D Hermitian convolution of f and g, each of size (2mx-1)*my,
+// with the x origin at row mx-1 (the compact layout of
+// ImplicitHConvolution2).
+class TunedHConvolution2 : public TunedConvolutionBase {
+protected:
+  unsigned int mx,my;
+  unsigned int nx,ny;
+  ImplicitHConvolution2 *I;
+  ExplicitHConvolution2 *E[2];
+  DirectHConvolution2 *D;
+
+  bool build(unsigned int e);
+  void release(unsigned int e);
+  void run(Complex *f, Complex *g, unsigned int e);
+public:
+  TunedHConvolution2(unsigned int mx, unsigned int my,
+                     unsigned int threads=fftw::maxthreads) :
+    TunedConvolutionBase((2*mx-1)*my,
+                         fftsize(3*mx-2,true)*(fftsize(3*my-2,true)/2+1),
+                         threads),
+    mx(mx), my(my), nx(fftsize(3*mx-2,true)), ny(fftsize(3*my-2,true)),
+    I(NULL), D(NULL) {
+    E[0]=E[1]=NULL;
+    tune("TunedHConvolution2",mx,my);
+  }
+
+  ~TunedHConvolution2() {
+    for(unsigned int e=0; e < ENGINES; ++e)
+      release(e);
+  }
+};
+
+// Tuned 3D complex convolution of f and g, each of size mx*my*mz.
+class TunedConvolution3 : public TunedConvolutionBase {
+protected:
+  unsigned int mx,my,mz;
+  unsigned int nx,ny,nz;
+  ImplicitConvolution3 *I;
+  ExplicitConvolution3 *E[2];
+  DirectConvolution3 *D;
+
+  bool build(unsigned int e);
+  void release(unsigned int e);
+  void run(Complex *f, Complex *g, unsigned int e);
+public:
+  TunedConvolution3(unsigned int mx, unsigned int my, unsigned int mz,
+                    unsigned int threads=fftw::maxthreads) :
+    TunedConvolutionBase(mx*my*mz,fftsize(2*mx-1)*fftsize(2*my-1)*
+                         fftsize(2*mz-1),threads),
+    mx(mx), my(my), mz(mz), nx(fftsize(2*mx-1)), ny(fftsize(2*my-1)),
+    nz(fftsize(2*mz-1)), I(NULL), D(NULL) {
+    E[0]=E[1]=NULL;
+    tune("TunedConvolution3",mx,my,mz);
+  }
+
+  ~TunedConvolution3() {
+    for(unsigned int e=0; e < ENGINES; ++e)
+      release(e);
+  }
+};
+
+}
+
+#endif
@@ -1,99 +1,64 @@
-#!/usr/bin/python
-# fftwpp.py - Python wrapper of the C callable FFTW+ wrapper.
+#!/usr/bin/env python
+# fftwpp.py - Python wrapper of the FFTW++ extension module _fftwpp.
 #
 # Authors: Matthew Emmett <memmett@gmail.com>
 #          Malcolm Roberts <malcolm.i.w.roberts@gmail.com>
+#
+# The extension module operates in place on the memory of NumPy arrays,
+# which must be C-contiguous and 16-byte aligned, and releases the global
+# interpreter lock while planning and executing, so independent objects
+# may be used concurrently from several Python threads.
 
 import numpy as np
-import os
 
-from numpy.ctypeslib import ndpointer
-from ctypes import *
+import _fftwpp
 
-def complex_align(shape):
-    dtype = np.dtype(np.complex128)
-    nbytes = np.prod(shape) * dtype.itemsize
-    buf = np.empty(nbytes + 16, dtype = np.uint8)
-    start_index = -buf.ctypes.data % 16
-    return buf[start_index:start_index + nbytes].view(dtype).reshape(shape)
+__all__ = [ 'Convolution', 'HConvolution', 'AutoConvolution',
+            'FFT', 'RCFFT', 'CRFFT', 'MFFT', 'MRCFFT', 'MCRFFT',
+            'complex_align', 'real_align' ]
 
-__all__ = [ 'Convolution' , 'HConvolution' ]
+alignment = 16
 
-# Load fftwpp shared library
-base = os.path.dirname(os.path.abspath(__file__))
-clib = CDLL(os.path.join(base, '_fftwpp.so'))
+def aligned(shape, dtype):
+    """Return an uninitialized array of the given shape and dtype whose
+    data is suitably aligned for FFTW++.  NumPy arrays are normally
+    already aligned; otherwise the array is carved out of a slightly
+    larger buffer."""
+    a = np.empty(shape, dtype = dtype)
+    if a.ctypes.data % alignment == 0:
+        return a
+    dtype = np.dtype(dtype)
+    nbytes = int(np.prod(shape)) * dtype.itemsize
+    buf = np.empty(nbytes + alignment, dtype = np.uint8)
+    start = -buf.ctypes.data % alignment
+    return buf[start:start + nbytes].view(dtype).reshape(shape)
+
+def complex_align(shape):
+    return aligned(shape, np.complex128)
+
+def real_align(shape):
+    return aligned(shape, np.float64)
 
 def fftwpp_set_maxthreads(nthreads):
-    clib.set_fftwpp_maxthreads(nthreads)
+    _fftwpp.set_maxthreads(nthreads)
 
 def fftwpp_get_maxthreads():
-    return clib.get_fftwpp_maxthreads()
-
-# Prototypes
-clib.fftwpp_create_conv1d.restype = c_void_p
-clib.fftwpp_create_conv1d.argtypes = [ c_int ]
-clib.fftwpp_create_conv1dAB.restype = c_void_p
-clib.fftwpp_create_conv1dAB.argtypes = [ c_int , c_int, c_int ]
-clib.fftwpp_conv1d_delete.argtypes = [ c_void_p ]
-clib.fftwpp_conv1d_convolve.argtypes = [ c_void_p,
-                                         ndpointer(dtype = np.complex128),
-                                         ndpointer(dtype = np.complex128) ]
-clib.fftwpp_conv1d_correlate.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
-clib.fftwpp_conv1d_autoconvolve.argtypes = [ c_void_p,
-                                             ndpointer(dtype = np.complex128)]
-clib.fftwpp_conv1d_autocorrelate.argtypes = [ c_void_p,
-                                              ndpointer(dtype = np.complex128)]
-
-clib.fftwpp_create_hconv1d.restype = c_void_p
-clib.fftwpp_create_hconv1d.argtypes = [ c_int ]
-clib.fftwpp_hconv1d_delete.argtypes = [ c_void_p ]
-clib.fftwpp_hconv1d_convolve.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
-
-clib.fftwpp_create_conv2d.restype = c_void_p
-clib.fftwpp_create_conv2d.argtypes = [ c_int, c_int ]
-clib.fftwpp_conv2d_delete.argtypes = [ c_void_p ]
-clib.fftwpp_conv2d_convolve.argtypes = [ c_void_p,
-                                         ndpointer(dtype = np.complex128),
-                                         ndpointer(dtype = np.complex128) ]
-clib.fftwpp_conv2d_correlate.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
-
-clib.fftwpp_create_hconv2d.restype = c_void_p
-clib.fftwpp_create_hconv2d.argtypes = [ c_int, c_int ]
-clib.fftwpp_hconv2d_delete.argtypes = [ c_void_p ]
-clib.fftwpp_hconv2d_convolve.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
-
-clib.fftwpp_create_conv3d.restype = c_void_p
-clib.fftwpp_create_conv3d.argtypes = [ c_int, c_int, c_int ]
-clib.fftwpp_conv3d_delete.argtypes = [ c_void_p ]
-clib.fftwpp_conv3d_convolve.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
-clib.fftwpp_conv3d_correlate.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
-
-clib.fftwpp_create_hconv3d.restype = c_void_p
-clib.fftwpp_create_hconv3d.argtypes = [ c_int, c_int, c_int ]
-clib.fftwpp_hconv3d_delete.argtypes = [ c_void_p ]
-clib.fftwpp_hconv3d_convolve.argtypes = [ c_void_p,
-                                          ndpointer(dtype = np.complex128),
-                                          ndpointer(dtype = np.complex128) ]
+    return _fftwpp.get_maxthreads()
 
 class Convolution(object):
     """Implicitly zero-padded complex convolution class.
 
     :param shape: shape/number of elements in the input arrays (int,
     tuple or list)
+    :param mult: name of the multiplier: 'binary', 'correlation',
+    'autoconvolution', 'autocorrelation', 'dot', or 'cross'
+    :param A: number of inputs (only needed for the 'dot' multiplier,
+    which accepts any even A up to 16)
+    :param threads: number of threads (0 selects the default)
 
     The length of *shape* determines the dimension of the convolution.
+    The convolution object, including its FFTW plans and work arrays,
+    persists between calls.
 
     One dimensional convolutions
     ----------------------------
@@ -105,8 +70,8 @@ class Convolution(object):
     >>> N = 8
     >>> f = fftwpp.complex_align([N])
     >>> g = fftwpp.complex_align([N])
-    >>> for i in range(len(f)): f[i]=np.complex(i,i+1)
-    >>> for i in range(len(g)): g[i]=np.complex(i,2*i+1)
+    >>> for i in range(len(f)): f[i]=complex(i,i+1)
+    >>> for i in range(len(g)): g[i]=complex(i,2*i+1)
 
     At this point, both ``f`` and ``g`` have shape ``(N,)``::
 
@@ -123,6 +88,33 @@ class Convolution(object):
     -45. +50.j,-71. +90.j, -105.+147.j, -148.+224.j])
     True
 
+    Several independent convolutions are computed in a single call by
+    stacking the inputs along an additional leading axis::
+
+    >>> F = fftwpp.complex_align([3, N])
+    >>> G = fftwpp.complex_align([3, N])
+    >>> for k in range(3):
+    ...     for i in range(N):
+    ...         F[k][i] = complex(i,i+1)
+    ...         G[k][i] = complex(i,2*i+1)
+    ...
+    >>> c.convolve(F, G)
+    >>> np.allclose(F[2], f)
+    True
+
+    Multipliers with more than two inputs combine several convolutions
+    into a single one; here f*g+f*g::
+
+    >>> d = fftwpp.Convolution(N, mult='dot', A=4)
+    >>> F = [fftwpp.complex_align([N]) for a in range(4)]
+    >>> for i in range(N):
+    ...     F[0][i] = F[1][i] = complex(i,i+1)
+    ...     F[2][i] = F[3][i] = complex(i,2*i+1)
+    ...
+    >>> d.convolve(*F)
+    >>> np.allclose(F[0], 2*f)
+    True
+
     Two dimensional convolutions
     ----------------------------
 
@@ -135,11 +127,11 @@ class Convolution(object):
     >>> g = fftwpp.complex_align([N,N])
     >>> for i in range(len(f)):
     ...     for j in range(len(f[i])):
-    ...             f[i][j]=np.complex(i,j)
+    ...             f[i][j]=complex(i,j)
     ...
     >>> for i in range(len(g)):
     ...     for j in range(len(g[i])):
-    ...             g[i][j]=np.complex(2*i,j+1)
+    ...             g[i][j]=complex(2*i,j+1)
     ...
 
     At this point, both ``f`` and ``g`` have shape ``(N, N)``::
@@ -152,8 +144,7 @@ class Convolution(object):
     >>> c = fftwpp.Convolution(f.shape)
     >>> c.convolve(f, g)
 
-    Again, the convolution is now in ``f``::
-
+    Again, the convolution is now in ``f``.
 
     Three dimensional convolutions
     ------------------------------
@@ -168,9 +159,9 @@ class Convolution(object):
     >>> for i in range(len(f)):
     ...     for j in range(len(f[i])):
     ...             for k in range(len(f[i][j])):
-    ...                     f[i][j][k]=np.complex(i+k,j+k)
-    ...                     g[i][j][k]=np.complex(2*i+k,j+1+k)
-    ... 
+    ...                     f[i][j][k]=complex(i+k,j+k)
+    ...                     g[i][j][k]=complex(2*i+k,j+1+k)
+    ...
 
     At this point, both ``f`` and ``g`` have shape ``(N, N, N)``::
 
@@ -182,11 +173,13 @@ class Convolution(object):
     >>> c = fftwpp.Convolution(f.shape)
     >>> c.convolve(f, g)
 
-    Again, the convolution is now in ``f``::
+    Again, the convolution is now in ``f``.
 
     """
 
-    def __init__(self, shape):
+    convolution = _fftwpp.Convolution
+
+    def __init__(self, shape, mult = 'binary', A = 0, threads = 0):
 
         if isinstance(shape, int):
             shape = (shape,)
@@ -194,57 +187,47 @@ class Convolution(object):
         self.dim   = len(shape)
         self.shape = tuple(shape)
 
-        if self.dim == 1:
-            self.cptr = clib.fftwpp_create_conv1d(*shape)
-            self._convolve = clib.fftwpp_conv1d_convolve
-            self._correlate = clib.fftwpp_conv1d_correlate
-            self._delete = clib.fftwpp_conv1d_delete
-        elif self.dim == 2:
-            self.cptr = clib.fftwpp_create_conv2d(*shape)
-            self._convolve = clib.fftwpp_conv2d_convolve
-            self._correlate = clib.fftwpp_conv2d_correlate
-            self._delete = clib.fftwpp_conv2d_delete
-        elif self.dim == 3:
-            self.cptr = clib.fftwpp_create_conv3d(*shape)
-            self._convolve = clib.fftwpp_conv3d_convolve
-            self._correlate = clib.fftwpp_conv3d_correlate
-            self._delete = clib.fftwpp_conv3d_delete
-        else:
+        if self.dim < 1 or self.dim > 3:
             raise ValueError("invalid shape (length/dimension should be 1, 2, or 3)")
 
-    def __del__(self):
-        self._delete(self.cptr)
+        self.conv = self.convolution(self.shape, mult, A, threads)
+        self.A = self.conv.A
+        self.B = self.conv.B
 
-    def convolve(self, f, g):
-        """Compute the convolution of *f* and *g*.
+    def convolve(self, *arrays, **kwargs):
+        """Compute the convolution of the *A* input arrays.
 
-        The convolution is performed in-place (*f* is over-written).
+        Exactly max(*A*, *B*) distinct arrays must be supplied; the
+        inputs are read from the first *A* of them.  The convolution is
+        performed in-place: the *B* outputs are returned in the first
+        *B* arrays and the remaining arrays are over-written.  The
+        multiplier may be overridden with the keyword argument *mult*.
         """
 
-        assert f.shape == self.shape
-        assert g.shape == self.shape
+        self.conv.convolve(*arrays, **kwargs)
 
-        self._convolve(self.cptr, f, g)
+    def correlate(self, f, g):
+        """Compute the correlation of *f* and *g*.
 
-    # def correlate(self, f, g):
-    #     """Compute the convolution of *f* and *g*.
-
-    #     The convolution is performed in-place (*f* is over-written).
-    #     """
-
-    #     assert f.shape == self.shape
-    #     assert g.shape == self.shape
+        The correlation is performed in-place (*f* is over-written).
+        """
 
-    #     self._correlate(self.cptr, f, g)
-        
+        self.conv.convolve(f, g, mult = 'correlation')
 
-class HConvolution(object):
+class HConvolution(Convolution):
     """Implicitly zero-padded complex Hermitian-symmetric convolution class.
 
     :param shape: shape/number of elements in the input arrays (int,
     tuple or list)
+    :param mult: name of the multiplier: 'binary', 'correlation',
+    'autoconvolution', 'autocorrelation', 'dot', 'cross', 'advection2',
+    or 'advection3'
+    :param A: number of inputs (only needed for the 'dot' multiplier)
+    :param threads: number of threads (0 selects the default)
 
     The length of *shape* determines the dimension of the convolution.
+    The arrays are centered on the origin in all but the last
+    dimension, so the first lengths must be odd.
 
     One dimensional convolutions
     ----------------------------
@@ -257,14 +240,16 @@ class HConvolution(object):
     >>> f = fftwpp.complex_align([N])
     >>> g = fftwpp.complex_align([N])
     >>> for i in range(len(f)):
-    ...     f[i] = np.complex(i, i + 1)
-    ...     g[i] = np.complex(i, 2 * i + 1)
+    ...     f[i] = complex(i, i + 1)
+    ...     g[i] = complex(i, 2 * i + 1)
+    ...
 
     At this point, both ``f`` and ``g`` have shape ``(N,)``::
 
     >>> assert f.shape == (N,)
 
     Now, construct the convolution object and convolve::
+
     >>> c = fftwpp.HConvolution(N)
     >>> c.convolve(f, g)
 
@@ -288,16 +273,16 @@ class HConvolution(object):
     >>> g = fftwpp.complex_align([2 * Nx - 1, Ny])
     >>> for i in range(len(f)):
     ...     for j in range(len(f[i])):
-    ...             f[i][j] = np.complex(i, j)
-    ...             g[i][j] = np.complex(2 * i, j + 1)
-    ... 
+    ...             f[i][j] = complex(i, j)
+    ...             g[i][j] = complex(2 * i, j + 1)
+    ...
 
     Now, construct the convolution object and convolve::
 
     >>> c = fftwpp.HConvolution(f.shape)
     >>> c.convolve(f, g)
 
-    Again, the convolution is now in ``f``::
+    Again, the convolution is now in ``f``.
 
 
     Three dimensional convolutions
@@ -312,110 +297,189 @@ class HConvolution(object):
     >>> Nz = 4
     >>> f = fftwpp.complex_align([2 * Nx - 1, 2 * Ny - 1, Nz])
     >>> g = fftwpp.complex_align([2 * Nx - 1, 2 * Ny - 1, Nz])
+    >>> f[:] = 0
+    >>> g[:] = 0
 
     Now, construct the convolution object and convolve::
 
     >>> c = fftwpp.HConvolution(f.shape)
     >>> c.convolve(f, g)
 
-    Again, the convolution is now in ``f``::
-
-    >>> #np.allclose(f/N**3, np.fft.fftn(np.sin(x)*np.sin(5*y)*np.sin(z)))
-    True
+    Again, the convolution is now in ``f``.
 
     """
 
-    def __init__(self, shape):
+    convolution = _fftwpp.HConvolution
 
-        if isinstance(shape, int):
-            shape = (shape,)
-            
-        self.dim   = len(shape)
-        self.shape = tuple(shape)
-
-        if self.dim == 1:
-            self.cptr = clib.fftwpp_create_hconv1d(c_int(shape[0]))
-            #self.cptr = clib.fftwpp_create_hconv1d(*shape)
-            self._convolve = clib.fftwpp_hconv1d_convolve
-            self._delete = clib.fftwpp_hconv1d_delete
-        elif self.dim == 2:
-            self.cptr = clib.fftwpp_create_hconv2d(c_int((shape[0] + 1) / 2),
-                                                   c_int(shape[1]))
-            self._convolve = clib.fftwpp_hconv2d_convolve
-            self._delete = clib.fftwpp_hconv2d_delete
-        elif self.dim == 3:
-            self.cptr = clib.fftwpp_create_hconv3d(c_int((shape[0] + 1) / 2), 
-                                                   c_int((shape[1] + 1) / 2), 
-                                                   c_int(shape[2]))
-            self._convolve = clib.fftwpp_hconv3d_convolve
-            self._delete = clib.fftwpp_hconv3d_delete
-        else:
-            raise ValueError("invalid shape (length/dimension should be 1, 2, or 3)")
-
-    def __del__(self):
-        self._delete(self.cptr)
-
-    def convolve(self, f, g):
-        """Compute the convolution of *f* and *g*.
-
-        The convolution is performed in-place (*f* is over-written).
-        """
-
-        assert f.shape == self.shape
-        assert g.shape == self.shape
-
-        self._convolve(self.cptr, f, g)
-
-class AutoConvolution(object):
+class AutoConvolution(Convolution):
     """Implicitly zero-padded complex autoconvolution class.
-    FIXME: doc
-    """
-    def __init__(self, shape):
 
-        if isinstance(shape, int):
-            shape = (shape,)
-
-        self.dim   = len(shape)
-        self.shape = tuple(shape)
-        
-        if self.dim == 1:
-            self.cptr = clib.fftwpp_create_conv1dAB(shape[0], 1, 1)
-            self._autoconvolve = clib.fftwpp_conv1d_autoconvolve
-            self._autocorrelate = clib.fftwpp_conv1d_autocorrelate
-            self._delete = clib.fftwpp_conv1d_delete
-        elif self.dim == 2:
-            self.cptr = clib.fftwpp_create_conv2dAB(shape[0], 1, 1)
-            self._autoconvolve = clib.fftwpp_conv2d_autoconvolve
-            self._autocorrelate = clib.fftwpp_conv2d_autocorrelate
-            self._delete = clib.fftwpp_conv2d_delete
-        elif self.dim == 3:
-            self.cptr = clib.fftwpp_create_conv3dAB(shape[0], 1, 1)
-            self._autoconvolve = clib.fftwpp_conv3d_autoconvolve
-            self._autocorrelate = clib.fftwpp_conv3d_autocorrelate
-            self._delete = clib.fftwpp_conv3d_delete
-        else:
-            raise ValueError("invalid shape (length/dimension should be 1, 2, or 3)")
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.complex_align([8])
+    >>> for i in range(len(f)): f[i]=complex(i,i+1)
+    >>> g = f.copy()
+    >>> h = fftwpp.complex_align([8])
+    >>> h[:] = f
+    >>> c = fftwpp.AutoConvolution(f.shape)
+    >>> c.autoconvolve(f)
+    >>> fftwpp.Convolution(8).convolve(g, h)
+    >>> np.allclose(f, g)
+    True
+    """
 
-    def __del__(self):
-        self._delete(self.cptr)
+    def __init__(self, shape, threads = 0):
+        Convolution.__init__(self, shape, 'autoconvolution', 1, threads)
 
     def autoconvolve(self, f):
         """
         Compute the autoconvolution of *f*.
         The convolution is performed in-place (*f* is over-written).
         """
-        assert f.shape == self.shape
-        self._autoconvolve(self.cptr, f)
+        self.conv.convolve(f)
 
     def autocorrelate(self, f):
         """
         Compute the autocorrelation of *f*.
         The correlation is performed in-place (*f* is over-written).
         """
-        assert f.shape == self.shape
-        self._autocorrelate(self.cptr, f)
+        self.conv.convolve(f, mult = 'autocorrelation')
+
+class Transform(object):
+    """Base class of the FFT classes, which hold a persistent FFTW plan.
+
+    The plan is created for the shape (and in-place or out-of-place
+    layout) given to the constructor and may then be executed on any
+    suitably aligned arrays of that shape, concurrently from several
+    threads.
+    """
+
+    def fft(self, f, out = None):
+        """Transform *f* (in place unless the transform was planned out of
+        place) and return the output array, which is allocated if *out*
+        is None."""
+        if out is None and not self.plan.inplace:
+            out = self.output()
+        self.plan.fft(f, out)
+        return f if out is None else out
+
+    def fftNormalized(self, f, out = None):
+        """Like fft, but also divide by the number of points of each
+        transform."""
+        if out is None and not self.plan.inplace:
+            out = self.output()
+        self.plan.fftNormalized(f, out)
+        return f if out is None else out
+
+    def output(self):
+        shape = self.plan.oshape
+        return real_align(shape) if self.real_output else complex_align(shape)
+
+    real_output = False
+
+class FFT(Transform):
+    """1D, 2D, or 3D complex Fourier transform.
+
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.complex_align([4, 6])
+    >>> f[:] = np.arange(24).reshape(4, 6) * (1 + 2j)
+    >>> g = np.fft.fftn(f)
+    >>> forward = fftwpp.FFT(f.shape)
+    >>> np.allclose(forward.fft(f), g)
+    True
+    >>> np.allclose(fftwpp.FFT(f.shape, 1).fftNormalized(f),
+    ...             np.arange(24).reshape(4, 6) * (1 + 2j))
+    True
+    """
+
+    def __init__(self, shape, sign = -1, inplace = True, threads = 0):
+        self.plan = _fftwpp.fft(shape, sign, inplace, threads = threads)
+
+class RCFFT(Transform):
+    """1D, 2D, or 3D real-to-complex Fourier transform of real arrays of
+    the given shape; the last dimension of the output is n/2+1.
+
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.real_align([4, 6])
+    >>> f[:] = np.arange(24).reshape(4, 6)
+    >>> np.allclose(fftwpp.RCFFT(f.shape).fft(f), np.fft.rfftn(f))
+    True
+    """
+
+    def __init__(self, shape, threads = 0):
+        self.plan = _fftwpp.rcfft(shape, threads = threads)
+
+class CRFFT(Transform):
+    """1D, 2D, or 3D complex-to-real Fourier transform to real arrays of
+    the given shape (the input array is over-written).
+
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.real_align([4, 6])
+    >>> f[:] = np.arange(24).reshape(4, 6)
+    >>> F = fftwpp.RCFFT(f.shape).fft(f)
+    >>> np.allclose(fftwpp.CRFFT(f.shape).fftNormalized(F), f)
+    True
+    """
+
+    real_output = True
+
+    def __init__(self, shape, threads = 0):
+        self.plan = _fftwpp.crfft(shape, threads = threads)
+
+class MFFT(Transform):
+    """Complex Fourier transforms of the rows (axis=-1) or columns
+    (axis=0) of a 2D array.
+
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.complex_align([5, 8])
+    >>> f[:] = np.arange(40).reshape(5, 8) * (1 - 1j)
+    >>> g = np.fft.fft(f, axis=0)
+    >>> np.allclose(fftwpp.MFFT(f.shape, axis=0).fft(f), g)
+    True
+    """
+
+    def __init__(self, shape, sign = -1, inplace = True, axis = -1,
+                 threads = 0):
+        self.plan = _fftwpp.mfft(shape, sign, inplace, axis, threads)
+
+class MRCFFT(Transform):
+    """Real-to-complex Fourier transforms of the rows (axis=-1) or
+    columns (axis=0) of a 2D real array.
+
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.real_align([5, 8])
+    >>> f[:] = np.arange(40).reshape(5, 8)
+    >>> np.allclose(fftwpp.MRCFFT(f.shape).fft(f), np.fft.rfft(f))
+    True
+    """
+
+    def __init__(self, shape, axis = -1, threads = 0):
+        self.plan = _fftwpp.mrcfft(shape, axis = axis, threads = threads)
+
+class MCRFFT(Transform):
+    """Complex-to-real Fourier transforms to the rows (axis=-1) or
+    columns (axis=0) of a 2D real array (the input array is
+    over-written).
+
+    >>> import numpy as np
+    >>> import fftwpp
+    >>> f = fftwpp.real_align([5, 8])
+    >>> f[:] = np.arange(40).reshape(5, 8)
+    >>> F = fftwpp.MRCFFT(f.shape, axis=0).fft(f)
+    >>> np.allclose(fftwpp.MCRFFT(f.shape, axis=0).fftNormalized(F), f)
+    True
+    """
+
+    real_output = True
+
+    def __init__(self, shape, axis = -1, threads = 0):
+        self.plan = _fftwpp.mcrfft(shape, axis = axis, threads = threads)
 
 if __name__ == "__main__":
     import doctest
     doctest.testmod()
-
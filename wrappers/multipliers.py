@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+
+# Check every registered multiplier of the Python convolution classes
+# against an explicitly zero-padded convolution computed with numpy.
+
+import sys
+import numpy as np
+import fftwpp
+
+# Each multiplier maps the A physical-space inputs u to the B outputs;
+# real data are self-conjugate, so conj has no effect in the Hermitian
+# case.
+def dot(u):
+    M = len(u) // 2
+    return [sum(u[s] * u[M + s] for s in range(M))]
+
+multipliers = [
+    ("binary", 0, lambda u: [u[0] * u[1]]),
+    ("correlation", 0, lambda u: [u[0] * np.conj(u[1])]),
+    ("autoconvolution", 0, lambda u: [u[0] * u[0]]),
+    ("autocorrelation", 0, lambda u: [u[0] * np.conj(u[0])]),
+    ("dot", 2, dot),
+    ("dot", 4, dot),
+    ("cross", 0, lambda u: [u[1] * u[5] - u[2] * u[4],
+                            u[2] * u[3] - u[0] * u[5],
+                            u[0] * u[4] - u[1] * u[3]]),
+    ("advection2", 0, lambda u: [u[1] * u[1] - u[0] * u[0], u[0] * u[1]]),
+    ("advection3", 0, lambda u: [u[0] * u[0] - u[2] * u[2],
+                                 u[1] * u[1] - u[2] * u[2],
+                                 u[0] * u[1], u[0] * u[2], u[1] * u[2]]),
+]
+
+# Wavenumbers of each index along every axis, and the length of the
+# unaliased grid.
+def wavenumbers(shape, hermitian):
+    k = []
+    for i, n in enumerate(shape):
+        if hermitian and i < len(shape) - 1:
+            k.append(np.arange(n) - (n - 1) // 2)
+        else:
+            k.append(np.arange(n))
+    N = 3 * max(shape) if hermitian else 2 * max(shape)
+    return k, N
+
+# Impose Hermitian symmetry on the plane with zero last wavenumber.
+def symmetrize(f):
+    f0 = f[..., 0]
+    f[..., 0] = 0.5 * (f0 + np.conj(f0[tuple(slice(None, None, -1)
+                                             for i in range(f0.ndim))]))
+
+def direct(F, shape, hermitian, mult):
+    k, N = wavenumbers(shape, hermitian)
+    d = len(shape)
+    grid = np.ix_(*[kk % N for kk in k])
+    mirror = np.ix_(*[-kk % N for kk in k])
+    u = []
+    for f in F:
+        full = np.zeros([N] * d, dtype=complex)
+        full[grid] = f
+        if hermitian:
+            full[mirror] = np.conj(f)
+        u.append(np.fft.ifftn(full) * N ** d)
+        if hermitian:
+            u[-1] = u[-1].real
+    return [np.fft.fftn(h)[grid] / N ** d for h in mult(u)]
+
+def check(cls, shape, name, A, mult):
+    hermitian = cls is fftwpp.HConvolution
+    try:
+        c = cls(shape, mult = name, A = A)
+    except ValueError:
+        # The multiplier is not available for this type of convolution.
+        return 0
+    C = max(c.A, c.B)
+    rng = np.random.RandomState(len(shape))
+    F = []
+    for a in range(C):
+        f = fftwpp.complex_align(list(shape))
+        f[...] = rng.standard_normal(shape) + 1j * rng.standard_normal(shape)
+        if hermitian:
+            symmetrize(f)
+        F.append(f)
+    expected = direct([f.copy() for f in F[:c.A]], shape, hermitian, mult)
+    c.convolve(*F)
+    error = max(np.max(np.abs(F[b] - expected[b])) for b in range(c.B))
+    norm = max(np.max(np.abs(e)) for e in expected)
+    label = "%s %s A=%d B=%d %s" % (cls.__name__, name, c.A, c.B, shape)
+    if error > 1e-10 * norm:
+        print(label + "\tFAILED (error=%g)" % error)
+        return 1
+    print(label + "\tok")
+    return 0
+
+returnflag = 0
+
+for name, A, mult in multipliers:
+    for shape in [(8,), (4, 5), (3, 4, 2)]:
+        returnflag += check(fftwpp.Convolution, shape, name, A, mult)
+    for shape in [(8,), (5, 4), (3, 5, 3)]:
+        returnflag += check(fftwpp.HConvolution, shape, name, A, mult)
+
+# Too few arrays must raise an exception rather than read past the end.
+c = fftwpp.HConvolution(8, mult = "advection3")
+F = [fftwpp.complex_align([8]) for a in range(c.A)]
+try:
+    c.convolve(*F)
+    print("advection3 with A arrays\tFAILED")
+    returnflag += 1
+except TypeError:
+    print("advection3 with A arrays\tok")
+
+sys.exit(returnflag)
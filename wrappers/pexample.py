@@ -1,11 +1,12 @@
-#!/usr/bin/python
+#!/usr/bin/env python
+
+from __future__ import print_function
 
 import sys
 import numpy as np
 import fftwpp
-import ctypes
 
-print "Example of calling fftw++ convolutions from python:"
+print("Example of calling fftw++ convolutions from python:")
 
 nthreads = 2
 fftwpp.fftwpp_set_maxthreads(nthreads)
@@ -15,59 +16,59 @@ N = 8
 def init(f, g):
     k = 0
     while k < len(f) :
-        f[k] = np.complex(k, k + 1)
-        g[k] = np.complex(k, 2 * k + 1)
+        f[k] = complex(k, k + 1)
+        g[k] = complex(k, 2 * k + 1)
         k += 1
     return;
 
 f = fftwpp.complex_align([N])
 g = fftwpp.complex_align([N])
 
-print
-print "1d non-centered complex convolution:"
+print()
+print("1d non-centered complex convolution:")
 init(f, g)
-print "input f:"
-print f
-print
-print "input g:"
-print g
+print("input f:")
+print(f)
+print()
+print("input g:")
+print(g)
 conv = fftwpp.Convolution(f.shape)
 conv.convolve(f, g)
 #conv.correlate(f, g)
-print f
+print(f)
 
-print
-print "1d non-centered complex autoconvolution:"
+print()
+print("1d non-centered complex autoconvolution:")
 init(f, g)
 conv = fftwpp.AutoConvolution(f.shape)
 conv.autoconvolve(f)
-print f
+print(f)
 
-print
-print "1d non-centered complex autocorrelation:"
+print()
+print("1d non-centered complex autocorrelation:")
 init(f, g)
 conv.autocorrelate(f)
-print f
-print
+print(f)
+print()
 
 
-print
-print "1d centered Hermitian-symmetric complex convolution:"
+print()
+print("1d centered Hermitian-symmetric complex convolution:")
 hconv = fftwpp.HConvolution(f.shape)
 init(f, g)
 hconv.convolve(f, g)
-print f
+print(f)
 
-print
-print "2d non-centered complex convolution:"
+print()
+print("2d non-centered complex convolution:")
 
 def init2(f, g):
     a = 0
     while a < f.shape[0] :
         b = 0
         while b < f[0].shape[0] :
-            f[a][b] = np.complex(a, b)
-            g[a][b] = np.complex(2 * a, b + 1)
+            f[a][b] = complex(a, b)
+            g[a][b] = complex(2 * a, b + 1)
             b += 1
         a += 1
     return;
@@ -83,11 +84,11 @@ init2(x, y)
 conv = fftwpp.Convolution(x.shape)
 conv.convolve(x, y)
 #conv.correlate(x, y)
-print x
+print(x)
 
 
-print
-print "2d centered Hermitian-symmetric convolution:"
+print()
+print("2d centered Hermitian-symmetric convolution:")
 mx = 4
 my = 4
 
@@ -95,13 +96,13 @@ hx = fftwpp.complex_align([2 * mx - 1, my])
 hy = fftwpp.complex_align([2 * mx - 1, my])
 
 init2(hx, hy)
-print hx
+print(hx)
 hconv2 = fftwpp.HConvolution(hx.shape)
 hconv2.convolve(hx, hy)
-print hx
+print(hx)
 
-print
-print "3d non-centered complex convolution:"
+print()
+print("3d non-centered complex convolution:")
 
 mx = 4
 my = 4
@@ -117,8 +118,8 @@ def init3(f, g):
         while b < f.shape[1] :
             c = 0
             while c < f.shape[2] :
-                f[a][b][c] = np.complex(a + c, b + c)
-                g[a][b][c] = np.complex(2 * a + c, b + 1 + c)
+                f[a][b][c] = complex(a + c, b + c)
+                g[a][b][c] = complex(2 * a + c, b + 1 + c)
                 c += 1
             b += 1
         a += 1
@@ -129,10 +130,10 @@ init3(x, y)
 conv = fftwpp.Convolution(x.shape)
 conv.convolve(x, y)
 #conv.correlate(x, y)
-print x
+print(x)
 
-print
-print "3d centered Hermitian-symmetric convolution:"
+print()
+print("3d centered Hermitian-symmetric convolution:")
 mx = 4
 my = 4
 mz = 4
@@ -142,4 +143,26 @@ hy = fftwpp.complex_align([2 * mx - 1, 2 * my - 1, mz])
 init3(hx, hy)
 conv = fftwpp.HConvolution(hx.shape)
 conv.convolve(hx, hy)
-print hx
+print(hx)
+
+print()
+print("Independent convolutions from several Python threads:")
+
+import threading
+
+def worker(results, k):
+    f = fftwpp.complex_align([N])
+    g = fftwpp.complex_align([N])
+    conv = fftwpp.Convolution(f.shape, threads = 1)
+    init(f, g)
+    conv.convolve(f, g)
+    results[k] = f
+
+results = [None] * nthreads
+threads = [threading.Thread(target = worker, args = (results, k))
+           for k in range(nthreads)]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+print(results[0])
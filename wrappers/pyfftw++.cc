@@ -0,0 +1,944 @@
+/* pyfftw++.cc - Python extension module for FFTW++.
+ *
+ * Unlike the C callable wrapper cfftw++.cc, this module operates directly
+ * on the memory of any object exporting the buffer protocol (such as a
+ * NumPy array), without copying, provided that it is C-contiguous and
+ * 16-byte aligned. The global interpreter lock is released while planning
+ * and while executing transforms and convolutions, so that independent
+ * objects may be used concurrently from a pool of Python threads.
+ *
+ * Not all of the FFTW++ routines are wrapped.
+ */
+
+#include <Python.h>
+#include <pthread.h>
+
+#include "Complex.h"
+#include "convolution.h"
+
+using namespace fftwpp;
+
+namespace {
+
+// Shape of the arrays accepted by a transform or convolution.
+struct Shape {
+  int ndim;
+  Py_ssize_t n[3];
+
+  Py_ssize_t size() const {
+    Py_ssize_t size=1;
+    for(int i=0; i < ndim; ++i) size *= n[i];
+    return size;
+  }
+};
+
+// Parse an integer or a sequence of 1 to 3 positive integers into S.
+bool getshape(PyObject *obj, Shape& S)
+{
+  if(PyNumber_Check(obj) && !PySequence_Check(obj)) {
+    S.ndim=1;
+    S.n[0]=PyNumber_AsSsize_t(obj,PyExc_OverflowError);
+  } else {
+    PyObject *seq=PySequence_Fast(obj,"shape must be an integer or a sequence");
+    if(!seq) return false;
+    S.ndim=PySequence_Fast_GET_SIZE(seq);
+    if(S.ndim < 1 || S.ndim > 3) {
+      Py_DECREF(seq);
+      PyErr_SetString(PyExc_ValueError,"shape must have 1, 2, or 3 dimensions");
+      return false;
+    }
+    for(int i=0; i < S.ndim; ++i)
+      S.n[i]=PyNumber_AsSsize_t(PySequence_Fast_GET_ITEM(seq,i),
+                                PyExc_OverflowError);
+    Py_DECREF(seq);
+  }
+  if(PyErr_Occurred()) return false;
+  for(int i=0; i < S.ndim; ++i) {
+    if(S.n[i] <= 0) {
+      PyErr_SetString(PyExc_ValueError,"shape must be positive");
+      return false;
+    }
+  }
+  return true;
+}
+
+PyObject *shapetuple(const Shape& S)
+{
+  PyObject *t=PyTuple_New(S.ndim);
+  if(!t) return NULL;
+  for(int i=0; i < S.ndim; ++i)
+    PyTuple_SET_ITEM(t,i,PyLong_FromSsize_t(S.n[i]));
+  return t;
+}
+
+// Buffer views released on destruction.
+class Views {
+  Py_buffer *view;
+  Py_ssize_t n;
+public:
+  Views(Py_ssize_t size) : view(new Py_buffer[size]), n(0) {}
+  ~Views() {
+    for(Py_ssize_t i=0; i < n; ++i)
+      PyBuffer_Release(view+i);
+    delete [] view;
+  }
+
+  // Acquire a writable view of obj as an array of Complex (complex=true)
+  // or double values of shape S, or, if batch is nonzero, of shape
+  // (K,)+S, where K is returned in batch. A NULL pointer is returned (and
+  // an exception set) if obj is not C-contiguous, 16-byte aligned, and of
+  // the correct type and shape.
+  void *get(PyObject *obj, const Shape& S, bool complex, const char *name,
+            Py_ssize_t *batch=NULL) {
+    Py_buffer *v=view+n;
+    if(PyObject_GetBuffer(obj,v,PyBUF_C_CONTIGUOUS | PyBUF_FORMAT |
+                          PyBUF_WRITABLE) != 0)
+      return NULL;
+    ++n;
+
+    const char *format=v->format ? v->format : "B";
+    size_t len=strlen(format);
+    bool iscomplex=len >= 2 && strcmp(format+len-2,"Zd") == 0;
+    bool isdouble=!iscomplex && len >= 1 && format[len-1] == 'd';
+    if(complex ? !iscomplex || v->itemsize != sizeof(Complex) :
+       !isdouble || v->itemsize != sizeof(double)) {
+      PyErr_Format(PyExc_TypeError,"%s must be an array of %s",name,
+                   complex ? "complex128" : "float64");
+      return NULL;
+    }
+
+    if((size_t) v->buf % sizeof(Complex) != 0) {
+      PyErr_Format(PyExc_ValueError,"%s is not %d-byte aligned",name,
+                   (int) sizeof(Complex));
+      return NULL;
+    }
+
+    int offset=batch && v->ndim == S.ndim+1 ? 1 : 0;
+    bool match=v->ndim == S.ndim+offset;
+    for(int i=0; match && i < S.ndim; ++i)
+      match=v->shape[i+offset] == S.n[i];
+    if(!match) {
+      PyObject *t=shapetuple(S);
+      if(t) {
+        PyObject *s=PyObject_Repr(t);
+        if(s) {
+          PyObject *b=PyUnicode_AsUTF8String(s);
+          if(b) {
+            PyErr_Format(PyExc_ValueError,"%s must have shape %s%s",name,
+                         batch ? "(K,)+" : "",PyBytes_AS_STRING(b));
+            Py_DECREF(b);
+          }
+          Py_DECREF(s);
+        }
+        Py_DECREF(t);
+      }
+      return NULL;
+    }
+    if(batch) *batch=offset ? v->shape[0] : 1;
+    return v->buf;
+  }
+};
+
+// Multipliers selectable by name. The number of inputs A and outputs B is
+// fixed except for the dot product, which accepts any even A up to 16
+// (A=0 here).
+struct Multiplier {
+  const char *name;
+  multiplier *mult;
+  realmultiplier *realmult;
+  unsigned int A,B;
+};
+
+Multiplier multipliers[]={
+  {"binary",multbinary,multbinary,2,1},
+  {"correlation",multcorrelation,multcorrelation,2,1},
+  {"autoconvolution",multautoconvolution,multautoconvolution,1,1},
+  {"autocorrelation",multautocorrelation,multautocorrelation,1,1},
+  {"dot",NULL,NULL,0,1},
+  {"cross",multcross,multcross,6,3},
+  {"advection2",NULL,multadvection2,2,2},
+  {"advection3",NULL,multadvection3,3,5},
+};
+
+const size_t nmultipliers=sizeof(multipliers)/sizeof(Multiplier);
+
+template<class T>
+T *dotmultiplier(unsigned int A)
+{
+  switch(A) {
+    case 2: return multdot<2>;
+    case 4: return multdot<4>;
+    case 6: return multdot<6>;
+    case 8: return multdot<8>;
+    case 10: return multdot<10>;
+    case 12: return multdot<12>;
+    case 14: return multdot<14>;
+    case 16: return multdot<16>;
+  }
+  return NULL;
+}
+
+// Look up the named multiplier for A inputs (A=0 selects its default)
+// and B outputs (B=0 selects its default); mult or realmult is set
+// according to hermitian. Returns false (and sets an exception) if the
+// multiplier is unknown or incompatible.
+bool getmultiplier(const char *name, bool hermitian, unsigned int& A,
+                   unsigned int& B, multiplier *&mult,
+                   realmultiplier *&realmult)
+{
+  for(size_t i=0; i < nmultipliers; ++i) {
+    const Multiplier& M=multipliers[i];
+    if(strcmp(name,M.name) != 0) continue;
+    if(M.A == 0) {
+      if(A == 0) A=2;
+      mult=dotmultiplier<multiplier>(A);
+      realmult=dotmultiplier<realmultiplier>(A);
+      if(!mult) {
+        PyErr_Format(PyExc_ValueError,
+                     "dot multiplier requires an even A <= 16, not %u",A);
+        return false;
+      }
+    } else {
+      if(A == 0) A=M.A;
+      mult=M.mult;
+      realmult=M.realmult;
+      if(A != M.A) {
+        PyErr_Format(PyExc_ValueError,"%s multiplier requires A=%u, not %u",
+                     name,M.A,A);
+        return false;
+      }
+    }
+    if(B == 0) B=M.B;
+    if(B != M.B) {
+      PyErr_Format(PyExc_ValueError,"%s multiplier requires B=%u, not %u",
+                   name,M.B,B);
+      return false;
+    }
+    if(hermitian ? !realmult : !mult) {
+      PyErr_Format(PyExc_ValueError,"%s multiplier is not available for %s "
+                   "convolutions",name,hermitian ? "Hermitian" : "complex");
+      return false;
+    }
+    return true;
+  }
+  PyErr_Format(PyExc_ValueError,"unknown multiplier %s",name);
+  return false;
+}
+
+// Type-independent interface to the implicitly dealiased convolutions.
+class Convolver {
+public:
+  virtual ~Convolver() {}
+  virtual void convolve(Complex **F, multiplier *mult,
+                        realmultiplier *realmult)=0;
+  virtual unsigned int Threads()=0;
+};
+
+template<class C>
+class ComplexConvolver : public Convolver {
+  C *c;
+public:
+  ComplexConvolver(C *c) : c(c) {}
+  ~ComplexConvolver() {delete c;}
+  void convolve(Complex **F, multiplier *mult, realmultiplier *) {
+    c->convolve(F,mult);
+  }
+  unsigned int Threads() {return c->Threads();}
+};
+
+template<class C>
+class HermitianConvolver : public Convolver {
+  C *c;
+public:
+  HermitianConvolver(C *c) : c(c) {}
+  ~HermitianConvolver() {delete c;}
+  void convolve(Complex **F, multiplier *, realmultiplier *realmult) {
+    c->convolve(F,realmult);
+  }
+  unsigned int Threads() {return c->Threads();}
+};
+
+// Python convolution object; the mutex serializes concurrent calls on the
+// same object, which share its work arrays.
+struct Convolution {
+  PyObject_HEAD
+  Convolver *convolver;
+  Shape shape;
+  bool hermitian;
+  unsigned int A,B;
+  multiplier *mult;
+  realmultiplier *realmult;
+  pthread_mutex_t lock;
+};
+
+Convolver *newConvolver(const Shape& S, bool hermitian, unsigned int A,
+                        unsigned int B, unsigned int threads)
+{
+  if(hermitian) {
+    switch(S.ndim) {
+      case 1:
+        return new HermitianConvolver<ImplicitHConvolution>
+          (new ImplicitHConvolution(S.n[0],true,A,B,threads));
+      case 2:
+        return new HermitianConvolver<ImplicitHConvolution2>
+          (new ImplicitHConvolution2((S.n[0]+1)/2,S.n[1],true,true,A,B,
+                                     threads));
+      case 3:
+        return new HermitianConvolver<ImplicitHConvolution3>
+          (new ImplicitHConvolution3((S.n[0]+1)/2,(S.n[1]+1)/2,S.n[2],
+                                     true,true,true,A,B,threads));
+    }
+  } else {
+    switch(S.ndim) {
+      case 1:
+        return new ComplexConvolver<ImplicitConvolution>
+          (new ImplicitConvolution(S.n[0],A,B,threads));
+      case 2:
+        return new ComplexConvolver<ImplicitConvolution2>
+          (new ImplicitConvolution2(S.n[0],S.n[1],A,B,threads));
+      case 3:
+        return new ComplexConvolver<ImplicitConvolution3>
+          (new ImplicitConvolution3(S.n[0],S.n[1],S.n[2],A,B,threads));
+    }
+  }
+  return NULL;
+}
+
+int Convolution_init(Convolution *self, PyObject *args, PyObject *kwds,
+                     bool hermitian)
+{
+  static const char *kwlist[]={"shape","mult","A","threads",NULL};
+  PyObject *shape;
+  const char *name="binary";
+  unsigned int A=0;
+  unsigned int threads=0;
+  if(!PyArg_ParseTupleAndKeywords(args,kwds,"O|sII",(char **) kwlist,
+                                  &shape,&name,&A,&threads))
+    return -1;
+
+  if(self->convolver) {
+    PyErr_SetString(PyExc_RuntimeError,"convolution is already initialized");
+    return -1;
+  }
+
+  Shape S;
+  if(!getshape(shape,S)) return -1;
+  if(hermitian) {
+    for(int i=0; i < S.ndim-1; ++i) {
+      if(S.n[i] % 2 == 0) {
+        PyErr_SetString(PyExc_ValueError,"Hermitian convolutions require "
+                        "odd lengths 2m-1 in all but the last dimension");
+        return -1;
+      }
+    }
+  }
+
+  unsigned int B=0;
+  if(!getmultiplier(name,hermitian,A,B,self->mult,self->realmult))
+    return -1;
+  if(threads == 0) threads=fftw::maxthreads;
+
+  Convolver *convolver;
+  Py_BEGIN_ALLOW_THREADS
+  convolver=newConvolver(S,hermitian,A,B,threads);
+  Py_END_ALLOW_THREADS
+
+  self->convolver=convolver;
+  self->shape=S;
+  self->hermitian=hermitian;
+  self->A=A;
+  self->B=B;
+  return 0;
+}
+
+int ComplexConvolution_init(Convolution *self, PyObject *args, PyObject *kwds)
+{
+  return Convolution_init(self,args,kwds,false);
+}
+
+int HConvolution_init(Convolution *self, PyObject *args, PyObject *kwds)
+{
+  return Convolution_init(self,args,kwds,true);
+}
+
+PyObject *Convolution_new(PyTypeObject *type, PyObject *, PyObject *)
+{
+  Convolution *self=(Convolution *) type->tp_alloc(type,0);
+  if(self) {
+    self->convolver=NULL;
+    pthread_mutex_init(&self->lock,NULL);
+  }
+  return (PyObject *) self;
+}
+
+void Convolution_dealloc(Convolution *self)
+{
+  Convolver *convolver=self->convolver;
+  if(convolver) {
+    Py_BEGIN_ALLOW_THREADS
+    delete convolver;
+    Py_END_ALLOW_THREADS
+  }
+  pthread_mutex_destroy(&self->lock);
+  Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+PyObject *Convolution_convolve(Convolution *self, PyObject *args,
+                               PyObject *kwds)
+{
+  if(!self->convolver) {
+    PyErr_SetString(PyExc_RuntimeError,"convolution is not initialized");
+    return NULL;
+  }
+
+  multiplier *mult=self->mult;
+  realmultiplier *realmult=self->realmult;
+  if(kwds) {
+    static const char *kwlist[]={"mult",NULL};
+    const char *name;
+    PyObject *empty=PyTuple_New(0);
+    if(!empty) return NULL;
+    int parsed=PyArg_ParseTupleAndKeywords(empty,kwds,"|s",(char **) kwlist,
+                                           &name);
+    Py_DECREF(empty);
+    if(!parsed) return NULL;
+    unsigned int A=self->A, B=self->B;
+    if(PyDict_Size(kwds) > 0 &&
+       !getmultiplier(name,self->hermitian,A,B,mult,realmult))
+      return NULL;
+  }
+
+  // The convolutions require max(A,B) distinct arrays: the first A hold
+  // the inputs and the first B receive the outputs.
+  unsigned int C=std::max(self->A,self->B);
+  if(PyTuple_GET_SIZE(args) != (Py_ssize_t) C) {
+    PyErr_Format(PyExc_TypeError,"convolve() requires %u arrays, not %d",C,
+                 (int) PyTuple_GET_SIZE(args));
+    return NULL;
+  }
+
+  Views views(C);
+  Complex **data=new Complex*[C];
+  Py_ssize_t K=0;
+  for(unsigned int a=0; a < C; ++a) {
+    char name[32];
+    snprintf(name,sizeof(name),"array %u",a);
+    Py_ssize_t batch;
+    data[a]=(Complex *) views.get(PyTuple_GET_ITEM(args,a),self->shape,true,
+                                  name,&batch);
+    if(!data[a]) {
+      delete [] data;
+      return NULL;
+    }
+    if(a == 0) K=batch;
+    else if(batch != K) {
+      delete [] data;
+      PyErr_SetString(PyExc_ValueError,
+                      "arrays must have the same number of batched inputs");
+      return NULL;
+    }
+    for(unsigned int b=0; b < a; ++b) {
+      if(data[b] == data[a]) {
+        delete [] data;
+        PyErr_SetString(PyExc_ValueError,"arrays must be distinct");
+        return NULL;
+      }
+    }
+  }
+
+  Py_ssize_t size=self->shape.size();
+  Complex **F=new Complex*[C];
+  Py_BEGIN_ALLOW_THREADS
+  pthread_mutex_lock(&self->lock);
+  for(Py_ssize_t k=0; k < K; ++k) {
+    for(unsigned int a=0; a < C; ++a)
+      F[a]=data[a]+k*size;
+    self->convolver->convolve(F,mult,realmult);
+  }
+  pthread_mutex_unlock(&self->lock);
+  Py_END_ALLOW_THREADS
+
+  delete [] F;
+  delete [] data;
+  Py_RETURN_NONE;
+}
+
+PyObject *Convolution_shape(Convolution *self, void *)
+{
+  return shapetuple(self->shape);
+}
+
+PyObject *Convolution_A(Convolution *self, void *)
+{
+  return PyLong_FromLong(self->A);
+}
+
+PyObject *Convolution_B(Convolution *self, void *)
+{
+  return PyLong_FromLong(self->B);
+}
+
+PyObject *Convolution_threads(Convolution *self, void *)
+{
+  return PyLong_FromLong(self->convolver ? self->convolver->Threads() : 0);
+}
+
+PyMethodDef Convolution_methods[]={
+  {"convolve",(PyCFunction) Convolution_convolve,METH_VARARGS | METH_KEYWORDS,
+   "convolve(*arrays, mult=None)\n\n"
+   "Convolve the first A of the max(A,B) arrays in place, returning the B\n"
+   "outputs in the first B arrays; the remaining arrays are overwritten.\n"
+   "Each array may have an additional leading dimension K, in which case\n"
+   "K independent convolutions are computed. mult optionally selects\n"
+   "another multiplier with the same A and B."},
+  {NULL}
+};
+
+PyGetSetDef Convolution_getset[]={
+  {(char *) "shape",(getter) Convolution_shape,NULL,
+   (char *) "shape of the arrays",NULL},
+  {(char *) "A",(getter) Convolution_A,NULL,(char *) "number of inputs",NULL},
+  {(char *) "B",(getter) Convolution_B,NULL,(char *) "number of outputs",NULL},
+  {(char *) "threads",(getter) Convolution_threads,NULL,
+   (char *) "number of threads",NULL},
+  {NULL}
+};
+
+PyTypeObject ConvolutionType={PyVarObject_HEAD_INIT(NULL,0)};
+PyTypeObject HConvolution_Type={PyVarObject_HEAD_INIT(NULL,0)};
+
+// Python transform object holding a persistent FFTW++ plan.
+struct Transform {
+  PyObject_HEAD
+  fftw *plan;
+  Shape ishape,oshape;
+  bool icomplex,ocomplex;
+  bool inplace;
+  double norm;
+};
+
+PyTypeObject TransformType={PyVarObject_HEAD_INIT(NULL,0)};
+
+void Transform_dealloc(Transform *self)
+{
+  fftw *plan=self->plan;
+  if(plan) {
+    Py_BEGIN_ALLOW_THREADS
+    delete plan;
+    Py_END_ALLOW_THREADS
+  }
+  Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+PyObject *execute(Transform *self, PyObject *args, PyObject *kwds,
+                  bool normalize)
+{
+  static const char *kwlist[]={"input","output",NULL};
+  PyObject *in;
+  PyObject *out=Py_None;
+  if(!PyArg_ParseTupleAndKeywords(args,kwds,"O|O",(char **) kwlist,&in,
+                                  &out))
+    return NULL;
+
+  if(out == Py_None) {
+    if(!self->inplace) {
+      PyErr_SetString(PyExc_ValueError,
+                      "an output array is required for out-of-place "
+                      "transforms");
+      return NULL;
+    }
+    out=in;
+  }
+
+  Views views(2);
+  void *I=views.get(in,self->ishape,self->icomplex,"input");
+  if(!I) return NULL;
+  void *O=out == in ? I : views.get(out,self->oshape,self->ocomplex,"output");
+  if(!O) return NULL;
+  if((O == I) != self->inplace) {
+    PyErr_SetString(PyExc_ValueError,self->inplace ?
+                    "transform was planned in place" :
+                    "transform was planned out of place");
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  self->plan->fft((Complex *) I,(Complex *) O);
+  if(normalize) {
+    double norm=self->norm;
+    Py_ssize_t n=self->oshape.size();
+    if(self->ocomplex) {
+      Complex *o=(Complex *) O;
+      for(Py_ssize_t i=0; i < n; ++i) o[i] *= norm;
+    } else {
+      double *o=(double *) O;
+      for(Py_ssize_t i=0; i < n; ++i) o[i] *= norm;
+    }
+  }
+  Py_END_ALLOW_THREADS
+
+  Py_RETURN_NONE;
+}
+
+PyObject *Transform_fft(Transform *self, PyObject *args, PyObject *kwds)
+{
+  return execute(self,args,kwds,false);
+}
+
+PyObject *Transform_fftNormalized(Transform *self, PyObject *args,
+                                  PyObject *kwds)
+{
+  return execute(self,args,kwds,true);
+}
+
+PyObject *Transform_ishape(Transform *self, void *)
+{
+  return shapetuple(self->ishape);
+}
+
+PyObject *Transform_oshape(Transform *self, void *)
+{
+  return shapetuple(self->oshape);
+}
+
+PyObject *Transform_inplace(Transform *self, void *)
+{
+  return PyBool_FromLong(self->inplace);
+}
+
+PyObject *Transform_threads(Transform *self, void *)
+{
+  return PyLong_FromLong(self->plan->Threads());
+}
+
+PyMethodDef Transform_methods[]={
+  {"fft",(PyCFunction) Transform_fft,METH_VARARGS | METH_KEYWORDS,
+   "fft(input, output=None)\n\n"
+   "Transform input into output (or in place for in-place transforms)."},
+  {"fftNormalized",(PyCFunction) Transform_fftNormalized,
+   METH_VARARGS | METH_KEYWORDS,
+   "fftNormalized(input, output=None)\n\n"
+   "Transform and divide by the number of points of each transform."},
+  {NULL}
+};
+
+PyGetSetDef Transform_getset[]={
+  {(char *) "ishape",(getter) Transform_ishape,NULL,
+   (char *) "shape of the input array",NULL},
+  {(char *) "oshape",(getter) Transform_oshape,NULL,
+   (char *) "shape of the output array",NULL},
+  {(char *) "inplace",(getter) Transform_inplace,NULL,
+   (char *) "whether the transform is computed in place",NULL},
+  {(char *) "threads",(getter) Transform_threads,NULL,
+   (char *) "number of threads",NULL},
+  {NULL}
+};
+
+// The kinds of transforms created by newTransform.
+enum Kind {FFT,RCFFT,CRFFT,MFFT,MRCFFT,MCRFFT};
+
+// Plan a transform of the given kind on temporary arrays, so that it may
+// later be executed on any suitably aligned arrays of the same shape.
+fftw *plan(Kind kind, const Shape& S, int sign, bool inplace, int axis,
+           unsigned int threads)
+{
+  Py_ssize_t nx=S.n[0];
+  Py_ssize_t ny=S.ndim > 1 ? S.n[1] : 1;
+  Py_ssize_t nz=S.ndim > 2 ? S.n[2] : 1;
+
+  if(kind == FFT) {
+    Complex *in=NULL, *out=NULL;
+    if(!inplace) {
+      in=utils::ComplexAlign(S.size());
+      out=utils::ComplexAlign(S.size());
+    }
+    fftw *f=NULL;
+    switch(S.ndim) {
+      case 1: f=new fft1d(nx,sign,in,out,threads); break;
+      case 2: f=new fft2d(nx,ny,sign,in,out,threads); break;
+      case 3: f=new fft3d(nx,ny,nz,sign,in,out,threads); break;
+    }
+    if(!inplace) {
+      utils::deleteAlign(out);
+      utils::deleteAlign(in);
+    }
+    return f;
+  }
+
+  if(kind == RCFFT || kind == CRFFT) {
+    Py_ssize_t n=S.n[S.ndim-1];
+    double *r=utils::doubleAlign(S.size());
+    Complex *c=utils::ComplexAlign(S.size()/n*(n/2+1));
+    fftw *f=NULL;
+    if(kind == RCFFT) {
+      switch(S.ndim) {
+        case 1: f=new rcfft1d(nx,r,c,threads); break;
+        case 2: f=new rcfft2d(nx,ny,r,c,threads); break;
+        case 3: f=new rcfft3d(nx,ny,nz,r,c,threads); break;
+      }
+    } else {
+      switch(S.ndim) {
+        case 1: f=new crfft1d(nx,c,r,threads); break;
+        case 2: f=new crfft2d(nx,ny,c,r,threads); break;
+        case 3: f=new crfft3d(nx,ny,nz,c,r,threads); break;
+      }
+    }
+    utils::deleteAlign(c);
+    utils::deleteAlign(r);
+    return f;
+  }
+
+  // Multiple 1D transforms of length n along axis of an M x n (axis=1) or
+  // n x M (axis=0) array.
+  unsigned int n=S.n[axis];
+  unsigned int M=S.n[1-axis];
+  unsigned int nc=kind == MFFT ? n : n/2+1;
+  size_t istride=axis == 0 ? M : 1;
+  size_t ostride=istride;
+  size_t idist=axis == 0 ? 1 : (kind == MCRFFT ? nc : n);
+  size_t odist=axis == 0 ? 1 : (kind == MRCFFT ? nc : n);
+
+  if(kind == MFFT) {
+    Complex *in=NULL, *out=NULL;
+    if(!inplace) {
+      in=utils::ComplexAlign(S.size());
+      out=utils::ComplexAlign(S.size());
+    }
+    fftw *f=new mfft1d(n,sign,M,istride,ostride,idist,odist,in,out,threads);
+    if(!inplace) {
+      utils::deleteAlign(out);
+      utils::deleteAlign(in);
+    }
+    return f;
+  }
+
+  double *r=utils::doubleAlign(n*M);
+  Complex *c=utils::ComplexAlign(nc*M);
+  fftw *f;
+  if(kind == MRCFFT)
+    f=new mrcfft1d(n,M,istride,ostride,idist,odist,r,c,threads);
+  else
+    f=new mcrfft1d(n,M,istride,ostride,idist,odist,c,r,threads);
+  utils::deleteAlign(c);
+  utils::deleteAlign(r);
+  return f;
+}
+
+PyObject *newTransform(Kind kind, PyObject *args, PyObject *kwds)
+{
+  static const char *kwlist[]={"shape","sign","inplace","axis","threads",
+                               NULL};
+  bool complex=kind == FFT || kind == MFFT;
+  bool multiple=kind == MFFT || kind == MRCFFT || kind == MCRFFT;
+  PyObject *shape;
+  int sign=kind == CRFFT || kind == MCRFFT ? 1 : -1;
+  int inplace=complex;
+  int axis=-1;
+  unsigned int threads=0;
+  if(!PyArg_ParseTupleAndKeywords(args,kwds,"O|iiiI",(char **) kwlist,
+                                  &shape,&sign,&inplace,&axis,&threads))
+    return NULL;
+
+  Shape S;
+  if(!getshape(shape,S)) return NULL;
+  if(multiple) {
+    if(S.ndim != 2) {
+      PyErr_SetString(PyExc_ValueError,
+                      "multiple transforms require a 2D shape");
+      return NULL;
+    }
+    if(axis < 0) axis += 2;
+    if(axis < 0 || axis > 1) {
+      PyErr_SetString(PyExc_ValueError,"axis must be 0 or 1");
+      return NULL;
+    }
+  } else axis=S.ndim-1;
+  if(sign != 1 && sign != -1) {
+    PyErr_SetString(PyExc_ValueError,"sign must be 1 or -1");
+    return NULL;
+  }
+  if(!complex && inplace) {
+    PyErr_SetString(PyExc_ValueError,
+                    "real transforms are computed out of place");
+    return NULL;
+  }
+
+  // The complex array of a real transform stores only the nonnegative
+  // frequencies of the last (or transformed) axis.
+  Shape C=S;
+  if(!complex) C.n[axis]=S.n[axis]/2+1;
+
+  Transform *self=(Transform *) TransformType.tp_alloc(&TransformType,0);
+  if(!self) return NULL;
+  self->ishape=kind == CRFFT || kind == MCRFFT ? C : S;
+  self->oshape=kind == RCFFT || kind == MRCFFT ? C : S;
+  self->icomplex=kind != RCFFT && kind != MRCFFT;
+  self->ocomplex=kind != CRFFT && kind != MCRFFT;
+  self->inplace=inplace;
+  self->norm=1.0/(multiple ? S.n[axis] : S.size());
+  if(threads == 0) threads=fftw::maxthreads;
+
+  fftw *f;
+  Py_BEGIN_ALLOW_THREADS
+  f=plan(kind,S,sign,inplace,axis,threads);
+  Py_END_ALLOW_THREADS
+  self->plan=f;
+  return (PyObject *) self;
+}
+
+PyObject *pyfft(PyObject *, PyObject *args, PyObject *kwds)
+{
+  return newTransform(FFT,args,kwds);
+}
+
+PyObject *pyrcfft(PyObject *, PyObject *args, PyObject *kwds)
+{
+  return newTransform(RCFFT,args,kwds);
+}
+
+PyObject *pycrfft(PyObject *, PyObject *args, PyObject *kwds)
+{
+  return newTransform(CRFFT,args,kwds);
+}
+
+PyObject *pymfft(PyObject *, PyObject *args, PyObject *kwds)
+{
+  return newTransform(MFFT,args,kwds);
+}
+
+PyObject *pymrcfft(PyObject *, PyObject *args, PyObject *kwds)
+{
+  return newTransform(MRCFFT,args,kwds);
+}
+
+PyObject *pymcrfft(PyObject *, PyObject *args, PyObject *kwds)
+{
+  return newTransform(MCRFFT,args,kwds);
+}
+
+PyObject *get_maxthreads(PyObject *, PyObject *)
+{
+  return PyLong_FromLong(fftw::maxthreads);
+}
+
+PyObject *set_maxthreads(PyObject *, PyObject *args)
+{
+  unsigned int threads;
+  if(!PyArg_ParseTuple(args,"I",&threads)) return NULL;
+  fftw::maxthreads=threads > 0 ? threads : 1;
+  Py_RETURN_NONE;
+}
+
+PyMethodDef methods[]={
+  {"fft",(PyCFunction) pyfft,METH_VARARGS | METH_KEYWORDS,
+   "fft(shape, sign=-1, inplace=True, threads=0)\n\n"
+   "Plan a 1D, 2D, or 3D complex transform."},
+  {"rcfft",(PyCFunction) pyrcfft,METH_VARARGS | METH_KEYWORDS,
+   "rcfft(shape, threads=0)\n\n"
+   "Plan a 1D, 2D, or 3D real-to-complex transform of real arrays of the\n"
+   "given shape."},
+  {"crfft",(PyCFunction) pycrfft,METH_VARARGS | METH_KEYWORDS,
+   "crfft(shape, threads=0)\n\n"
+   "Plan a 1D, 2D, or 3D complex-to-real transform to real arrays of the\n"
+   "given shape (the input array is overwritten)."},
+  {"mfft",(PyCFunction) pymfft,METH_VARARGS | METH_KEYWORDS,
+   "mfft(shape, sign=-1, inplace=True, axis=-1, threads=0)\n\n"
+   "Plan the complex transforms along axis of a 2D array."},
+  {"mrcfft",(PyCFunction) pymrcfft,METH_VARARGS | METH_KEYWORDS,
+   "mrcfft(shape, axis=-1, threads=0)\n\n"
+   "Plan the real-to-complex transforms along axis of a 2D real array."},
+  {"mcrfft",(PyCFunction) pymcrfft,METH_VARARGS | METH_KEYWORDS,
+   "mcrfft(shape, axis=-1, threads=0)\n\n"
+   "Plan the complex-to-real transforms along axis to a 2D real array\n"
+   "(the input array is overwritten)."},
+  {"get_maxthreads",get_maxthreads,METH_NOARGS,
+   "Return the default number of threads."},
+  {"set_maxthreads",set_maxthreads,METH_VARARGS,
+   "Set the default number of threads."},
+  {NULL}
+};
+
+bool ready(PyTypeObject& type, const char *name, size_t size,
+           const char *doc)
+{
+  type.tp_name=name;
+  type.tp_basicsize=size;
+  type.tp_flags=Py_TPFLAGS_DEFAULT;
+  type.tp_doc=doc;
+  return PyType_Ready(&type) == 0;
+}
+
+bool readyConvolution(PyTypeObject& type, const char *name, initproc init,
+                      const char *doc)
+{
+  type.tp_new=Convolution_new;
+  type.tp_init=init;
+  type.tp_dealloc=(destructor) Convolution_dealloc;
+  type.tp_methods=Convolution_methods;
+  type.tp_getset=Convolution_getset;
+  return ready(type,name,sizeof(Convolution),doc);
+}
+
+// Prepare the module types, returning false (with an exception set) on
+// failure.
+bool readyTypes()
+{
+  TransformType.tp_dealloc=(destructor) Transform_dealloc;
+  TransformType.tp_methods=Transform_methods;
+  TransformType.tp_getset=Transform_getset;
+  return
+    readyConvolution(ConvolutionType,"_fftwpp.Convolution",
+                     (initproc) ComplexConvolution_init,
+                     "Convolution(shape, mult='binary', A=0, threads=0)\n\n"
+                     "Implicitly dealiased 1D, 2D, or 3D complex "
+                     "convolution.") &&
+    readyConvolution(HConvolution_Type,"_fftwpp.HConvolution",
+                     (initproc) HConvolution_init,
+                     "HConvolution(shape, mult='binary', A=0, threads=0)\n\n"
+                     "Implicitly dealiased 1D, 2D, or 3D centered "
+                     "Hermitian-symmetric\nconvolution; shape is (m,), "
+                     "(2mx-1,my), or (2mx-1,2my-1,mz).") &&
+    ready(TransformType,"_fftwpp.Transform",sizeof(Transform),
+          "Persistent FFTW++ transform plan.");
+}
+
+bool addTypes(PyObject *module)
+{
+  Py_INCREF(&ConvolutionType);
+  Py_INCREF(&HConvolution_Type);
+  Py_INCREF(&TransformType);
+  return
+    PyModule_AddObject(module,"Convolution",(PyObject *) &ConvolutionType)
+    == 0 &&
+    PyModule_AddObject(module,"HConvolution",(PyObject *) &HConvolution_Type)
+    == 0 &&
+    PyModule_AddObject(module,"Transform",(PyObject *) &TransformType) == 0;
+}
+
+const char *moduledoc="Python interface to FFTW++.";
+
+} // anonymous namespace
+
+#if PY_MAJOR_VERSION >= 3
+static PyModuleDef moduledef={
+  PyModuleDef_HEAD_INIT,"_fftwpp",moduledoc,-1,methods
+};
+
+PyMODINIT_FUNC PyInit__fftwpp()
+{
+  if(!readyTypes()) return NULL;
+  PyObject *module=PyModule_Create(&moduledef);
+  if(module && !addTypes(module)) {
+    Py_DECREF(module);
+    return NULL;
+  }
+  return module;
+}
+#else
+PyMODINIT_FUNC init_fftwpp()
+{
+  if(!readyTypes()) return;
+  PyObject *module=Py_InitModule3("_fftwpp",methods,moduledoc);
+  if(module) addTypes(module);
+}
+#endif
@@ -1,4 +1,6 @@
-#!/usr/bin/python
+#!/usr/bin/env python
+
+from __future__ import print_function
 
 # script for unit testing fftw++ convolution wrappers
 
@@ -6,46 +8,37 @@ import os
 import subprocess
 import sys
 
+# Run the tests from this directory with the interpreter running this
+# script, so that they find the _fftwpp module built here.
+os.chdir(os.path.dirname(os.path.abspath(__file__)))
+
 returnflag=0
 
-command = ["./cexample"]
-with open(os.devnull, "w") as fnull:
-    result = subprocess.call(command, stdout = fnull, stderr = fnull)
-
-if result == 0:
-    print "cexample\tok"
-else:
-    print "cexample\tFAILED"
-    returnflag += 1
-
-command = ["python", "fftwpp.py"]
-with open(os.devnull, "w") as fnull:
-    result = subprocess.call(command)
-
-if result == 0:
-    print "fftwpp.py\tok"
-else:
-    print "fftwpp.py\tFAILED"
-    returnflag += 2
-
-command = ["python", "pexample.py"]
-with open(os.devnull, "w") as fnull:
-    result = subprocess.call(command, stdout = fnull, stderr = fnull)
-
-if result == 0:
-    print "pexample.py\tok"
-else:
-    print "pexample.py\tFAILED"
-    returnflag += 4
-
-command = ["./fexample"]
-with open(os.devnull, "w") as fnull:
-    result = subprocess.call(command, stdout = fnull, stderr = fnull)
-
-if result == 0:
-    print "fexample\tok"
-else:
-    print "fexample\tFAILED"
-    returnflag += 8
+def run(name, command, flag, quiet=True):
+    global returnflag
+    with open(os.devnull, "w") as fnull:
+        if quiet:
+            result = subprocess.call(command, stdout = fnull, stderr = fnull)
+        else:
+            result = subprocess.call(command)
+    if result == 0:
+        print(name + "\tok")
+    else:
+        print(name + "\tFAILED")
+        returnflag += flag
+
+# The compiled examples are optional: they are skipped if they have not
+# been built.
+def example(name, flag):
+    if os.path.exists(name):
+        run(name, ["./" + name], flag)
+    else:
+        print(name + "\tskipped (not built)")
+
+example("cexample", 1)
+run("fftwpp.py", [sys.executable, "fftwpp.py"], 2, quiet=False)
+run("pexample.py", [sys.executable, "pexample.py"], 4)
+example("fexample", 8)
+run("multipliers.py", [sys.executable, "multipliers.py"], 16)
 
 sys.exit(returnflag)